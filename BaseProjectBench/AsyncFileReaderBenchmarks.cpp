@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "BaseProjectBench/StorageBenchmarks.h"
+#include "Platform/Storage/AsyncFileReader.h"
+#include "Platform/Storage/File.h"
+
+using namespace Benchmarking;
+using namespace std;
+using namespace Storage;
+
+namespace
+{
+	const uint32 CHUNK_SIZE = 1u << 18;	/// Chunks of 256 KiB for comparing synchronous and asynchronous reading.
+
+	/** Sums floats as simple decoding work which can overlap with reading the next chunk.
+	@param data Set this to the start of the floats, possibly unaligned.
+	@param byteCount Set this to the number of bytes at data.
+	@return Returns the sum of all complete floats at data. */
+	float sumFloats(const uint8 *data, const uint64 byteCount)
+	{
+		float sum = 0.0f;
+		for (uint64 offset = 0; offset + sizeof(float) <= byteCount; offset += sizeof(float))
+		{
+			float value;
+			memcpy(&value, data + offset, sizeof(float));
+			sum += value;
+		}
+
+		return sum;
+	}
+
+	/** Reads the floats file chunk by chunk and decodes each chunk while the next ones are read ahead.
+	@param fileName Set this to the path of the floats file.
+	@param backend Set this to the preferred AsyncFileReader backend. */
+	void sumFloatsAsynchronously(const Path &fileName, const AsyncFileReader::BACKEND backend)
+	{
+		AsyncFileReader reader(fileName, CHUNK_SIZE, AsyncFileReader::DEFAULT_BUFFER_COUNT, backend);
+		AsyncFileReader::Chunk chunk;
+		float sum = 0.0f;
+
+		while (reader.acquireChunk(chunk))
+			sum += sumFloats(chunk.mData, chunk.mSize);
+		doNotOptimizeAway(sum);
+	}
+}
+
+void Benchmarking::addAsyncFileReaderBenchmarks(BenchmarkRunner &runner, const shared_ptr<StorageData> &data)
+{
+	// synchronous vs. asynchronous reading, an iteration reads and decodes the whole file chunk by chunk
+	runner.add("Storage/File/readChunksSynchronous", [data] (uint64 iterationCount)
+	{
+		vector<uint8> chunk(CHUNK_SIZE);
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			File file(data->mFloatsFile, File::OPEN_READING, true);
+			float sum = 0.0f;
+
+			for (uint32 readBytes = file.read(chunk.data(), CHUNK_SIZE, 1, CHUNK_SIZE); readBytes > 0;
+				readBytes = file.read(chunk.data(), CHUNK_SIZE, 1, CHUNK_SIZE))
+				sum += sumFloats(chunk.data(), readBytes);
+			doNotOptimizeAway(sum);
+		}
+	}, FLOAT_COUNT * sizeof(float));
+
+	runner.add("Storage/AsyncFileReader/readChunksIOURing", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			sumFloatsAsynchronously(data->mFloatsFile, AsyncFileReader::BACKEND_IO_URING);
+	}, FLOAT_COUNT * sizeof(float));
+
+	runner.add("Storage/AsyncFileReader/readChunksThread", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			sumFloatsAsynchronously(data->mFloatsFile, AsyncFileReader::BACKEND_THREAD);
+	}, FLOAT_COUNT * sizeof(float));
+}
@@ -0,0 +1,402 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include "BaseProjectBench/BenchmarkRunner.h"
+#include "Platform/FailureHandling/FileCorruptionException.h"
+#include "Platform/Storage/File.h"
+
+using namespace Benchmarking;
+using namespace FailureHandling;
+using namespace std;
+using namespace Storage;
+
+namespace
+{
+	/// Minimal reader for the JSON result files which are written by BenchmarkRunner::saveJSON().
+	/** Supports objects, arrays, strings without escape sequences other than \" and \\, numbers, true, false and null. */
+	class JSONReader
+	{
+	public:
+		JSONReader(const string &text, const Path &fileName) :
+			mFileName(fileName), mText(text), mPosition(0)
+		{
+
+		}
+
+		/** Consumes the next non white space character if it is c.
+		@param c Set this to the wanted character.
+		@return Returns true if c was consumed. */
+		bool accept(const char c)
+		{
+			skipWhiteSpace();
+			if (mPosition >= mText.size() || mText[mPosition] != c)
+				return false;
+
+			++mPosition;
+			return true;
+		}
+
+		/** Consumes the next non white space character which must be c.
+		@param c Set this to the expected character. */
+		void expect(const char c)
+		{
+			if (!accept(c))
+				fail(string("Expected '") + c + "'.");
+		}
+
+		/** Throws an exception describing a syntax error at the current position.
+		@param message Describes what is wrong. */
+		void fail(const string &message) const
+		{
+			ostringstream stream;
+			stream << "Invalid benchmark results at character " << mPosition << ": " << message;
+			throw FileCorruptionException(stream.str(), mFileName);
+		}
+
+		/** Consumes a number.
+		@return Returns the consumed number. */
+		double readNumber()
+		{
+			skipWhiteSpace();
+			const char *begin = mText.c_str() + mPosition;
+			char *end = NULL;
+
+			const double number = strtod(begin, &end);
+			if (end == begin)
+				fail("Expected a number.");
+
+			mPosition += end - begin;
+			return number;
+		}
+
+		/** Consumes a string in double quotes.
+		@return Returns the string without quotes. */
+		string readString()
+		{
+			expect('"');
+
+			string result;
+			while (mPosition < mText.size() && mText[mPosition] != '"')
+			{
+				if ('\\' == mText[mPosition])
+					++mPosition;
+				if (mPosition < mText.size())
+					result += mText[mPosition++];
+			}
+
+			expect('"');
+			return result;
+		}
+
+		/** Skips the next value and returns its text.
+		@return Returns the complete text of the skipped value, e.g., a whole object. */
+		string skipValue()
+		{
+			skipWhiteSpace();
+			const size_t begin = mPosition;
+
+			if (accept('{'))
+			{
+				if (!accept('}'))
+				{
+					do
+					{
+						readString();
+						expect(':');
+						skipValue();
+					} while (accept(','));
+					expect('}');
+				}
+			}
+			else if (accept('['))
+			{
+				if (!accept(']'))
+				{
+					do
+					{
+						skipValue();
+					} while (accept(','));
+					expect(']');
+				}
+			}
+			else if (mPosition < mText.size() && '"' == mText[mPosition])
+			{
+				readString();
+			}
+			else if (mPosition < mText.size() && isalpha((unsigned char) mText[mPosition]))
+			{
+				while (mPosition < mText.size() && isalpha((unsigned char) mText[mPosition]))
+					++mPosition;
+			}
+			else
+			{
+				readNumber();
+			}
+
+			return mText.substr(begin, mPosition - begin);
+		}
+
+	private:
+		void skipWhiteSpace()
+		{
+			while (mPosition < mText.size() && isspace((unsigned char) mText[mPosition]))
+				++mPosition;
+		}
+
+	private:
+		const Path		&mFileName;	/// For error messages.
+		const string	&mText;		/// Complete file content.
+		size_t			mPosition;	/// Index of the next unread character in mText.
+	};
+}
+
+BenchmarkRunner::BenchmarkRunner(const uint32 warmupCount, const uint32 repetitionCount, const double minRepetitionTime) :
+	mMinRepetitionTime(minRepetitionTime), mRepetitionCount(repetitionCount), mWarmupCount(warmupCount)
+{
+	assert(repetitionCount > 0);
+	assert(minRepetitionTime > 0.0);
+}
+
+void BenchmarkRunner::add(const string &name, const Function &function, const uint64 bytesPerIteration,
+	const Fixture &setUp, const Fixture &tearDown)
+{
+	Benchmark benchmark;
+	benchmark.mName = name;
+	benchmark.mFunction = function;
+	benchmark.mSetUp = setUp;
+	benchmark.mTearDown = tearDown;
+	benchmark.mBytesPerIteration = bytesPerIteration;
+
+	mBenchmarks.push_back(benchmark);
+}
+
+uint64 BenchmarkRunner::calibrate(const Benchmark &benchmark) const
+{
+	const double minDuration = mMinRepetitionTime * 1e9;
+	uint64 iterationCount = 1;
+
+	while (true)
+	{
+		const double duration = measure(benchmark, iterationCount);
+		if (duration >= minDuration)
+			return iterationCount;
+
+		// jump close to the wanted duration but grow at most by factor 10 per step since first measurements are noisy
+		double factor = (duration > 0.0 ? 1.2 * minDuration / duration : 10.0);
+		if (factor < 2.0)
+			factor = 2.0;
+		else if (factor > 10.0)
+			factor = 10.0;
+		iterationCount = (uint64) ceil(iterationCount * factor);
+	}
+}
+
+double BenchmarkRunner::measure(const Benchmark &benchmark, const uint64 iterationCount)
+{
+	const chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+	benchmark.mFunction(iterationCount);
+	const chrono::high_resolution_clock::time_point end = chrono::high_resolution_clock::now();
+
+	return chrono::duration_cast<chrono::duration<double, nano> >(end - start).count();
+}
+
+void BenchmarkRunner::loadJSON(vector<BenchmarkResult> &results, string &context, const Path &fileName)
+{
+	string text;
+	File::loadTextFile(text, fileName);
+
+	results.clear();
+	context = "{}";
+
+	JSONReader reader(text, fileName);
+	reader.expect('{');
+	do
+	{
+		const string key = reader.readString();
+		reader.expect(':');
+
+		if ("context" == key)
+		{
+			context = reader.skipValue();
+			continue;
+		}
+
+		if ("benchmarks" != key)
+		{
+			reader.skipValue();
+			continue;
+		}
+
+		// each benchmark result
+		reader.expect('[');
+		if (reader.accept(']'))
+			continue;
+
+		do
+		{
+			BenchmarkResult result;
+			result.mIterationCount = 0;
+			result.mBytesPerIteration = 0;
+
+			reader.expect('{');
+			do
+			{
+				const string property = reader.readString();
+				reader.expect(':');
+
+				if ("name" == property)
+				{
+					result.mName = reader.readString();
+				}
+				else if ("iterations" == property)
+				{
+					result.mIterationCount = (uint64) reader.readNumber();
+				}
+				else if ("bytesPerIteration" == property)
+				{
+					result.mBytesPerIteration = (uint64) reader.readNumber();
+				}
+				else if ("samples" == property)
+				{
+					reader.expect('[');
+					if (!reader.accept(']'))
+					{
+						do
+						{
+							result.mSamples.push_back(reader.readNumber());
+						} while (reader.accept(','));
+						reader.expect(']');
+					}
+				}
+				else
+				{
+					reader.skipValue();
+				}
+			} while (reader.accept(','));
+			reader.expect('}');
+
+			if (result.mName.empty() || result.mSamples.empty())
+				reader.fail("Benchmark result without name or samples.");
+
+			summarize(result);
+			results.push_back(result);
+		} while (reader.accept(','));
+		reader.expect(']');
+	} while (reader.accept(','));
+	reader.expect('}');
+}
+
+void BenchmarkRunner::run(const string &filter)
+{
+	mResults.clear();
+	printf("%-48s %12s %12s %12s %8s %12s %12s %10s\n",
+		"Benchmark", "Iterations", "Mean [ns]", "Median [ns]", "CV [%]", "Min [ns]", "Max [ns]", "MB/s");
+
+	const size_t benchmarkCount = mBenchmarks.size();
+	for (size_t benchmarkIdx = 0; benchmarkIdx < benchmarkCount; ++benchmarkIdx)
+	{
+		// wanted?
+		const Benchmark &benchmark = mBenchmarks[benchmarkIdx];
+		if (!filter.empty() && string::npos == benchmark.mName.find(filter))
+			continue;
+
+		if (benchmark.mSetUp)
+			benchmark.mSetUp();
+
+		// calibrate & warm up
+		BenchmarkResult result;
+		result.mName = benchmark.mName;
+		result.mBytesPerIteration = benchmark.mBytesPerIteration;
+		result.mIterationCount = calibrate(benchmark);
+		for (uint32 warmupIdx = 0; warmupIdx < mWarmupCount; ++warmupIdx)
+			measure(benchmark, result.mIterationCount);
+
+		// measure
+		result.mSamples.resize(mRepetitionCount);
+		for (uint32 repetitionIdx = 0; repetitionIdx < mRepetitionCount; ++repetitionIdx)
+			result.mSamples[repetitionIdx] = measure(benchmark, result.mIterationCount) / result.mIterationCount;
+
+		if (benchmark.mTearDown)
+			benchmark.mTearDown();
+
+		// output
+		summarize(result);
+		mResults.push_back(result);
+
+		const double variation = (result.mMean > 0.0 ? 100.0 * result.mStandardDeviation / result.mMean : 0.0);
+		printf("%-48s %12" PRIu64 " %12.2f %12.2f %8.2f %12.2f %12.2f",
+			result.mName.c_str(), result.mIterationCount, result.mMean, result.mMedian, variation, result.mMin, result.mMax);
+		if (result.mBytesPerIteration > 0)
+			printf(" %10.1f\n", (result.mBytesPerIteration / (1024.0 * 1024.0)) / (result.mMedian * 1e-9));
+		else
+			printf(" %10s\n", "-");
+		fflush(stdout);
+	}
+}
+
+void BenchmarkRunner::saveJSON(const Path &fileName, const string &context, const vector<BenchmarkResult> &results)
+{
+	File file(fileName, File::CREATE_WRITING, false);
+	FILE *handle = &file.getHandle();
+
+	fprintf(handle, "{\n\"context\":%s,\n\"benchmarks\":[\n", (context.empty() ? "{}" : context.c_str()));
+
+	const size_t resultCount = results.size();
+	for (size_t resultIdx = 0; resultIdx < resultCount; ++resultIdx)
+	{
+		const BenchmarkResult &result = results[resultIdx];
+
+		fprintf(handle, "{\"name\":\"%s\",\"unit\":\"ns\",\"iterations\":%" PRIu64 ",\"bytesPerIteration\":%" PRIu64 ","
+			"\"repetitions\":%u,\"mean\":%.4f,\"median\":%.4f,\"stddev\":%.4f,\"min\":%.4f,\"max\":%.4f,\"samples\":[",
+			result.mName.c_str(), result.mIterationCount, result.mBytesPerIteration,
+			(uint32) result.mSamples.size(), result.mMean, result.mMedian, result.mStandardDeviation, result.mMin, result.mMax);
+
+		const size_t sampleCount = result.mSamples.size();
+		for (size_t sampleIdx = 0; sampleIdx < sampleCount; ++sampleIdx)
+			fprintf(handle, (0 == sampleIdx ? "%.4f" : ",%.4f"), result.mSamples[sampleIdx]);
+
+		fputs((resultIdx + 1 < resultCount ? "]},\n" : "]}\n"), handle);
+	}
+
+	fputs("]\n}\n", handle);
+}
+
+void BenchmarkRunner::summarize(BenchmarkResult &result)
+{
+	vector<double> sorted(result.mSamples);
+	sort(sorted.begin(), sorted.end());
+
+	const size_t count = sorted.size();
+	assert(count > 0);
+
+	// mean & extremes
+	double sum = 0.0;
+	for (size_t sampleIdx = 0; sampleIdx < count; ++sampleIdx)
+		sum += sorted[sampleIdx];
+
+	result.mMean = sum / count;
+	result.mMin = sorted.front();
+	result.mMax = sorted.back();
+	result.mMedian = (count % 2 ? sorted[count / 2] : 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]));
+
+	// sample standard deviation
+	double squaredDeviations = 0.0;
+	for (size_t sampleIdx = 0; sampleIdx < count; ++sampleIdx)
+	{
+		const double deviation = sorted[sampleIdx] - result.mMean;
+		squaredDeviations += deviation * deviation;
+	}
+	result.mStandardDeviation = (count > 1 ? sqrt(squaredDeviations / (count - 1)) : 0.0);
+}
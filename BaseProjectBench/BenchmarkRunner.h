@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _BENCHMARK_RUNNER_H_
+#define _BENCHMARK_RUNNER_H_
+
+#include <cassert>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Platform/DataTypes.h"
+#include "Platform/Storage/Path.h"
+
+/// Contains the microbenchmark harness and the benchmarks of the core libraries.
+namespace Benchmarking
+{
+	/// Summary of all measured repetitions of a single benchmark.
+	struct BenchmarkResult
+	{
+		std::string			mName;				/// Unique name of the benchmark, e.g., "Math/Vector3/crossProduct".
+		std::vector<double>	mSamples;			/// Nanoseconds per iteration of each measured repetition.
+		uint64				mIterationCount;	/// Number of iterations of each repetition which was calibrated before measuring.
+		uint64				mBytesPerIteration;	/// Processed bytes per iteration for throughput or 0 if not meaningful.
+		double				mMean;				/// Mean of mSamples.
+		double				mMedian;			/// Median of mSamples.
+		double				mStandardDeviation;	/// Sample standard deviation of mSamples.
+		double				mMin;				/// Smallest sample.
+		double				mMax;				/// Largest sample.
+	};
+
+	/// Registers, calibrates, runs and summarizes microbenchmarks.
+	/** Each benchmark is a function which executes a requested number of iterations of the measured operation.
+		The runner first doubles the iteration count until a single repetition takes at least the minimum repetition time,
+		then executes some unmeasured warmup repetitions and finally measures each of the wanted repetitions.
+		Results are the times per iteration in nanoseconds and can be printed as table or saved as JSON file.
+		Nothing requires a window or graphics context. */
+	class BenchmarkRunner
+	{
+	public:
+		/// Executes iterationCount iterations of the measured operation.
+		typedef std::function<void (uint64 iterationCount)> Function;
+
+		/// Prepares or cleans up unmeasured state of a benchmark, e.g., creates a file which is read afterwards.
+		typedef std::function<void ()> Fixture;
+
+	public:
+		/** Creates a runner without benchmarks.
+		@param warmupCount Set this to the number of unmeasured repetitions before the measured ones.
+		@param repetitionCount Set this to the number of measured repetitions of each benchmark. Must be positive.
+		@param minRepetitionTime Set this to the minimum duration of a single repetition in seconds which determines the iteration count. */
+		BenchmarkRunner(const uint32 warmupCount, const uint32 repetitionCount, const double minRepetitionTime);
+
+		/** Registers a benchmark. Benchmarks are run in the order in which they were added.
+		@param name Set this to a unique name. Slashes group benchmarks, e.g., "Math/Vector3/crossProduct".
+		@param function Set this to the function which executes the measured iterations.
+		@param bytesPerIteration Set this to the number of processed bytes per iteration to additionally get the throughput or to 0.
+		@param setUp Is called once before calibration if it is not empty.
+		@param tearDown Is called once after the measurements if it is not empty. */
+		void add(const std::string &name, const Function &function, const uint64 bytesPerIteration = 0,
+			const Fixture &setUp = Fixture(), const Fixture &tearDown = Fixture());
+
+		/** Loads results which were saved with saveJSON().
+		@param results Is filled with the loaded results in file order. Their statistics are recomputed from the loaded samples.
+		@param context Is set to the JSON object describing the configuration of the saved run.
+		@param fileName Set this to the path of the JSON file.
+		@throws FileCorruptionException Thrown if the file is not a valid result file. */
+		static void loadJSON(std::vector<BenchmarkResult> &results, std::string &context, const Storage::Path &fileName);
+
+		/** Returns the results of the benchmarks which were run so far.
+		@return Returns one result per executed benchmark in execution order. */
+		inline const std::vector<BenchmarkResult> &getResults() const;
+
+		/** Runs all registered benchmarks whose names contain filter and prints a summary line for each of them.
+		@param filter Only benchmarks with names containing this string are run. Set it to an empty string to run all benchmarks. */
+		void run(const std::string &filter);
+
+		/** Saves the results of the last run() call as JSON file.
+		@param fileName Set this to the path of the created file.
+		@param context Set this to a JSON object describing the configuration of the run, e.g., "{\"threads\":4}". */
+		inline void saveJSON(const Storage::Path &fileName, const std::string &context) const;
+
+		/** Saves results as JSON file which can be loaded with loadJSON().
+		@param fileName Set this to the path of the created file.
+		@param context Set this to a JSON object describing the configuration of the run, e.g., "{\"threads\":4}".
+		@param results Set this to the results which are saved. */
+		static void saveJSON(const Storage::Path &fileName, const std::string &context, const std::vector<BenchmarkResult> &results);
+
+		/** Computes mean, median, standard deviation and extremes of the samples of result.
+		@param result Its statistics are computed from its samples which must not be empty. */
+		static void summarize(BenchmarkResult &result);
+
+	private:
+		/// Registered but not necessarily executed benchmark.
+		struct Benchmark
+		{
+			std::string	mName;				/// See BenchmarkResult::mName.
+			Function	mFunction;			/// Executes the measured iterations.
+			Fixture		mSetUp;				/// Called before calibration or empty.
+			Fixture		mTearDown;			/// Called after measuring or empty.
+			uint64		mBytesPerIteration;	/// See BenchmarkResult::mBytesPerIteration.
+		};
+
+	private:
+		/** Finds an iteration count for which a single repetition takes at least mMinRepetitionTime.
+		@param benchmark Set this to the benchmark which is calibrated.
+		@return Returns the number of iterations per repetition. */
+		uint64 calibrate(const Benchmark &benchmark) const;
+
+		/** Executes iterationCount iterations of a benchmark and measures how long this takes.
+		@param benchmark Set this to the executed benchmark.
+		@param iterationCount Set this to the number of executed iterations.
+		@return Returns the duration of all iterations in nanoseconds. */
+		static double measure(const Benchmark &benchmark, const uint64 iterationCount);
+
+	private:
+		std::vector<Benchmark>			mBenchmarks;			/// All registered benchmarks.
+		std::vector<BenchmarkResult>	mResults;				/// Results of the last run() call.
+		double							mMinRepetitionTime;		/// Minimum duration of a single repetition in seconds.
+		uint32							mRepetitionCount;		/// Number of measured repetitions.
+		uint32							mWarmupCount;			/// Number of unmeasured repetitions.
+	};
+
+	/** Prevents the compiler from removing the computation of value although it is never used.
+	@param value Set this to the result of the measured operation. */
+	template <class T>
+	inline void doNotOptimizeAway(const T &value);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline const std::vector<BenchmarkResult> &BenchmarkRunner::getResults() const
+	{
+		return mResults;
+	}
+
+	inline void BenchmarkRunner::saveJSON(const Storage::Path &fileName, const std::string &context) const
+	{
+		saveJSON(fileName, context, mResults);
+	}
+
+	template <class T>
+	inline void doNotOptimizeAway(const T &value)
+	{
+		#ifdef __GNUC__
+			asm volatile("" : : "g"(&value) : "memory");
+		#else
+			const volatile char *bytes = reinterpret_cast<const volatile char *>(&value);
+			(void) *bytes;
+		#endif // __GNUC__
+	}
+}
+
+#endif // _BENCHMARK_RUNNER_H_
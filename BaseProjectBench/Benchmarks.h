@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _BENCHMARKS_H_
+#define _BENCHMARKS_H_
+
+#include "BaseProjectBench/BenchmarkRunner.h"
+#include "Platform/Storage/Path.h"
+
+namespace Benchmarking
+{
+	/** Registers the benchmarks of CollisionDetection intersection and distance routines.
+	@param runner The benchmarks are added to this runner. */
+	void addCollisionDetectionBenchmarks(BenchmarkRunner &runner);
+
+	/** Registers the benchmarks of Vector3, Matrix4x4, Quaternion and LinearSolver operations.
+	@param runner The benchmarks are added to this runner. */
+	void addMathBenchmarks(BenchmarkRunner &runner);
+
+	/** Registers the benchmarks of the Multithreading::Manager task throughput. Requires a running Multithreading::Manager.
+	@param runner The benchmarks are added to this runner. */
+	void addMultithreadingBenchmarks(BenchmarkRunner &runner);
+
+	/** Registers the benchmarks of MemoryPool requests and releases.
+	@param runner The benchmarks are added to this runner. */
+	void addResourceManagementBenchmarks(BenchmarkRunner &runner);
+
+	/** Registers the benchmarks of Storage::File, AsyncFileReader, compressed files, PlyFile and mesh caches, see StorageBenchmarks.h.
+	@param runner The benchmarks are added to this runner.
+	@param dataDirectory Temporary input files are created in this directory while the benchmarks run and removed afterwards. */
+	void addStorageBenchmarks(BenchmarkRunner &runner, const Storage::Path &dataDirectory);
+}
+
+#endif // _BENCHMARKS_H_
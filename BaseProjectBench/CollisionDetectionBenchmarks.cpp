@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <memory>
+#include <vector>
+#include "BaseProjectBench/Benchmarks.h"
+#include "CollisionDetection/CollisionDetection.h"
+#include "Math/Vector3.h"
+#include "Platform/Utilities/RandomManager.h"
+
+using namespace Benchmarking;
+using namespace CollisionDetection;
+using namespace Math;
+using namespace std;
+using namespace Utilities;
+
+namespace
+{
+	const uint32 SCENE_SIZE = 1024;	/// Number of random primitives per benchmark, power of two to cycle through them cheaply.
+
+	/// Random rays, triangles, boxes and spheres in [-1, 1]^3 so that roughly half of the tests hit.
+	struct Scene
+	{
+		vector<Vector3>	mRayStarts;
+		vector<Vector3>	mRayDirections;
+		vector<Vector3>	mTriangles;		/// 3 corners per triangle.
+		vector<Vector3>	mAABBs;			/// Minimum and maximum corner per box.
+		vector<Vector3>	mSphereCenters;
+		vector<Real>	mSphereRadii;
+	};
+
+	shared_ptr<Scene> createScene()
+	{
+		RandomManager &random = RandomManager::getSingleton();
+		shared_ptr<Scene> scene(new Scene());
+
+		const Vector3 min(-1.0f, -1.0f, -1.0f);
+		const Vector3 max(1.0f, 1.0f, 1.0f);
+
+		scene->mRayStarts.resize(SCENE_SIZE);
+		scene->mRayDirections.resize(SCENE_SIZE);
+		scene->mTriangles.resize(3 * SCENE_SIZE);
+		scene->mAABBs.resize(2 * SCENE_SIZE);
+		scene->mSphereCenters.resize(SCENE_SIZE);
+		scene->mSphereRadii.resize(SCENE_SIZE);
+
+		for (uint32 primitiveIdx = 0; primitiveIdx < SCENE_SIZE; ++primitiveIdx)
+		{
+			// rays from outside towards the center region
+			scene->mRayStarts[primitiveIdx] = random.getUniform(min, max) * 4.0f;
+			scene->mRayDirections[primitiveIdx] = random.getUniform(min, max) * 0.5f - scene->mRayStarts[primitiveIdx];
+
+			for (uint32 cornerIdx = 0; cornerIdx < 3; ++cornerIdx)
+				scene->mTriangles[3 * primitiveIdx + cornerIdx] = random.getUniform(min, max);
+
+			const Vector3 center = random.getUniform(min, max);
+			const Vector3 halfSize = random.getUniform(Vector3(0.1f, 0.1f, 0.1f), max);
+			scene->mAABBs[2 * primitiveIdx] = center - halfSize;
+			scene->mAABBs[2 * primitiveIdx + 1] = center + halfSize;
+
+			scene->mSphereCenters[primitiveIdx] = random.getUniform(min, max);
+			scene->mSphereRadii[primitiveIdx] = random.getUniform(0.1f, 1.0f);
+		}
+
+		return scene;
+	}
+}
+
+void Benchmarking::addCollisionDetectionBenchmarks(BenchmarkRunner &runner)
+{
+	const shared_ptr<Scene> scene = createScene();
+	const uint32 mask = SCENE_SIZE - 1;
+
+	runner.add("CollisionDetection/intersectRayWithTriangle", [scene, mask] (uint64 iterationCount)
+	{
+		const Vector3 *triangles = scene->mTriangles.data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const uint32 idx = (uint32) (i & mask);
+			const Vector3 *triangle = triangles + 3 * ((idx * 7) & mask);
+
+			Vector3 intersection;
+			const bool hit = intersectRayWithTriangle(intersection, false, scene->mRayStarts[idx], scene->mRayDirections[idx],
+				triangle[0], triangle[1], triangle[2]);
+			doNotOptimizeAway(hit);
+			doNotOptimizeAway(intersection);
+		}
+	});
+
+	runner.add("CollisionDetection/intersectAABBWithLine", [scene, mask] (uint64 iterationCount)
+	{
+		const Vector3 *boxes = scene->mAABBs.data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const uint32 idx = (uint32) (i & mask);
+			const Vector3 *box = boxes + 2 * ((idx * 7) & mask);
+
+			Real entryT;
+			Real exitT;
+			const bool hit = intersectAABBWithLine(entryT, exitT, scene->mRayStarts[idx], scene->mRayDirections[idx], box[0], box[1]);
+			doNotOptimizeAway(hit);
+			doNotOptimizeAway(entryT);
+		}
+	});
+
+	runner.add("CollisionDetection/intersectAABBWithTriangle", [scene, mask] (uint64 iterationCount)
+	{
+		const Vector3 *boxes = scene->mAABBs.data();
+		const Vector3 *triangles = scene->mTriangles.data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const uint32 idx = (uint32) (i & mask);
+			const Vector3 *box = boxes + 2 * idx;
+			const Vector3 *triangle = triangles + 3 * ((idx * 7) & mask);
+
+			const bool hit = intersectAABBWithTriangle(box[0], box[1], triangle[0], triangle[1], triangle[2]);
+			doNotOptimizeAway(hit);
+		}
+	});
+
+	runner.add("CollisionDetection/intersectLineWithSphere", [scene, mask] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const uint32 idx = (uint32) (i & mask);
+			const uint32 sphereIdx = (idx * 7) & mask;
+
+			Vector3 intersections[2];
+			Real x[2];
+			const bool hit = intersectLineWithSphere(intersections, x, scene->mRayStarts[idx], scene->mRayDirections[idx],
+				scene->mSphereCenters[sphereIdx], scene->mSphereRadii[sphereIdx]);
+			doNotOptimizeAway(hit);
+			doNotOptimizeAway(x);
+		}
+	});
+
+	runner.add("CollisionDetection/getDistanceToLineSegment", [scene, mask] (uint64 iterationCount)
+	{
+		const Vector3 *triangles = scene->mTriangles.data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const uint32 idx = (uint32) (i & mask);
+			const Vector3 *segment = triangles + 3 * ((idx * 7) & mask);
+
+			Vector3 closestPoint;
+			const Real distance = getDistanceToLineSegment(&closestPoint, scene->mSphereCenters[idx], segment[0], segment[1]);
+			doNotOptimizeAway(distance);
+			doNotOptimizeAway(closestPoint);
+		}
+	});
+
+	runner.add("CollisionDetection/isPointInAABB", [scene, mask] (uint64 iterationCount)
+	{
+		const Vector3 *boxes = scene->mAABBs.data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const uint32 idx = (uint32) (i & mask);
+			const Vector3 *box = boxes + 2 * ((idx * 7) & mask);
+
+			const bool inside = isPointInAABB(scene->mSphereCenters[idx], box[0], box[1]);
+			doNotOptimizeAway(inside);
+		}
+	});
+}
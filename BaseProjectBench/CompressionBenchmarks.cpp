@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <memory>
+#include <vector>
+#include "BaseProjectBench/StorageBenchmarks.h"
+#include "Platform/Storage/File.h"
+
+using namespace Benchmarking;
+using namespace std;
+using namespace Storage;
+
+void Benchmarking::addCompressionBenchmarks(BenchmarkRunner &runner, const shared_ptr<StorageData> &data)
+{
+	// compressed Storage::File, an iteration converts, compresses & writes all floats
+	runner.add("Storage/File/writeArrayGzip", [data] (uint64 iterationCount)
+	{
+		const vector<float> floats(FLOAT_COUNT, 0.5f);
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			File file(data->mOutputFile, File::CREATE_WRITING, File::COMPRESSION_GZIP);
+			file.writeArray(floats.data(), FLOAT_COUNT, ENCODING_BINARY_BIG_ENDIAN);
+		}
+	}, FLOAT_COUNT * sizeof(float));
+}
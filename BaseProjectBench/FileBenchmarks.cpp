@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "BaseProjectBench/StorageBenchmarks.h"
+#include "Platform/Storage/BufferedFileWriter.h"
+#include "Platform/Storage/File.h"
+
+using namespace Benchmarking;
+using namespace std;
+using namespace Storage;
+
+namespace
+{
+	/** Reads iterationCount floats value by value from data.mOpenFile and rewinds it if necessary.
+	@param data Its open file is read.
+	@param iterationCount Set this to the number of floats to read.
+	@param encoding Defines how each value is decoded. */
+	void readFloats(StorageData &data, const uint64 iterationCount, const Encoding encoding)
+	{
+		File &file = *data.mOpenFile;
+
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			if (0 == data.mRemaining)
+			{
+				fseek(&file.getHandle(), 0, SEEK_SET);
+				data.mRemaining = FLOAT_COUNT;
+			}
+
+			const float value = file.readFloat(encoding);
+			doNotOptimizeAway(value);
+			--data.mRemaining;
+		}
+	}
+}
+
+void Benchmarking::addFileBenchmarks(BenchmarkRunner &runner, const shared_ptr<StorageData> &data)
+{
+	const BenchmarkRunner::Fixture openFloats = [data] ()
+	{
+		data->mOpenFile.reset(new File(data->mFloatsFile, File::OPEN_READING, true));
+		data->mRemaining = FLOAT_COUNT;
+	};
+	const BenchmarkRunner::Fixture closeFloats = [data] ()
+	{
+		data->mOpenFile.reset();
+	};
+
+	// Storage::File, a bulk read iteration reads the whole file
+	runner.add("Storage/File/readBulk", [data] (uint64 iterationCount)
+	{
+		vector<float> floats(FLOAT_COUNT);
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			File file(data->mFloatsFile, File::OPEN_READING, true);
+			file.read(floats.data(), floats.size() * sizeof(float), sizeof(float), FLOAT_COUNT);
+			doNotOptimizeAway(floats.back());
+		}
+	}, FLOAT_COUNT * sizeof(float));
+
+	// Storage::File, an array iteration reads and converts the whole file
+	runner.add("Storage/File/readArrayLittleEndian", [data] (uint64 iterationCount)
+	{
+		vector<float> floats(FLOAT_COUNT);
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			File file(data->mFloatsFile, File::OPEN_READING, true);
+			file.readArray(floats.data(), FLOAT_COUNT, ENCODING_BINARY_LITTLE_ENDIAN);
+			doNotOptimizeAway(floats.back());
+		}
+	}, FLOAT_COUNT * sizeof(float));
+
+	runner.add("Storage/File/readArrayBigEndian", [data] (uint64 iterationCount)
+	{
+		vector<float> floats(FLOAT_COUNT);
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			File file(data->mFloatsFile, File::OPEN_READING, true);
+			file.readArray(floats.data(), FLOAT_COUNT, ENCODING_BINARY_BIG_ENDIAN);
+			doNotOptimizeAway(floats.back());
+		}
+	}, FLOAT_COUNT * sizeof(float));
+
+	// Storage::File, a per value iteration reads a single float
+	runner.add("Storage/File/readFloatLittleEndian", [data] (uint64 iterationCount)
+	{
+		readFloats(*data, iterationCount, ENCODING_BINARY_LITTLE_ENDIAN);
+	}, sizeof(float), openFloats, closeFloats);
+
+	runner.add("Storage/File/readFloatBigEndian", [data] (uint64 iterationCount)
+	{
+		readFloats(*data, iterationCount, ENCODING_BINARY_BIG_ENDIAN);
+	}, sizeof(float), openFloats, closeFloats);
+
+	// Storage::File vs. BufferedFileWriter, an iteration converts & writes all floats
+	runner.add("Storage/File/writeArrayBigEndian", [data] (uint64 iterationCount)
+	{
+		const vector<float> floats(FLOAT_COUNT, 0.5f);
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			File file(data->mOutputFile, File::CREATE_WRITING, true);
+			file.writeArray(floats.data(), FLOAT_COUNT, ENCODING_BINARY_BIG_ENDIAN);
+		}
+	}, FLOAT_COUNT * sizeof(float));
+
+	runner.add("Storage/BufferedFileWriter/writeArrayBigEndian",[data] (uint64 iterationCount)
+	{
+		const vector<float> floats(FLOAT_COUNT, 0.5f);
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			BufferedFileWriter writer(data->mOutputFile);
+			writer.writeArray(floats.data(), FLOAT_COUNT, ENCODING_BINARY_BIG_ENDIAN);
+		}
+	}, FLOAT_COUNT * sizeof(float));
+
+	runner.add("Storage/BufferedFileWriter/writeFloatASCII", [data] (uint64 iterationCount)
+	{
+		BufferedFileWriter writer(data->mOutputFile);
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			writer.writeFloat(0.001f * (uint32) i, ENCODING_ASCII);
+			writer.writeCharacter(' ');
+		}
+	}, sizeof(float));
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifdef _LINUX
+	#include <sys/utsname.h>
+#endif // _LINUX
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include "BaseProjectBench/MachineInfo.h"
+
+using namespace Benchmarking;
+using namespace std;
+
+namespace
+{
+	/** Escapes a string for JSON output.
+	@param text Set this to the unescaped text.
+	@return Returns text in double quotes with escaped quotes, backslashes and without control characters. */
+	string toJSONString(const string &text)
+	{
+		string result("\"");
+		for (size_t charIdx = 0; charIdx < text.size(); ++charIdx)
+		{
+			const char c = text[charIdx];
+			if ('"' == c || '\\' == c)
+				result += '\\';
+			if ((unsigned char) c >= 0x20)
+				result += c;
+		}
+		result += '"';
+		return result;
+	}
+}
+
+MachineInfo::MachineInfo() :
+	mCompiler("unknown"), mCPU("unknown"), mOperatingSystem("unknown"),
+	mHardwareThreads(thread::hardware_concurrency())
+{
+	// build configuration
+	mBuild = (sizeof(Real) == sizeof(double) ? "double" : "single");
+	#ifdef PROFILING
+		mBuild += " profiling";
+	#endif // PROFILING
+	#ifdef MEMORY_MANAGEMENT
+		mBuild += " memory management";
+	#endif // MEMORY_MANAGEMENT
+	#ifndef NDEBUG
+		mBuild += " assertions";
+	#endif // NDEBUG
+
+	// compiler
+	#if defined(__clang__)
+		mCompiler = string("clang ") + __clang_version__;
+	#elif defined(__GNUC__)
+		mCompiler = string("gcc ") + __VERSION__;
+	#elif defined(_MSC_VER)
+		ostringstream compiler;
+		compiler << "msvc " << _MSC_VER;
+		mCompiler = compiler.str();
+	#endif // compilers
+
+	#ifdef _LINUX
+		// CPU model
+		FILE *cpuInfo = fopen("/proc/cpuinfo", "r");
+		if (cpuInfo)
+		{
+			char line[512];
+			while (fgets(line, sizeof(line), cpuInfo))
+			{
+				if (0 != strncmp(line, "model name", 10))
+					continue;
+
+				const char *value = strchr(line, ':');
+				if (!value)
+					break;
+
+				mCPU = value + 1;
+				mCPU.erase(0, mCPU.find_first_not_of(" \t"));
+				mCPU.erase(mCPU.find_last_not_of(" \t\r\n") + 1);
+				break;
+			}
+			fclose(cpuInfo);
+		}
+
+		// operating system
+		struct utsname names;
+		if (0 == uname(&names))
+			mOperatingSystem = string(names.sysname) + " " + names.release + " " + names.machine;
+	#endif // _LINUX
+
+	computeFingerprint();
+}
+
+void MachineInfo::computeFingerprint()
+{
+	ostringstream properties;
+	properties << mCPU << '|' << mHardwareThreads << '|' << mOperatingSystem << '|' << mCompiler << '|' << mBuild;
+	const string text = properties.str();
+
+	// 64 bit FNV-1a hash
+	uint64 hash = 14695981039346656037ull;
+	for (size_t charIdx = 0; charIdx < text.size(); ++charIdx)
+	{
+		hash ^= (unsigned char) text[charIdx];
+		hash *= 1099511628211ull;
+	}
+
+	char digits[17];
+	snprintf(digits, sizeof(digits), "%016llx", (unsigned long long) hash);
+	mFingerprint = digits;
+}
+
+string MachineInfo::toJSON() const
+{
+	ostringstream json;
+	json << "{\"fingerprint\":" << toJSONString(mFingerprint);
+	json << ",\"cpu\":" << toJSONString(mCPU);
+	json << ",\"hardwareThreads\":" << mHardwareThreads;
+	json << ",\"operatingSystem\":" << toJSONString(mOperatingSystem);
+	json << ",\"compiler\":" << toJSONString(mCompiler);
+	json << ",\"build\":" << toJSONString(mBuild) << "}";
+	return json.str();
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _MACHINE_INFO_H_
+#define _MACHINE_INFO_H_
+
+#include <string>
+#include "Platform/DataTypes.h"
+
+namespace Benchmarking
+{
+	/// Describes the machine and build configuration which produced benchmark results.
+	/** Results are only comparable if they were measured on the same kind of machine with the same build configuration.
+		The fingerprint is a short hash of all properties and identifies such a configuration, e.g., to store baselines per machine. */
+	class MachineInfo
+	{
+	public:
+		/** Queries the properties of the executing machine and of this build. */
+		MachineInfo();
+
+		/** Returns a hash of all properties which identifies the machine and build configuration.
+		@return Returns 16 hexadecimal digits. */
+		inline const std::string &getFingerprint() const;
+
+		/** Returns all properties and the fingerprint as JSON object, e.g., for the context of result files.
+		@return Returns a JSON object like {"fingerprint":"...","cpu":"...",...}. */
+		std::string toJSON() const;
+
+	private:
+		/** Computes mFingerprint from all other properties. */
+		void computeFingerprint();
+
+	private:
+		std::string	mBuild;				/// Build flags which influence performance, e.g., precision and profiling.
+		std::string	mCompiler;			/// Compiler and its version.
+		std::string	mCPU;				/// CPU model name.
+		std::string	mFingerprint;		/// Hash of all other properties.
+		std::string	mOperatingSystem;	/// Operating system name, release and architecture.
+		uint32		mHardwareThreads;	/// Number of hardware threads.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline const std::string &MachineInfo::getFingerprint() const
+	{
+		return mFingerprint;
+	}
+}
+
+#endif // _MACHINE_INFO_H_
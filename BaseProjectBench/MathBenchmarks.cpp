@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <memory>
+#include <vector>
+#include "BaseProjectBench/Benchmarks.h"
+#include "Math/LinearSolver.h"
+#include "Math/MathCore.h"
+#include "Math/Matrix4x4.h"
+#include "Math/Quaternion.h"
+#include "Math/Vector3.h"
+#include "Math/Vector4.h"
+#include "Platform/Utilities/BatchTransforms.h"
+#include "Platform/Utilities/RandomManager.h"
+
+using namespace Benchmarking;
+using namespace Math;
+using namespace std;
+using namespace Utilities;
+
+namespace
+{
+	const uint32 OPERAND_COUNT = 1024;	/// Number of random operands per benchmark, power of two to cycle through them cheaply.
+	const uint32 SYSTEM_SIZE = 64;		/// Number of unknowns of the linear systems.
+
+	/// Random operands which are shared by the math benchmarks.
+	struct Operands
+	{
+		vector<Vector3>		mVectors3[2];
+		vector<Vector4>		mVectors4;
+		vector<Matrix4x4>	mMatrices;
+		vector<Quaternion>	mQuaternions[2];
+		vector<Real>		mComponents[3];			/// x, y and z of mVectors3[0] as separate arrays.
+		vector<Vector3>		mTargets;				/// Results of the batch transforms.
+		vector<Real>		mTargetComponents[3];	/// Results of the batch transforms of mComponents.
+	};
+
+	/// Strongly diagonally dominant and symmetric linear system which suits conjugate gradients and Jacobi.
+	struct LinearSystem
+	{
+		vector<Real> mA;
+		vector<Real> mB;
+		vector<Real> mX;
+		vector<Real> mBuffers[3];
+	};
+
+	shared_ptr<Operands> createOperands()
+	{
+		RandomManager &random = RandomManager::getSingleton();
+		shared_ptr<Operands> operands(new Operands());
+
+		const Vector3 min(-1.0f, -1.0f, -1.0f);
+		const Vector3 max(1.0f, 1.0f, 1.0f);
+		for (uint32 i = 0; i < 2; ++i)
+		{
+			operands->mVectors3[i].resize(OPERAND_COUNT);
+			operands->mQuaternions[i].resize(OPERAND_COUNT);
+		}
+		for (uint32 componentIdx = 0; componentIdx < 3; ++componentIdx)
+		{
+			operands->mComponents[componentIdx].resize(OPERAND_COUNT);
+			operands->mTargetComponents[componentIdx].resize(OPERAND_COUNT);
+		}
+		operands->mTargets.resize(OPERAND_COUNT);
+		operands->mVectors4.resize(OPERAND_COUNT);
+		operands->mMatrices.resize(OPERAND_COUNT);
+
+		for (uint32 operandIdx = 0; operandIdx < OPERAND_COUNT; ++operandIdx)
+		{
+			for (uint32 i = 0; i < 2; ++i)
+			{
+				operands->mVectors3[i][operandIdx] = random.getUniform(min, max);
+
+				Vector3 axis = random.getUniform(min, max);
+				axis.normalize();
+				operands->mQuaternions[i][operandIdx] = Quaternion(axis, random.getUniform(-Math::PI, Math::PI));
+				operands->mQuaternions[i][operandIdx].normalize();
+			}
+
+			for (uint32 componentIdx = 0; componentIdx < 3; ++componentIdx)
+				operands->mComponents[componentIdx][operandIdx] = operands->mVectors3[0][operandIdx].getData()[componentIdx];
+
+			const Vector3 v = random.getUniform(min, max);
+			operands->mVectors4[operandIdx] = Vector4(v.x, v.y, v.z, 1.0f);
+
+			Matrix4x4 &matrix = operands->mMatrices[operandIdx];
+			matrix = Matrix4x4::createRotationX(random.getUniform(-Math::PI, Math::PI)) *
+				Matrix4x4::createRotationY(random.getUniform(-Math::PI, Math::PI));
+			const Vector3 translation = random.getUniform(min, max);
+			matrix.addTranslation(translation.x, translation.y, translation.z);
+		}
+
+		return operands;
+	}
+
+	shared_ptr<LinearSystem> createLinearSystem()
+	{
+		RandomManager &random = RandomManager::getSingleton();
+		shared_ptr<LinearSystem> system(new LinearSystem());
+
+		system->mA.resize(SYSTEM_SIZE * SYSTEM_SIZE);
+		system->mB.resize(SYSTEM_SIZE);
+		system->mX.resize(SYSTEM_SIZE);
+		for (uint32 i = 0; i < 3; ++i)
+			system->mBuffers[i].resize(SYSTEM_SIZE);
+
+		// symmetric with a dominant diagonal
+		for (uint32 row = 0; row < SYSTEM_SIZE; ++row)
+		{
+			system->mB[row] = random.getUniform(-1.0f, 1.0f);
+			for (uint32 column = row + 1; column < SYSTEM_SIZE; ++column)
+				system->mA[row * SYSTEM_SIZE + column] = system->mA[column * SYSTEM_SIZE + row] = random.getUniform(-0.5f, 0.5f);
+			system->mA[row * SYSTEM_SIZE + row] = (Real) SYSTEM_SIZE;
+		}
+
+		return system;
+	}
+}
+
+void Benchmarking::addMathBenchmarks(BenchmarkRunner &runner)
+{
+	const shared_ptr<Operands> operands = createOperands();
+	const shared_ptr<LinearSystem> system = createLinearSystem();
+	const uint32 mask = OPERAND_COUNT - 1;
+
+	// Vector3
+	runner.add("Math/Vector3/crossProduct", [operands, mask] (uint64 iterationCount)
+	{
+		const Vector3 *a = operands->mVectors3[0].data();
+		const Vector3 *b = operands->mVectors3[1].data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const Vector3 result = a[i & mask].crossProduct(b[i & mask]);
+			doNotOptimizeAway(result);
+		}
+	});
+
+	runner.add("Math/Vector3/dotProduct", [operands, mask] (uint64 iterationCount)
+	{
+		const Vector3 *a = operands->mVectors3[0].data();
+		const Vector3 *b = operands->mVectors3[1].data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const Real result = a[i & mask].dotProduct(b[i & mask]);
+			doNotOptimizeAway(result);
+		}
+	});
+
+	runner.add("Math/Vector3/normalize", [operands, mask] (uint64 iterationCount)
+	{
+		const Vector3 *a = operands->mVectors3[0].data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			Vector3 result = a[i & mask];
+			result.normalize();
+			doNotOptimizeAway(result);
+		}
+	});
+
+	// Vector4
+	runner.add("Math/Vector4/dotProduct", [operands, mask] (uint64 iterationCount)
+	{
+		const Vector4 *vectors = operands->mVectors4.data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const Real result = vectors[i & mask].dotProduct(vectors[(i + 1) & mask]);
+			doNotOptimizeAway(result);
+		}
+	});
+
+	// Matrix4x4
+	runner.add("Math/Matrix4x4/multiply", [operands, mask] (uint64 iterationCount)
+	{
+		const Matrix4x4 *matrices = operands->mMatrices.data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const Matrix4x4 result = matrices[i & mask] * matrices[(i + 1) & mask];
+			doNotOptimizeAway(result);
+		}
+	});
+
+	runner.add("Math/Matrix4x4/createInverse", [operands, mask] (uint64 iterationCount)
+	{
+		const Matrix4x4 *matrices = operands->mMatrices.data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const Matrix4x4 result = Matrix4x4::createInverse(matrices[i & mask]);
+			doNotOptimizeAway(result);
+		}
+	});
+
+	runner.add("Math/Matrix4x4/transformVector4", [operands, mask] (uint64 iterationCount)
+	{
+		const Matrix4x4 *matrices = operands->mMatrices.data();
+		const Vector4 *vectors = operands->mVectors4.data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const Vector4 result = vectors[i & mask] * matrices[(i >> 4) & mask];
+			doNotOptimizeAway(result);
+		}
+	});
+
+	// Quaternion
+	runner.add("Math/Quaternion/multiply", [operands, mask] (uint64 iterationCount)
+	{
+		const Quaternion *a = operands->mQuaternions[0].data();
+		const Quaternion *b = operands->mQuaternions[1].data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const Quaternion result = a[i & mask] * b[i & mask];
+			doNotOptimizeAway(result);
+		}
+	});
+
+	runner.add("Math/Quaternion/rotateVector", [operands, mask] (uint64 iterationCount)
+	{
+		const Quaternion *q = operands->mQuaternions[0].data();
+		const Vector3 *v = operands->mVectors3[0].data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			Vector3 result;
+			q[i & mask].rotateVector(result, v[i & mask]);
+			doNotOptimizeAway(result);
+		}
+	});
+
+	runner.add("Math/Quaternion/sLerp", [operands, mask] (uint64 iterationCount)
+	{
+		const Quaternion *a = operands->mQuaternions[0].data();
+		const Quaternion *b = operands->mQuaternions[1].data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			const Quaternion result = Quaternion::sLerp(a[i & mask], b[i & mask], 0.25f);
+			doNotOptimizeAway(result);
+		}
+	});
+
+	// BatchTransforms, each iteration transforms all OPERAND_COUNT vectors, the loop is the per vector baseline
+	runner.add("Math/BatchTransforms/transformPointsLoop1024", [operands, mask] (uint64 iterationCount)
+	{
+		const Matrix4x4 &matrix = operands->mMatrices[0];
+		const Vector3 *points = operands->mVectors3[0].data();
+		Vector3 *targets = operands->mTargets.data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			for (uint32 pointIdx = 0; pointIdx < OPERAND_COUNT; ++pointIdx)
+			{
+				const Vector3 &p = points[pointIdx];
+				const Vector4 result = Vector4(p.x, p.y, p.z, 1.0f) * matrix;
+				targets[pointIdx].set(result.x, result.y, result.z);
+			}
+			doNotOptimizeAway(targets[i & mask]);
+		}
+	});
+
+	runner.add("Math/BatchTransforms/transformPoints1024", [operands, mask] (uint64 iterationCount)
+	{
+		const Matrix4x4 &matrix = operands->mMatrices[0];
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			BatchTransforms::transformPoints(operands->mTargets.data(), operands->mVectors3[0].data(), OPERAND_COUNT, matrix);
+			doNotOptimizeAway(operands->mTargets[i & mask]);
+		}
+	});
+
+	runner.add("Math/BatchTransforms/transformPointsComponents1024", [operands, mask] (uint64 iterationCount)
+	{
+		const Matrix4x4 &matrix = operands->mMatrices[0];
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			BatchTransforms::transformPoints(operands->mTargetComponents[0].data(), operands->mTargetComponents[1].data(), operands->mTargetComponents[2].data(),
+				operands->mComponents[0].data(), operands->mComponents[1].data(), operands->mComponents[2].data(), OPERAND_COUNT, matrix);
+			doNotOptimizeAway(operands->mTargetComponents[0][i & mask]);
+		}
+	});
+
+	runner.add("Math/BatchTransforms/rotateLoop1024", [operands, mask] (uint64 iterationCount)
+	{
+		const Quaternion &rotation = operands->mQuaternions[0][0];
+		const Vector3 *vectors = operands->mVectors3[0].data();
+		Vector3 *targets = operands->mTargets.data();
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			for (uint32 vectorIdx = 0; vectorIdx < OPERAND_COUNT; ++vectorIdx)
+				rotation.rotateVector(targets[vectorIdx], vectors[vectorIdx]);
+			doNotOptimizeAway(targets[i & mask]);
+		}
+	});
+
+	runner.add("Math/BatchTransforms/rotate1024", [operands, mask] (uint64 iterationCount)
+	{
+		const Quaternion &rotation = operands->mQuaternions[0][0];
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			BatchTransforms::rotate(operands->mTargets.data(), operands->mVectors3[0].data(), OPERAND_COUNT, rotation);
+			doNotOptimizeAway(operands->mTargets[i & mask]);
+		}
+	});
+
+	runner.add("Math/BatchTransforms/transformNormalsComponents1024", [operands, mask] (uint64 iterationCount)
+	{
+		const Matrix4x4 &matrix = operands->mMatrices[0];
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			BatchTransforms::transformNormals(operands->mTargetComponents[0].data(), operands->mTargetComponents[1].data(), operands->mTargetComponents[2].data(),
+				operands->mComponents[0].data(), operands->mComponents[1].data(), operands->mComponents[2].data(), OPERAND_COUNT, matrix, true);
+			doNotOptimizeAway(operands->mTargetComponents[0][i & mask]);
+		}
+	});
+
+	// LinearSolver, each iteration solves the complete system from scratch
+	runner.add("Math/LinearSolver/conjugateGradients64", [system] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			system->mX.assign(SYSTEM_SIZE, 0.0f);
+			LinearSolver::solveWithConjugateGradients(system->mX.data(),
+				system->mBuffers[0].data(), system->mBuffers[1].data(), system->mBuffers[2].data(),
+				SYSTEM_SIZE, system->mA.data(), system->mB.data(), 1e-5f, SYSTEM_SIZE + 50);
+			doNotOptimizeAway(system->mX[0]);
+		}
+	});
+
+	runner.add("Math/LinearSolver/jacobi64", [system] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+		{
+			system->mX.assign(SYSTEM_SIZE, 0.0f);
+			LinearSolver::solveWithJacobi(system->mX.data(), system->mBuffers[0].data(),
+				SYSTEM_SIZE, system->mA.data(), system->mB.data(), 1e-5f, 1000);
+			doNotOptimizeAway(system->mX[0]);
+		}
+	});
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <memory>
+#include "BaseProjectBench/StorageBenchmarks.h"
+#include "Platform/Utilities/MeshCache.h"
+#include "Platform/Utilities/PlyFile.h"
+
+using namespace Benchmarking;
+using namespace std;
+using namespace Storage;
+using namespace Utilities;
+
+namespace
+{
+	/** Provides a complete triangle mesh via its native cache file with PlyFile::loadCached(), i.e., by mapping the cache without parsing.
+	@param fileName Set this to the path of the ply file. */
+	void loadCachedMesh(const Path &fileName)
+	{
+		MeshCache cache;
+		PlyFile::loadCached(cache, fileName);
+
+		doNotOptimizeAway(cache.getPositions()[cache.getVertexCount() - 1]);
+		doNotOptimizeAway(cache.getTriangleCount());
+	}
+}
+
+void Benchmarking::addMeshCacheBenchmarks(BenchmarkRunner &runner, const shared_ptr<StorageData> &data)
+{
+	// PlyFile automatic cache mode, an iteration maps the cache file which is created once before
+	{
+		MeshCache cache;
+		PlyFile::loadCached(cache, data->mBinaryMesh);
+	}
+
+	runner.add("Storage/PlyFile/loadCached", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			loadCachedMesh(data->mBinaryMesh);
+	}, getFileSize(data->mBinaryMesh));
+}
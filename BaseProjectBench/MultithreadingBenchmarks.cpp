@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <memory>
+#include "BaseProjectBench/Benchmarks.h"
+#include "Platform/Multithreading/Manager.h"
+
+using namespace Benchmarking;
+using namespace Platform::Multithreading;
+using namespace std;
+
+namespace
+{
+	const uint32 TASK_BATCH_SIZE = 256;	/// Number of tasks which are enqueued before waiting for all of them.
+
+	/// Task which only executes a configurable amount of arithmetic work.
+	class BenchmarkTask : public Task
+	{
+	public:
+		BenchmarkTask() : Task(), mWork(0), mResult(0) { }
+
+		virtual void function()
+		{
+			uint64 result = mResult;
+			for (uint32 i = 0; i < mWork; ++i)
+				result = result * 6364136223846793005ull + 1442695040888963407ull;
+			mResult = result;
+		}
+
+	public:
+		uint32 mWork;	/// Number of arithmetic steps of function().
+		uint64 mResult;	/// Keeps the work from being optimized away.
+	};
+
+	/// Tasks which are reused by all repetitions.
+	struct TaskBatch
+	{
+		BenchmarkTask mTasks[TASK_BATCH_SIZE];
+	};
+
+	/** Enqueues iterationCount tasks in batches of TASK_BATCH_SIZE and waits for each batch.
+	@param tasks Set this to the reused tasks. */
+	void runTasks(TaskBatch &tasks, const uint64 iterationCount)
+	{
+		Manager &manager = Manager::getSingleton();
+
+		for (uint64 done = 0; done < iterationCount; done += TASK_BATCH_SIZE)
+		{
+			const uint32 count = (uint32) (iterationCount - done < TASK_BATCH_SIZE ? iterationCount - done : TASK_BATCH_SIZE);
+
+			for (uint32 taskIdx = 0; taskIdx < count; ++taskIdx)
+			{
+				tasks.mTasks[taskIdx].redo();
+				manager.enqueue(&tasks.mTasks[taskIdx]);
+			}
+
+			for (uint32 taskIdx = 0; taskIdx < count; ++taskIdx)
+				tasks.mTasks[taskIdx].waitUntilFinished();
+		}
+	}
+}
+
+void Benchmarking::addMultithreadingBenchmarks(BenchmarkRunner &runner)
+{
+	if (!Manager::exists() || 0 == Manager::getSingleton().getThreadCount())
+		return;
+
+	// each iteration is a single task, empty tasks measure the scheduling overhead
+	const shared_ptr<TaskBatch> emptyTasks(new TaskBatch());
+	runner.add("Multithreading/Manager/emptyTasks", [emptyTasks] (uint64 iterationCount)
+	{
+		runTasks(*emptyTasks, iterationCount);
+	});
+
+	const shared_ptr<TaskBatch> smallTasks(new TaskBatch());
+	for (uint32 taskIdx = 0; taskIdx < TASK_BATCH_SIZE; ++taskIdx)
+		smallTasks->mTasks[taskIdx].mWork = 1000;
+	runner.add("Multithreading/Manager/smallTasks", [smallTasks] (uint64 iterationCount)
+	{
+		runTasks(*smallTasks, iterationCount);
+	});
+
+	const shared_ptr<TaskBatch> largeTasks(new TaskBatch());
+	for (uint32 taskIdx = 0; taskIdx < TASK_BATCH_SIZE; ++taskIdx)
+		largeTasks->mTasks[taskIdx].mWork = 100000;
+	runner.add("Multithreading/Manager/largeTasks", [largeTasks] (uint64 iterationCount)
+	{
+		runTasks(*largeTasks, iterationCount);
+	});
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "BaseProjectBench/StorageBenchmarks.h"
+#include "Graphics/FacesDescription.h"
+#include "Graphics/VerticesDescription.h"
+#include "Math/Vector3.h"
+#include "Platform/Storage/File.h"
+#include "Platform/Utilities/PlyFile.h"
+
+using namespace Benchmarking;
+using namespace Graphics;
+using namespace Math;
+using namespace std;
+using namespace Storage;
+using namespace Utilities;
+
+namespace
+{
+	/** Loads a complete triangle mesh the way applications load ply files.
+	@param fileName Set this to the path of the ply file.
+	@param binary Set this to true if the file is binary encoded.
+	@param mode Set this to OPEN_READING or OPEN_READING_MAPPED. */
+	void loadMesh(const Path &fileName, const bool binary, const File::FileMode mode)
+	{
+		PlyFile file(fileName, mode, binary);
+
+		VerticesDescription verticesFormat;
+		FacesDescription facesFormat;
+		file.loadHeader(verticesFormat, &facesFormat);
+
+		const vector<ElementsDescription::TYPES> &types = verticesFormat.getTypeStructure();
+		const vector<uint32> &semantics = verticesFormat.getSemantics();
+		const uint32 vertexCount = verticesFormat.getElementCount();
+		const uint32 propertyCount = verticesFormat.getPropertyCount();
+
+		vector<Vector3> positions(vertexCount);
+		vector<Vector3> normals(vertexCount);
+		vector<Vector3> colors(vertexCount);
+		for (uint32 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx)
+			for (uint32 propertyIdx = 0; propertyIdx < propertyCount; ++propertyIdx)
+				file.readVertexProperty(&colors[vertexIdx], &normals[vertexIdx], positions[vertexIdx], NULL, NULL, NULL, NULL,
+					types[propertyIdx], (VerticesDescription::SEMANTICS) semantics[propertyIdx]);
+
+		vector<uint32> indices;
+		file.loadTriangles(indices, facesFormat);
+
+		doNotOptimizeAway(positions.back());
+		doNotOptimizeAway(indices.back());
+	}
+
+	/** Loads a complete triangle mesh with PlyFile::loadVertices() instead of reading each vertex property separately.
+		ASCII vertices and faces are parsed in parallel chunks if the Manager is running.
+	@param fileName Set this to the path of the ply file.
+	@param binary Set this to true if the file is binary encoded.
+	@param mode Set this to OPEN_READING or OPEN_READING_MAPPED. */
+	void loadDecodedMesh(const Path &fileName, const bool binary, const File::FileMode mode)
+	{
+		PlyFile file(fileName, mode, binary);
+
+		VerticesDescription verticesFormat;
+		FacesDescription facesFormat;
+		file.loadHeader(verticesFormat, &facesFormat);
+
+		PlyVertices vertices;
+		file.loadVertices(vertices, verticesFormat);
+
+		vector<uint32> indices;
+		file.loadTriangles(indices, facesFormat);
+
+		doNotOptimizeAway(vertices.mPositions.back());
+		doNotOptimizeAway(indices.back());
+	}
+
+	/** Returns the interleaved layout of the rendering benchmarks with float positions and normals and normalized byte colors.
+	@return Returns a layout with 28 bytes per vertex. */
+	PlyVertexDecoder::InterleavedLayout getRenderingLayout()
+	{
+		PlyVertexDecoder::InterleavedLayout layout;
+		layout.setAttribute(PlyVertexDecoder::ATTRIBUTE_POSITION, PlyVertexDecoder::COMPONENT_FLOAT32, 0);
+		layout.setAttribute(PlyVertexDecoder::ATTRIBUTE_NORMAL, PlyVertexDecoder::COMPONENT_FLOAT32, 12);
+		layout.setAttribute(PlyVertexDecoder::ATTRIBUTE_COLOR, PlyVertexDecoder::COMPONENT_UNORM8, 24);
+		layout.mStride = 28;
+		return layout;
+	}
+
+	/** Loads the vertices of a mesh into attribute arrays and converts them afterwards into an interleaved rendering buffer.
+	@param fileName Set this to the path of the binary ply file. */
+	void loadAndInterleaveVertices(const Path &fileName)
+	{
+		PlyFile file(fileName, File::OPEN_READING_MAPPED, true);
+
+		VerticesDescription verticesFormat;
+		FacesDescription facesFormat;
+		file.loadHeader(verticesFormat, &facesFormat);
+
+		PlyVertices vertices;
+		file.loadVertices(vertices, verticesFormat);
+
+		const PlyVertexDecoder::InterleavedLayout layout = getRenderingLayout();
+		const size_t vertexCount = vertices.mPositions.size();
+		vector<uint8> buffer(vertexCount * layout.mStride);
+
+		for (size_t vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx)
+		{
+			uint8 *vertex = buffer.data() + vertexIdx * layout.mStride;
+			for (uint32 componentIdx = 0; componentIdx < 3; ++componentIdx)
+			{
+				const float position = (float) vertices.mPositions[vertexIdx].getData()[componentIdx];
+				const float normal = (float) vertices.mNormals[vertexIdx].getData()[componentIdx];
+				const Real color = vertices.mColors[vertexIdx].getData()[componentIdx];
+
+				memcpy(vertex + 4 * componentIdx, &position, sizeof(float));
+				memcpy(vertex + 12 + 4 * componentIdx, &normal, sizeof(float));
+				vertex[24 + componentIdx] = (uint8) (color * 255.0f + 0.5f);
+			}
+		}
+
+		doNotOptimizeAway(buffer.back());
+	}
+
+	/** Loads the vertices of a mesh directly into an interleaved rendering buffer with PlyFile::loadInterleavedVertices().
+	@param fileName Set this to the path of the binary ply file. */
+	void loadInterleavedVertices(const Path &fileName)
+	{
+		PlyFile file(fileName, File::OPEN_READING_MAPPED, true);
+
+		VerticesDescription verticesFormat;
+		FacesDescription facesFormat;
+		file.loadHeader(verticesFormat, &facesFormat);
+
+		const PlyVertexDecoder::InterleavedLayout layout = getRenderingLayout();
+		vector<uint8> buffer(verticesFormat.getElementCount() * layout.mStride);
+		file.loadInterleavedVertices(buffer.data(), layout, verticesFormat);
+
+		doNotOptimizeAway(buffer.back());
+	}
+
+	/** Streams a complete triangle mesh in batches with PlyFile::streamVertices() and PlyFile::streamTriangles() and only decodes positions.
+	@param fileName Set this to the path of the ply file.
+	@param binary Set this to true if the file is binary encoded.
+	@param mode Set this to OPEN_READING or OPEN_READING_MAPPED. */
+	void streamMesh(const Path &fileName, const bool binary, const File::FileMode mode)
+	{
+		PlyFile file(fileName, mode, binary);
+
+		VerticesDescription verticesFormat;
+		FacesDescription facesFormat;
+		file.loadHeader(verticesFormat, &facesFormat);
+
+		Vector3 positionSum(0.0f, 0.0f, 0.0f);
+		file.streamVertices([&positionSum] (const PlyVertices &vertices, const uint64 firstVertexIdx, const uint64 vertexCount)
+		{
+			for (uint64 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx)
+				positionSum += vertices.mPositions[vertexIdx];
+		}, verticesFormat, PlyFile::STREAM_BATCH_SIZE, 1u << PlyVertexDecoder::ATTRIBUTE_POSITION);
+
+		uint64 triangleSum = 0;
+		file.streamTriangles([&triangleSum] (const uint32 *indices, const uint64 triangleCount, const uint64 firstFaceIdx)
+		{
+			triangleSum += triangleCount;
+		}, facesFormat);
+
+		doNotOptimizeAway(positionSum);
+		doNotOptimizeAway(triangleSum);
+	}
+}
+
+void Benchmarking::addPlyFileBenchmarks(BenchmarkRunner &runner, const shared_ptr<StorageData> &data)
+{
+	// PlyFile, an iteration saves the complete mesh
+	runner.add("Storage/PlyFile/saveBinary", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			createMeshFile(data->mOutputFile, ENCODING_BINARY_LITTLE_ENDIAN);
+	}, getFileSize(data->mBinaryMesh));
+
+	runner.add("Storage/PlyFile/saveASCII", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			createMeshFile(data->mOutputFile, ENCODING_ASCII);
+	}, getFileSize(data->mASCIIMesh));
+
+	// PlyFile, an iteration loads the complete mesh
+	runner.add("Storage/PlyFile/loadBinary", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			loadMesh(data->mBinaryMesh, true, File::OPEN_READING);
+	}, getFileSize(data->mBinaryMesh));
+
+	runner.add("Storage/PlyFile/loadASCII", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			loadMesh(data->mASCIIMesh, false, File::OPEN_READING);
+	}, getFileSize(data->mASCIIMesh));
+
+	runner.add("Storage/PlyFile/loadBinaryMapped", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			loadMesh(data->mBinaryMesh, true, File::OPEN_READING_MAPPED);
+	}, getFileSize(data->mBinaryMesh));
+
+	runner.add("Storage/PlyFile/loadASCIIMapped", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			loadMesh(data->mASCIIMesh, false, File::OPEN_READING_MAPPED);
+	}, getFileSize(data->mASCIIMesh));
+
+	// PlyFile with compiled vertex decoding, an iteration loads the complete mesh
+	runner.add("Storage/PlyFile/loadVerticesBinary", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			loadDecodedMesh(data->mBinaryMesh, true, File::OPEN_READING);
+	}, getFileSize(data->mBinaryMesh));
+
+	runner.add("Storage/PlyFile/loadVerticesBinaryMapped", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			loadDecodedMesh(data->mBinaryMesh, true, File::OPEN_READING_MAPPED);
+	}, getFileSize(data->mBinaryMesh));
+
+	runner.add("Storage/PlyFile/loadVerticesASCII", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			loadDecodedMesh(data->mASCIIMesh, false, File::OPEN_READING);
+	}, getFileSize(data->mASCIIMesh));
+
+	runner.add("Storage/PlyFile/loadVerticesASCIIMapped", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			loadDecodedMesh(data->mASCIIMesh, false, File::OPEN_READING_MAPPED);
+	}, getFileSize(data->mASCIIMesh));
+
+	// PlyFile with interleaved rendering buffers, an iteration loads all vertices into an interleaved buffer
+	runner.add("Storage/PlyFile/loadAndInterleaveBinaryMapped", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			loadAndInterleaveVertices(data->mBinaryMesh);
+	}, getFileSize(data->mBinaryMesh));
+
+	runner.add("Storage/PlyFile/loadInterleavedBinaryMapped", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			loadInterleavedVertices(data->mBinaryMesh);
+	}, getFileSize(data->mBinaryMesh));
+
+	// PlyFile streaming with bounded memory, an iteration streams the complete mesh
+	runner.add("Storage/PlyFile/streamBinary", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			streamMesh(data->mBinaryMesh, true, File::OPEN_READING);
+	}, getFileSize(data->mBinaryMesh));
+
+	runner.add("Storage/PlyFile/streamASCII", [data] (uint64 iterationCount)
+	{
+		for (uint64 i = 0; i < iterationCount; ++i)
+			streamMesh(data->mASCIIMesh, false, File::OPEN_READING);
+	}, getFileSize(data->mASCIIMesh));
+}
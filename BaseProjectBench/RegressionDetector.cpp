@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <utility>
+#include "BaseProjectBench/RegressionDetector.h"
+
+using namespace Benchmarking;
+using namespace std;
+
+RegressionDetector::RegressionDetector(const double significanceLevel, const double relevantChange) :
+	mRelevantChange(relevantChange), mSignificanceLevel(significanceLevel)
+{
+	assert(significanceLevel > 0.0 && significanceLevel < 1.0);
+	assert(relevantChange >= 0.0);
+}
+
+void RegressionDetector::compare(const vector<BenchmarkResult> &baseline, const vector<BenchmarkResult> &current)
+{
+	mComparisons.clear();
+
+	// baseline results by name
+	map<string, const BenchmarkResult *> baselineResults;
+	for (size_t resultIdx = 0; resultIdx < baseline.size(); ++resultIdx)
+		baselineResults[baseline[resultIdx].mName] = &baseline[resultIdx];
+
+	for (size_t resultIdx = 0; resultIdx < current.size(); ++resultIdx)
+	{
+		const BenchmarkResult &result = current[resultIdx];
+
+		Comparison comparison;
+		comparison.mName = result.mName;
+		comparison.mBaselineMedian = 0.0;
+		comparison.mCurrentMedian = result.mMedian;
+		comparison.mRelativeChange = 0.0;
+		comparison.mPValue = 1.0;
+		comparison.mStatus = STATUS_NEW;
+
+		// compare with the baseline result if there is one
+		const map<string, const BenchmarkResult *>::const_iterator it = baselineResults.find(result.mName);
+		if (baselineResults.end() != it)
+		{
+			const BenchmarkResult &reference = *it->second;
+			comparison.mBaselineMedian = reference.mMedian;
+			comparison.mRelativeChange = (reference.mMedian > 0.0 ? (result.mMedian - reference.mMedian) / reference.mMedian : 0.0);
+			comparison.mPValue = computeMannWhitneyPValue(reference.mSamples, result.mSamples);
+
+			comparison.mStatus = STATUS_UNCHANGED;
+			if (comparison.mPValue <= mSignificanceLevel)
+			{
+				if (comparison.mRelativeChange > mRelevantChange)
+					comparison.mStatus = STATUS_REGRESSION;
+				else if (comparison.mRelativeChange < -mRelevantChange)
+					comparison.mStatus = STATUS_IMPROVEMENT;
+			}
+		}
+
+		mComparisons.push_back(comparison);
+	}
+}
+
+double RegressionDetector::computeExactPValue(const double u, const uint32 n1, const uint32 n2)
+{
+	// counts[j][k] = number of orderings of i first and j second sample values with U = k, built up for i = 0, ..., n1
+	const uint32 maxU = n1 * n2;
+	vector<vector<double> > previous(n2 + 1, vector<double>(maxU + 1, 0.0));
+	vector<vector<double> > counts(n2 + 1, vector<double>(maxU + 1, 0.0));
+	for (uint32 j = 0; j <= n2; ++j)
+		previous[j][0] = 1.0;
+
+	for (uint32 i = 1; i <= n1; ++i)
+	{
+		counts[0].assign(maxU + 1, 0.0);
+		counts[0][0] = 1.0;
+
+		// the largest value is either from the first sample and then greater than all j values of the second sample or it is from the second sample
+		for (uint32 j = 1; j <= n2; ++j)
+			for (uint32 k = 0; k <= maxU; ++k)
+				counts[j][k] = (k >= j ? previous[j][k - j] : 0.0) + counts[j - 1][k];
+
+		previous.swap(counts);
+	}
+
+	// tail probabilities
+	const vector<double> &distribution = previous[n2];
+	double total = 0.0;
+	double lower = 0.0;
+	double upper = 0.0;
+	for (uint32 k = 0; k <= maxU; ++k)
+	{
+		total += distribution[k];
+		if (k <= u)
+			lower += distribution[k];
+		if (k >= u)
+			upper += distribution[k];
+	}
+
+	return min(1.0, 2.0 * min(lower, upper) / total);
+}
+
+double RegressionDetector::computeMannWhitneyPValue(const vector<double> &a, const vector<double> &b)
+{
+	assert(!a.empty() && !b.empty());
+
+	// rank all values together
+	vector<pair<double, uint32> > values;
+	for (size_t valueIdx = 0; valueIdx < a.size(); ++valueIdx)
+		values.push_back(make_pair(a[valueIdx], 0u));
+	for (size_t valueIdx = 0; valueIdx < b.size(); ++valueIdx)
+		values.push_back(make_pair(b[valueIdx], 1u));
+	sort(values.begin(), values.end());
+
+	// rank sum of a with average ranks for ties
+	const size_t n = values.size();
+	double rankSumA = 0.0;
+	double tieCorrection = 0.0;
+	for (size_t begin = 0; begin < n; )
+	{
+		size_t end = begin + 1;
+		while (end < n && values[end].first == values[begin].first)
+			++end;
+
+		const double averageRank = 0.5 * (begin + 1 + end);
+		for (size_t valueIdx = begin; valueIdx < end; ++valueIdx)
+			if (0 == values[valueIdx].second)
+				rankSumA += averageRank;
+
+		const double tieSize = (double) (end - begin);
+		tieCorrection += tieSize * tieSize * tieSize - tieSize;
+		begin = end;
+	}
+
+	const double n1 = (double) a.size();
+	const double n2 = (double) b.size();
+	const double u = rankSumA - 0.5 * n1 * (n1 + 1.0);
+
+	// exact distribution for small samples without ties
+	if (0.0 == tieCorrection && a.size() * b.size() <= MAX_EXACT_SAMPLE_PRODUCT)
+		return computeExactPValue(u, (uint32) a.size(), (uint32) b.size());
+
+	// normal approximation with tie and continuity correction
+	const double mean = 0.5 * n1 * n2;
+	const double variance = (n1 * n2 / 12.0) * ((n1 + n2 + 1.0) - tieCorrection / ((n1 + n2) * (n1 + n2 - 1.0)));
+	if (variance <= 0.0)
+		return 1.0;
+
+	const double deviation = fabs(u - mean) - 0.5;
+	const double z = (deviation > 0.0 ? deviation : 0.0) / sqrt(variance);
+	return min(1.0, erfc(z / sqrt(2.0)));
+}
+
+string RegressionDetector::getReport(const string &fingerprint) const
+{
+	ostringstream report;
+	char line[256];
+
+	report << "Comparison with the baseline of machine " << fingerprint << "\n";
+	snprintf(line, sizeof(line), "Significance level %.4f, relevant median change %.1f%%\n\n", mSignificanceLevel, 100.0 * mRelevantChange);
+	report << line;
+
+	snprintf(line, sizeof(line), "%-48s %14s %14s %10s %10s  %s\n", "Benchmark", "Baseline [ns]", "Current [ns]", "Change [%]", "p-value", "Status");
+	report << line;
+
+	for (size_t comparisonIdx = 0; comparisonIdx < mComparisons.size(); ++comparisonIdx)
+	{
+		const Comparison &comparison = mComparisons[comparisonIdx];
+		if (STATUS_NEW == comparison.mStatus)
+			snprintf(line, sizeof(line), "%-48s %14s %14.2f %10s %10s  %s\n",
+				comparison.mName.c_str(), "-", comparison.mCurrentMedian, "-", "-", getStatusName(comparison.mStatus));
+		else
+			snprintf(line, sizeof(line), "%-48s %14.2f %14.2f %+10.2f %10.4f  %s\n",
+				comparison.mName.c_str(), comparison.mBaselineMedian, comparison.mCurrentMedian,
+				100.0 * comparison.mRelativeChange, comparison.mPValue, getStatusName(comparison.mStatus));
+		report << line;
+	}
+
+	report << "\nRegressions: " << getStatusCount(STATUS_REGRESSION);
+	report << ", improvements: " << getStatusCount(STATUS_IMPROVEMENT);
+	report << ", unchanged: " << getStatusCount(STATUS_UNCHANGED);
+	report << ", new: " << getStatusCount(STATUS_NEW) << "\n";
+	return report.str();
+}
+
+uint32 RegressionDetector::getStatusCount(const STATUS status) const
+{
+	uint32 count = 0;
+	for (size_t comparisonIdx = 0; comparisonIdx < mComparisons.size(); ++comparisonIdx)
+		if (status == mComparisons[comparisonIdx].mStatus)
+			++count;
+	return count;
+}
+
+const char *RegressionDetector::getStatusName(const STATUS status)
+{
+	switch (status)
+	{
+		case STATUS_UNCHANGED:		return "unchanged";
+		case STATUS_IMPROVEMENT:	return "improvement";
+		case STATUS_REGRESSION:		return "REGRESSION";
+		case STATUS_NEW:			return "new";
+
+		default:
+			assert(false);
+			return "unknown";
+	}
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _REGRESSION_DETECTOR_H_
+#define _REGRESSION_DETECTOR_H_
+
+#include <string>
+#include <vector>
+#include "BaseProjectBench/BenchmarkRunner.h"
+
+namespace Benchmarking
+{
+	/// Compares benchmark results with baseline results of the same machine and flags significant slowdowns.
+	/** The repetition samples of each benchmark are compared with the baseline samples of the same benchmark by a two sided Mann-Whitney U test.
+		A benchmark is a regression if the test rejects equal distributions at the significance level
+		and if its median time per iteration grew by more than the relevant relative change.
+		Significant median reductions by more than the relevant change are improvements.
+		Requiring both filters out tiny but significant differences as well as large but noisy ones. */
+	class RegressionDetector
+	{
+	public:
+		/// Outcome of the comparison of a single benchmark.
+		enum STATUS
+		{
+			STATUS_UNCHANGED,	/// No significant and relevant change.
+			STATUS_IMPROVEMENT,	/// Significantly and relevantly faster than the baseline.
+			STATUS_REGRESSION,	/// Significantly and relevantly slower than the baseline.
+			STATUS_NEW,			/// There is no baseline result for the benchmark.
+			STATUS_COUNT		/// Number of states.
+		};
+
+		/// Comparison of the results of a single benchmark.
+		struct Comparison
+		{
+			std::string	mName;				/// Name of the compared benchmark.
+			double		mBaselineMedian;	/// Median baseline nanoseconds per iteration or 0 for new benchmarks.
+			double		mCurrentMedian;		/// Median current nanoseconds per iteration.
+			double		mRelativeChange;	/// (current - baseline) / baseline median, e.g., 0.1 for 10% slower.
+			double		mPValue;			/// Probability of the observed or a more extreme U statistic for equal distributions.
+			STATUS		mStatus;			/// Outcome of the comparison.
+		};
+
+	public:
+		/** Creates a detector without comparisons.
+		@param significanceLevel Set this to the maximum p-value of significant changes, e.g., 0.01.
+		@param relevantChange Set this to the minimum relative median change of relevant changes, e.g., 0.05 for 5%. */
+		RegressionDetector(const double significanceLevel, const double relevantChange);
+
+		/** Compares each current result with the baseline result of the same name and stores the comparisons.
+		@param baseline Set this to the results of the reference run.
+		@param current Set this to the results which are checked. */
+		void compare(const std::vector<BenchmarkResult> &baseline, const std::vector<BenchmarkResult> &current);
+
+		/** Returns the comparisons of the last compare() call.
+		@return Returns one comparison per current result in the same order. */
+		inline const std::vector<Comparison> &getComparisons() const;
+
+		/** Creates a human readable report of the last compare() call.
+		@param fingerprint Set this to the machine fingerprint of the compared results, see MachineInfo.
+		@return Returns a table of all comparisons followed by a summary. */
+		std::string getReport(const std::string &fingerprint) const;
+
+		/** Returns the number of comparisons with a certain outcome.
+		@param status Identifies the counted outcome.
+		@return Returns how many comparisons of the last compare() call have the outcome status. */
+		uint32 getStatusCount(const STATUS status) const;
+
+		/** Computes the two sided p-value of the Mann-Whitney U test for samples a and b.
+			The exact null distribution is used for small samples without ties, otherwise the tie corrected normal approximation.
+		@param a Set this to the first sample which must not be empty.
+		@param b Set this to the second sample which must not be empty.
+		@return Returns the probability of a U statistic at least as extreme as the observed one if a and b stem from the same distribution. */
+		static double computeMannWhitneyPValue(const std::vector<double> &a, const std::vector<double> &b);
+
+		/** Returns the name of an outcome, e.g., for reports.
+		@param status Identifies the outcome.
+		@return Returns a short name like "REGRESSION". */
+		static const char *getStatusName(const STATUS status);
+
+	public:
+		static const uint32 MAX_EXACT_SAMPLE_PRODUCT = 400;	/// The exact U distribution is used if the product of the sample sizes is at most this.
+
+	private:
+		/** Computes the exact two sided p-value of U without ties.
+		@param u Set this to the U statistic of the first sample.
+		@param n1 Set this to the size of the first sample.
+		@param n2 Set this to the size of the second sample.
+		@return Returns the two sided p-value. */
+		static double computeExactPValue(const double u, const uint32 n1, const uint32 n2);
+
+	private:
+		std::vector<Comparison>	mComparisons;			/// Results of the last compare() call.
+		double					mRelevantChange;		/// Minimum relative median change for improvements and regressions.
+		double					mSignificanceLevel;		/// Maximum p-value for improvements and regressions.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline const std::vector<RegressionDetector::Comparison> &RegressionDetector::getComparisons() const
+	{
+		return mComparisons;
+	}
+}
+
+#endif // _REGRESSION_DETECTOR_H_
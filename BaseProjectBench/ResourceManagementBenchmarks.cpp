@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cstdlib>
+#include <memory>
+#include "BaseProjectBench/Benchmarks.h"
+#include "Platform/ResourceManagement/MemoryPool.h"
+
+using namespace Benchmarking;
+using namespace ResourceManagement;
+using namespace std;
+
+namespace
+{
+	const uint32 BATCH_SIZE = 64;	/// Number of blocks which are requested before all of them are released again.
+	const uint32 BUCKET_COUNT = 5;	/// Number of buckets of the benchmarked pool.
+
+	const uint16 BUCKET_CAPACITIES[BUCKET_COUNT] = { 1024, 1024, 1024, 1024, 1024 };
+	const uint16 BUCKET_GRANULARITIES[BUCKET_COUNT] = { 16, 32, 64, 128, 256 };
+
+	/// Mixed block sizes covering all buckets of the pool.
+	const size_t REQUEST_SIZES[8] = { 8, 16, 24, 40, 64, 100, 128, 250 };
+
+	/** Requests BATCH_SIZE blocks of mixed sizes and releases them in reverse order until iterationCount pairs were done.
+	@param request Allocates a block.
+	@param release Frees a block returned by request. */
+	template <class Request, class Release>
+	void requestAndRelease(const uint64 iterationCount, const Request &request, const Release &release)
+	{
+		void *blocks[BATCH_SIZE];
+
+		for (uint64 done = 0; done < iterationCount; done += BATCH_SIZE)
+		{
+			const uint32 count = (uint32) (iterationCount - done < BATCH_SIZE ? iterationCount - done : BATCH_SIZE);
+
+			for (uint32 blockIdx = 0; blockIdx < count; ++blockIdx)
+			{
+				blocks[blockIdx] = request(REQUEST_SIZES[blockIdx % 8]);
+				doNotOptimizeAway(blocks[blockIdx]);
+			}
+
+			for (uint32 blockIdx = count; blockIdx > 0; --blockIdx)
+				release(blocks[blockIdx - 1]);
+		}
+	}
+}
+
+void Benchmarking::addResourceManagementBenchmarks(BenchmarkRunner &runner)
+{
+	const shared_ptr<MemoryPool> pool(new MemoryPool(BUCKET_CAPACITIES, BUCKET_GRANULARITIES, BUCKET_COUNT));
+
+	// each iteration is a single request and release pair
+	runner.add("ResourceManagement/MemoryPool/requestRelease", [pool] (uint64 iterationCount)
+	{
+		MemoryPool *p = pool.get();
+		requestAndRelease(iterationCount,
+			[p] (size_t size) { return p->requestMemory(size); },
+			[p] (void *block) { p->releaseMemory(block); });
+	});
+
+	runner.add("ResourceManagement/malloc/requestRelease", [] (uint64 iterationCount)
+	{
+		requestAndRelease(iterationCount,
+			[] (size_t size) { return malloc(size); },
+			[] (void *block) { free(block); });
+	});
+}
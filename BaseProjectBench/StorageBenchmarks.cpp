@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "BaseProjectBench/Benchmarks.h"
+#include "BaseProjectBench/StorageBenchmarks.h"
+#include "Math/Vector3.h"
+#include "Platform/Utilities/PlyFile.h"
+
+using namespace Benchmarking;
+using namespace Math;
+using namespace std;
+using namespace Storage;
+using namespace Utilities;
+
+namespace
+{
+	const uint32 GRID_SIZE = 128;	/// The benchmark mesh is a grid of GRID_SIZE x GRID_SIZE vertices.
+
+	/** Creates the raw floats input file.
+	@param fileName Set this to the path of the created file. */
+	void createFloatsFile(const Path &fileName)
+	{
+		vector<float> floats(FLOAT_COUNT);
+		for (uint32 floatIdx = 0; floatIdx < FLOAT_COUNT; ++floatIdx)
+			floats[floatIdx] = 0.001f * floatIdx;
+
+		File file(fileName, File::CREATE_WRITING, true);
+		file.write(floats.data(), sizeof(float), FLOAT_COUNT);
+	}
+}
+
+StorageData::~StorageData()
+{
+	mOpenFile.reset();
+	remove(mFloatsFile.getCString());
+	remove(mBinaryMesh.getCString());
+	remove(mASCIIMesh.getCString());
+	remove(mOutputFile.getCString());
+
+	// created by PlyFile::loadCached()
+	remove(PlyFile::getCachePath(mBinaryMesh).getCString());
+	remove(PlyFile::getCachePath(mASCIIMesh).getCString());
+}
+
+void Benchmarking::createMeshFile(const Path &fileName, const Encoding encoding)
+{
+	const uint32 vertexCount = GRID_SIZE * GRID_SIZE;
+	vector<Vector3> positions(vertexCount);
+	vector<Vector3> normals(vertexCount);
+	vector<Vector3> colors(vertexCount);
+	vector<uint32> indices;
+	indices.reserve(6 * (GRID_SIZE - 1) * (GRID_SIZE - 1));
+
+	for (uint32 y = 0; y < GRID_SIZE; ++y)
+	{
+		for (uint32 x = 0; x < GRID_SIZE; ++x)
+		{
+			const uint32 vertexIdx = y * GRID_SIZE + x;
+			const Real u = (Real) x / (GRID_SIZE - 1);
+			const Real v = (Real) y / (GRID_SIZE - 1);
+
+			positions[vertexIdx].set(u, v, 0.1f * u * v);
+			normals[vertexIdx].set(0.0f, 0.0f, 1.0f);
+			colors[vertexIdx].set(u, v, 0.5f);
+
+			if (x + 1 == GRID_SIZE || y + 1 == GRID_SIZE)
+				continue;
+
+			indices.push_back(vertexIdx);
+			indices.push_back(vertexIdx + 1);
+			indices.push_back(vertexIdx + GRID_SIZE);
+			indices.push_back(vertexIdx + 1);
+			indices.push_back(vertexIdx + GRID_SIZE + 1);
+			indices.push_back(vertexIdx + GRID_SIZE);
+		}
+	}
+
+	PlyFile file(fileName, File::CREATE_WRITING, true);
+	file.saveTriangleMesh(encoding, true, vertexCount, (uint32) indices.size(),
+		colors.data(), normals.data(), positions.data(), NULL, NULL, NULL, 0, indices.data());
+}
+
+uint64 Benchmarking::getFileSize(const Path &fileName)
+{
+	File file(fileName, File::OPEN_READING, true);
+	FILE &handle = file.getHandle();
+
+	fseek(&handle, 0, SEEK_END);
+	return (uint64) ftell(&handle);
+}
+
+void Benchmarking::addStorageBenchmarks(BenchmarkRunner &runner, const Path &dataDirectory)
+{
+	// input files
+	const shared_ptr<StorageData> data(new StorageData());
+	data->mFloatsFile = Path::appendChild(dataDirectory, "BaseProjectBenchFloats.raw");
+	data->mBinaryMesh = Path::appendChild(dataDirectory, "BaseProjectBenchMeshBinary.ply");
+	data->mASCIIMesh = Path::appendChild(dataDirectory, "BaseProjectBenchMeshASCII.ply");
+	data->mOutputFile = Path::appendChild(dataDirectory, "BaseProjectBenchOutput.tmp");
+	data->mRemaining = 0;
+
+	createFloatsFile(data->mFloatsFile);
+	createMeshFile(data->mBinaryMesh, ENCODING_BINARY_LITTLE_ENDIAN);
+	createMeshFile(data->mASCIIMesh, ENCODING_ASCII);
+
+	addFileBenchmarks(runner, data);
+	addAsyncFileReaderBenchmarks(runner, data);
+	addCompressionBenchmarks(runner, data);
+	addPlyFileBenchmarks(runner, data);
+	addMeshCacheBenchmarks(runner, data);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _STORAGE_BENCHMARKS_H_
+#define _STORAGE_BENCHMARKS_H_
+
+#include <memory>
+#include "BaseProjectBench/BenchmarkRunner.h"
+#include "Platform/DataTypes.h"
+#include "Platform/Storage/File.h"
+#include "Platform/Storage/Path.h"
+
+namespace Benchmarking
+{
+	const uint32 FLOAT_COUNT = 1u << 20;	/// Number of floats in the raw binary input file (4 MiB).
+
+	/// Input files of the storage benchmarks and the state of per value reading.
+	/** The files are created once by addStorageBenchmarks() and removed when the last benchmark referencing them is destroyed. */
+	struct StorageData
+	{
+		/** Closes mOpenFile and removes all files including the mesh caches which were created by PlyFile::loadCached(). */
+		~StorageData();
+
+		Storage::Path					mFloatsFile;	/// FLOAT_COUNT little endian floats.
+		Storage::Path					mBinaryMesh;	/// Binary little endian ply mesh.
+		Storage::Path					mASCIIMesh;		/// ASCII ply mesh with the same content as mBinaryMesh.
+		Storage::Path					mOutputFile;	/// File which is overwritten by the writing benchmarks.
+		std::unique_ptr<Storage::File>	mOpenFile;		/// File which is read value by value while a per value benchmark runs.
+		uint64							mRemaining;		/// Number of values left in mOpenFile before it must be rewound.
+	};
+
+	/** Creates a grid mesh with colors and normals.
+	@param fileName Set this to the path of the created ply file.
+	@param encoding Defines how the mesh is saved. */
+	void createMeshFile(const Storage::Path &fileName, const Encoding encoding);
+
+	/** Returns the size of a file.
+	@param fileName Identifies the file.
+	@return Returns the file size in bytes. */
+	uint64 getFileSize(const Storage::Path &fileName);
+
+	/** Registers the benchmarks of AsyncFileReader compared with synchronous chunk reading.
+	@param runner The benchmarks are added to this runner.
+	@param data Set this to the input files of the benchmarks. */
+	void addAsyncFileReaderBenchmarks(BenchmarkRunner &runner, const std::shared_ptr<StorageData> &data);
+
+	/** Registers the benchmarks of compressed Storage::File streams.
+	@param runner The benchmarks are added to this runner.
+	@param data Set this to the input files of the benchmarks. */
+	void addCompressionBenchmarks(BenchmarkRunner &runner, const std::shared_ptr<StorageData> &data);
+
+	/** Registers the benchmarks of Storage::File and BufferedFileWriter reading and writing.
+	@param runner The benchmarks are added to this runner.
+	@param data Set this to the input files of the benchmarks. */
+	void addFileBenchmarks(BenchmarkRunner &runner, const std::shared_ptr<StorageData> &data);
+
+	/** Registers the benchmarks of PlyFile::loadCached() and its native mesh cache files.
+	@param runner The benchmarks are added to this runner.
+	@param data Set this to the input files of the benchmarks. */
+	void addMeshCacheBenchmarks(BenchmarkRunner &runner, const std::shared_ptr<StorageData> &data);
+
+	/** Registers the benchmarks of PlyFile saving, loading and streaming.
+	@param runner The benchmarks are added to this runner.
+	@param data Set this to the input files of the benchmarks. */
+	void addPlyFileBenchmarks(BenchmarkRunner &runner, const std::shared_ptr<StorageData> &data);
+}
+
+#endif // _STORAGE_BENCHMARKS_H_
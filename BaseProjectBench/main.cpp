@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "BaseProjectBench/BenchmarkRunner.h"
+#include "BaseProjectBench/Benchmarks.h"
+#include "BaseProjectBench/MachineInfo.h"
+#include "BaseProjectBench/RegressionDetector.h"
+#include "Platform/FailureHandling/Exception.h"
+#include "Platform/Multithreading/Manager.h"
+#include "Platform/ResourceManagement/MemoryManager.h"
+#include "Platform/Storage/Directory.h"
+#include "Platform/Storage/File.h"
+#include "Platform/Utilities/RandomManager.h"
+
+using namespace Benchmarking;
+using namespace FailureHandling;
+using namespace Platform;
+using namespace std;
+using namespace Storage;
+using namespace Utilities;
+
+#ifdef MEMORY_MANAGEMENT
+	const uint32 ResourceManagement::DEFAULT_POOL_BUCKET_NUMBER = 5;
+	const uint16 ResourceManagement::DEFAULT_POOL_BUCKET_CAPACITIES[DEFAULT_POOL_BUCKET_NUMBER] = { 1024, 1024, 1024, 1024, 1024 };
+	const uint16 ResourceManagement::DEFAULT_POOL_BUCKET_GRANULARITIES[DEFAULT_POOL_BUCKET_NUMBER] = { 16, 32, 64, 128, 256 };
+#endif // MEMORY_MANAGEMENT
+
+/// Command line configuration of a benchmark run.
+struct Options
+{
+	string	mBaselineDirectory;	/// Baselines of all machines are stored here or empty to not compare with a baseline.
+	string	mDataDirectory;		/// Temporary input files are created here.
+	string	mFilter;			/// Only benchmarks with names containing this are run.
+	string	mOutput;			/// JSON result file or empty.
+	string	mReport;			/// Comparison report file or empty.
+	double	mMinTime;			/// Minimum duration of a single repetition in seconds.
+	double	mSignificanceLevel;	/// Maximum p-value of regressions.
+	double	mThreshold;			/// Minimum relative median change of regressions.
+	uint32	mRepetitions;		/// Number of measured repetitions.
+	uint32	mThreads;			/// Number of worker threads of the Multithreading::Manager.
+	uint32	mWarmup;			/// Number of unmeasured repetitions.
+	bool	mUpdateBaseline;	/// Defines whether the results are stored in the baseline of this machine.
+};
+
+void printUsage()
+{
+	cout << "Usage: BaseProjectBench.exe [options]\n";
+	cout << "  --filter <text>       Only runs benchmarks with names containing text, e.g., Math/Vector3.\n";
+	cout << "  --repetitions <n>     Number of measured repetitions per benchmark (default 10).\n";
+	cout << "  --warmup <n>          Number of unmeasured repetitions before measuring (default 2).\n";
+	cout << "  --min-time <seconds>  Minimum duration of each repetition which determines the iteration count (default 0.05).\n";
+	cout << "  --threads <n>         Number of worker threads for the multithreading benchmarks (default: hardware threads).\n";
+	cout << "  --data <directory>    Directory for temporary input files (default: current directory).\n";
+	cout << "  --output <file>       Saves all results as JSON file.\n";
+	cout << "  --baseline <dir>      Compares the results with the baseline of this machine in dir and fails on regressions.\n";
+	cout << "  --update-baseline     Stores the results in the baseline of this machine in the --baseline directory, which is created if missing.\n";
+	cout << "  --alpha <p>           Significance level of the Mann-Whitney U test for regressions (default 0.01).\n";
+	cout << "  --threshold <percent> Minimum median slowdown of regressions (default 5).\n";
+	cout << "  --report <file>       Saves the baseline comparison report as text file.\n";
+	cout << flush;
+}
+
+bool parseOptions(Options &options, int argc, char *argv[])
+{
+	// defaults
+	const uint32 hardwareThreads = thread::hardware_concurrency();
+	options.mDataDirectory = ".";
+	options.mMinTime = 0.05;
+	options.mRepetitions = 10;
+	options.mSignificanceLevel = 0.01;
+	options.mThreshold = 0.05;
+	options.mUpdateBaseline = false;
+	options.mThreads = (hardwareThreads > 0 ? hardwareThreads : 1);
+	options.mWarmup = 2;
+
+	for (int argIdx = 1; argIdx < argc; ++argIdx)
+	{
+		const char *option = argv[argIdx];
+		if (0 == strcmp(option, "--help") || 0 == strcmp(option, "-h"))
+			return false;
+		if (0 == strcmp(option, "--update-baseline"))
+		{
+			options.mUpdateBaseline = true;
+			continue;
+		}
+
+		// all other options have a value
+		if (argIdx + 1 >= argc)
+		{
+			cerr << "Missing value of option " << option << ".\n";
+			return false;
+		}
+		const char *value = argv[++argIdx];
+
+		if (0 == strcmp(option, "--filter"))
+			options.mFilter = value;
+		else if (0 == strcmp(option, "--repetitions"))
+			options.mRepetitions = (uint32) strtoul(value, NULL, 10);
+		else if (0 == strcmp(option, "--warmup"))
+			options.mWarmup = (uint32) strtoul(value, NULL, 10);
+		else if (0 == strcmp(option, "--min-time"))
+			options.mMinTime = strtod(value, NULL);
+		else if (0 == strcmp(option, "--threads"))
+			options.mThreads = (uint32) strtoul(value, NULL, 10);
+		else if (0 == strcmp(option, "--data"))
+			options.mDataDirectory = value;
+		else if (0 == strcmp(option, "--output"))
+			options.mOutput = value;
+		else if (0 == strcmp(option, "--baseline"))
+			options.mBaselineDirectory = value;
+		else if (0 == strcmp(option, "--alpha"))
+			options.mSignificanceLevel = strtod(value, NULL);
+		else if (0 == strcmp(option, "--threshold"))
+			options.mThreshold = 0.01 * strtod(value, NULL);
+		else if (0 == strcmp(option, "--report"))
+			options.mReport = value;
+		else
+		{
+			cerr << "Unknown option " << option << ".\n";
+			return false;
+		}
+	}
+
+	if (0 == options.mRepetitions || options.mMinTime <= 0.0)
+	{
+		cerr << "The repetition count and the minimum repetition time must be positive.\n";
+		return false;
+	}
+
+	if (options.mSignificanceLevel <= 0.0 || options.mSignificanceLevel >= 1.0 || options.mThreshold < 0.0)
+	{
+		cerr << "The significance level must be in (0, 1) and the threshold must not be negative.\n";
+		return false;
+	}
+
+	if (options.mUpdateBaseline && options.mBaselineDirectory.empty())
+	{
+		cerr << "--update-baseline requires --baseline.\n";
+		return false;
+	}
+
+	return true;
+}
+
+/** Compares results with the baseline of the executing machine and optionally updates the baseline.
+@param options Defines the baseline directory, the test parameters and whether the baseline is updated.
+@param results Set this to the results of the current run.
+@param machine Identifies the baseline file of the executing machine.
+@param context Describes the current run and is stored in updated baselines.
+@return Returns EXIT_FAILURE if there are regressions and EXIT_SUCCESS otherwise. */
+int processBaseline(const Options &options, const vector<BenchmarkResult> &results, const MachineInfo &machine, const string &context)
+{
+	const Path fileName = Path::appendChild(options.mBaselineDirectory, "BaseProjectBench_" + machine.getFingerprint() + ".json");
+	vector<BenchmarkResult> baseline;
+	string baselineContext;
+	int result = EXIT_SUCCESS;
+
+	// compare
+	if (File::exists(fileName))
+	{
+		BenchmarkRunner::loadJSON(baseline, baselineContext, fileName);
+
+		RegressionDetector detector(options.mSignificanceLevel, options.mThreshold);
+		detector.compare(baseline, results);
+
+		const string report = detector.getReport(machine.getFingerprint());
+		cout << "\n" << report << flush;
+		if (!options.mReport.empty())
+		{
+			File file(options.mReport, File::CREATE_WRITING, false);
+			fputs(report.c_str(), &file.getHandle());
+		}
+
+		if (detector.getStatusCount(RegressionDetector::STATUS_REGRESSION) > 0)
+			result = EXIT_FAILURE;
+	}
+	else
+	{
+		cout << "\nThere is no baseline " << fileName << " for this machine yet." << endl;
+	}
+
+	if (!options.mUpdateBaseline)
+		return result;
+
+	// replace or add the results of the benchmarks which were run & keep the others
+	for (size_t resultIdx = 0; resultIdx < results.size(); ++resultIdx)
+	{
+		size_t baselineIdx = 0;
+		while (baselineIdx < baseline.size() && baseline[baselineIdx].mName != results[resultIdx].mName)
+			++baselineIdx;
+
+		if (baselineIdx < baseline.size())
+			baseline[baselineIdx] = results[resultIdx];
+		else
+			baseline.push_back(results[resultIdx]);
+	}
+
+	BenchmarkRunner::saveJSON(fileName, context, baseline);
+	cout << "Updated baseline " << fileName << "." << endl;
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	Options options;
+	if (!parseOptions(options, argc, argv))
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	// fail before running the whole suite if the updated baseline could not be saved
+	if (options.mUpdateBaseline && !Directory::createDirectory(options.mBaselineDirectory))
+	{
+		cerr << "Could not create the baseline directory " << options.mBaselineDirectory << ".\n";
+		return EXIT_FAILURE;
+	}
+
+	// headless: only managers which do not require a window
+	RandomManager *randomManager = new RandomManager();
+	Multithreading::Manager *workManager = new Multithreading::Manager();
+	workManager->runWork(options.mThreads);
+
+	int result = EXIT_SUCCESS;
+	try
+	{
+		BenchmarkRunner runner(options.mWarmup, options.mRepetitions, options.mMinTime);
+		addMathBenchmarks(runner);
+		addCollisionDetectionBenchmarks(runner);
+		addStorageBenchmarks(runner, options.mDataDirectory);
+		addResourceManagementBenchmarks(runner);
+		addMultithreadingBenchmarks(runner);
+
+		runner.run(options.mFilter);
+
+		// results are keyed by machine & build configuration
+		const MachineInfo machine;
+		ostringstream context;
+		context << "{\"machine\":" << machine.toJSON();
+		context << ",\"threads\":" << options.mThreads;
+		context << ",\"warmup\":" << options.mWarmup;
+		context << ",\"repetitions\":" << options.mRepetitions;
+		context << ",\"minRepetitionTime\":" << options.mMinTime << "}";
+
+		if (!options.mOutput.empty())
+		{
+			runner.saveJSON(options.mOutput, context.str());
+			cout << "Saved results to " << options.mOutput << "." << endl;
+		}
+
+		if (!options.mBaselineDirectory.empty())
+			result = processBaseline(options, runner.getResults(), machine, context.str());
+	}
+	catch (Exception &exception)
+	{
+		cerr << exception << endl;
+		result = EXIT_FAILURE;
+	}
+
+	delete workManager;
+	delete randomManager;
+
+	#ifdef MEMORY_MANAGEMENT
+		ResourceManagement::MemoryManager::shutDown();
+	#endif // MEMORY_MANAGEMENT
+
+	return result;
+}
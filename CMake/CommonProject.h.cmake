@@ -19,11 +19,18 @@ mark_as_advanced(BASE_LOGGING)
 option(BASE_PROFILING "Enables or disables profiling functionality." on)
 mark_as_advanced(BASE_PROFILING)
 
+option(BASE_IO_URING "Enables io_uring based asynchronous file reading on Linux if the kernel headers provide it, see Storage::AsyncFileReader." on)
+mark_as_advanced(BASE_IO_URING)
+
+option(BASE_ZSTD "Enables zstd compressed files if the zstd library is found, see Storage::File::Compression." on)
+mark_as_advanced(BASE_ZSTD)
+
 # memory management user options
 option(BASE_MEMORY_MANAGEMENT "Enables or disables the custom memory management of the base project." off)
 option(BASE_MEMORY_MANAGEMENT_ACTIVE_MEMORY_DESTRUCTION "Enables overwriting of released memory with an uncommon pattern. Only works if MEMORY_MANAGEMENT is turned on." on)
 option(BASE_MEMORY_MANAGEMENT_CORRECT_DELETE_OPERATOR_AND_BOUNDS_CHECK "Enables checking of correct usage of delete and delete [] and heap array bounds overwrite detection. Only works if MEMORY_MANAGEMENT is turned on." on)
-mark_as_advanced(BASE_MEMORY_MANAGEMENT BASE_MEMORY_MANAGEMENT_ACTIVE_MEMORY_DESTRUCTION BASE_MEMORY_MANAGEMENT_CORRECT_DELETE_OPERATOR_AND_BOUNDS_CHECK)
+option(BASE_MEMORY_MANAGEMENT_HEAP_PROFILING "Enables sampling of allocations and their attribution to call sites, see ResourceManagement::HeapProfiler. Only works if MEMORY_MANAGEMENT is turned on." off)
+mark_as_advanced(BASE_MEMORY_MANAGEMENT BASE_MEMORY_MANAGEMENT_ACTIVE_MEMORY_DESTRUCTION BASE_MEMORY_MANAGEMENT_CORRECT_DELETE_OPERATOR_AND_BOUNDS_CHECK BASE_MEMORY_MANAGEMENT_HEAP_PROFILING)
 
 # where to find built 3rd party dendencies
 list(APPEND CMAKE_MODULE_PATH ${BASE_PROJECT_DIR}/CMake)
@@ -105,6 +112,18 @@ if (BASE_MEMORY_MANAGEMENT_CORRECT_DELETE_OPERATOR_AND_BOUNDS_CHECK)
 	add_definitions(-DCORRECT_DELETE_OPERATOR_AND_BOUNDS_CHECK)
 endif (BASE_MEMORY_MANAGEMENT_CORRECT_DELETE_OPERATOR_AND_BOUNDS_CHECK)
 
+if (BASE_MEMORY_MANAGEMENT_HEAP_PROFILING)
+	add_definitions(-DHEAP_PROFILING)
+endif (BASE_MEMORY_MANAGEMENT_HEAP_PROFILING)
+
 if (BASE_LOGGING)
 	add_definitions(-DBASE_LOGGING)
 endif (BASE_LOGGING)
+
+if (BASE_IO_URING AND ${LINUX})
+	include(CheckIncludeFile)
+	check_include_file(linux/io_uring.h BASE_IO_URING_HEADER_FOUND)
+	if (BASE_IO_URING_HEADER_FOUND)
+		add_definitions(-DIO_URING)
+	endif (BASE_IO_URING_HEADER_FOUND)
+endif (BASE_IO_URING AND ${LINUX})
@@ -0,0 +1,35 @@
+#
+# Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+# All rights reserved.
+#
+# This software may be modified and distributed under the terms
+# of the BSD 3-Clause license. See the License.txt file for details.
+#
+
+# zlib and zstd specific cmake functionality for compressed files, see Storage::CompressedStream
+
+# zlib is always required, e.g., also by libPNG
+find_package(ZLIB REQUIRED)
+include_directories(${ZLIB_INCLUDE_DIRS})
+
+# zstd is optional
+if (BASE_ZSTD)
+	find_path(ZSTD_INCLUDE_DIR zstd.h)
+	find_library(ZSTD_LIBRARY NAMES zstd zstd_static)
+	mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
+
+	if (ZSTD_INCLUDE_DIR AND ZSTD_LIBRARY)
+		add_definitions(-DZSTD)
+		include_directories(${ZSTD_INCLUDE_DIR})
+	else (ZSTD_INCLUDE_DIR AND ZSTD_LIBRARY)
+		message(STATUS "zstd was not found, files can only be compressed with gzip.")
+		set(ZSTD_LIBRARY "")
+	endif (ZSTD_INCLUDE_DIR AND ZSTD_LIBRARY)
+endif (BASE_ZSTD)
+
+macro(addCompressionLibs libs)
+	set(${libs} ${${libs}} ${ZLIB_LIBRARIES})
+	if (BASE_ZSTD AND ZSTD_LIBRARY)
+		set(${libs} ${${libs}} ${ZSTD_LIBRARY})
+	endif (BASE_ZSTD AND ZSTD_LIBRARY)
+endmacro(addCompressionLibs)
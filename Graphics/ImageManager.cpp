@@ -20,6 +20,7 @@
 #include "Platform/FailureHandling/FileAccessException.h"
 #include "Platform/FailureHandling/FileCorruptionException.h"
 #include "Platform/FailureHandling/FileException.h"
+#include "Platform/Storage/AsyncFileReader.h"
 #include "png.h"
 
 using namespace FailureHandling;
@@ -28,6 +29,22 @@ using namespace std;
 using namespace Storage;
 using namespace Utilities;
 
+namespace
+{
+	const uint32 PNG_CHUNK_SIZE = 1u << 18;	/// PNG files are read ahead in chunks of 256 KiB.
+
+	/** Provides libpng with the next bytes of a PNG file which is read ahead in the background.
+	@param png Set this to the libpng read struct with an AsyncFileReader as I/O pointer.
+	@param target Is filled with the next file bytes.
+	@param size Set this to the number of requested bytes. */
+	void readPNGData(png_structp png, png_bytep target, png_size_t size)
+	{
+		AsyncFileReader &file = *reinterpret_cast<AsyncFileReader *>(png_get_io_ptr(png));
+		if (size != file.read(target, size))
+			png_error(png, "Read Error");
+	}
+}
+
 ImageManager::~ImageManager()
 {
 
@@ -106,15 +123,15 @@ uint8 *ImageManager::loadPNG(ImgSize &size, Texture::Format &format, const Path
 
 	try
 	{
-		File file(fileName, File::OPEN_READING, true);
+		// decode chunk N while chunk N + 1 is read
+		AsyncFileReader file(fileName, PNG_CHUNK_SIZE);
 		
 		// get header data
 		{
 			// each png file starts with a specific 8 byte sequence -> check it to be sure that the file is a png
 			const uint8 SIGNATURE_BYTE_COUNT = 8;
 			png_byte signature[SIGNATURE_BYTE_COUNT];
-			uint8 readSequenceCount = file.read(signature, SIGNATURE_BYTE_COUNT, SIGNATURE_BYTE_COUNT, 1);
-			if (file.errorOccured() || 0 == readSequenceCount || !file.hasLeftData())
+			if (SIGNATURE_BYTE_COUNT != file.read(signature, SIGNATURE_BYTE_COUNT) || file.getFileSize() == SIGNATURE_BYTE_COUNT)
 				throw FileCorruptionException("Could not read the mandatory PNG file signature.", fileName);
 
 			if (0 != png_sig_cmp(signature, 0, SIGNATURE_BYTE_COUNT))
@@ -130,7 +147,7 @@ uint8 *ImageManager::loadPNG(ImgSize &size, Texture::Format &format, const Path
 				throw Exception("Could not create png info structure since the call of png_create_info_struct failed.");
 
 			// prepare png data struct for file reading operations
-			png_init_io(pngData, &file.getHandle());
+			png_set_read_fn(pngData, &file, readPNGData);
 			png_set_sig_bytes(pngData, SIGNATURE_BYTE_COUNT); // signature was already read
 
 			// get header / meta data
@@ -214,18 +231,13 @@ uint32 ImageManager::loadTileTexture(Size2<Real> &tileSize, const Path &name) co
 {
 	TextureHeader header;
 	uint32 identifier	= 0;
-	File file(name, File::OPEN_READING, true);
+	File file(name, File::OPEN_READING_MAPPED, true);
 
 	// check file type and get texture header
 	{
-		char buffer[TILE_TEXTURE_START_CHAR_COUNT];
-		const uint32 count = file.read(buffer, TILE_TEXTURE_START_CHAR_COUNT, 1, TILE_TEXTURE_START_CHAR_COUNT);
-
-		if (TILE_TEXTURE_START_CHAR_COUNT != count ||
-			0 != strncmp(buffer, TILE_TEXTURE_START_CHARS, TILE_TEXTURE_START_CHAR_COUNT))
-		{
+		const char *startChars = file.readView<char>(TILE_TEXTURE_START_CHAR_COUNT);
+		if (!startChars || 0 != strncmp(startChars, TILE_TEXTURE_START_CHARS, TILE_TEXTURE_START_CHAR_COUNT))
 			throw FileCorruptionException("Tile texture file doesn't begin with with standard start text.", name);
-		}
 	}
 
 	// read header
@@ -242,18 +254,12 @@ uint32 ImageManager::loadTileTexture(Size2<Real> &tileSize, const Path &name) co
 	const uint32 pixelSize = (Texture::FORMAT_RGB == header.mFormat ? 3 : 4);
 	const uint32 bufferSize = pixelCount * pixelSize;
 
-	// todo memory allocation can this be done better?
-	// read pixel data
-	uint8 *pixels = new uint8[bufferSize];
-	if (pixelCount != file.read(pixels, bufferSize, pixelSize, pixelCount))
+	// upload pixel data directly from the mapped file
+	const uint8 *pixels = file.readView<uint8>(bufferSize);
+	if (!pixels)
 		throw FileCorruptionException("Tile texture file does not contain as many pixels as described in its header.", name);
 
 	identifier = createOpenGLTexture(header, pixels);
-
-	// free resources
-	delete [] pixels;
-	pixels = NULL;
-
 	return identifier;
 }
 
@@ -7,6 +7,7 @@
  */
 #include "Math/MathHelper.h"
 #include "Math/Matrix4x4.h"
+#include "Math/SIMD.h"
 #include "Math/Vector2.h"
 #include "Math/Vector3.h"
 #include "Math/Vector4.h"
@@ -67,49 +68,61 @@ Matrix4x4 Matrix4x4::createFromMajorColumnArray(const Real * data)
 
 Matrix4x4 Matrix4x4::createInverse(const Matrix4x4 &m)
 {
-	Real s0 = computeDeterminant(m.m00, m.m01, m.m10, m.m11);
-	Real c5 = computeDeterminant(m.m22, m.m23, m.m32, m.m33);
-
-	Real s1 = computeDeterminant(m.m00, m.m02, m.m10, m.m12);
-	Real c4 = computeDeterminant(m.m21, m.m23, m.m31, m.m33);
-
-	Real s2 = computeDeterminant(m.m00, m.m03, m.m10, m.m13);
-	Real c3 = computeDeterminant(m.m21, m.m22, m.m31, m.m32);
-
-	Real s3 = computeDeterminant(m.m01, m.m02, m.m11, m.m12);
-	Real c2 = computeDeterminant(m.m20, m.m23, m.m30, m.m33);
-
-	Real s4 = computeDeterminant(m.m01, m.m03, m.m11, m.m13);
-	Real c1 = computeDeterminant(m.m20, m.m22, m.m30, m.m32);
-
-	Real s5 = computeDeterminant(m.m02, m.m03, m.m12, m.m13);
-	Real c0 = computeDeterminant(m.m20, m.m21, m.m30, m.m31);
-
-	Real determinant = (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+	const SIMDReal4 row0 = SIMDReal4::load(m.values[0]);
+	const SIMDReal4 row1 = SIMDReal4::load(m.values[1]);
+	const SIMDReal4 row2 = SIMDReal4::load(m.values[2]);
+	const SIMDReal4 row3 = SIMDReal4::load(m.values[3]);
+
+	// 2x2 determinants of the upper rows s = (s0, s1, s2, s3), (s4, s5) and of the lower rows c = (c0, c1, c2, c3), (c4, c5)
+	// for the column pairs (0, 1), (0, 2), (0, 3), (1, 2), (1, 3) and (2, 3)
+	const SIMDReal4 s0123 = row0.shuffle<0, 0, 0, 1>() * row1.shuffle<1, 2, 3, 2>() - row0.shuffle<1, 2, 3, 2>() * row1.shuffle<0, 0, 0, 1>();
+	const SIMDReal4 s45 = row0.shuffle<1, 2, 1, 2>() * row1.shuffle<3, 3, 3, 3>() - row0.shuffle<3, 3, 3, 3>() * row1.shuffle<1, 2, 1, 2>();
+	const SIMDReal4 c0123 = row2.shuffle<0, 0, 0, 1>() * row3.shuffle<1, 2, 3, 2>() - row2.shuffle<1, 2, 3, 2>() * row3.shuffle<0, 0, 0, 1>();
+	const SIMDReal4 c45 = row2.shuffle<1, 2, 1, 2>() * row3.shuffle<3, 3, 3, 3>() - row2.shuffle<3, 3, 3, 3>() * row3.shuffle<1, 2, 1, 2>();
+
+	Real s[8];
+	Real c[8];
+	s0123.store(s);
+	s45.store(s + 4);
+	c0123.store(c);
+	c45.store(c + 4);
+
+	Real determinant = (s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0]);
 	assert(fabsr(determinant) > EPSILON);
 
-	Real oD = 1.0f / determinant;
-
-	return Matrix4x4(
-		oD * ( m.m11 * c5 - m.m12 * c4 + m.m13 * c3),
-		oD * (-m.m01 * c5 + m.m02 * c4 - m.m03 * c3),
-		oD * ( m.m31 * s5 - m.m32 * s4 + m.m33 * s3),
-		oD * (-m.m21 * s5 + m.m22 * s4 - m.m23 * s3),
-		
-		oD * (-m.m10 * c5 + m.m12 * c2 - m.m13 * c1),
-		oD * ( m.m00 * c5 - m.m02 * c2 + m.m03 * c1),
-		oD * (-m.m30 * s5 + m.m32 * s2 - m.m33 * s1),
-		oD * ( m.m20 * s5 - m.m22 * s2 + m.m23 * s1),
-		
-		oD * ( m.m10 * c4 - m.m11 * c2 + m.m13 * c0),
-		oD * (-m.m00 * c4 + m.m01 * c2 - m.m03 * c0),
-		oD * ( m.m30 * s4 - m.m31 * s2 + m.m33 * s0),
-		oD * (-m.m20 * s4 + m.m21 * s2 - m.m23 * s0),
-		
-		oD * (-m.m10 * c3 + m.m11 * c1 - m.m12 * c0),
-		oD * ( m.m00 * c3 - m.m01 * c1 + m.m02 * c0),
-		oD * (-m.m30 * s3 + m.m31 * s1 - m.m32 * s0),
-		oD * ( m.m20 * s3 - m.m21 * s1 + m.m22 * s0));
+	// q_k = (c_k, -c_k, s_k, -s_k)
+	const SIMDReal4 signs = SIMDReal4::set(1.0f, -1.0f, 1.0f, -1.0f);
+	const SIMDReal4 cs01 = SIMDReal4::interleaveLow(c0123, s0123);
+	const SIMDReal4 cs23 = SIMDReal4::interleaveHigh(c0123, s0123);
+	const SIMDReal4 cs45 = SIMDReal4::interleaveLow(c45, s45);
+	const SIMDReal4 q0 = cs01.shuffle<0, 0, 1, 1>() * signs;
+	const SIMDReal4 q1 = cs01.shuffle<2, 2, 3, 3>() * signs;
+	const SIMDReal4 q2 = cs23.shuffle<0, 0, 1, 1>() * signs;
+	const SIMDReal4 q3 = cs23.shuffle<2, 2, 3, 3>() * signs;
+	const SIMDReal4 q4 = cs45.shuffle<0, 0, 1, 1>() * signs;
+	const SIMDReal4 q5 = cs45.shuffle<2, 2, 3, 3>() * signs;
+
+	// a_j = (m1j, m0j, m3j, m2j)
+	SIMDReal4 a0 = row0;
+	SIMDReal4 a1 = row1;
+	SIMDReal4 a2 = row2;
+	SIMDReal4 a3 = row3;
+	SIMDReal4::transpose(a0, a1, a2, a3);
+	a0 = a0.shuffle<1, 0, 3, 2>();
+	a1 = a1.shuffle<1, 0, 3, 2>();
+	a2 = a2.shuffle<1, 0, 3, 2>();
+	a3 = a3.shuffle<1, 0, 3, 2>();
+
+	// same products and summation order as the cofactor expansion of each inverse entry
+	const SIMDReal4 negative = SIMDReal4::splat(-1.0f);
+	const SIMDReal4 oD = SIMDReal4::splat(1.0f / determinant);
+
+	Matrix4x4 inverse;
+	(oD * (a1 * q5 - a2 * q4 + a3 * q3)).store(inverse.values[0]);
+	(oD * (negative * a0 * q5 + a2 * q2 - a3 * q1)).store(inverse.values[1]);
+	(oD * (a0 * q4 - a1 * q2 + a3 * q0)).store(inverse.values[2]);
+	(oD * (negative * a0 * q3 + a1 * q1 - a2 * q0)).store(inverse.values[3]);
+	return inverse;
 }
 
 Matrix4x4 Matrix4x4::createInverseCameraTransformation(const Vector3 &cx, const Vector3 &cy, const Vector3 &cz, const Vector3 &position)
@@ -402,25 +415,22 @@ Matrix4x4 Matrix4x4::operator /(Real scalar) const
 
 Matrix4x4 Matrix4x4::operator *(const Matrix4x4 &b) const
 {
-	return Matrix4x4(	m00 * b.m00 + m01 * b.m10 + m02 * b.m20 + m03 * b.m30,
-						m00 * b.m01 + m01 * b.m11 + m02 * b.m21 + m03 * b.m31,
-						m00 * b.m02 + m01 * b.m12 + m02 * b.m22 + m03 * b.m32,
-						m00 * b.m03 + m01 * b.m13 + m02 * b.m23 + m03 * b.m33,
-
-						m10 * b.m00 + m11 * b.m10 + m12 * b.m20 + m13 * b.m30,
-						m10 * b.m01 + m11 * b.m11 + m12 * b.m21 + m13 * b.m31,
-						m10 * b.m02 + m11 * b.m12 + m12 * b.m22 + m13 * b.m32,
-						m10 * b.m03 + m11 * b.m13 + m12 * b.m23 + m13 * b.m33,
-
-						m20 * b.m00 + m21 * b.m10 + m22 * b.m20 + m23 * b.m30,
-						m20 * b.m01 + m21 * b.m11 + m22 * b.m21 + m23 * b.m31,
-						m20 * b.m02 + m21 * b.m12 + m22 * b.m22 + m23 * b.m32,
-						m20 * b.m03 + m21 * b.m13 + m22 * b.m23 + m23 * b.m33,
-						
-						m30 * b.m00 + m31 * b.m10 + m32 * b.m20 + m33 * b.m30,
-						m30 * b.m01 + m31 * b.m11 + m32 * b.m21 + m33 * b.m31,
-						m30 * b.m02 + m31 * b.m12 + m32 * b.m22 + m33 * b.m32,
-						m30 * b.m03 + m31 * b.m13 + m32 * b.m23 + m33 * b.m33);
+	// each row of the product is a linear combination of the rows of b
+	const SIMDReal4 b0 = SIMDReal4::load(b.values[0]);
+	const SIMDReal4 b1 = SIMDReal4::load(b.values[1]);
+	const SIMDReal4 b2 = SIMDReal4::load(b.values[2]);
+	const SIMDReal4 b3 = SIMDReal4::load(b.values[3]);
+
+	Matrix4x4 product;
+	for (uint32 rowIdx = 0; rowIdx < 4; ++rowIdx)
+	{
+		const Real *row = values[rowIdx];
+		const SIMDReal4 result = SIMDReal4::splat(row[0]) * b0 + SIMDReal4::splat(row[1]) * b1 +
+			SIMDReal4::splat(row[2]) * b2 + SIMDReal4::splat(row[3]) * b3;
+		result.store(product.values[rowIdx]);
+	}
+
+	return product;
 }
 
 inline void Matrix4x4::setColumn(const Math::Vector4 &newColumn, const uint32 columnIdx)
@@ -9,6 +9,7 @@
 #include "Math/Matrix3x3.h"
 #include "Math/Matrix4x4.h"
 #include "Math/Quaternion.h"
+#include "Math/SIMD.h"
 
 using namespace Math;
 using namespace std;
@@ -184,11 +185,21 @@ Quaternion &Quaternion::operator /=(Real scalar)
 Quaternion Quaternion::operator *(const Quaternion &rhs) const
 {
 	// IF YOU CHANGE THIS - THEN ALSO CHANGE *= !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-	return Quaternion(
-		 rhs.x * w + rhs.y * z - rhs.z * y + rhs.w * x,
-		-rhs.x * z + rhs.y * w + rhs.z * x + rhs.w * y,
-		 rhs.x * y - rhs.y * x + rhs.z * w + rhs.w * z,
-		-rhs.x * x - rhs.y * y - rhs.z * z + rhs.w * w);
+	// lane-wise version of
+	//  rhs.x * w + rhs.y * z - rhs.z * y + rhs.w * x,
+	// -rhs.x * z + rhs.y * w + rhs.z * x + rhs.w * y,
+	//  rhs.x * y - rhs.y * x + rhs.z * w + rhs.w * z,
+	// -rhs.x * x - rhs.y * y - rhs.z * z + rhs.w * w
+	const SIMDReal4 lhs = SIMDReal4::load(&x);
+	const SIMDReal4 product =
+		SIMDReal4::splat(rhs.x) * (lhs.shuffle<3, 2, 1, 0>() * SIMDReal4::set(1.0f, -1.0f, 1.0f, -1.0f)) +
+		SIMDReal4::splat(rhs.y) * (lhs.shuffle<2, 3, 0, 1>() * SIMDReal4::set(1.0f, 1.0f, -1.0f, -1.0f)) +
+		SIMDReal4::splat(rhs.z) * (lhs.shuffle<1, 0, 3, 2>() * SIMDReal4::set(-1.0f, 1.0f, 1.0f, -1.0f)) +
+		SIMDReal4::splat(rhs.w) * lhs;
+
+	Quaternion result;
+	product.store(&result.x);
+	return result;
 }
 
 Quaternion &Quaternion::operator +=(const Quaternion &rhs)
@@ -0,0 +1,698 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _MATH_SIMD_H_
+#define _MATH_SIMD_H_
+
+#include "Math/MathCore.h"
+
+// Selects the SIMD backend of SIMDReal4 at compile time depending on Real and the instruction sets of the target.
+// Define NO_SIMD to always use the scalar backend.
+// The NEON backend has not been built and tested on ARM yet, so define SIMD_NEON to opt in to it. Otherwise, ARM uses the scalar backend.
+#ifndef NO_SIMD
+	#ifdef DOUBLE_PRECISION
+		#if defined(__AVX__)
+			#define MATH_SIMD_AVX
+		#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+			#define MATH_SIMD_SSE2
+		#elif defined(SIMD_NEON) && defined(__ARM_NEON) && defined(__aarch64__)
+			#define MATH_SIMD_NEON
+		#endif
+	#else
+		#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+			#define MATH_SIMD_SSE
+		#elif defined(SIMD_NEON) && defined(__ARM_NEON)
+			#define MATH_SIMD_NEON
+		#endif
+	#endif // DOUBLE_PRECISION
+#endif // NO_SIMD
+
+#if defined(MATH_SIMD_AVX)
+	#include <immintrin.h>
+#elif defined(MATH_SIMD_SSE2)
+	#include <emmintrin.h>
+#elif defined(MATH_SIMD_SSE)
+	#include <xmmintrin.h>
+#elif defined(MATH_SIMD_NEON)
+	#include <arm_neon.h>
+#endif
+
+namespace Math
+{
+	/// Four Real lanes in SIMD registers for the core operations of Vector3, Vector4, Matrix4x4 and Quaternion.
+	/** The backend is selected at compile time: SSE for float, AVX or SSE2 register pairs for double, NEON on ARM if SIMD_NEON is defined and plain Reals otherwise.
+		All backends compute exactly the same lane-wise operations without fused multiply-adds,
+		so results only depend on the order in which callers combine the lanes and not on the backend.
+		Loads and stores are unaligned and do not require any changes to the memory layout of the existing classes. */
+	class SIMDReal4
+	{
+	public:
+		/** Loads four consecutive Reals from memory which does not need to be aligned.
+		@param source Set this to the first of the four loaded Reals.
+		@return Returns the lanes (source[0], source[1], source[2], source[3]). */
+		inline static SIMDReal4 load(const Real *source);
+
+		/** Creates a vector with four individual lanes.
+		@param x Set this to the value of the first lane.
+		@param y Set this to the value of the second lane.
+		@param z Set this to the value of the third lane.
+		@param w Set this to the value of the fourth lane.
+		@return Returns the lanes (x, y, z, w). */
+		inline static SIMDReal4 set(Real x, Real y, Real z, Real w);
+
+		/** Creates a vector with four equal lanes.
+		@param value Set this to the value of all lanes.
+		@return Returns the lanes (value, value, value, value). */
+		inline static SIMDReal4 splat(Real value);
+
+		/** Interleaves the first two lanes of two vectors.
+		@param a Set this to the vector which provides the lanes 0 and 2 of the result.
+		@param b Set this to the vector which provides the lanes 1 and 3 of the result.
+		@return Returns (a[0], b[0], a[1], b[1]). */
+		inline static SIMDReal4 interleaveLow(const SIMDReal4 &a, const SIMDReal4 &b);
+
+		/** Interleaves the last two lanes of two vectors.
+		@param a Set this to the vector which provides the lanes 0 and 2 of the result.
+		@param b Set this to the vector which provides the lanes 1 and 3 of the result.
+		@return Returns (a[2], b[2], a[3], b[3]). */
+		inline static SIMDReal4 interleaveHigh(const SIMDReal4 &a, const SIMDReal4 &b);
+
+		/** Transposes the 4x4 matrix which consists of the four row vectors in place.
+		@param row0 Set this to the first row. It is replaced by the first column.
+		@param row1 Set this to the second row. It is replaced by the second column.
+		@param row2 Set this to the third row. It is replaced by the third column.
+		@param row3 Set this to the fourth row. It is replaced by the fourth column. */
+		inline static void transpose(SIMDReal4 &row0, SIMDReal4 &row1, SIMDReal4 &row2, SIMDReal4 &row3);
+
+	public:
+		/** Creates a vector with undefined lanes. */
+		inline SIMDReal4();
+
+		/** Stores all four lanes to memory which does not need to be aligned.
+		@param target Set this to the memory of four Reals which receive the lanes. */
+		inline void store(Real *target) const;
+
+		/** Stores the first three lanes to memory which does not need to be aligned, e.g., to a Vector3.
+		@param target Set this to the memory of three Reals which receive the lanes 0, 1 and 2. The Real behind them is not accessed. */
+		inline void store3(Real *target) const;
+
+		/** Rearranges the lanes of this vector.
+		@tparam X Set this to the index of the lane of this vector which is moved to the first lane.
+		@tparam Y Set this to the index of the lane of this vector which is moved to the second lane.
+		@tparam Z Set this to the index of the lane of this vector which is moved to the third lane.
+		@tparam W Set this to the index of the lane of this vector which is moved to the fourth lane.
+		@return Returns (this[X], this[Y], this[Z], this[W]). */
+		template <int X, int Y, int Z, int W>
+		inline SIMDReal4 shuffle() const;
+
+		/** Adds up all four lanes in the order (lane0 + lane2) + (lane1 + lane3).
+		@return Returns the sum of all lanes. */
+		inline Real sum() const;
+
+		/** Computes the square root of each lane.
+		@return Returns the lane-wise square roots of this vector. */
+		inline SIMDReal4 squareRoot() const;
+
+		inline SIMDReal4 operator +(const SIMDReal4 &rhs) const;
+		inline SIMDReal4 operator -(const SIMDReal4 &rhs) const;
+		inline SIMDReal4 operator *(const SIMDReal4 &rhs) const;
+		inline SIMDReal4 operator /(const SIMDReal4 &rhs) const;
+
+	private:
+		#if defined(MATH_SIMD_AVX)
+			inline SIMDReal4(const __m256d &lanes) : mLanes(lanes) { }
+			__m256d mLanes;				/// All four lanes.
+		#elif defined(MATH_SIMD_SSE2)
+			inline SIMDReal4(const __m128d &low, const __m128d &high) : mLow(low), mHigh(high) { }
+			__m128d mLow;				/// Lanes 0 and 1.
+			__m128d mHigh;				/// Lanes 2 and 3.
+		#elif defined(MATH_SIMD_SSE)
+			inline SIMDReal4(const __m128 &lanes) : mLanes(lanes) { }
+			__m128 mLanes;				/// All four lanes.
+		#elif defined(MATH_SIMD_NEON) && defined(DOUBLE_PRECISION)
+			inline SIMDReal4(const float64x2_t &low, const float64x2_t &high) : mLow(low), mHigh(high) { }
+			float64x2_t mLow;			/// Lanes 0 and 1.
+			float64x2_t mHigh;			/// Lanes 2 and 3.
+		#elif defined(MATH_SIMD_NEON)
+			inline SIMDReal4(const float32x4_t &lanes) : mLanes(lanes) { }
+			float32x4_t mLanes;			/// All four lanes.
+		#else
+			Real mLanes[4];				/// All four lanes.
+		#endif
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline & template function definitions   /////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline SIMDReal4::SIMDReal4()
+	{
+
+	}
+
+	inline SIMDReal4 SIMDReal4::set(Real x, Real y, Real z, Real w)
+	{
+		const Real lanes[4] = { x, y, z, w };
+		return load(lanes);
+	}
+
+	#if defined(MATH_SIMD_AVX)
+
+	inline SIMDReal4 SIMDReal4::load(const Real *source)
+	{
+		return SIMDReal4(_mm256_loadu_pd(source));
+	}
+
+	inline SIMDReal4 SIMDReal4::splat(Real value)
+	{
+		return SIMDReal4(_mm256_set1_pd(value));
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveLow(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return SIMDReal4(_mm256_permute2f128_pd(_mm256_unpacklo_pd(a.mLanes, b.mLanes), _mm256_unpackhi_pd(a.mLanes, b.mLanes), 0x20));
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveHigh(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return SIMDReal4(_mm256_permute2f128_pd(_mm256_unpacklo_pd(a.mLanes, b.mLanes), _mm256_unpackhi_pd(a.mLanes, b.mLanes), 0x31));
+	}
+
+	inline void SIMDReal4::transpose(SIMDReal4 &row0, SIMDReal4 &row1, SIMDReal4 &row2, SIMDReal4 &row3)
+	{
+		const __m256d t0 = _mm256_unpacklo_pd(row0.mLanes, row1.mLanes);
+		const __m256d t1 = _mm256_unpackhi_pd(row0.mLanes, row1.mLanes);
+		const __m256d t2 = _mm256_unpacklo_pd(row2.mLanes, row3.mLanes);
+		const __m256d t3 = _mm256_unpackhi_pd(row2.mLanes, row3.mLanes);
+
+		row0.mLanes = _mm256_permute2f128_pd(t0, t2, 0x20);
+		row1.mLanes = _mm256_permute2f128_pd(t1, t3, 0x20);
+		row2.mLanes = _mm256_permute2f128_pd(t0, t2, 0x31);
+		row3.mLanes = _mm256_permute2f128_pd(t1, t3, 0x31);
+	}
+
+	inline void SIMDReal4::store(Real *target) const
+	{
+		_mm256_storeu_pd(target, mLanes);
+	}
+
+	inline void SIMDReal4::store3(Real *target) const
+	{
+		_mm_storeu_pd(target, _mm256_castpd256_pd128(mLanes));
+		_mm_store_sd(target + 2, _mm256_extractf128_pd(mLanes, 1));
+	}
+
+	template <int X, int Y, int Z, int W>
+	inline SIMDReal4 SIMDReal4::shuffle() const
+	{
+		// select within both 128 bit halves of copies of the low and high half, then blend
+		const __m256d low = _mm256_permute2f128_pd(mLanes, mLanes, 0x00);
+		const __m256d high = _mm256_permute2f128_pd(mLanes, mLanes, 0x11);
+		const int selection = (X & 1) | ((Y & 1) << 1) | ((Z & 1) << 2) | ((W & 1) << 3);
+		const int halves = (X >> 1) | ((Y >> 1) << 1) | ((Z >> 1) << 2) | ((W >> 1) << 3);
+		return SIMDReal4(_mm256_blend_pd(_mm256_permute_pd(low, selection), _mm256_permute_pd(high, selection), halves));
+	}
+
+	inline Real SIMDReal4::sum() const
+	{
+		const __m128d pairs = _mm_add_pd(_mm256_castpd256_pd128(mLanes), _mm256_extractf128_pd(mLanes, 1));
+		return _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+	}
+
+	inline SIMDReal4 SIMDReal4::squareRoot() const
+	{
+		return SIMDReal4(_mm256_sqrt_pd(mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator +(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm256_add_pd(mLanes, rhs.mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator -(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm256_sub_pd(mLanes, rhs.mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator *(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm256_mul_pd(mLanes, rhs.mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator /(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm256_div_pd(mLanes, rhs.mLanes));
+	}
+
+	#elif defined(MATH_SIMD_SSE2)
+
+	inline SIMDReal4 SIMDReal4::load(const Real *source)
+	{
+		return SIMDReal4(_mm_loadu_pd(source), _mm_loadu_pd(source + 2));
+	}
+
+	inline SIMDReal4 SIMDReal4::splat(Real value)
+	{
+		const __m128d lanes = _mm_set1_pd(value);
+		return SIMDReal4(lanes, lanes);
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveLow(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return SIMDReal4(_mm_unpacklo_pd(a.mLow, b.mLow), _mm_unpackhi_pd(a.mLow, b.mLow));
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveHigh(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return SIMDReal4(_mm_unpacklo_pd(a.mHigh, b.mHigh), _mm_unpackhi_pd(a.mHigh, b.mHigh));
+	}
+
+	inline void SIMDReal4::transpose(SIMDReal4 &row0, SIMDReal4 &row1, SIMDReal4 &row2, SIMDReal4 &row3)
+	{
+		const SIMDReal4 column0(_mm_unpacklo_pd(row0.mLow, row1.mLow), _mm_unpacklo_pd(row2.mLow, row3.mLow));
+		const SIMDReal4 column1(_mm_unpackhi_pd(row0.mLow, row1.mLow), _mm_unpackhi_pd(row2.mLow, row3.mLow));
+		const SIMDReal4 column2(_mm_unpacklo_pd(row0.mHigh, row1.mHigh), _mm_unpacklo_pd(row2.mHigh, row3.mHigh));
+		const SIMDReal4 column3(_mm_unpackhi_pd(row0.mHigh, row1.mHigh), _mm_unpackhi_pd(row2.mHigh, row3.mHigh));
+
+		row0 = column0;
+		row1 = column1;
+		row2 = column2;
+		row3 = column3;
+	}
+
+	inline void SIMDReal4::store(Real *target) const
+	{
+		_mm_storeu_pd(target, mLow);
+		_mm_storeu_pd(target + 2, mHigh);
+	}
+
+	inline void SIMDReal4::store3(Real *target) const
+	{
+		_mm_storeu_pd(target, mLow);
+		_mm_store_sd(target + 2, mHigh);
+	}
+
+	template <int X, int Y, int Z, int W>
+	inline SIMDReal4 SIMDReal4::shuffle() const
+	{
+		return SIMDReal4(
+			_mm_shuffle_pd(X < 2 ? mLow : mHigh, Y < 2 ? mLow : mHigh, (X & 1) | ((Y & 1) << 1)),
+			_mm_shuffle_pd(Z < 2 ? mLow : mHigh, W < 2 ? mLow : mHigh, (Z & 1) | ((W & 1) << 1)));
+	}
+
+	inline Real SIMDReal4::sum() const
+	{
+		const __m128d pairs = _mm_add_pd(mLow, mHigh);
+		return _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+	}
+
+	inline SIMDReal4 SIMDReal4::squareRoot() const
+	{
+		return SIMDReal4(_mm_sqrt_pd(mLow), _mm_sqrt_pd(mHigh));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator +(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm_add_pd(mLow, rhs.mLow), _mm_add_pd(mHigh, rhs.mHigh));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator -(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm_sub_pd(mLow, rhs.mLow), _mm_sub_pd(mHigh, rhs.mHigh));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator *(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm_mul_pd(mLow, rhs.mLow), _mm_mul_pd(mHigh, rhs.mHigh));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator /(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm_div_pd(mLow, rhs.mLow), _mm_div_pd(mHigh, rhs.mHigh));
+	}
+
+	#elif defined(MATH_SIMD_SSE)
+
+	inline SIMDReal4 SIMDReal4::load(const Real *source)
+	{
+		return SIMDReal4(_mm_loadu_ps(source));
+	}
+
+	inline SIMDReal4 SIMDReal4::splat(Real value)
+	{
+		return SIMDReal4(_mm_set1_ps(value));
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveLow(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return SIMDReal4(_mm_unpacklo_ps(a.mLanes, b.mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveHigh(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return SIMDReal4(_mm_unpackhi_ps(a.mLanes, b.mLanes));
+	}
+
+	inline void SIMDReal4::transpose(SIMDReal4 &row0, SIMDReal4 &row1, SIMDReal4 &row2, SIMDReal4 &row3)
+	{
+		_MM_TRANSPOSE4_PS(row0.mLanes, row1.mLanes, row2.mLanes, row3.mLanes);
+	}
+
+	inline void SIMDReal4::store(Real *target) const
+	{
+		_mm_storeu_ps(target, mLanes);
+	}
+
+	inline void SIMDReal4::store3(Real *target) const
+	{
+		_mm_storel_pi(reinterpret_cast<__m64 *>(target), mLanes);
+		_mm_store_ss(target + 2, _mm_movehl_ps(mLanes, mLanes));
+	}
+
+	template <int X, int Y, int Z, int W>
+	inline SIMDReal4 SIMDReal4::shuffle() const
+	{
+		return SIMDReal4(_mm_shuffle_ps(mLanes, mLanes, _MM_SHUFFLE(W, Z, Y, X)));
+	}
+
+	inline Real SIMDReal4::sum() const
+	{
+		const __m128 pairs = _mm_add_ps(mLanes, _mm_movehl_ps(mLanes, mLanes));
+		return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+	}
+
+	inline SIMDReal4 SIMDReal4::squareRoot() const
+	{
+		return SIMDReal4(_mm_sqrt_ps(mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator +(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm_add_ps(mLanes, rhs.mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator -(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm_sub_ps(mLanes, rhs.mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator *(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm_mul_ps(mLanes, rhs.mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator /(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(_mm_div_ps(mLanes, rhs.mLanes));
+	}
+
+	#elif defined(MATH_SIMD_NEON) && defined(DOUBLE_PRECISION)
+
+	inline SIMDReal4 SIMDReal4::load(const Real *source)
+	{
+		return SIMDReal4(vld1q_f64(source), vld1q_f64(source + 2));
+	}
+
+	inline SIMDReal4 SIMDReal4::splat(Real value)
+	{
+		const float64x2_t lanes = vdupq_n_f64(value);
+		return SIMDReal4(lanes, lanes);
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveLow(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return SIMDReal4(vzip1q_f64(a.mLow, b.mLow), vzip2q_f64(a.mLow, b.mLow));
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveHigh(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return SIMDReal4(vzip1q_f64(a.mHigh, b.mHigh), vzip2q_f64(a.mHigh, b.mHigh));
+	}
+
+	inline void SIMDReal4::transpose(SIMDReal4 &row0, SIMDReal4 &row1, SIMDReal4 &row2, SIMDReal4 &row3)
+	{
+		const SIMDReal4 column0(vzip1q_f64(row0.mLow, row1.mLow), vzip1q_f64(row2.mLow, row3.mLow));
+		const SIMDReal4 column1(vzip2q_f64(row0.mLow, row1.mLow), vzip2q_f64(row2.mLow, row3.mLow));
+		const SIMDReal4 column2(vzip1q_f64(row0.mHigh, row1.mHigh), vzip1q_f64(row2.mHigh, row3.mHigh));
+		const SIMDReal4 column3(vzip2q_f64(row0.mHigh, row1.mHigh), vzip2q_f64(row2.mHigh, row3.mHigh));
+
+		row0 = column0;
+		row1 = column1;
+		row2 = column2;
+		row3 = column3;
+	}
+
+	inline void SIMDReal4::store(Real *target) const
+	{
+		vst1q_f64(target, mLow);
+		vst1q_f64(target + 2, mHigh);
+	}
+
+	inline void SIMDReal4::store3(Real *target) const
+	{
+		vst1q_f64(target, mLow);
+		vst1q_lane_f64(target + 2, mHigh, 0);
+	}
+
+	template <int X, int Y, int Z, int W>
+	inline SIMDReal4 SIMDReal4::shuffle() const
+	{
+		float64x2_t low = vdupq_n_f64(vgetq_lane_f64(X < 2 ? mLow : mHigh, X & 1));
+		float64x2_t high = vdupq_n_f64(vgetq_lane_f64(Z < 2 ? mLow : mHigh, Z & 1));
+		low = vsetq_lane_f64(vgetq_lane_f64(Y < 2 ? mLow : mHigh, Y & 1), low, 1);
+		high = vsetq_lane_f64(vgetq_lane_f64(W < 2 ? mLow : mHigh, W & 1), high, 1);
+		return SIMDReal4(low, high);
+	}
+
+	inline Real SIMDReal4::sum() const
+	{
+		const float64x2_t pairs = vaddq_f64(mLow, mHigh);
+		return vgetq_lane_f64(pairs, 0) + vgetq_lane_f64(pairs, 1);
+	}
+
+	inline SIMDReal4 SIMDReal4::squareRoot() const
+	{
+		return SIMDReal4(vsqrtq_f64(mLow), vsqrtq_f64(mHigh));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator +(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(vaddq_f64(mLow, rhs.mLow), vaddq_f64(mHigh, rhs.mHigh));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator -(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(vsubq_f64(mLow, rhs.mLow), vsubq_f64(mHigh, rhs.mHigh));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator *(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(vmulq_f64(mLow, rhs.mLow), vmulq_f64(mHigh, rhs.mHigh));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator /(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(vdivq_f64(mLow, rhs.mLow), vdivq_f64(mHigh, rhs.mHigh));
+	}
+
+	#elif defined(MATH_SIMD_NEON)
+
+	inline SIMDReal4 SIMDReal4::load(const Real *source)
+	{
+		return SIMDReal4(vld1q_f32(source));
+	}
+
+	inline SIMDReal4 SIMDReal4::splat(Real value)
+	{
+		return SIMDReal4(vdupq_n_f32(value));
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveLow(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return SIMDReal4(vzipq_f32(a.mLanes, b.mLanes).val[0]);
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveHigh(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return SIMDReal4(vzipq_f32(a.mLanes, b.mLanes).val[1]);
+	}
+
+	inline void SIMDReal4::transpose(SIMDReal4 &row0, SIMDReal4 &row1, SIMDReal4 &row2, SIMDReal4 &row3)
+	{
+		const float32x4x2_t t0 = vzipq_f32(row0.mLanes, row2.mLanes);
+		const float32x4x2_t t1 = vzipq_f32(row1.mLanes, row3.mLanes);
+		const float32x4x2_t low = vzipq_f32(t0.val[0], t1.val[0]);
+		const float32x4x2_t high = vzipq_f32(t0.val[1], t1.val[1]);
+
+		row0.mLanes = low.val[0];
+		row1.mLanes = low.val[1];
+		row2.mLanes = high.val[0];
+		row3.mLanes = high.val[1];
+	}
+
+	inline void SIMDReal4::store(Real *target) const
+	{
+		vst1q_f32(target, mLanes);
+	}
+
+	inline void SIMDReal4::store3(Real *target) const
+	{
+		vst1_f32(target, vget_low_f32(mLanes));
+		vst1q_lane_f32(target + 2, mLanes, 2);
+	}
+
+	template <int X, int Y, int Z, int W>
+	inline SIMDReal4 SIMDReal4::shuffle() const
+	{
+		float32x4_t lanes = vdupq_n_f32(vgetq_lane_f32(mLanes, X));
+		lanes = vsetq_lane_f32(vgetq_lane_f32(mLanes, Y), lanes, 1);
+		lanes = vsetq_lane_f32(vgetq_lane_f32(mLanes, Z), lanes, 2);
+		lanes = vsetq_lane_f32(vgetq_lane_f32(mLanes, W), lanes, 3);
+		return SIMDReal4(lanes);
+	}
+
+	inline Real SIMDReal4::sum() const
+	{
+		const float32x2_t pairs = vadd_f32(vget_low_f32(mLanes), vget_high_f32(mLanes));
+		return vget_lane_f32(pairs, 0) + vget_lane_f32(pairs, 1);
+	}
+
+	inline SIMDReal4 SIMDReal4::squareRoot() const
+	{
+		#ifdef __aarch64__
+			return SIMDReal4(vsqrtq_f32(mLanes));
+		#else
+			// ARMv7 NEON has no exact square root
+			Real lanes[4];
+			store(lanes);
+			return set(sqrtr(lanes[0]), sqrtr(lanes[1]), sqrtr(lanes[2]), sqrtr(lanes[3]));
+		#endif // __aarch64__
+	}
+
+	inline SIMDReal4 SIMDReal4::operator +(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(vaddq_f32(mLanes, rhs.mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator -(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(vsubq_f32(mLanes, rhs.mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator *(const SIMDReal4 &rhs) const
+	{
+		return SIMDReal4(vmulq_f32(mLanes, rhs.mLanes));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator /(const SIMDReal4 &rhs) const
+	{
+		#ifdef __aarch64__
+			return SIMDReal4(vdivq_f32(mLanes, rhs.mLanes));
+		#else
+			// ARMv7 NEON has no exact division
+			Real lhsLanes[4];
+			Real rhsLanes[4];
+			store(lhsLanes);
+			rhs.store(rhsLanes);
+			return set(lhsLanes[0] / rhsLanes[0], lhsLanes[1] / rhsLanes[1], lhsLanes[2] / rhsLanes[2], lhsLanes[3] / rhsLanes[3]);
+		#endif // __aarch64__
+	}
+
+	#else // scalar backend
+
+	inline SIMDReal4 SIMDReal4::load(const Real *source)
+	{
+		SIMDReal4 result;
+		for (int i = 0; i < 4; ++i)
+			result.mLanes[i] = source[i];
+		return result;
+	}
+
+	inline SIMDReal4 SIMDReal4::splat(Real value)
+	{
+		SIMDReal4 result;
+		for (int i = 0; i < 4; ++i)
+			result.mLanes[i] = value;
+		return result;
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveLow(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return set(a.mLanes[0], b.mLanes[0], a.mLanes[1], b.mLanes[1]);
+	}
+
+	inline SIMDReal4 SIMDReal4::interleaveHigh(const SIMDReal4 &a, const SIMDReal4 &b)
+	{
+		return set(a.mLanes[2], b.mLanes[2], a.mLanes[3], b.mLanes[3]);
+	}
+
+	inline void SIMDReal4::transpose(SIMDReal4 &row0, SIMDReal4 &row1, SIMDReal4 &row2, SIMDReal4 &row3)
+	{
+		SIMDReal4 *rows[4] = { &row0, &row1, &row2, &row3 };
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int j = i + 1; j < 4; ++j)
+			{
+				const Real temp = rows[i]->mLanes[j];
+				rows[i]->mLanes[j] = rows[j]->mLanes[i];
+				rows[j]->mLanes[i] = temp;
+			}
+		}
+	}
+
+	inline void SIMDReal4::store(Real *target) const
+	{
+		for (int i = 0; i < 4; ++i)
+			target[i] = mLanes[i];
+	}
+
+	inline void SIMDReal4::store3(Real *target) const
+	{
+		for (int i = 0; i < 3; ++i)
+			target[i] = mLanes[i];
+	}
+
+	template <int X, int Y, int Z, int W>
+	inline SIMDReal4 SIMDReal4::shuffle() const
+	{
+		return set(mLanes[X], mLanes[Y], mLanes[Z], mLanes[W]);
+	}
+
+	inline Real SIMDReal4::sum() const
+	{
+		return (mLanes[0] + mLanes[2]) + (mLanes[1] + mLanes[3]);
+	}
+
+	inline SIMDReal4 SIMDReal4::squareRoot() const
+	{
+		return set(sqrtr(mLanes[0]), sqrtr(mLanes[1]), sqrtr(mLanes[2]), sqrtr(mLanes[3]));
+	}
+
+	inline SIMDReal4 SIMDReal4::operator +(const SIMDReal4 &rhs) const
+	{
+		return set(mLanes[0] + rhs.mLanes[0], mLanes[1] + rhs.mLanes[1], mLanes[2] + rhs.mLanes[2], mLanes[3] + rhs.mLanes[3]);
+	}
+
+	inline SIMDReal4 SIMDReal4::operator -(const SIMDReal4 &rhs) const
+	{
+		return set(mLanes[0] - rhs.mLanes[0], mLanes[1] - rhs.mLanes[1], mLanes[2] - rhs.mLanes[2], mLanes[3] - rhs.mLanes[3]);
+	}
+
+	inline SIMDReal4 SIMDReal4::operator *(const SIMDReal4 &rhs) const
+	{
+		return set(mLanes[0] * rhs.mLanes[0], mLanes[1] * rhs.mLanes[1], mLanes[2] * rhs.mLanes[2], mLanes[3] * rhs.mLanes[3]);
+	}
+
+	inline SIMDReal4 SIMDReal4::operator /(const SIMDReal4 &rhs) const
+	{
+		return set(mLanes[0] / rhs.mLanes[0], mLanes[1] / rhs.mLanes[1], mLanes[2] / rhs.mLanes[2], mLanes[3] / rhs.mLanes[3]);
+	}
+
+	#endif // MATH_SIMD_AVX, MATH_SIMD_SSE2, MATH_SIMD_SSE, MATH_SIMD_NEON
+}
+
+#endif // _MATH_SIMD_H_
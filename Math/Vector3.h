@@ -17,6 +17,7 @@
 #include "Math/MathCore.h"
 #include "Math/Matrix3x3.h"
 #include "Math/Matrix4x4.h"
+#include "Math/SIMD.h"
 
 namespace Math
 {
@@ -427,9 +428,14 @@ namespace Math
 
 	inline Vector3 Vector3::operator *(const Matrix4x4 &rhs) const
 	{
-		return Vector3(	x * rhs.m00 + y * rhs.m10 + z * rhs.m20,
-						x * rhs.m01 + y * rhs.m11 + z * rhs.m21,
-						x * rhs.m02 + y * rhs.m12 + z * rhs.m22);
+		// linear combination of the upper matrix rows, the fourth lane is dropped
+		const SIMDReal4 product =
+			SIMDReal4::splat(x) * SIMDReal4::load(rhs.values[0]) + SIMDReal4::splat(y) * SIMDReal4::load(rhs.values[1]) +
+			SIMDReal4::splat(z) * SIMDReal4::load(rhs.values[2]);
+
+		Real result[4];
+		product.store(result);
+		return Vector3(result[0], result[1], result[2]);
 	}
 
 	inline Matrix3x3 Vector3::outerProduct(const Vector3 &rhs) const
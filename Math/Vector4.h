@@ -16,6 +16,7 @@
 #include <iostream>
 #include "Math/MathCore.h"
 #include "Math/Matrix4x4.h"
+#include "Math/SIMD.h"
 
 namespace Math
 {
@@ -292,10 +293,14 @@ namespace Math
 
 	inline Vector4 Vector4::operator *(const Matrix4x4 &rhs) const
 	{
-		return Vector4(	x * rhs.m00 + y * rhs.m10 + z * rhs.m20 + w * rhs.m30,
-						x * rhs.m01 + y * rhs.m11 + z * rhs.m21 + w * rhs.m31,
-						x * rhs.m02 + y * rhs.m12 + z * rhs.m22 + w * rhs.m32,
-						x * rhs.m03 + y * rhs.m13 + z * rhs.m23 + w * rhs.m33);
+		// linear combination of the matrix rows
+		const SIMDReal4 product =
+			SIMDReal4::splat(x) * SIMDReal4::load(rhs.values[0]) + SIMDReal4::splat(y) * SIMDReal4::load(rhs.values[1]) +
+			SIMDReal4::splat(z) * SIMDReal4::load(rhs.values[2]) + SIMDReal4::splat(w) * SIMDReal4::load(rhs.values[3]);
+
+		Vector4 result;
+		product.store(result.getData());
+		return result;
 	}
 				
 	inline bool Vector4::areOrthogonal(const Vector4 &rhs) const
@@ -305,7 +310,8 @@ namespace Math
 
 	inline Real Vector4::dotProduct(const Vector4 &rhs) const
 	{
-		return x * rhs.x + y * rhs.y + z * rhs.z + w * rhs.w;
+		// summation order (x + z) + (y + w) of SIMDReal4::sum()
+		return (SIMDReal4::load(getData()) * SIMDReal4::load(rhs.getData())).sum();
 	}
 
 	inline Real Vector4::dotProductAbsolute(const Vector4 &rhs) const
@@ -7,6 +7,7 @@
  */
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -17,6 +18,7 @@
 #include "Math/Matrix4x4.h"
 #include "Math/Polybezier.h"
 #include "Math/Quaternion.h"
+#include "Math/SIMD.h"
 #include "Math/Vector2.h"
 #include "Math/Vector3.h"
 #include "Math/Vector4.h"
@@ -649,6 +651,109 @@ void testQuat()
 	cout << qZ << endl;
 }
 
+/** Checks that four lanes have exactly the same bits as four expected Reals.
+@param lanes Set this to the tested SIMD vector.
+@param x Set this to the expected first lane.
+@param y Set this to the expected second lane.
+@param z Set this to the expected third lane.
+@param w Set this to the expected fourth lane.
+@return Returns true if all lanes are bitwise equal to the expected values. */
+bool equalLanes(const SIMDReal4 &lanes, Real x, Real y, Real z, Real w)
+{
+	Real stored[4];
+	const Real expected[4] = { x, y, z, w };
+	lanes.store(stored);
+	return 0 == memcmp(stored, expected, sizeof(expected));
+}
+
+void testSIMD()
+{
+	cout << "SIMD tests (" << (sizeof(Real) == sizeof(double) ? "double" : "float") << "), compared with the scalar backend:\n";
+
+	// the scalar backend computes the same lane-wise operations with plain Reals
+	const uint32 numIterations = 10000;
+	bool correct[14] = { true, true, true, true, true, true, true, true, true, true, true, true, true, true };
+
+	for (uint32 i = 0; i < numIterations; ++i)
+	{
+		Real a[4];
+		Real b[4];
+		Real c[4];
+		Real d[4];
+		for (uint32 lane = 0; lane < 4; ++lane)
+		{
+			a[lane] = realRandom();
+			b[lane] = realRandom();
+			c[lane] = realRandom();
+			d[lane] = realRandom();
+			if (0.0f == b[lane])
+				b[lane] = 1.0f;
+		}
+
+		const SIMDReal4 va = SIMDReal4::load(a);
+		const SIMDReal4 vb = SIMDReal4::load(b);
+		const SIMDReal4 vc = SIMDReal4::load(c);
+		const SIMDReal4 vd = SIMDReal4::load(d);
+
+		// creation & storing
+		correct[0] &= equalLanes(va, a[0], a[1], a[2], a[3]);
+		correct[1] &= equalLanes(SIMDReal4::set(a[0], b[1], c[2], d[3]), a[0], b[1], c[2], d[3]);
+		correct[2] &= equalLanes(SIMDReal4::splat(c[1]), c[1], c[1], c[1], c[1]);
+
+		Real stored3[4] = { d[0], d[1], d[2], d[3] };
+		va.store3(stored3);
+		correct[3] &= (stored3[0] == a[0] && stored3[1] == a[1] && stored3[2] == a[2] && stored3[3] == d[3]);
+
+		// lane rearrangements
+		correct[4] &= equalLanes(SIMDReal4::interleaveLow(va, vb), a[0], b[0], a[1], b[1]);
+		correct[5] &= equalLanes(SIMDReal4::interleaveHigh(va, vb), a[2], b[2], a[3], b[3]);
+
+		SIMDReal4 r0 = va;
+		SIMDReal4 r1 = vb;
+		SIMDReal4 r2 = vc;
+		SIMDReal4 r3 = vd;
+		SIMDReal4::transpose(r0, r1, r2, r3);
+		correct[6] &= equalLanes(r0, a[0], b[0], c[0], d[0]) && equalLanes(r1, a[1], b[1], c[1], d[1]) &&
+			equalLanes(r2, a[2], b[2], c[2], d[2]) && equalLanes(r3, a[3], b[3], c[3], d[3]);
+
+		correct[7] &= equalLanes(va.shuffle<0, 1, 2, 3>(), a[0], a[1], a[2], a[3]) &&
+			equalLanes(va.shuffle<3, 2, 1, 0>(), a[3], a[2], a[1], a[0]) &&
+			equalLanes(va.shuffle<1, 2, 0, 3>(), a[1], a[2], a[0], a[3]) &&
+			equalLanes(va.shuffle<0, 0, 0, 1>(), a[0], a[0], a[0], a[1]) &&
+			equalLanes(va.shuffle<3, 3, 3, 3>(), a[3], a[3], a[3], a[3]) &&
+			equalLanes(va.shuffle<2, 3, 2, 3>(), a[2], a[3], a[2], a[3]);
+
+		// arithmetic
+		const Real sum = va.sum();
+		const Real expectedSum = (a[0] + a[2]) + (a[1] + a[3]);
+		correct[8] &= (0 == memcmp(&sum, &expectedSum, sizeof(Real)));
+
+		const SIMDReal4 positive = va * va;
+		correct[9] &= equalLanes(positive.squareRoot(), sqrtr(a[0] * a[0]), sqrtr(a[1] * a[1]), sqrtr(a[2] * a[2]), sqrtr(a[3] * a[3]));
+		correct[10] &= equalLanes(va + vb, a[0] + b[0], a[1] + b[1], a[2] + b[2], a[3] + b[3]);
+		correct[11] &= equalLanes(va - vb, a[0] - b[0], a[1] - b[1], a[2] - b[2], a[3] - b[3]);
+		correct[12] &= equalLanes(va * vb, a[0] * b[0], a[1] * b[1], a[2] * b[2], a[3] * b[3]);
+		correct[13] &= equalLanes(va / vb, a[0] / b[0], a[1] / b[1], a[2] / b[2], a[3] / b[3]);
+	}
+
+	test("SIMD load & store", correct[0]);
+	test("SIMD set", correct[1]);
+	test("SIMD splat", correct[2]);
+	test("SIMD store3", correct[3]);
+	test("SIMD interleaveLow", correct[4]);
+	test("SIMD interleaveHigh", correct[5]);
+	test("SIMD transpose", correct[6]);
+	test("SIMD shuffle", correct[7]);
+	test("SIMD sum", correct[8]);
+	test("SIMD squareRoot", correct[9]);
+	test("SIMD addition", correct[10]);
+	test("SIMD subtraction", correct[11]);
+	test("SIMD multiplication", correct[12]);
+	test("SIMD division", correct[13]);
+
+	cout << endl;
+}
+
 void testVector4()
 {
 	Vector4 v1(2.0f, 3.0f, 4.0f, 5.0f);
@@ -703,6 +808,7 @@ int main(int argc, char** argv)
 {
 	testEigensystemsFor2x2Matrices();
 	testEigensystemsForSymmetric3x3Matrices();
+	testSIMD();
 	testVector4();
 	testVector3();
 	testMatrix3x3();
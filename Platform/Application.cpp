@@ -10,11 +10,15 @@
 #endif // _WINDOWS
 
 #include <chrono>
+#include <map>
 #include <thread>
 #include "Platform/Application.h"
 #include "Platform/Input/InputManager.h"
 #include "Platform/Multithreading/Manager.h"
 #include "Platform/Profiling/FrameRateCalculator.h"
+#include "Platform/Profiling/MetricsRegistry.h"
+#include "Platform/Profiling/Profiler.h"
+#include "Platform/Profiling/ScopedZone.h"
 #include "Platform/ResourceManagement/MemoryManager.h"
 #include "Platform/Storage/File.h"
 #include "Platform/Storage/Storage.h"
@@ -41,6 +45,11 @@ Application::Application
 	const string &configurationFileName
 ) :
 	mFrameRateCalculator(NULL),
+	mMetricsExporter(NULL),
+	mFrameCounter(NULL),
+	mStutterCounter(NULL),
+	mFrameRate(NULL),
+	mFrameTimes(NULL),
 	mWantedFrameTime(1.0f / 60.0f),
 	mInterpretingTextInput(false),
 	mRunning(true),
@@ -68,6 +77,115 @@ Application::Application
 
 	// input manager depends on window
 	InputManager *inputManager = new InputManager();
+
+	// runtime metrics depend on the work manager & frame rate calculator
+	createMetrics();
+}
+
+void Application::createMetrics()
+{
+	MetricsRegistry *registry = new MetricsRegistry();
+
+	// main loop
+	const vector<double> frameTimeBounds = Histogram::createExponentialBounds(0.001, 2.0, 12);
+	mFrameCounter = &registry->addCounter("frames_total", "Number of frames with measured phase times.");
+	mStutterCounter = &registry->addCounter("frame_stutters_total", "Number of frames which took much longer than wanted.");
+	mFrameTimes = &registry->addHistogram("frame_time_seconds", "Duration of complete frames.", frameTimeBounds);
+	for (uint32 phaseIdx = 0; phaseIdx < FrameRateCalculator::PHASE_COUNT; ++phaseIdx)
+	{
+		const string labels = string("phase=\"") + FrameRateCalculator::getPhaseName((FrameRateCalculator::PHASE) phaseIdx) + "\"";
+		mPhaseTimes[phaseIdx] = &registry->addHistogram("frame_phase_time_seconds", "Duration of the phases of frames.", frameTimeBounds, labels);
+	}
+
+	mFrameRate = &registry->addGauge("frames_per_second", "Average frame rate of the last frame rate period.");
+
+	// zones of the profiler call trees
+	#ifdef PROFILING
+		registry->addCollector([registry] ()
+		{
+			if (!Profiler::exists())
+				return;
+
+			const vector<double> zoneTimeBounds = Histogram::createExponentialBounds(1e-6, 4.0, 12);
+			const size_t boundCount = zoneTimeBounds.size();
+			vector<uint64> bucketCounts(boundCount + 1);
+
+			map<string, TimeMeasurements> zones;
+			Profiler::getSingleton().getZoneStatistics(zones);
+			for (map<string, TimeMeasurements>::const_iterator it = zones.begin(); it != zones.end(); ++it)
+			{
+				// non cumulative bucket counts from the call tree statistics which are merged over all threads
+				const TimeMeasurements &times = it->second;
+				uint64 previousCount = 0;
+				for (size_t boundIdx = 0; boundIdx < boundCount; ++boundIdx)
+				{
+					const uint64 count = times.getCountUpTo(zoneTimeBounds[boundIdx]);
+					bucketCounts[boundIdx] = count - previousCount;
+					previousCount = count;
+				}
+				bucketCounts[boundCount] = times.getCount() - previousCount;
+
+				const string labels = "zone=\"" + MetricsRegistry::escapeLabelValue(it->first) + "\"";
+				Histogram &zoneTimes = registry->addHistogram("profiler_zone_time_seconds", "Duration of profiler zones.", zoneTimeBounds, labels);
+				zoneTimes.assign(bucketCounts.data(), times.getSummedTime());
+			}
+		});
+	#endif // PROFILING
+
+	// tasks
+	Gauge *queuedTasks = &registry->addGauge("task_queue_depth", "Number of tasks which wait for a worker thread.");
+	Gauge *workers = &registry->addGauge("task_worker_threads", "Number of worker threads of the task manager.");
+	registry->addCollector([queuedTasks, workers] ()
+	{
+		if (!Multithreading::Manager::exists())
+			return;
+
+		const Multithreading::Manager &manager = Multithreading::Manager::getSingleton();
+		queuedTasks->set(manager.getQueuedTaskCount());
+		workers->set(manager.getThreadCount());
+	});
+
+	// memory
+	#ifdef MEMORY_MANAGEMENT
+		registry->addCollector([registry] ()
+		{
+			const ResourceManagement::MemoryManager &memoryManager = ResourceManagement::MemoryManager::getSingleton();
+			const uint32 poolCount = memoryManager.getMemoryPoolCount();
+			for (uint32 poolIdx = 0; poolIdx < poolCount; ++poolIdx)
+			{
+				const ResourceManagement::MemoryPool::Statistics statistics = memoryManager.getMemoryPoolStatistics(poolIdx);
+				const string labels = "pool=\"" + to_string(poolIdx) + "\"";
+				registry->addGauge("memory_pool_capacity_bytes", "Bytes which are managed by the buckets of a memory pool.", labels).set((double) statistics.mBucketCapacity);
+				registry->addGauge("memory_pool_used_bytes", "Bytes of the bucket chunks which are requested from a memory pool.", labels).set((double) statistics.mBucketBytesInUse);
+				registry->addGauge("memory_pool_fallback_blocks", "Blocks of a memory pool which are provided by malloc since its buckets could not serve them.", labels).set((double) statistics.mFallbackBlockCount);
+			}
+		});
+	#endif // MEMORY_MANAGEMENT
+
+	#if defined(MEMORY_MANAGEMENT) && defined(HEAP_PROFILING)
+		Gauge *sampledLiveBytes = &registry->addGauge("heap_sampled_live_bytes", "Bytes of live allocations sampled by the heap profiler.");
+		Gauge *sampledPeakBytes = &registry->addGauge("heap_sampled_peak_live_bytes", "Peak of the bytes of live allocations sampled by the heap profiler.");
+		registry->addCollector([sampledLiveBytes, sampledPeakBytes] ()
+		{
+			const ResourceManagement::HeapProfiler::Statistics statistics =
+				ResourceManagement::MemoryManager::getSingleton().getHeapProfiler().getStatistics();
+			sampledLiveBytes->set((double) statistics.mLiveBytes);
+			sampledPeakBytes->set((double) statistics.mPeakLiveBytes);
+		});
+	#endif // MEMORY_MANAGEMENT && HEAP_PROFILING
+
+	// export target
+	const ParametersManager &manager = ParametersManager::getSingleton();
+	string metricsFile;
+	string metricsSocket;
+	Real period;
+	if (!manager.get(period, "Platform::Profiling::metricsPeriod"))
+		period = (Real) MetricsExporter::DEFAULT_PERIOD;
+
+	if (manager.get(metricsSocket, "Platform::Profiling::metricsSocket") && !metricsSocket.empty())
+		mMetricsExporter = new MetricsExporter(metricsSocket, MetricsExporter::TARGET_UNIX_SOCKET);
+	else if (manager.get(metricsFile, "Platform::Profiling::metricsFile") && !metricsFile.empty())
+		mMetricsExporter = new MetricsExporter(metricsFile, MetricsExporter::TARGET_FILE, period);
 }
 
 void Application::createWindow
@@ -89,6 +207,9 @@ void Application::createWindow
 	string title;
 	ImgSize size;
 	Real timePeriodPerFPSMeasurement;
+	Real stutterThresholdFactor;
+	string stutterCapturePath;
+	uint32 maxStutterCaptures;
 	uint32 depthBitsPerPixel;
 	uint32 stencilBitsPerPixel;
 	uint32 maxFrameRate;
@@ -111,6 +232,12 @@ void Application::createWindow
 		maxFrameRate = 60;
 	if (!manager.get(timePeriodPerFPSMeasurement, "Platform::timePeriodPerFPSMeasurement"))
 		timePeriodPerFPSMeasurement = 1.0f;
+	if (!manager.get(stutterThresholdFactor, "Platform::stutterThresholdFactor"))
+		stutterThresholdFactor = 3.0f;
+	if (!manager.get(stutterCapturePath, "Platform::stutterCapturePath"))
+		stutterCapturePath = "";
+	if (!manager.get(maxStutterCaptures, "Platform::maxStutterCaptures"))
+		maxStutterCaptures = 8;
 
 	// create window & register observer
 	Window *window = 
@@ -128,11 +255,20 @@ void Application::createWindow
 
 	// over which time period do we measure / average FPS measurements
 	if (timePeriodPerFPSMeasurement > 0.0f)
+	{
 		mFrameRateCalculator = new FrameRateCalculator(timePeriodPerFPSMeasurement);
+		mFrameRateCalculator->enableStutterDetection(mWantedFrameTime, stutterThresholdFactor, stutterCapturePath, maxStutterCaptures);
+	}
 }
 
 Application::~Application()
 {
+	// metric collectors access the frame rate calculator & managers
+	delete mMetricsExporter;
+	mMetricsExporter = NULL;
+	if (MetricsRegistry::exists())
+		delete MetricsRegistry::getSingletonPointer();
+
 	delete mFrameRateCalculator;
 
 	// release singletons
@@ -206,22 +342,52 @@ int64 Application::run()
 				continue;
 		#endif // _WINDOWS
 
+		if (mFrameRateCalculator)
+			mFrameRateCalculator->beginFrame();
+
+		#ifdef PROFILING
+			if (Profiler::exists())
+				Profiler::getSingleton().markFrame();
+		#endif // PROFILING
+
 		// 01 input
-		InputManager::getSingleton().update();	
+		{
+			PROFILE_ZONE("Input");
+			InputManager::getSingleton().update();
+		}
+		if (mFrameRateCalculator)
+			mFrameRateCalculator->endPhase(FrameRateCalculator::PHASE_INPUT);
 
 		// 02 update
-		updateCompletely();
+		{
+			PROFILE_ZONE("Update");
+			updateCompletely();
+		}
+		if (mFrameRateCalculator)
+			mFrameRateCalculator->endPhase(FrameRateCalculator::PHASE_UPDATE);
 
 		// 03 render
-		render();
+		{
+			PROFILE_ZONE("Render");
+			render();
+		}
 		if (mFrameRateCalculator)
+		{
+			mFrameRateCalculator->endPhase(FrameRateCalculator::PHASE_RENDER);
 			mFrameRateCalculator->onFrameRendered();
-
-		// 04 post render
-		postRender();
-
-		// 05 last things to do before next frame, is necessary due to crappy xlib input management
-		endFrame();
+		}
+
+		// 04 post render & 05 last things to do before next frame, is necessary due to crappy xlib input management
+		{
+			PROFILE_ZONE("Present");
+			postRender();
+			endFrame();
+		}
+		if (mFrameRateCalculator)
+		{
+			mFrameRateCalculator->endPhase(FrameRateCalculator::PHASE_PRESENT);
+			recordFrameMetrics(mFrameRateCalculator->endFrame());
+		}
 
 		// wait to restrict frame rate
 		wait();
@@ -230,6 +396,20 @@ int64 Application::run()
 	return 0;
 }
 
+void Application::recordFrameMetrics(const bool stutter)
+{
+	const FrameRateCalculator::FrameTimes &frame = mFrameRateCalculator->getRecentFrame(0);
+
+	mFrameCounter->increment();
+	if (stutter)
+		mStutterCounter->increment();
+	mFrameRate->set(mFrameRateCalculator->getFPS());
+
+	mFrameTimes->observe(frame.mTotalTime);
+	for (uint32 phaseIdx = 0; phaseIdx < FrameRateCalculator::PHASE_COUNT; ++phaseIdx)
+		mPhaseTimes[phaseIdx]->observe(frame.mPhaseTimes[phaseIdx]);
+}
+
 void Application::updateCompletely()
 {
 	ApplicationTimer::getSingleton().update();
@@ -11,6 +11,8 @@
 #include "Patterns/Singleton.h"
 #include "Platform/Input/TextInput.h"
 #include "Platform/Profiling/FrameRateCalculator.h"
+#include "Platform/Profiling/Metrics.h"
+#include "Platform/Profiling/MetricsExporter.h"
 #include "Platform/Window.h"
 
 namespace Platform
@@ -89,7 +91,8 @@ namespace Platform
 	private:
 		/** Copy constructor is forbidden.
 		@param rhs Don't call it, it fails.*/
-		Application(const Application &rhs) : mFrameRateCalculator(NULL), mWantedFrameTime(-1.0f),
+		Application(const Application &rhs) : mFrameRateCalculator(NULL), mMetricsExporter(NULL), mFrameCounter(NULL),
+			mStutterCounter(NULL), mFrameRate(NULL), mFrameTimes(NULL), mWantedFrameTime(-1.0f),
 			mInterpretingTextInput(false), mRunning(false), mRunningSlowly(false)
 		{
 			assert(false);
@@ -104,6 +107,10 @@ namespace Platform
 			return *this;
 		}
 
+		/** Creates the MetricsRegistry, registers the main loop and task metrics and starts a MetricsExporter if the configuration defines a target.
+			Configuration parameters are Platform::Profiling::metricsFile, Platform::Profiling::metricsSocket and Platform::Profiling::metricsPeriod. */
+		void createMetrics();
+
 		/** Creates a window according to the application configuration file. */
 		#ifdef _WINDOWS
 			void createWindow(HINSTANCE applicationHandle);
@@ -114,6 +121,10 @@ namespace Platform
 		/** Contains last executions that are done before waiting for the next frame to be started. */
 		void endFrame();
 
+		/** Adds the phase times of the frame which just ended to the frame metrics.
+		@param stutter Set this to true if the frame was detected as stutter. */
+		void recordFrameMetrics(const bool stutter);
+
 		/** Does everything which needs to be done to update the complete application in a reasonable order.
 		   For example, it includes updating the ApplicationTimer object, calling update, etc. */
 		void updateCompletely();
@@ -128,6 +139,12 @@ namespace Platform
 	protected:
 		Input::TextInput mTextInput;							/// This is a representation of what the text the user enters.
 		Profiling::FrameRateCalculator *mFrameRateCalculator;	/// Is responsible for FPS calculation.
+		Profiling::MetricsExporter *mMetricsExporter;			/// Publishes snapshots of all metrics or is NULL if no target is configured.
+		Profiling::Counter *mFrameCounter;						/// Counts all frames with measured phase times.
+		Profiling::Counter *mStutterCounter;					/// Counts frames which were detected as stutters.
+		Profiling::Gauge *mFrameRate;							/// Frame rate of mFrameRateCalculator which is only set by the main loop.
+		Profiling::Histogram *mFrameTimes;						/// Distribution of complete frame times in seconds.
+		Profiling::Histogram *mPhaseTimes[Profiling::FrameRateCalculator::PHASE_COUNT];	/// Distribution of the times of each frame phase in seconds.
 		Real mWantedFrameTime;									/// Defines how many seconds a frame should take at least. This is used to cap the frame rate.
 																/// Main loop thread sleeps if it actually requires less time to update, render etc.
 		bool mInterpretingTextInput;							/// This value is true if the application is interpreting key strokes by the user as text input.
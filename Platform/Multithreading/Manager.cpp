@@ -5,23 +5,45 @@
  * This software may be modified and distributed under the terms
  * of the BSD 3-Clause license. See the License.txt file for details.
  */
+#include <chrono>
+#include <sstream>
 #include "Manager.h"
+#include "Platform/Profiling/Profiler.h"
+#include "Platform/Profiling/ScopedZone.h"
 
 using namespace Platform::Multithreading;
 using namespace std;
 
+namespace
+{
+	thread_local bool tWorkerThread = false;	/// Is true for the worker threads of the Manager.
+}
+
 Manager::Manager() :
-	mWorkers(NULL), mThreadCount(0), mRunning(false)
+	mWorkers(NULL),
+	#ifdef PROFILING
+		mWorkerStatistics(NULL), mWorkerStatisticsMutexes(NULL), mWorkerStatisticsCount(0),
+	#endif // PROFILING
+	mThreadCount(0), mRunning(false)
 {
 }
 
 Manager::~Manager()
 {
 	stopWork();
+
+	#ifdef PROFILING
+		delete [] mWorkerStatistics;
+		delete [] mWorkerStatisticsMutexes;
+	#endif // PROFILING
 }
 
 void Manager::enqueue(Task *task)
 {
+	#ifdef PROFILING
+		task->mEnqueueTimeStamp = getTimeStamp();
+	#endif // PROFILING
+
 	// queue task
 	{
 		unique_lock<mutex> uniqueLock(mQueueMutex);
@@ -31,14 +53,82 @@ void Manager::enqueue(Task *task)
 	mWorkersCondition.notify_one();
 }
 
+uint32 Manager::getQueuedTaskCount() const
+{
+	unique_lock<mutex> uniqueLock(mQueueMutex);
+	return (uint32) mTasks.size();
+}
+
+bool Manager::isWorkerThread()
+{
+	return tWorkerThread;
+}
+
+#ifdef PROFILING
+	uint64 Manager::getTimeStamp()
+	{
+		return (uint64) chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	bool Manager::getWorkerStatistics(WorkerStatistics &statistics, const uint32 workerIdx) const
+	{
+		if (workerIdx >= mWorkerStatisticsCount)
+			return false;
+
+		unique_lock<mutex> uniqueLock(mWorkerStatisticsMutexes[workerIdx]);
+		statistics = mWorkerStatistics[workerIdx];
+		return true;
+	}
+
+	void Manager::recordTask(const uint32 workerIdx, const uint64 idleTime, const uint64 queueLatency, const uint64 runTime,
+		const uint32 emptyWakeUpCount)
+	{
+		assert(workerIdx < mWorkerStatisticsCount);
+
+		unique_lock<mutex> uniqueLock(mWorkerStatisticsMutexes[workerIdx]);
+		WorkerStatistics &statistics = mWorkerStatistics[workerIdx];
+		statistics.mQueueLatencies.add(queueLatency);
+		statistics.mRunTimes.add(runTime);
+		statistics.mBusyTime += runTime;
+		statistics.mIdleTime += idleTime;
+		statistics.mEmptyWakeUpCount += emptyWakeUpCount;
+		++statistics.mTaskCount;
+		if (runTime > statistics.mLongestRunTime)
+			statistics.mLongestRunTime = runTime;
+	}
+
+	void Manager::resetStatistics()
+	{
+		for (uint32 workerIdx = 0; workerIdx < mWorkerStatisticsCount; ++workerIdx)
+		{
+			unique_lock<mutex> uniqueLock(mWorkerStatisticsMutexes[workerIdx]);
+			WorkerStatistics &statistics = mWorkerStatistics[workerIdx];
+			statistics.mQueueLatencies.reset();
+			statistics.mRunTimes.reset();
+			statistics.mBusyTime = statistics.mIdleTime = statistics.mLongestRunTime = 0;
+			statistics.mTaskCount = statistics.mEmptyWakeUpCount = 0;
+		}
+	}
+#endif // PROFILING
+
 void Manager::runWork(uint32 threadCount)
 {
+	#ifdef PROFILING
+		// fresh statistics for the new workers
+		delete [] mWorkerStatistics;
+		delete [] mWorkerStatisticsMutexes;
+		mWorkerStatistics = new WorkerStatistics[threadCount];
+		mWorkerStatisticsMutexes = new mutex[threadCount];
+		mWorkerStatisticsCount = threadCount;
+		resetStatistics();
+	#endif // PROFILING
+
 	mThreadCount	= threadCount;
 	mRunning		= true;
 	mWorkers		= new thread[mThreadCount];
 
 	for (uint32 i = 0; i < mThreadCount; ++i)
-		mWorkers[i] = thread(&Manager::workerFunction);
+		mWorkers[i] = thread(&Manager::workerFunction, i);
 }
 
 void Manager::stopWork()
@@ -72,21 +162,39 @@ void Manager::stopWork()
 	mThreadCount = 0;
 }
 
-void Manager::workerFunction()
+void Manager::workerFunction(const uint32 workerIdx)
 {
+	// name the thread for profiling
+	ostringstream name;
+	name << "Worker " << workerIdx;
+	Profiling::Profiler::setCurrentThreadName(name.str());
+	tWorkerThread = true;
+
 	Task *task = NULL;
 	unique_lock<mutex> uniqueLock(Manager::getSingleton().mQueueMutex);
 	uniqueLock.unlock();
 
 	while (Manager::getSingleton().mRunning)
 	{
+		#ifdef PROFILING
+			const uint64 waitStart = getTimeStamp();
+			uint32 emptyWakeUpCount = 0;
+		#endif // PROFILING
+
 		// get some or wait for work
 		uniqueLock.lock();
 
 		// wait as long as there are no tasks
 		while (Manager::getSingleton().mRunning && Manager::getSingleton().mTasks.empty())
+		{
 			Manager::getSingleton().mWorkersCondition.wait(uniqueLock);
 
+			#ifdef PROFILING
+				if (Manager::getSingleton().mTasks.empty())
+					++emptyWakeUpCount;
+			#endif // PROFILING
+		}
+
 		// stop working if requested
 		if (!Manager::getSingleton().mRunning)
 			break;
@@ -98,6 +206,21 @@ void Manager::workerFunction()
 		uniqueLock.unlock();
 
 		// execute task
-		task->solve();
+		#ifdef PROFILING
+			// the task might be deleted by a waiting thread as soon as it is solved
+			const uint64 enqueueTimeStamp = task->mEnqueueTimeStamp;
+			const uint64 start = getTimeStamp();
+			{
+				// one zone per task, the fixed-capacity trace history of the worker only keeps the most recent ones
+				PROFILE_ZONE("Task");
+				task->solve();
+			}
+			const uint64 end = getTimeStamp();
+
+			Manager::getSingleton().recordTask(workerIdx, start - waitStart,
+				(start > enqueueTimeStamp ? start - enqueueTimeStamp : 0), end - start, emptyWakeUpCount);
+		#else
+			task->solve();
+		#endif // PROFILING
 	}
 }
@@ -15,12 +15,28 @@
 #include <thread>
 #include "Platform/DataTypes.h"
 #include "Patterns/Singleton.h"
+#include "Platform/Profiling/LatencyHistogram.h"
 #include "Task.h"
 
 namespace Platform
 {
 	namespace Multithreading
 	{
+		#ifdef PROFILING
+			/// Scheduling statistics of a single worker thread, see Manager::getWorkerStatistics().
+			/** There is a single task queue which is shared by all workers. Thus there is no work stealing and each task is simply run by the first free worker. */
+			struct WorkerStatistics
+			{
+				Profiling::LatencyHistogram	mQueueLatencies;	/// Nanoseconds from enqueue() until the start of each task run by the worker.
+				Profiling::LatencyHistogram	mRunTimes;			/// Nanoseconds each task run by the worker took.
+				uint64						mBusyTime;			/// Nanoseconds the worker spent running tasks.
+				uint64						mIdleTime;			/// Nanoseconds the worker spent waiting for tasks.
+				uint64						mLongestRunTime;	/// Run time of the longest task in nanoseconds.
+				uint64						mTaskCount;			/// Number of tasks run by the worker.
+				uint64						mEmptyWakeUpCount;	/// Number of wake ups without a task, e.g., since other workers took all tasks first.
+			};
+		#endif // PROFILING
+
 		/// Manages threads for task parallelization.
 		/** Creates threads and provides features to work off tasks in a parallel manner. */
 		class Manager : public Patterns::Singleton<Manager>
@@ -33,9 +49,37 @@ namespace Platform
 
 			void enqueue(Task *task);
 
+			/** Returns the number of tasks which wait for a worker thread, e.g., for runtime metrics.
+			@return Returns the current length of the task queue. */
+			uint32 getQueuedTaskCount() const;
+
 			uint32 getThreadCount() const { return mThreadCount; }
 
+			#ifdef PROFILING
+				/** Returns the current time point of the clock which is used for task statistics.
+				@return Returns a monotonic time stamp in nanoseconds. */
+				static uint64 getTimeStamp();
+
+				/** Copies the scheduling statistics of a worker thread. Statistics are kept after stopWork() until the next runWork() call.
+				@param statistics Is filled with the statistics of the worker.
+				@param workerIdx Identifies the worker, must be smaller than the thread count of the last runWork() call.
+				@return Returns false if there are no statistics for workerIdx. */
+				bool getWorkerStatistics(WorkerStatistics &statistics, const uint32 workerIdx) const;
+
+				/** Returns the number of workers with statistics.
+				@return Returns the thread count of the last runWork() call. */
+				inline uint32 getWorkerStatisticsCount() const { return mWorkerStatisticsCount; }
+
+				/** Resets the statistics of all workers, e.g., to measure a particular part of the application. */
+				void resetStatistics();
+			#endif // PROFILING
+
 			inline bool isRunning() const { return mRunning; }
+
+			/** Checks whether the calling thread is one of the worker threads, e.g., to avoid waiting for tasks inside of tasks.
+				Waiting for other tasks within a task can block all workers if these tasks are still queued.
+			@return Returns true if the function is called by a task which is run by a worker thread. */
+			static bool isWorkerThread();
 			
 			void runWork(uint32 threadCount);
 
@@ -51,14 +95,32 @@ namespace Platform
             @return Don't call it, it fails. */
             Manager &operator =(const Manager &rhs) { assert(false); return *this; }
 
-			static void workerFunction();
+			/** Executed by each worker thread to work off enqueued tasks until stopWork() is called.
+			@param workerIdx Identifies the worker thread, e.g., for profiling. */
+			static void workerFunction(const uint32 workerIdx);
+
+			#ifdef PROFILING
+				/** Adds the timings of a task to the statistics of the worker which ran it.
+				@param workerIdx Identifies the worker which ran the task.
+				@param idleTime Set this to the nanoseconds the worker waited for the task.
+				@param queueLatency Set this to the nanoseconds from enqueue() until the task was started.
+				@param runTime Set this to the nanoseconds the task took.
+				@param emptyWakeUpCount Set this to the number of wake ups without a task while the worker waited. */
+				void recordTask(const uint32 workerIdx, const uint64 idleTime, const uint64 queueLatency, const uint64 runTime, const uint32 emptyWakeUpCount);
+			#endif // PROFILING
 
         private:
 			std::thread				*mWorkers;
 			std::queue<Task *>		mTasks;
 			std::condition_variable mTasksCondition;
 			std::condition_variable	mWorkersCondition;
-			std::mutex				mQueueMutex;
+			mutable std::mutex		mQueueMutex;
+
+			#ifdef PROFILING
+				WorkerStatistics	*mWorkerStatistics;			/// Statistics of each worker of the last runWork() call.
+				std::mutex			*mWorkerStatisticsMutexes;	/// Protect mWorkerStatistics, one uncontended mutex per worker.
+				uint32				mWorkerStatisticsCount;		/// Number of entries in mWorkerStatistics.
+			#endif // PROFILING
 
 			uint32					mThreadCount;
             bool					mRunning;
@@ -13,7 +13,11 @@ using namespace std;
 
 mutex Task::msMutex;
 
-Task::Task() : mFinished(false)
+Task::Task() :
+	#ifdef PROFILING
+		mEnqueueTimeStamp(0),
+	#endif // PROFILING
+	mFinished(false)
 {
 
 }
@@ -11,13 +11,18 @@
 
 #include <cassert>
 #include <mutex>
+#include "Platform/DataTypes.h"
 
 namespace Platform
 {
 	namespace Multithreading
 	{
+		class Manager;
+
 		class Task
 		{
+		friend class Manager;
+
 		public:
 			Task();
 
@@ -40,6 +45,9 @@ namespace Platform
 
 		private:
 			static std::mutex	msMutex;
+			#ifdef PROFILING
+				uint64			mEnqueueTimeStamp;	/// Time point of the last Manager::enqueue() call in nanoseconds, see Manager::getTimeStamp().
+			#endif // PROFILING
 			bool				mFinished;
 		};
 	}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include "Platform/Profiling/EventBuffer.h"
+#include "Platform/Profiling/ThreadProfile.h"
+
+using namespace Profiling;
+
+EventBuffer::EventBuffer(const uint32 capacity) :
+	mEvents(new ProfilingEvent[capacity]), mMask(capacity - 1),
+	mReadPosition(0), mWritePosition(0), mDroppedZones(0), mReservedCount(0), mSkippedDepth(0)
+{
+	assert(capacity > 1 && 0 == (capacity & (capacity - 1)));
+}
+
+EventBuffer::~EventBuffer()
+{
+	delete [] mEvents;
+	mEvents = NULL;
+}
+
+uint32 EventBuffer::drain(ThreadProfile &target)
+{
+	const uint64 readPosition = mReadPosition.load(std::memory_order_relaxed);
+	const uint64 writePosition = mWritePosition.load(std::memory_order_acquire);
+
+	// move all published events
+	for (uint64 position = readPosition; position < writePosition; ++position)
+		target.addEvent(mEvents[position & mMask]);
+
+	// free their slots for the producer
+	mReadPosition.store(writePosition, std::memory_order_release);
+	return (uint32) (writePosition - readPosition);
+}
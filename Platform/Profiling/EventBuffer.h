@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _EVENT_BUFFER_H_
+#define _EVENT_BUFFER_H_
+
+#include <atomic>
+#include <cassert>
+#include "Platform/DataTypes.h"
+
+namespace Profiling
+{
+	class ThreadProfile;
+
+	/// Time stamped event recorded by a profiled thread, e.g., entering a zone.
+	struct ProfilingEvent
+	{
+		/// Defines what happened at the time stamp of an event.
+		enum TYPE
+		{
+			TYPE_BEGIN_ZONE,	/// A zone was entered.
+			TYPE_END_ZONE,		/// The most recently entered zone was left.
+			TYPE_ZONE_COUNTER	/// Counter difference of the zone which was left by the preceding end event, see PerformanceCounters.
+		};
+
+		const char	*mName;				/// Identifies the zone of begin events. Points to a string with static storage duration.
+		union
+		{
+			uint64	mTimeStamp;			/// Time point in nanoseconds relative to the profiler epoch for begin and end events.
+			uint64	mCounterValue;		/// Counter difference for counter events or PerformanceCounters::INVALID_VALUE.
+		};
+		TYPE		mType;				/// Defines what happened at mTimeStamp.
+		uint32		mCounter;			/// Identifies the counter of counter events, see PerformanceCounters::COUNTER.
+	};
+
+	/// Preallocated single producer single consumer ring buffer of ProfilingEvent objects.
+	/** Exactly one thread records events (producer) and exactly one other thread drains them (consumer), e.g., the profiler collector.
+		Recording does neither lock nor allocate. If the buffer is full then complete zones are dropped instead of single events:
+		a begin event is only recorded if there is space left for the end and counter events of all open zones so that recorded zones always stay balanced. */
+	class EventBuffer
+	{
+	public:
+		/** Allocates the ring buffer.
+		@param capacity Set this to the maximum number of events which can be stored until the consumer drains them. Must be a power of two. */
+		EventBuffer(const uint32 capacity);
+
+		/** Frees the ring buffer. */
+		~EventBuffer();
+
+		/** Records that a zone was entered. Only the producer thread must call this.
+		@param name Identifies the zone. Must point to a string with static storage duration, e.g., a string literal.
+		@param timeStamp Time point in nanoseconds relative to the profiler epoch.
+		@param counterCount Set this to the number of counter values which are recorded when the zone is left or to 0 for zones without counters.
+			The zone must be left with endZone(timeStamp, counterValues, counterCount) then.
+		@return Returns false if the buffer is full and the zone is dropped. */
+		inline bool beginZone(const char *name, const uint64 timeStamp, const uint32 counterCount = 0);
+
+		/** Records that the most recently entered zone was left. Only the producer thread must call this.
+		@param timeStamp Time point in nanoseconds relative to the profiler epoch.
+		@param counterValues Set this to counterCount counter differences of the zone or to NULL, see PerformanceCounters.
+		@param counterCount Set this to the same count as for the corresponding beginZone() call. */
+		inline void endZone(const uint64 timeStamp, const uint64 *counterValues = NULL, const uint32 counterCount = 0);
+
+		/** Moves all events recorded so far to target. Only the consumer thread must call this.
+		@param target Receives all recorded events in recording order, see ThreadProfile::addEvent().
+		@return Returns the number of moved events. */
+		uint32 drain(ThreadProfile &target);
+
+		/** Returns how many zones were not recorded since the buffer was full.
+		@return Returns the number of dropped zones including nested zones of dropped zones. */
+		inline uint64 getDroppedZoneCount() const;
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		EventBuffer(const EventBuffer &copy) : mEvents(NULL), mMask(0) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		EventBuffer &operator =(const EventBuffer &rhs) { assert(false); return *this; }
+
+		/** Stores an event at the current write position without publishing it to the consumer.
+		@param writePosition Set this to the position of the event.
+		@param name Identifies the zone of begin events.
+		@param value Set this to the time stamp in nanoseconds relative to the profiler epoch or to the counter difference.
+		@param type Defines what happened.
+		@param counter Identifies the counter of counter events. */
+		inline void store(const uint64 writePosition, const char *name, const uint64 value, const ProfilingEvent::TYPE type, const uint32 counter);
+
+	private:
+		ProfilingEvent			*mEvents;			/// Preallocated ring buffer memory.
+		const uint64			mMask;				/// Capacity - 1, maps positions to ring buffer indices.
+
+		// consumer data
+		std::atomic<uint64>		mReadPosition;		/// Number of events which were consumed so far.
+		uint8					mPadding[64];		/// Keeps consumer and producer data in different cache lines.
+
+		// producer data
+		std::atomic<uint64>		mWritePosition;		/// Number of events which were recorded so far.
+		std::atomic<uint64>		mDroppedZones;		/// Number of zones which were not recorded since the buffer was full.
+		uint32					mReservedCount;		/// Number of events which must still be recorded to leave all open zones.
+		uint32					mSkippedDepth;		/// Nesting depth within a dropped zone or 0 if the current zone was recorded.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline bool EventBuffer::beginZone(const char *name, const uint64 timeStamp, const uint32 counterCount)
+	{
+		// within a dropped zone?
+		if (mSkippedDepth > 0)
+		{
+			++mSkippedDepth;
+			mDroppedZones.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		// keep space for the end & counter events of all open zones
+		const uint64 writePosition = mWritePosition.load(std::memory_order_relaxed);
+		const uint64 readPosition = mReadPosition.load(std::memory_order_acquire);
+		const uint64 freeCount = (mMask + 1) - (writePosition - readPosition);
+		if (freeCount < mReservedCount + 2 + counterCount)
+		{
+			mSkippedDepth = 1;
+			mDroppedZones.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		mReservedCount += 1 + counterCount;
+		store(writePosition, name, timeStamp, ProfilingEvent::TYPE_BEGIN_ZONE, 0);
+		mWritePosition.store(writePosition + 1, std::memory_order_release);
+		return true;
+	}
+
+	inline void EventBuffer::endZone(const uint64 timeStamp, const uint64 *counterValues, const uint32 counterCount)
+	{
+		// leaving a dropped zone?
+		if (mSkippedDepth > 0)
+		{
+			--mSkippedDepth;
+			return;
+		}
+
+		// there is always space for it, see beginZone
+		assert(mReservedCount >= 1 + counterCount);
+		mReservedCount -= 1 + counterCount;
+
+		// end event followed by counter events, published at once
+		const uint64 writePosition = mWritePosition.load(std::memory_order_relaxed);
+		store(writePosition, NULL, timeStamp, ProfilingEvent::TYPE_END_ZONE, 0);
+		for (uint32 counterIdx = 0; counterIdx < counterCount; ++counterIdx)
+			store(writePosition + 1 + counterIdx, NULL, counterValues[counterIdx], ProfilingEvent::TYPE_ZONE_COUNTER, counterIdx);
+
+		mWritePosition.store(writePosition + 1 + counterCount, std::memory_order_release);
+	}
+
+	inline uint64 EventBuffer::getDroppedZoneCount() const
+	{
+		return mDroppedZones.load(std::memory_order_relaxed);
+	}
+
+	inline void EventBuffer::store(const uint64 writePosition, const char *name, const uint64 value, const ProfilingEvent::TYPE type, const uint32 counter)
+	{
+		ProfilingEvent &event = mEvents[writePosition & mMask];
+		event.mName = name;
+		event.mTimeStamp = value;
+		event.mType = type;
+		event.mCounter = counter;
+	}
+}
+
+#endif // _EVENT_BUFFER_H_
@@ -5,9 +5,102 @@
  * This software may be modified and distributed under the terms
  * of the BSD 3-Clause license. See the License.txt file for details.
  */
+#include <sstream>
 #include "Platform/Profiling/FrameRateCalculator.h"
+#include "Platform/Profiling/Profiler.h"
 
 using namespace Profiling;
+using namespace std;
+using namespace Timing;
+
+FrameRateCalculator::FrameRateCalculator(Real frameRatePeriod, uint32 frameHistorySize) :
+	mFrameRatePeriod(frameRatePeriod), mFPS(-1.0f), mFramesThisPeriod(0),
+	mFrames(frameHistorySize), mRecordedFrameCount(0),
+	mStutterThreshold(0.0f), mRemainingCaptures(0), mStutterCount(0)
+{
+	assert(frameRatePeriod > 0.0f);
+	assert(frameHistorySize > 0);
+
+	beginFrame();
+}
+
+void FrameRateCalculator::beginFrame()
+{
+	for (uint32 phaseIdx = 0; phaseIdx < PHASE_COUNT; ++phaseIdx)
+		mCurrentFrame.mPhaseTimes[phaseIdx] = 0.0f;
+	mCurrentFrame.mTotalTime = 0.0f;
+	mCurrentFrame.mFrameIdx = mRecordedFrameCount;
+
+	mFrameStart = chrono::high_resolution_clock::now();
+	mPhaseStart = mFrameStart;
+}
+
+void FrameRateCalculator::captureStutter(const FrameTimes &frame)
+{
+	#ifdef PROFILING
+		if (0 == mRemainingCaptures || !Profiler::exists())
+			return;
+		--mRemainingCaptures;
+
+		// zones of the stutter frame are saved in the background to not extend the stutter
+		Profiler &profiler = Profiler::getSingleton();
+		const uint64 begin = profiler.getTimeStamp(mFrameStart);
+		const uint64 end = profiler.getTimeStamp(chrono::high_resolution_clock::now());
+
+		ostringstream fileName;
+		fileName << mCapturePath << "Stutter" << frame.mFrameIdx << ".json";
+		profiler.requestTrace(fileName.str(), begin, end);
+	#endif // PROFILING
+}
+
+void FrameRateCalculator::enableStutterDetection(Real wantedFrameTime, Real factor, const string &capturePath, uint32 maxCaptureCount)
+{
+	mStutterThreshold = (factor > 0.0f ? factor * wantedFrameTime : 0.0f);
+	mCapturePath = capturePath;
+	mRemainingCaptures = maxCaptureCount;
+}
+
+bool FrameRateCalculator::endFrame()
+{
+	// store frame in ring buffer
+	const TimePoint now = chrono::high_resolution_clock::now();
+	mCurrentFrame.mTotalTime = chrono::duration_cast<chrono::duration<Real> >(now - mFrameStart).count();
+
+	const FrameTimes &frame = mFrames[mRecordedFrameCount % mFrames.size()] = mCurrentFrame;
+	++mRecordedFrameCount;
+
+	// stutter?
+	if (mStutterThreshold <= 0.0f || frame.mTotalTime <= mStutterThreshold)
+		return false;
+
+	++mStutterCount;
+	captureStutter(frame);
+	return true;
+}
+
+void FrameRateCalculator::endPhase(PHASE phase)
+{
+	assert(phase < PHASE_COUNT);
+
+	const TimePoint now = chrono::high_resolution_clock::now();
+	mCurrentFrame.mPhaseTimes[phase] += chrono::duration_cast<chrono::duration<Real> >(now - mPhaseStart).count();
+	mPhaseStart = now;
+}
+
+const char *FrameRateCalculator::getPhaseName(PHASE phase)
+{
+	switch (phase)
+	{
+		case PHASE_INPUT:	return "input";
+		case PHASE_UPDATE:	return "update";
+		case PHASE_RENDER:	return "render";
+		case PHASE_PRESENT:	return "present";
+
+		default:
+			assert(false);
+			return "unknown";
+	}
+}
 
 void FrameRateCalculator::update()
 {
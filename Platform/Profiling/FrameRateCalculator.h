@@ -9,34 +9,135 @@
 #define _FRAME_RATE_CALCULATOR_H_
 
 #include <cassert>
+#include <string>
+#include <vector>
+#include "Platform/Timing/ApplicationTimer.h"
 #include "Platform/Timing/TimePeriod.h"
 
 namespace Profiling
 {
 	/// Small helper class used to measure rendered frames per second.
+	/** Besides the average frame rate, it records how long the phases of each frame took in a ring buffer of recent frames.
+		Frames which take much longer than wanted are detected as stutters and the profiler zones of such frames can be saved automatically. */
 	class FrameRateCalculator
 	{
+	public:
+		/// Identifies the parts of a frame of the main loop, see Application::run().
+		enum PHASE
+		{
+			PHASE_INPUT,	/// Input devices are updated.
+			PHASE_UPDATE,	/// The application is updated.
+			PHASE_RENDER,	/// The frame is rendered.
+			PHASE_PRESENT,	/// Post render functionality, e.g., swapping buffers, and last things of the frame.
+			PHASE_COUNT		/// Number of phases.
+		};
+
+		/// Durations of the phases of a single frame.
+		struct FrameTimes
+		{
+			Real	mPhaseTimes[PHASE_COUNT];	/// Duration of each phase in seconds.
+			Real	mTotalTime;					/// Duration from beginFrame() to endFrame() in seconds.
+			uint64	mFrameIdx;					/// Number of frames recorded before this one.
+		};
+
 	public:
 		/** Creates the calculater and sets current fps to a negative value.
-		@param frameRatePeriod Defines over what time period in seconds frames are counted to measure average frames per second over this period. */
-		FrameRateCalculator(Real frameRatePeriod) : mFrameRatePeriod(frameRatePeriod), mFPS(-1.0f), mFramesThisPeriod(0) { assert(frameRatePeriod > 0.0f); }
+		@param frameRatePeriod Defines over what time period in seconds frames are counted to measure average frames per second over this period.
+		@param frameHistorySize Defines for how many recent frames the phase durations are kept, see getRecentFrame(). */
+		FrameRateCalculator(Real frameRatePeriod, uint32 frameHistorySize = DEFAULT_FRAME_HISTORY_SIZE);
+
+		/** Marks the beginning of a frame and of its first phase. */
+		void beginFrame();
+
+		/** Enables automatic detection of stutters which are frames taking more than factor * wantedFrameTime seconds.
+		@param wantedFrameTime Set this to the desired time per frame in seconds, see Application::getWantedFrameTime().
+		@param factor A frame is a stutter if it takes longer than factor times the wanted frame time. Set this to 0 to disable stutter detection.
+		@param capturePath If a Profiler exists then the zones of the first maxCaptureCount stutters are saved as Chrome trace files
+			named capturePath + "Stutter<frame index>.json" by the profiler collector thread, see Profiler::requestTrace().
+		@param maxCaptureCount Defines how many stutters are captured at most. */
+		void enableStutterDetection(Real wantedFrameTime, Real factor, const std::string &capturePath, uint32 maxCaptureCount);
+
+		/** Marks the end of a frame, stores its phase durations and checks whether it is a stutter.
+		@return Returns true if the frame is a stutter, see enableStutterDetection(). */
+		bool endFrame();
+
+		/** Marks the end of a phase of the current frame. The next phase begins immediately.
+		@param phase Identifies the phase which ended. Time since the end of the previous phase or the frame beginning is added to it. */
+		void endPhase(PHASE phase);
 
 		/** Returns how many frames per second were rendered last frame rate period.
 			The frame rate period length by this objects TimePeriod object.
 		@return Returns the number of frames rendered last frame rate period. */
 		inline Real getFPS() const { return mFPS; }
 
+		/** Returns how many recent frames are stored at most.
+		@return Returns the size of the ring buffer of recent frames. */
+		inline uint32 getFrameHistorySize() const { return (uint32) mFrames.size(); }
+
+		/** Returns a short name of a phase, e.g., for reports.
+		@param phase Identifies the phase.
+		@return Returns a name like "update". */
+		static const char *getPhaseName(PHASE phase);
+
+		/** Returns the phase durations of a recent frame.
+		@param age Set this to 0 for the last frame, 1 for the frame before and so on. Must be smaller than getRecentFrameCount().
+		@return Returns the durations of the frame which ended age frames before the last one. */
+		inline const FrameTimes &getRecentFrame(uint32 age) const;
+
+		/** Returns how many recent frames can be accessed.
+		@return Returns the number of stored frames which is at most getFrameHistorySize(). */
+		inline uint32 getRecentFrameCount() const;
+
+		/** Returns the number of detected stutters.
+		@return Returns how many frames took longer than the stutter threshold, see enableStutterDetection(). */
+		inline uint32 getStutterCount() const { return mStutterCount; }
+
 		/** Increases the number of frames rendered this frame rate period. */
 		inline void onFrameRendered() { ++mFramesThisPeriod; }
 
 		/** Updates FPS calculation. */
 		void update();
 
+	public:
+		static const uint32 DEFAULT_FRAME_HISTORY_SIZE = 256;	/// Default number of recent frames which are kept.
+
+	private:
+		/** Saves the profiler zones of a stutter frame if wanted.
+		@param frame Set this to the stutter. */
+		void captureStutter(const FrameTimes &frame);
+
 	private:
 		Timing::TimePeriod mFrameRatePeriod;	/// Defines over what time period the average frame rate is measured.
-		Real mFPS;								/// Stores how many frames per second were rendered last frame rate period.	
+		Real mFPS;								/// Stores how many frames per second were rendered last frame rate period.
 		uint32 mFramesThisPeriod;				/// Counts how many frames have been rendered this frame rate period, used for FPS calculation
+
+		std::vector<FrameTimes> mFrames;		/// Ring buffer of the most recent frames.
+		FrameTimes mCurrentFrame;				/// Phase durations of the frame which is currently recorded.
+		Timing::TimePoint mFrameStart;			/// Time point of the last beginFrame() call.
+		Timing::TimePoint mPhaseStart;			/// Time point when the current phase began.
+		uint64 mRecordedFrameCount;				/// Number of frames which were ended so far.
+
+		std::string mCapturePath;				/// Prefix for the file names of stutter captures.
+		Real mStutterThreshold;					/// Frames longer than this many seconds are stutters or 0 if detection is disabled.
+		uint32 mRemainingCaptures;				/// Defines how many more stutters are saved.
+		uint32 mStutterCount;					/// Number of detected stutters.
 	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline const FrameRateCalculator::FrameTimes &FrameRateCalculator::getRecentFrame(uint32 age) const
+	{
+		assert(age < getRecentFrameCount());
+		const uint64 frameIdx = mRecordedFrameCount - 1 - age;
+		return mFrames[frameIdx % mFrames.size()];
+	}
+
+	inline uint32 FrameRateCalculator::getRecentFrameCount() const
+	{
+		return (uint32) (mRecordedFrameCount < mFrames.size() ? mRecordedFrameCount : mFrames.size());
+	}
 }
 
 #endif // _FRAME_RATE_CALCULATER_H_
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cassert>
+#include <cmath>
+#include "Platform/Profiling/LatencyHistogram.h"
+
+using namespace Profiling;
+using namespace std;
+
+LatencyHistogram::LatencyHistogram() :
+	mCount(0)
+{
+
+}
+
+void LatencyHistogram::add(const uint64 nanoseconds)
+{
+	if (mBuckets.empty())
+		mBuckets.resize(BUCKET_COUNT, 0);
+
+	++mBuckets[getBucketIndex(nanoseconds)];
+	++mCount;
+}
+
+uint32 LatencyHistogram::getBucketIndex(const uint64 nanoseconds)
+{
+	// exactly counted small values
+	if (nanoseconds < SUB_BUCKET_COUNT)
+		return (uint32) nanoseconds;
+
+	// exponent = index of the highest set bit
+	#ifdef __GNUC__
+		const uint32 exponent = 63 - (uint32) __builtin_clzll(nanoseconds);
+	#else
+		uint32 exponent = SUB_BUCKET_BITS;
+		while (nanoseconds >> (exponent + 1))
+			++exponent;
+	#endif // __GNUC__
+
+	if (exponent >= MAX_EXPONENT)
+		return BUCKET_COUNT - 1;
+
+	// linear sub bucket within [2^exponent, 2^(exponent + 1))
+	const uint32 shift = exponent - SUB_BUCKET_BITS;
+	const uint32 subBucket = (uint32) (nanoseconds >> shift) - SUB_BUCKET_COUNT;
+	return (shift + 1) * SUB_BUCKET_COUNT + subBucket;
+}
+
+void LatencyHistogram::getBucketRange(uint64 &lowerBound, uint64 &upperBound, const uint32 bucketIdx)
+{
+	const uint32 row = bucketIdx / SUB_BUCKET_COUNT;
+	const uint32 subBucket = bucketIdx % SUB_BUCKET_COUNT;
+
+	if (0 == row)
+	{
+		lowerBound = subBucket;
+		upperBound = subBucket + 1;
+		return;
+	}
+
+	const uint32 shift = row - 1;
+	lowerBound = ((uint64) (SUB_BUCKET_COUNT + subBucket)) << shift;
+	upperBound = lowerBound + (((uint64) 1) << shift);
+}
+
+uint64 LatencyHistogram::getCountUpTo(const uint64 nanoseconds) const
+{
+	if (0 == mCount)
+		return 0;
+
+	uint64 count = 0;
+	const uint32 lastBucketIdx = getBucketIndex(nanoseconds);
+	for (uint32 bucketIdx = 0; bucketIdx <= lastBucketIdx; ++bucketIdx)
+		count += mBuckets[bucketIdx];
+
+	return count;
+}
+
+uint64 LatencyHistogram::getPercentile(const double percentile) const
+{
+	if (0 == mCount)
+		return 0;
+
+	// rank of the wanted value within all sorted values
+	assert(percentile >= 0.0 && percentile <= 1.0);
+	uint64 rank = (uint64) ceil(percentile * mCount);
+	if (rank < 1)
+		rank = 1;
+	if (rank > mCount)
+		rank = mCount;
+
+	// find the bucket containing rank
+	uint64 sum = 0;
+	for (uint32 bucketIdx = 0; bucketIdx < BUCKET_COUNT; ++bucketIdx)
+	{
+		sum += mBuckets[bucketIdx];
+		if (sum < rank)
+			continue;
+
+		uint64 lowerBound;
+		uint64 upperBound;
+		getBucketRange(lowerBound, upperBound, bucketIdx);
+		return lowerBound + (upperBound - 1 - lowerBound) / 2;
+	}
+
+	assert(false);
+	return 0;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+	if (0 == other.mCount)
+		return;
+
+	if (mBuckets.empty())
+		mBuckets.resize(BUCKET_COUNT, 0);
+
+	for (uint32 bucketIdx = 0; bucketIdx < BUCKET_COUNT; ++bucketIdx)
+		mBuckets[bucketIdx] += other.mBuckets[bucketIdx];
+	mCount += other.mCount;
+}
+
+void LatencyHistogram::reset()
+{
+	if (!mBuckets.empty())
+		mBuckets.assign(BUCKET_COUNT, 0);
+	mCount = 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _LATENCY_HISTOGRAM_H_
+#define _LATENCY_HISTOGRAM_H_
+
+#include <vector>
+#include "Platform/DataTypes.h"
+
+namespace Profiling
+{
+	/// Log bucketed histogram of time periods in nanoseconds for percentile queries with constant memory, similar to HDR histograms.
+	/** Each power of two range [2^e, 2^(e+1)) is split into SUB_BUCKET_COUNT linear sub buckets.
+		Thus the relative error of a returned percentile is at most 1 / SUB_BUCKET_COUNT, independent of the number of added values.
+		Values below SUB_BUCKET_COUNT nanoseconds are counted exactly and values of 2^MAX_EXPONENT nanoseconds or more end up in the last bucket.
+		Histograms can be merged, e.g., to combine the measurements of several threads.
+		Bucket memory is allocated when the first value is added. */
+	class LatencyHistogram
+	{
+	public:
+		/** Creates an empty histogram without bucket memory. */
+		LatencyHistogram();
+
+		/** Counts a single time period.
+		@param nanoseconds Set this to the measured time period in nanoseconds. */
+		void add(const uint64 nanoseconds);
+
+		/** Returns the number of counted time periods.
+		@return Returns how many values were added or merged since the last reset. */
+		inline uint64 getCount() const;
+
+		/** Returns how many counted time periods are not larger than a bound, e.g., for the cumulative buckets of exported histograms.
+		@param nanoseconds Set this to the bound in nanoseconds.
+		@return Returns the number of time periods in all buckets up to the one containing the bound.
+			Like percentiles, the result is exact up to the width of that bucket. */
+		uint64 getCountUpTo(const uint64 nanoseconds) const;
+
+		/** Returns a time period which is larger than or equal to the fraction percentile of all counted time periods.
+		@param percentile Set this to a value in [0, 1], e.g., 0.99 for the 99th percentile.
+		@return Returns the middle of the bucket containing the percentile in nanoseconds or 0 if the histogram is empty. */
+		uint64 getPercentile(const double percentile) const;
+
+		/** Adds all counts of another histogram to this one.
+		@param other Its counts are added to this histogram. */
+		void merge(const LatencyHistogram &other);
+
+		/** Removes all counted values but keeps the bucket memory. */
+		void reset();
+
+	public:
+		static const uint32 SUB_BUCKET_BITS = 5;							/// Defines the precision of the histogram.
+		static const uint32 SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;		/// Number of linear buckets per power of two range.
+		static const uint32 MAX_EXPONENT = 44;								/// Values of 2^MAX_EXPONENT ns (~4.9h) or more are counted in the last bucket.
+		static const uint32 BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;	/// Total number of buckets.
+
+	private:
+		/** Computes the bucket which counts value.
+		@param nanoseconds Identifies the bucket.
+		@return Returns the index of the bucket value belongs to. */
+		static uint32 getBucketIndex(const uint64 nanoseconds);
+
+		/** Computes the value range of a bucket.
+		@param lowerBound Is set to the smallest value of the bucket.
+		@param upperBound Is set to the smallest value of the next bucket.
+		@param bucketIdx Identifies the bucket. */
+		static void getBucketRange(uint64 &lowerBound, uint64 &upperBound, const uint32 bucketIdx);
+
+	private:
+		std::vector<uint32>	mBuckets;	/// Contains BUCKET_COUNT counters or is empty if nothing was added so far.
+		uint64				mCount;		/// Number of counted values.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline uint64 LatencyHistogram::getCount() const
+	{
+		return mCount;
+	}
+}
+
+#endif // _LATENCY_HISTOGRAM_H_
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <algorithm>
+#include "Platform/Profiling/Metrics.h"
+
+using namespace Profiling;
+using namespace std;
+
+namespace
+{
+	/** Atomically adds a value to an atomic double without locks.
+	@param target Set this to the atomic which is increased.
+	@param difference Set this to the added value. */
+	void atomicAdd(atomic<double> &target, const double difference)
+	{
+		double expected = target.load(memory_order_relaxed);
+		while (!target.compare_exchange_weak(expected, expected + difference, memory_order_relaxed))
+			;
+	}
+}
+
+void Gauge::add(const double difference)
+{
+	atomicAdd(mValue, difference);
+}
+
+vector<double> Histogram::createExponentialBounds(const double start, const double factor, const uint32 count)
+{
+	assert(start > 0.0 && factor > 1.0);
+
+	vector<double> bounds(count);
+	double bound = start;
+	for (uint32 boundIdx = 0; boundIdx < count; ++boundIdx, bound *= factor)
+		bounds[boundIdx] = bound;
+	return bounds;
+}
+
+Histogram::Histogram(const vector<double> &upperBounds) :
+	mUpperBounds(upperBounds), mBucketCounts(new atomic<uint64>[upperBounds.size() + 1]), mSum(0.0)
+{
+	#ifdef _DEBUG
+		for (size_t boundIdx = 1; boundIdx < mUpperBounds.size(); ++boundIdx)
+			assert(mUpperBounds[boundIdx - 1] < mUpperBounds[boundIdx]);
+	#endif // _DEBUG
+
+	for (size_t bucketIdx = 0; bucketIdx <= mUpperBounds.size(); ++bucketIdx)
+		mBucketCounts[bucketIdx].store(0, memory_order_relaxed);
+}
+
+void Histogram::assign(const uint64 *bucketCounts, const double sum)
+{
+	for (size_t bucketIdx = 0; bucketIdx <= mUpperBounds.size(); ++bucketIdx)
+		mBucketCounts[bucketIdx].store(bucketCounts[bucketIdx], memory_order_relaxed);
+	mSum.store(sum, memory_order_relaxed);
+}
+
+Histogram::~Histogram()
+{
+	delete [] mBucketCounts;
+	mBucketCounts = NULL;
+}
+
+void Histogram::observe(const double value)
+{
+	// first bound >= value or the bucket without bound
+	const size_t bucketIdx = lower_bound(mUpperBounds.begin(), mUpperBounds.end(), value) - mUpperBounds.begin();
+	mBucketCounts[bucketIdx].fetch_add(1, memory_order_relaxed);
+	atomicAdd(mSum, value);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _METRICS_H_
+#define _METRICS_H_
+
+#include <atomic>
+#include <cassert>
+#include <vector>
+#include "Platform/DataTypes.h"
+
+namespace Profiling
+{
+	/// Monotonically increasing count of events, e.g., rendered frames or sent bytes.
+	/** Updates are single relaxed atomic additions and thus lock-free and safe from any thread. See MetricsRegistry::addCounter(). */
+	class Counter
+	{
+	public:
+		/** Creates a counter with value 0. */
+		Counter() : mValue(0) { }
+
+		/** Returns the current count.
+		@return Returns the sum of all increments so far. */
+		inline uint64 get() const;
+
+		/** Increases the count.
+		@param increment Set this to the number of new events. */
+		inline void increment(const uint64 increment = 1);
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		Counter(const Counter &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		Counter &operator =(const Counter &rhs) { assert(false); return *this; }
+
+	private:
+		std::atomic<uint64> mValue;	/// Sum of all increments.
+	};
+
+	/// Value which can go up and down, e.g., frames per second or the number of queued tasks.
+	/** Updates are lock-free and safe from any thread. See MetricsRegistry::addGauge(). */
+	class Gauge
+	{
+	public:
+		/** Creates a gauge with value 0. */
+		Gauge() : mValue(0.0) { }
+
+		/** Adds a possibly negative difference to the current value.
+		@param difference Set this to the change of the value. */
+		void add(const double difference);
+
+		/** Returns the current value.
+		@return Returns the value of the last set() call plus all later add() differences. */
+		inline double get() const;
+
+		/** Replaces the current value.
+		@param value Set this to the new value. */
+		inline void set(const double value);
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		Gauge(const Gauge &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		Gauge &operator =(const Gauge &rhs) { assert(false); return *this; }
+
+	private:
+		std::atomic<double> mValue;	/// Current value.
+	};
+
+	/// Distribution of observed values in buckets with fixed upper bounds, e.g., frame times in seconds.
+	/** Each observation atomically increases one bucket count and the sum of all values without locks.
+		Buckets are exported cumulatively like Prometheus histograms, see MetricsRegistry::addHistogram(). */
+	class Histogram
+	{
+	public:
+		/** Creates upper bounds start, start * factor, start * factor^2, ... for value ranges spanning several orders of magnitude.
+		@param start Set this to the positive upper bound of the first bucket.
+		@param factor Set this to the ratio of consecutive bounds which must be greater than 1.
+		@param count Set this to the number of bounds.
+		@return Returns count increasing upper bounds. */
+		static std::vector<double> createExponentialBounds(const double start, const double factor, const uint32 count);
+
+	public:
+		/** Creates a histogram without observations.
+		@param upperBounds Set this to the strictly increasing inclusive upper bounds of the buckets.
+			An additional bucket without upper bound takes all larger values. */
+		Histogram(const std::vector<double> &upperBounds);
+
+		/** Frees the bucket counts. */
+		~Histogram();
+
+		/** Replaces all observations by a snapshot of statistics which are gathered elsewhere, e.g., the call trees of the Profiler.
+			Only call this from a MetricsRegistry collector for histograms which are not observed otherwise.
+		@param bucketCounts Set this to getUpperBounds().size() + 1 non cumulative observation counts, one per bucket.
+		@param sum Set this to the sum of all observed values. */
+		void assign(const uint64 *bucketCounts, const double sum);
+
+		/** Returns the number of observations of a bucket.
+		@param bucketIdx Identifies the bucket. getUpperBounds().size() identifies the bucket without upper bound.
+		@return Returns how many observed values were in the bucket which is not cumulative. */
+		inline uint64 getBucketCount(const uint32 bucketIdx) const;
+
+		/** Returns the sum of all observed values.
+		@return Returns the sum of all values passed to observe(). */
+		inline double getSum() const;
+
+		/** Returns the inclusive upper bounds of the buckets.
+		@return Returns the strictly increasing bounds passed to the constructor. */
+		inline const std::vector<double> &getUpperBounds() const;
+
+		/** Adds a value to the bucket with the smallest upper bound which is not smaller than value.
+		@param value Set this to the observed value. */
+		void observe(const double value);
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		Histogram(const Histogram &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		Histogram &operator =(const Histogram &rhs) { assert(false); return *this; }
+
+	private:
+		const std::vector<double>	mUpperBounds;	/// Inclusive upper bound of each bucket but the last one.
+		std::atomic<uint64>			*mBucketCounts;	/// mUpperBounds.size() + 1 observation counts.
+		std::atomic<double>			mSum;			/// Sum of all observed values.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline uint64 Counter::get() const
+	{
+		return mValue.load(std::memory_order_relaxed);
+	}
+
+	inline void Counter::increment(const uint64 increment)
+	{
+		mValue.fetch_add(increment, std::memory_order_relaxed);
+	}
+
+	inline double Gauge::get() const
+	{
+		return mValue.load(std::memory_order_relaxed);
+	}
+
+	inline void Gauge::set(const double value)
+	{
+		mValue.store(value, std::memory_order_relaxed);
+	}
+
+	inline uint64 Histogram::getBucketCount(const uint32 bucketIdx) const
+	{
+		assert(bucketIdx <= mUpperBounds.size());
+		return mBucketCounts[bucketIdx].load(std::memory_order_relaxed);
+	}
+
+	inline double Histogram::getSum() const
+	{
+		return mSum.load(std::memory_order_relaxed);
+	}
+
+	inline const std::vector<double> &Histogram::getUpperBounds() const
+	{
+		return mUpperBounds;
+	}
+}
+
+#endif // _METRICS_H_
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifdef _LINUX
+	#include <cerrno>
+	#include <poll.h>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <unistd.h>
+#endif // _LINUX
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "Platform/FailureHandling/NetworkException.h"
+#include "Platform/Profiling/MetricsExporter.h"
+#include "Platform/Profiling/MetricsRegistry.h"
+
+using namespace FailureHandling;
+using namespace Profiling;
+using namespace std;
+
+const double MetricsExporter::DEFAULT_PERIOD = 5.0;
+
+MetricsExporter::MetricsExporter(const string &path, const TARGET target, const double period) :
+	mPath(path), mPeriod(period), mExportCount(0), mSocket(-1), mTarget(target), mRunning(true)
+{
+	assert(target < TARGET_COUNT);
+	assert(TARGET_UNIX_SOCKET == target || period > 0.0);
+
+	if (TARGET_UNIX_SOCKET == mTarget)
+	{
+		#ifdef _LINUX
+			sockaddr_un address;
+			memset(&address, 0, sizeof(sockaddr_un));
+			address.sun_family = AF_UNIX;
+			if (mPath.size() >= sizeof(address.sun_path))
+				throw NetworkException("The metrics socket path " + mPath + " is too long.", ENAMETOOLONG);
+			strcpy(address.sun_path, mPath.c_str());
+
+			mSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (-1 == mSocket)
+				throw NetworkException("Could not create the metrics socket " + mPath + ".", errno);
+
+			// replace a stale socket file of a previous run
+			unlink(mPath.c_str());
+			if (0 != bind(mSocket, reinterpret_cast<sockaddr *>(&address), sizeof(sockaddr_un)) || 0 != listen(mSocket, 8))
+			{
+				const int errorCode = errno;
+				close(mSocket);
+				mSocket = -1;
+				throw NetworkException("Could not bind or listen on the metrics socket " + mPath + ".", errorCode);
+			}
+		#else
+			throw NetworkException("UNIX sockets for metrics are only supported on Linux.", 0);
+		#endif // _LINUX
+	}
+
+	mExporter = thread(&MetricsExporter::exporterFunction, this);
+}
+
+MetricsExporter::~MetricsExporter()
+{
+	// stop exporter thread
+	{
+		unique_lock<mutex> uniqueLock(mMutex);
+		mRunning = false;
+	}
+	mCondition.notify_all();
+	mExporter.join();
+
+	if (TARGET_FILE == mTarget)
+	{
+		writeFile();
+		return;
+	}
+
+	#ifdef _LINUX
+		close(mSocket);
+		unlink(mPath.c_str());
+	#endif // _LINUX
+}
+
+void MetricsExporter::exporterFunction()
+{
+	unique_lock<mutex> uniqueLock(mMutex);
+
+	while (mRunning)
+	{
+		if (TARGET_FILE == mTarget)
+		{
+			uniqueLock.unlock();
+			writeFile();
+			uniqueLock.lock();
+
+			mCondition.wait_for(uniqueLock, chrono::duration<double>(mPeriod));
+			continue;
+		}
+
+		// socket: wait for a client or check mRunning from time to time
+		uniqueLock.unlock();
+		#ifdef _LINUX
+			pollfd request;
+			request.fd = mSocket;
+			request.events = POLLIN;
+			request.revents = 0;
+
+			if (poll(&request, 1, SOCKET_POLL_PERIOD) > 0 && (request.revents & POLLIN))
+			{
+				const int client = accept(mSocket, NULL, NULL);
+				if (-1 != client)
+					serveClient(client);
+			}
+		#endif // _LINUX
+		uniqueLock.lock();
+	}
+}
+
+void MetricsExporter::serveClient(const int client)
+{
+	#ifdef _LINUX
+		// HTTP clients send a request right away, plain clients usually send nothing
+		char request[1024];
+		ssize_t requestLength = 0;
+
+		pollfd readable;
+		readable.fd = client;
+		readable.events = POLLIN;
+		readable.revents = 0;
+		if (poll(&readable, 1, SOCKET_POLL_PERIOD) > 0 && (readable.revents & POLLIN))
+			requestLength = recv(client, request, sizeof(request), 0);
+
+		const bool http = (requestLength >= 4 && 0 == memcmp(request, "GET ", 4));
+		const string snapshot = MetricsRegistry::getSingleton().getPrometheusText();
+
+		string response;
+		if (http)
+		{
+			char header[256];
+			snprintf(header, sizeof(header),
+				"HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %llu\r\nConnection: close\r\n\r\n",
+				(unsigned long long) snapshot.size());
+			response = header;
+		}
+		response += snapshot;
+
+		// send everything, the client is disconnected afterwards
+		size_t sentBytes = 0;
+		while (sentBytes < response.size())
+		{
+			const ssize_t count = send(client, response.data() + sentBytes, response.size() - sentBytes, MSG_NOSIGNAL);
+			if (count <= 0)
+				break;
+			sentBytes += (size_t) count;
+		}
+
+		close(client);
+		++mExportCount;
+	#endif // _LINUX
+}
+
+bool MetricsExporter::writeFile()
+{
+	if (TARGET_FILE != mTarget)
+		return false;
+
+	unique_lock<mutex> uniqueLock(mFileMutex);
+	const string snapshot = MetricsRegistry::getSingleton().getPrometheusText();
+
+	// write everything into a temporary file and replace the target by it
+	const string temporaryPath = mPath + ".tmp";
+	FILE *file = fopen(temporaryPath.c_str(), "w");
+	if (!file)
+		return false;
+
+	const bool written = (snapshot.size() == fwrite(snapshot.data(), 1, snapshot.size(), file));
+	const bool closed = (0 == fclose(file));
+	if (!written || !closed)
+	{
+		remove(temporaryPath.c_str());
+		return false;
+	}
+
+	#ifdef _WINDOWS
+		// rename does not replace existing files on Windows
+		remove(mPath.c_str());
+	#endif // _WINDOWS
+	if (0 != rename(temporaryPath.c_str(), mPath.c_str()))
+		return false;
+
+	++mExportCount;
+	return true;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _METRICS_EXPORTER_H_
+#define _METRICS_EXPORTER_H_
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Platform/DataTypes.h"
+
+namespace Profiling
+{
+	/// Publishes Prometheus text snapshots of the MetricsRegistry from a background thread.
+	/** A file target is periodically replaced by a complete new snapshot via rename so that readers,
+		e.g., the textfile collector of the Prometheus node exporter, never see partially written snapshots.
+		A UNIX socket target is served on demand: each client gets a fresh snapshot and is disconnected.
+		Clients which send an HTTP request get an HTTP response, e.g., "curl --unix-socket <path> http://localhost/metrics",
+		and all other clients get the plain snapshot, e.g., "nc -U <path>". UNIX sockets are only supported on Linux.
+		The MetricsRegistry must exist as long as the exporter. */
+	class MetricsExporter
+	{
+	public:
+		/// Defines where snapshots are published.
+		enum TARGET
+		{
+			TARGET_FILE,		/// Snapshots are periodically written to a file.
+			TARGET_UNIX_SOCKET,	/// Snapshots are served to clients of a local stream socket.
+			TARGET_COUNT		/// Number of targets.
+		};
+
+	public:
+		/** Opens the target and starts the exporter thread.
+		@param path Set this to the snapshot file or to the socket file which is replaced if it exists.
+		@param target Set this to the kind of target.
+		@param period Set this to the number of seconds between two file snapshots. Ignored for sockets.
+		@throws NetworkException Is thrown if the UNIX socket cannot be created, bound or listened on. */
+		MetricsExporter(const std::string &path, const TARGET target, const double period = DEFAULT_PERIOD);
+
+		/** Stops the exporter thread, writes a last file snapshot or closes and removes the socket. */
+		~MetricsExporter();
+
+		/** Returns how many snapshots were published so far.
+		@return Returns the number of written files or served clients. */
+		inline uint64 getExportCount() const;
+
+		/** Writes a snapshot to the target file right away. Does nothing for socket targets.
+		@return Returns false if the snapshot could not be written. */
+		bool writeFile();
+
+	public:
+		static const double DEFAULT_PERIOD;			/// Default number of seconds between two file snapshots.
+		static const uint32 SOCKET_POLL_PERIOD = 100;	/// Defines after how many milliseconds without clients the socket thread checks whether it should stop.
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		MetricsExporter(const MetricsExporter &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		MetricsExporter &operator =(const MetricsExporter &rhs) { assert(false); return *this; }
+
+		/** Executed by the exporter thread which publishes snapshots until the exporter is destroyed. */
+		void exporterFunction();
+
+		/** Sends a snapshot to a connected socket client and closes the connection.
+		@param client Set this to the descriptor of the accepted client connection. */
+		void serveClient(const int client);
+
+	private:
+		std::string				mPath;			/// Snapshot file or socket file.
+		std::thread				mExporter;		/// Publishes snapshots.
+		std::condition_variable	mCondition;		/// Wakes up the exporter thread to end it.
+		std::mutex				mFileMutex;		/// Serializes writeFile() calls.
+		std::mutex				mMutex;			/// Protects mRunning for mCondition.
+		double					mPeriod;		/// Seconds between two file snapshots.
+		std::atomic<uint64>		mExportCount;	/// Number of published snapshots.
+		int						mSocket;		/// Listening socket descriptor or -1.
+		TARGET					mTarget;		/// Kind of target.
+		bool					mRunning;		/// Is true as long as the exporter thread should continue.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline uint64 MetricsExporter::getExportCount() const
+	{
+		return mExportCount;
+	}
+}
+
+#endif // _METRICS_EXPORTER_H_
@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include "Platform/Profiling/MetricsRegistry.h"
+
+using namespace Profiling;
+using namespace std;
+
+namespace
+{
+	/** Formats a sample value as required by the Prometheus text format.
+	@param value Set this to the value.
+	@return Returns the shortest exact representation or NaN, +Inf or -Inf. */
+	string formatValue(const double value)
+	{
+		if (value != value)
+			return "NaN";
+		if (value == HUGE_VAL)
+			return "+Inf";
+		if (value == -HUGE_VAL)
+			return "-Inf";
+
+		// shortest of 15 or 17 significant digits which reproduces value
+		char text[32];
+		snprintf(text, sizeof(text), "%.15g", value);
+		if (strtod(text, NULL) != value)
+			snprintf(text, sizeof(text), "%.17g", value);
+		return text;
+	}
+
+	/** Escapes backslashes and line breaks of HELP texts.
+	@param help Set this to the unescaped description.
+	@return Returns the escaped description. */
+	string escapeHelp(const string &help)
+	{
+		string escaped;
+		for (size_t charIdx = 0; charIdx < help.size(); ++charIdx)
+		{
+			if ('\\' == help[charIdx])
+				escaped += "\\\\";
+			else if ('\n' == help[charIdx])
+				escaped += "\\n";
+			else
+				escaped += help[charIdx];
+		}
+		return escaped;
+	}
+
+	#ifndef NDEBUG
+	/** Checks whether a string is a valid Prometheus metric name. Only used by assertions.
+	@param name Set this to the checked name.
+	@return Returns true if name matches [a-zA-Z_:][a-zA-Z0-9_:]*. */
+	bool isValidName(const string &name)
+	{
+		if (name.empty())
+			return false;
+
+		for (size_t charIdx = 0; charIdx < name.size(); ++charIdx)
+		{
+			const char c = name[charIdx];
+			const bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || '_' == c || ':' == c;
+			const bool digit = (c >= '0' && c <= '9');
+			if (!letter && (!digit || 0 == charIdx))
+				return false;
+		}
+
+		return true;
+	}
+	#endif // NDEBUG
+
+	/** Writes a sample line "name{labels} value".
+	@param text Is extended by the sample line.
+	@param name Set this to the metric name including suffixes like _bucket.
+	@param labels Set this to the comma separated label pairs of the sample, possibly empty.
+	@param value Set this to the already formatted sample value. */
+	void writeSample(ostringstream &text, const string &name, const string &labels, const string &value)
+	{
+		text << name;
+		if (!labels.empty())
+			text << '{' << labels << '}';
+		text << ' ' << value << '\n';
+	}
+}
+
+MetricsRegistry::MetricsRegistry()
+{
+}
+
+MetricsRegistry::~MetricsRegistry()
+{
+	for (size_t entryIdx = 0; entryIdx < mEntries.size(); ++entryIdx)
+	{
+		Entry &entry = mEntries[entryIdx];
+		switch (entry.mType)
+		{
+			case TYPE_COUNTER:		delete reinterpret_cast<Counter *>(entry.mMetric);		break;
+			case TYPE_GAUGE:		delete reinterpret_cast<Gauge *>(entry.mMetric);		break;
+			case TYPE_HISTOGRAM:	delete reinterpret_cast<Histogram *>(entry.mMetric);	break;
+
+			default:
+				assert(false);
+		}
+	}
+}
+
+void MetricsRegistry::addCollector(const function<void ()> &collector)
+{
+	unique_lock<mutex> uniqueLock(mCollectorsMutex);
+	mCollectors.push_back(collector);
+}
+
+Counter &MetricsRegistry::addCounter(const string &name, const string &help, const string &labels)
+{
+	unique_lock<mutex> uniqueLock(mEntriesMutex);
+	return *reinterpret_cast<Counter *>(findOrCreate(name, help, labels, TYPE_COUNTER, NULL));
+}
+
+Gauge &MetricsRegistry::addGauge(const string &name, const string &help, const string &labels)
+{
+	unique_lock<mutex> uniqueLock(mEntriesMutex);
+	return *reinterpret_cast<Gauge *>(findOrCreate(name, help, labels, TYPE_GAUGE, NULL));
+}
+
+Histogram &MetricsRegistry::addHistogram(const string &name, const string &help, const vector<double> &upperBounds, const string &labels)
+{
+	unique_lock<mutex> uniqueLock(mEntriesMutex);
+	return *reinterpret_cast<Histogram *>(findOrCreate(name, help, labels, TYPE_HISTOGRAM, &upperBounds));
+}
+
+string MetricsRegistry::escapeLabelValue(const string &value)
+{
+	string escaped;
+	for (size_t charIdx = 0; charIdx < value.size(); ++charIdx)
+	{
+		if ('\\' == value[charIdx])
+			escaped += "\\\\";
+		else if ('"' == value[charIdx])
+			escaped += "\\\"";
+		else if ('\n' == value[charIdx])
+			escaped += "\\n";
+		else
+			escaped += value[charIdx];
+	}
+	return escaped;
+}
+
+void *MetricsRegistry::findOrCreate(const string &name, const string &help, const string &labels,
+	const TYPE type, const vector<double> *upperBounds)
+{
+	assert(isValidName(name));
+
+	// already registered?
+	for (size_t entryIdx = 0; entryIdx < mEntries.size(); ++entryIdx)
+	{
+		const Entry &entry = mEntries[entryIdx];
+		if (entry.mName != name)
+			continue;
+
+		// a name has a single type
+		assert(entry.mType == type);
+		if (entry.mLabels == labels)
+			return entry.mMetric;
+	}
+
+	// create it
+	Entry entry;
+	entry.mName = name;
+	entry.mHelp = help;
+	entry.mLabels = labels;
+	entry.mType = type;
+
+	switch (type)
+	{
+		case TYPE_COUNTER:		entry.mMetric = new Counter();				break;
+		case TYPE_GAUGE:		entry.mMetric = new Gauge();				break;
+		case TYPE_HISTOGRAM:	entry.mMetric = new Histogram(*upperBounds);	break;
+
+		default:
+			assert(false);
+			entry.mMetric = NULL;
+	}
+
+	mEntries.push_back(entry);
+	return entry.mMetric;
+}
+
+string MetricsRegistry::getPrometheusText()
+{
+	static const char *TYPE_NAMES[TYPE_COUNT] = { "counter", "gauge", "histogram" };
+
+	// update pull style metrics
+	unique_lock<mutex> collectorsLock(mCollectorsMutex);
+	for (size_t collectorIdx = 0; collectorIdx < mCollectors.size(); ++collectorIdx)
+		mCollectors[collectorIdx]();
+
+	unique_lock<mutex> entriesLock(mEntriesMutex);
+
+	// group entries by name in registration order of the names
+	vector<string> names;
+	map<string, vector<size_t> > entriesPerName;
+	for (size_t entryIdx = 0; entryIdx < mEntries.size(); ++entryIdx)
+	{
+		vector<size_t> &group = entriesPerName[mEntries[entryIdx].mName];
+		if (group.empty())
+			names.push_back(mEntries[entryIdx].mName);
+		group.push_back(entryIdx);
+	}
+
+	ostringstream text;
+	for (size_t nameIdx = 0; nameIdx < names.size(); ++nameIdx)
+	{
+		const vector<size_t> &group = entriesPerName[names[nameIdx]];
+		const Entry &first = mEntries[group[0]];
+		text << "# HELP " << first.mName << ' ' << escapeHelp(first.mHelp) << '\n';
+		text << "# TYPE " << first.mName << ' ' << TYPE_NAMES[first.mType] << '\n';
+
+		for (size_t groupIdx = 0; groupIdx < group.size(); ++groupIdx)
+		{
+			const Entry &entry = mEntries[group[groupIdx]];
+			if (TYPE_COUNTER == entry.mType)
+			{
+				ostringstream value;
+				value << reinterpret_cast<const Counter *>(entry.mMetric)->get();
+				writeSample(text, entry.mName, entry.mLabels, value.str());
+				continue;
+			}
+
+			if (TYPE_GAUGE == entry.mType)
+			{
+				writeSample(text, entry.mName, entry.mLabels, formatValue(reinterpret_cast<const Gauge *>(entry.mMetric)->get()));
+				continue;
+			}
+
+			// histogram: cumulative buckets, sum & count
+			const Histogram &histogram = *reinterpret_cast<const Histogram *>(entry.mMetric);
+			const vector<double> &bounds = histogram.getUpperBounds();
+			const string separator = (entry.mLabels.empty() ? "" : ",");
+			uint64 cumulativeCount = 0;
+
+			for (uint32 bucketIdx = 0; bucketIdx <= bounds.size(); ++bucketIdx)
+			{
+				cumulativeCount += histogram.getBucketCount(bucketIdx);
+				const string bound = (bucketIdx < bounds.size() ? formatValue(bounds[bucketIdx]) : "+Inf");
+
+				ostringstream value;
+				value << cumulativeCount;
+				writeSample(text, entry.mName + "_bucket", entry.mLabels + separator + "le=\"" + bound + "\"", value.str());
+			}
+
+			ostringstream count;
+			count << cumulativeCount;
+			writeSample(text, entry.mName + "_sum", entry.mLabels, formatValue(histogram.getSum()));
+			writeSample(text, entry.mName + "_count", entry.mLabels, count.str());
+		}
+	}
+
+	return text.str();
+}
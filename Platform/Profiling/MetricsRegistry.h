@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _METRICS_REGISTRY_H_
+#define _METRICS_REGISTRY_H_
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Patterns/Singleton.h"
+#include "Platform/Profiling/Metrics.h"
+
+namespace Profiling
+{
+	/// Owns all named runtime metrics of the application and creates Prometheus text snapshots of them.
+	/** Subsystems register counters, gauges and histograms once, keep the returned references and update them lock-free on hot paths.
+		Registration and snapshots lock a mutex. Registered metrics live as long as the registry.
+		Values which are cheap to query but expensive to track, e.g., queue lengths, can be updated right before each snapshot by collectors.
+		See MetricsExporter for periodic export of snapshots. */
+	class MetricsRegistry : public Patterns::Singleton<MetricsRegistry>
+	{
+	public:
+		/// Kind of a registered metric.
+		enum TYPE
+		{
+			TYPE_COUNTER,	/// See Counter.
+			TYPE_GAUGE,		/// See Gauge.
+			TYPE_HISTOGRAM,	/// See Histogram.
+			TYPE_COUNT		/// Number of types.
+		};
+
+	public:
+		/** Creates an empty registry. */
+		MetricsRegistry();
+
+		/** Frees all registered metrics. */
+		virtual ~MetricsRegistry();
+
+		/** Adds a function which is called before each snapshot, e.g., to set gauges to the current length of some queue.
+		@param collector Set this to a thread safe function which only updates registered metrics. It may register metrics. */
+		void addCollector(const std::function<void ()> &collector);
+
+		/** Registers a counter or returns the already registered counter with the same name and labels.
+		@param name Set this to a Prometheus metric name ([a-zA-Z_:][a-zA-Z0-9_:]*) which should end with _total, e.g., "frames_total".
+		@param help Set this to a short description of the metric.
+		@param labels Set this to an empty string or to comma separated label pairs which distinguish metrics with the same name, e.g., "phase=\"Render\"".
+		@return Returns the counter which lives as long as the registry. */
+		Counter &addCounter(const std::string &name, const std::string &help, const std::string &labels = "");
+
+		/** Registers a gauge or returns the already registered gauge with the same name and labels.
+		@param name Set this to a Prometheus metric name, e.g., "task_queue_depth".
+		@param help Set this to a short description of the metric.
+		@param labels Set this to an empty string or to comma separated label pairs, see addCounter().
+		@return Returns the gauge which lives as long as the registry. */
+		Gauge &addGauge(const std::string &name, const std::string &help, const std::string &labels = "");
+
+		/** Registers a histogram or returns the already registered histogram with the same name and labels.
+		@param name Set this to a Prometheus metric name with unit suffix, e.g., "frame_time_seconds".
+		@param help Set this to a short description of the metric.
+		@param upperBounds Set this to the strictly increasing upper bounds of the buckets, see Histogram::createExponentialBounds().
+			Ignored if the histogram already exists.
+		@param labels Set this to an empty string or to comma separated label pairs, see addCounter().
+		@return Returns the histogram which lives as long as the registry. */
+		Histogram &addHistogram(const std::string &name, const std::string &help, const std::vector<double> &upperBounds,
+			const std::string &labels = "");
+
+		/** Escapes backslashes, double quotes and line breaks of a label value, e.g., of a zone name.
+		@param value Set this to the unescaped label value.
+		@return Returns the value which can be put between the double quotes of a label pair. */
+		static std::string escapeLabelValue(const std::string &value);
+
+		/** Runs all collectors and writes all metrics in the Prometheus text exposition format (version 0.0.4).
+			Metrics with the same name are grouped under a single HELP and TYPE line in the order in which their names were registered.
+		@return Returns the complete snapshot text. */
+		std::string getPrometheusText();
+
+	private:
+		/// Registered metric including its identification.
+		struct Entry
+		{
+			std::string	mName;		/// Metric name without labels.
+			std::string	mHelp;		/// Description of the metric.
+			std::string	mLabels;	/// Comma separated label pairs or empty.
+			void		*mMetric;	/// Counter, Gauge or Histogram object according to mType.
+			TYPE		mType;		/// Kind of mMetric.
+		};
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		MetricsRegistry(const MetricsRegistry &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		MetricsRegistry &operator =(const MetricsRegistry &rhs) { assert(false); return *this; }
+
+		/** Finds a registered metric or creates it. mEntriesMutex must be locked.
+		@param name Set this to the metric name.
+		@param help Set this to the description which is used for new metrics.
+		@param labels Set this to the labels of the metric.
+		@param type Set this to the kind of metric which must match the kind of an existing metric with the same name and labels.
+		@param upperBounds Set this to the bucket bounds of new histograms or NULL for other types.
+		@return Returns the existing or new metric object. */
+		void *findOrCreate(const std::string &name, const std::string &help, const std::string &labels,
+			const TYPE type, const std::vector<double> *upperBounds);
+
+	private:
+		std::vector<std::function<void ()> >	mCollectors;		/// Called before each snapshot.
+		std::vector<Entry>						mEntries;			/// All registered metrics in registration order.
+		std::mutex								mCollectorsMutex;	/// Serializes snapshots and protects mCollectors.
+		std::mutex								mEntriesMutex;		/// Protects mEntries.
+	};
+}
+
+#endif // _METRICS_REGISTRY_H_
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cstring>
+#ifdef _LINUX
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif // _LINUX
+#include "Platform/Profiling/PerformanceCounters.h"
+
+using namespace Profiling;
+
+#ifdef _LINUX
+	/** Opens a single counter of the calling thread.
+	@param type Set this to the perf event type, e.g., PERF_TYPE_HARDWARE.
+	@param config Set this to the perf event of type, e.g., PERF_COUNT_HW_INSTRUCTIONS.
+	@param excludeKernel Set this to true to only count user space events.
+		Must be false for events which only occur in the kernel, e.g., PERF_COUNT_SW_CONTEXT_SWITCHES.
+	@param groupLeader Set this to the descriptor of the group leader or to -1 to open a new group.
+	@return Returns the descriptor of the counter or -1 if it could not be opened. */
+	static int openCounter(const uint32 type, const uint64 config, const bool excludeKernel, const int groupLeader)
+	{
+		perf_event_attr attributes;
+		memset(&attributes, 0, sizeof(perf_event_attr));
+
+		attributes.size = sizeof(perf_event_attr);
+		attributes.type = type;
+		attributes.config = config;
+		attributes.disabled = (-1 == groupLeader ? 1 : 0);
+		attributes.exclude_kernel = (excludeKernel ? 1 : 0);
+		attributes.exclude_hv = 1;
+		attributes.read_format = PERF_FORMAT_GROUP;
+
+		// pid = 0 & cpu = -1: calling thread on any CPU
+		return (int) syscall(__NR_perf_event_open, &attributes, 0, -1, groupLeader, 0);
+	}
+#endif // _LINUX
+
+PerformanceCounters::PerformanceCounters() :
+	mGroupSize(0)
+{
+	for (uint32 counterIdx = 0; counterIdx < COUNTER_COUNT; ++counterIdx)
+	{
+		mFileDescriptors[counterIdx] = -1;
+		mGroupOrder[counterIdx] = COUNTER_COUNT;
+	}
+
+	#ifdef _LINUX
+		const uint32 types[COUNTER_COUNT] =
+		{
+			PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE
+		};
+		const uint64 configs[COUNTER_COUNT] =
+		{
+			PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_SW_CONTEXT_SWITCHES
+		};
+
+		// the first counter which can be opened leads the group, missing counters are skipped
+		for (uint32 counterIdx = 0; counterIdx < COUNTER_COUNT; ++counterIdx)
+		{
+			const int leader = (0 == mGroupSize ? -1 : mFileDescriptors[mGroupOrder[0]]);
+			// context switches are counted by the kernel
+			const bool excludeKernel = (COUNTER_CONTEXT_SWITCHES != counterIdx);
+			const int descriptor = openCounter(types[counterIdx], configs[counterIdx], excludeKernel, leader);
+			if (descriptor < 0)
+				continue;
+
+			mFileDescriptors[counterIdx] = descriptor;
+			mGroupOrder[mGroupSize] = counterIdx;
+			++mGroupSize;
+		}
+
+		// start counting
+		if (0 == mGroupSize)
+			return;
+
+		const int leader = mFileDescriptors[mGroupOrder[0]];
+		ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	#endif // _LINUX
+}
+
+PerformanceCounters::~PerformanceCounters()
+{
+	#ifdef _LINUX
+		// close members before the leader
+		for (uint32 orderIdx = mGroupSize; orderIdx > 0; --orderIdx)
+			close(mFileDescriptors[mGroupOrder[orderIdx - 1]]);
+	#endif // _LINUX
+
+	mGroupSize = 0;
+}
+
+const char *PerformanceCounters::getName(const COUNTER counter)
+{
+	switch (counter)
+	{
+		case COUNTER_CYCLES:			return "cycles";
+		case COUNTER_INSTRUCTIONS:		return "instructions";
+		case COUNTER_CACHE_MISSES:		return "cache misses";
+		case COUNTER_BRANCH_MISSES:		return "branch misses";
+		case COUNTER_CONTEXT_SWITCHES:	return "context switches";
+
+		default:
+			assert(false);
+			return "unknown";
+	}
+}
+
+bool PerformanceCounters::read(Sample &sample) const
+{
+	memset(&sample, 0, sizeof(Sample));
+	if (0 == mGroupSize)
+		return false;
+
+	#ifdef _LINUX
+		// group layout: counter count followed by all values in group order
+		uint64 buffer[1 + COUNTER_COUNT];
+		const ssize_t expectedSize = (ssize_t) ((1 + mGroupSize) * sizeof(uint64));
+		if (::read(mFileDescriptors[mGroupOrder[0]], buffer, sizeof(buffer)) < expectedSize)
+			return false;
+
+		for (uint32 orderIdx = 0; orderIdx < mGroupSize; ++orderIdx)
+			sample.mValues[mGroupOrder[orderIdx]] = buffer[1 + orderIdx];
+		return true;
+	#else
+		return false;
+	#endif // _LINUX
+}
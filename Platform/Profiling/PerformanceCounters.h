@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _PERFORMANCE_COUNTERS_H_
+#define _PERFORMANCE_COUNTERS_H_
+
+#include <cassert>
+#include "Platform/DataTypes.h"
+
+namespace Profiling
+{
+	/// Hardware and operating system event counters of the calling thread, e.g., executed instructions or cache misses.
+	/** The counters are opened for the thread which creates the object via perf_event_open and only count user space events of this thread,
+		except for context switches which only occur in the kernel.
+		All available counters form a single group which is read at once with a single system call.
+		Counters which cannot be opened, e.g., since there is no PMU in a virtual machine or since perf events are not permitted,
+		are reported as unavailable and all other counters still work. Without Linux, no counter is available. */
+	class PerformanceCounters
+	{
+	public:
+		/// Identifies the counted events.
+		enum COUNTER
+		{
+			COUNTER_CYCLES,				/// CPU cycles.
+			COUNTER_INSTRUCTIONS,		/// Retired instructions.
+			COUNTER_CACHE_MISSES,		/// Last level cache misses.
+			COUNTER_BRANCH_MISSES,		/// Mispredicted branches.
+			COUNTER_CONTEXT_SWITCHES,	/// Context switches of the thread.
+			COUNTER_COUNT				/// Number of counters.
+		};
+
+		/// Values of all counters at a single time point.
+		struct Sample
+		{
+			uint64 mValues[COUNTER_COUNT];	/// Counter values indexed by COUNTER. Unavailable counters are zero.
+		};
+
+	public:
+		/** Opens all counters for the calling thread which must be the only thread using the object.
+			Never throws if counters are unavailable, see isAvailable(). */
+		PerformanceCounters();
+
+		/** Closes all counters. */
+		~PerformanceCounters();
+
+		/** Returns the name of a counter, e.g., for reports.
+		@param counter Identifies the counter.
+		@return Returns a short descriptive name, e.g., "instructions". */
+		static const char *getName(const COUNTER counter);
+
+		/** Returns whether at least one counter could be opened.
+		@return Returns true if read() provides meaningful values for some counters. */
+		inline bool isAvailable() const;
+
+		/** Returns whether a particular counter could be opened.
+		@param counter Identifies the counter.
+		@return Returns true if read() provides meaningful values for counter. */
+		inline bool isAvailable(const COUNTER counter) const;
+
+		/** Reads the current values of all counters with a single system call.
+		@param sample Is filled with the current counter values. Values of unavailable counters are set to zero.
+		@return Returns false if the counters could not be read. sample is then set to zeros. */
+		bool read(Sample &sample) const;
+
+	public:
+		static const uint64 INVALID_VALUE = (uint64) -1;	/// Marks differences of counters which are not available.
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		PerformanceCounters(const PerformanceCounters &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		PerformanceCounters &operator =(const PerformanceCounters &rhs) { assert(false); return *this; }
+
+	private:
+		int		mFileDescriptors[COUNTER_COUNT];	/// Descriptor of each opened counter or -1. The counter mGroupOrder[0] is the group leader.
+		uint32	mGroupOrder[COUNTER_COUNT];			/// Counters in the order in which they were added to the group which is the order of read values.
+		uint32	mGroupSize;							/// Number of opened counters.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline bool PerformanceCounters::isAvailable() const
+	{
+		return mGroupSize > 0;
+	}
+
+	inline bool PerformanceCounters::isAvailable(const COUNTER counter) const
+	{
+		assert(counter < COUNTER_COUNT);
+		return mFileDescriptors[counter] >= 0;
+	}
+}
+
+#endif // _PERFORMANCE_COUNTERS_H_
@@ -6,40 +6,107 @@
  * of the BSD 3-Clause license. See the License.txt file for details.
  */
 
+#include <iostream>
+#include <map>
+#include <sstream>
+#include "Platform/FailureHandling/Exception.h"
+#include "Platform/Multithreading/Manager.h"
 #include "Platform/Storage/File.h"
 #include "Platform/Profiling/Profiler.h"
+#include "Platform/Profiling/TraceExporter.h"
 
+using namespace Platform::Multithreading;
 using namespace Profiling;
 using namespace std;
 using namespace Storage;
 using namespace Timing;
 
+thread_local string Profiler::msCurrentThreadName;
+thread_local EventBuffer *Profiler::msCurrentThreadBuffer = NULL;
+thread_local PerformanceCounters *Profiler::msCurrentThreadCounters = NULL;
+thread_local uint32 Profiler::msCurrentThreadIdx = 0;
+thread_local uint32 Profiler::msCurrentThreadGeneration = 0;
+atomic<uint32> Profiler::msGeneration(0);
 
-Profiler::Profiler(const string *measurementNames, uint32 numberOfMeasurementNames)
+void Profiler::setCurrentThreadName(const string &name)
 {
+	msCurrentThreadName = name;
+
+	// rename existing profile
+	if (!Profiler::exists() || msCurrentThreadGeneration != msGeneration.load() || !msCurrentThreadBuffer)
+		return;
+
+	Profiler &profiler = Profiler::getSingleton();
+	unique_lock<mutex> uniqueLock(profiler.mThreadsMutex);
+		profiler.mThreadProfiles[msCurrentThreadIdx]->setName(name);
+	uniqueLock.unlock();
+}
+
+Profiler::Profiler(const string *measurementNames, uint32 numberOfMeasurementNames, const uint32 traceHistoryCapacity) :
+	mFrameStarts(FRAME_HISTORY_CAPACITY), mFrameCount(0), mTraceHistoryCapacity(traceHistoryCapacity),
+	mCollectorRunning(false), mEpoch(chrono::high_resolution_clock::now()), mEnabled(true)
+{
+	assert(traceHistoryCapacity > 0);
+
+	// invalidate event buffers of previous profilers
+	++msGeneration;
+
 	#ifdef PROFILING
 		// allocate memory & create 1x TimeMeasurements for each type / name
 		mMeasurementStarts.resize(numberOfMeasurementNames);
 		for (uint32 i = 0; i < numberOfMeasurementNames; ++i)
 			mTimeMeasurements.push_back(measurementNames[i]);
+
+		// the creating thread is usually the main thread
+		if (msCurrentThreadName.empty())
+			msCurrentThreadName = "Main";
+		getEventBuffer();
+
+		// start draining event buffers in the background
+		mCollectorRunning = true;
+		mCollector = thread(&Profiler::collectorFunction, this);
 	#endif // PROFILING
 }
 
 Profiler::~Profiler()
 {
+	// stop the collector
+	if (mCollector.joinable())
+	{
+		unique_lock<mutex> collectorLock(mCollectorMutex);
+			mCollectorRunning = false;
+		collectorLock.unlock();
+
+		mCollectorCondition.notify_one();
+		mCollector.join();
+	}
 
+	const size_t threadCount = mThreadProfiles.size();
+	for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+	{
+		delete mEventBuffers[threadIdx];
+		delete mPerformanceCounters[threadIdx];
+		delete mThreadProfiles[threadIdx];
+	}
+	mEventBuffers.clear();
+	mPerformanceCounters.clear();
+	mThreadProfiles.clear();
 }
 
-uint32 Profiler::addMeasurementType(const string &name)
+uint32 Profiler::addMeasurementType(const string &name, const double windowLength)
 {
 	#ifdef PROFILING
 		// add new representation & update mMeasurementStarts
-		mTimeMeasurements.push_back(TimeMeasurements(name));
+		unique_lock<mutex> uniqueLock(mMeasurementsMutex);
+			mTimeMeasurements.push_back(TimeMeasurements(name, windowLength));
 
-		size_t newCount = mTimeMeasurements.size();
-		mMeasurementStarts.resize(newCount);
+			size_t newCount = mTimeMeasurements.size();
+			mMeasurementStarts.resize(newCount);
+		uniqueLock.unlock();
 
 		return (uint32) (newCount - 1);
+	#else
+		return 0;
 	#endif // PROFILING
 }
 
@@ -47,58 +114,377 @@ void Profiler::addTimeMeasurement(uint32 index, double timePeriod)
 {
 	#ifdef PROFILING
 		// update the specific TimeMeasurements object
-		assert(index < mTimeMeasurements.size());
-		mTimeMeasurements[index].add(timePeriod);
+		unique_lock<mutex> uniqueLock(mMeasurementsMutex);
+			assert(index < mTimeMeasurements.size());
+			mTimeMeasurements[index].add(timePeriod);
+		uniqueLock.unlock();
 	#endif // PROFILING
 }
 
-void Profiler::endTimeMeasurement(uint32 index)
+void Profiler::collect()
 {
 	#ifdef PROFILING
-		assert(index < mTimeMeasurements.size());
+		unique_lock<mutex> uniqueLock(mThreadsMutex);
+			const size_t threadCount = mEventBuffers.size();
+			for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+				mEventBuffers[threadIdx]->drain(*mThreadProfiles[threadIdx]);
+		uniqueLock.unlock();
+	#endif // PROFILING
+}
+
+void Profiler::collectorFunction()
+{
+	setCurrentThreadName("Profiler Collector");
+
+	vector<TraceRequest> requests;
+	TraceWindow window;
+
+	unique_lock<mutex> collectorLock(mCollectorMutex);
+	while (mCollectorRunning)
+	{
+		mCollectorCondition.wait_for(collectorLock, chrono::milliseconds(COLLECTOR_PERIOD));
+		requests.swap(mTraceRequests);
+
+		collectorLock.unlock();
+			collect();
+
+			// requested traces after the zones of their windows were collected
+			// a trace which cannot be written, e.g., due to a missing directory or a full disk, is dropped since nobody could catch the exception on this thread
+			const size_t requestCount = requests.size();
+			for (size_t requestIdx = 0; requestIdx < requestCount; ++requestIdx)
+			{
+				const TraceRequest &request = requests[requestIdx];
+				try
+				{
+					copyTraceWindow(window, request.mBegin, request.mEnd);
+					writeTrace(request.mFileName, window);
+				}
+				catch (FailureHandling::Exception &exception)
+				{
+					cerr << "Profiler: Dropped the requested trace " << request.mFileName << ".\n" << exception << endl;
+				}
+			}
+			requests.clear();
+		collectorLock.lock();
+	}
+}
+
+void Profiler::copyTraceWindow(TraceWindow &window, const uint64 begin, const uint64 end) const
+{
+	window.mFrameIndices.clear();
+	window.mFrameStarts.clear();
+
+	unique_lock<mutex> uniqueLock(mThreadsMutex);
+		// most recent frames
+		const uint64 oldestFrameIdx = (mFrameCount > FRAME_HISTORY_CAPACITY ? mFrameCount - FRAME_HISTORY_CAPACITY : 0);
+		for (uint64 frameIdx = oldestFrameIdx; frameIdx < mFrameCount; ++frameIdx)
+		{
+			const uint64 frameStart = mFrameStarts[frameIdx % FRAME_HISTORY_CAPACITY];
+			if (frameStart < begin || frameStart > end)
+				continue;
+
+			window.mFrameIndices.push_back(frameIdx);
+			window.mFrameStarts.push_back(frameStart);
+		}
+
+		// zones of all threads
+		const size_t threadCount = mThreadProfiles.size();
+		window.mThreads.resize(threadCount);
+		for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+		{
+			const ThreadProfile &profile = *mThreadProfiles[threadIdx];
+			TraceWindow::Thread &thread = window.mThreads[threadIdx];
 
+			thread.mEvents.clear();
+			profile.copyEvents(thread.mEvents, begin, end);
+			thread.mName = profile.getName();
+			thread.mIndex = profile.getIndex();
+		}
+	uniqueLock.unlock();
+}
+
+PerformanceCounters &Profiler::createPerformanceCounters()
+{
+	// open counters outside of the lock, they only count the calling thread
+	PerformanceCounters *counters = new PerformanceCounters();
+
+	unique_lock<mutex> uniqueLock(mThreadsMutex);
+		mPerformanceCounters[msCurrentThreadIdx] = counters;
+	uniqueLock.unlock();
+
+	msCurrentThreadCounters = counters;
+	return *counters;
+}
+
+EventBuffer &Profiler::createEventBuffer()
+{
+	// create & register a new buffer and profile for the calling thread
+	unique_lock<mutex> uniqueLock(mThreadsMutex);
+		const uint32 threadIdx = (uint32) mThreadProfiles.size();
+		string name = msCurrentThreadName;
+		if (name.empty())
+		{
+			ostringstream stream;
+			stream << "Thread " << threadIdx;
+			name = stream.str();
+		}
+
+		msCurrentThreadBuffer = new EventBuffer(EVENT_BUFFER_CAPACITY);
+		msCurrentThreadCounters = NULL;
+		msCurrentThreadIdx = threadIdx;
+		msCurrentThreadGeneration = msGeneration.load();
+		mEventBuffers.push_back(msCurrentThreadBuffer);
+		mPerformanceCounters.push_back(NULL);
+		mThreadProfiles.push_back(new ThreadProfile(threadIdx, name, mTraceHistoryCapacity));
+	uniqueLock.unlock();
+
+	return *msCurrentThreadBuffer;
+}
+
+void Profiler::endTimeMeasurement(uint32 index)
+{
+	#ifdef PROFILING
 		// compute & store delta time
 		ApplicationTimer &appTimer = ApplicationTimer::getSingleton();
-		TimeMeasurements &times = mTimeMeasurements[index];
-		const TimePoint *start = &mMeasurementStarts[index];
 
-		times.add(appTimer.getTimeMeasurement(start));
+		unique_lock<mutex> uniqueLock(mMeasurementsMutex);
+			assert(index < mTimeMeasurements.size());
+			TimeMeasurements &times = mTimeMeasurements[index];
+			const TimePoint *start = &mMeasurementStarts[index];
+
+			times.add(appTimer.getTimeMeasurement(start));
+		uniqueLock.unlock();
+	#endif // PROFILING
+}
+
+uint64 Profiler::getDroppedZoneCount() const
+{
+	uint64 count = 0;
+
+	unique_lock<mutex> uniqueLock(mThreadsMutex);
+		const size_t threadCount = mEventBuffers.size();
+		for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+			count += mEventBuffers[threadIdx]->getDroppedZoneCount() + mThreadProfiles[threadIdx]->getOverwrittenEventCount();
+	uniqueLock.unlock();
+
+	return count;
+}
+
+void Profiler::getZoneStatistics(map<string, TimeMeasurements> &zones) const
+{
+	unique_lock<mutex> uniqueLock(mThreadsMutex);
+		const size_t threadCount = mThreadProfiles.size();
+		for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+		{
+			// root is only a dummy node
+			const vector<CallTreeNode> &callTree = mThreadProfiles[threadIdx]->getCallTree();
+			const size_t nodeCount = callTree.size();
+			for (size_t nodeIdx = 1; nodeIdx < nodeCount; ++nodeIdx)
+			{
+				const CallTreeNode &node = callTree[nodeIdx];
+				map<string, TimeMeasurements>::iterator it = zones.insert(make_pair(string(node.mName), TimeMeasurements(node.mName))).first;
+				it->second.merge(node.mTimes);
+			}
+		}
+	uniqueLock.unlock();
+}
+
+void Profiler::markFrame()
+{
+	#ifdef PROFILING
+		const uint64 timeStamp = getTimeStamp();
+
+		unique_lock<mutex> uniqueLock(mThreadsMutex);
+			mFrameStarts[mFrameCount % FRAME_HISTORY_CAPACITY] = timeStamp;
+			++mFrameCount;
+		uniqueLock.unlock();
+	#endif // PROFILING
+}
+
+void Profiler::requestTrace(const string &fileName, const uint64 begin, const uint64 end)
+{
+	#ifdef PROFILING
+		TraceRequest request;
+		request.mFileName = fileName;
+		request.mBegin = begin;
+		request.mEnd = end;
+
+		unique_lock<mutex> collectorLock(mCollectorMutex);
+			mTraceRequests.push_back(request);
+		collectorLock.unlock();
+
+		mCollectorCondition.notify_one();
 	#endif // PROFILING
 }
 
 void Profiler::reset()
 {
 	#ifdef PROFILING
-		size_t count = mTimeMeasurements.size();
-		for (size_t i = 0; i < count; ++i)
-			mTimeMeasurements[i].reset();
+		unique_lock<mutex> measurementsLock(mMeasurementsMutex);
+			size_t count = mTimeMeasurements.size();
+			for (size_t i = 0; i < count; ++i)
+				mTimeMeasurements[i].reset();
+		measurementsLock.unlock();
+
+		// process pending events first to keep open zones consistent
+		collect();
+
+		unique_lock<mutex> uniqueLock(mThreadsMutex);
+			const size_t threadCount = mThreadProfiles.size();
+			for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+				mThreadProfiles[threadIdx]->reset();
+
+			mFrameCount = 0;
+		uniqueLock.unlock();
 	#endif // PROFILING
 }
 
-void Profiler::saveToFile(const std::string &fileName) const
+void Profiler::saveToFile(const std::string &fileName)
 {
 	#ifdef PROFILING
+		collect();
+
 		File file(fileName, File::CREATE_WRITING, false);
 
 		fprintf(&file.getHandle(), "Profiling File\n");
 
-		size_t count = mTimeMeasurements.size();
-		for (size_t i = 0; i < count; ++i)
+		FILE *handle = &file.getHandle();
+
+		unique_lock<mutex> measurementsLock(mMeasurementsMutex);
+			size_t count = mTimeMeasurements.size();
+			for (size_t i = 0; i < count; ++i)
+			{
+				string text = mTimeMeasurements[i].toString();
+				fputs(text.c_str(), handle);
+				fputc('\n', handle);
+			}
+
+			// percentiles of measurements
+			if (count > 0)
+			{
+				fprintf(handle, "\nPercentiles\n%s\n", TimeMeasurements::getPercentileTableHeader().c_str());
+				for (size_t i = 0; i < count; ++i)
+					fprintf(handle, "%s\n", mTimeMeasurements[i].toPercentileString().c_str());
+			}
+		measurementsLock.unlock();
+
+		// call trees
+		unique_lock<mutex> uniqueLock(mThreadsMutex);
+			const size_t threadCount = mThreadProfiles.size();
+			for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+			{
+				const ThreadProfile &profile = *mThreadProfiles[threadIdx];
+				fputc('\n', handle);
+				fputs(profile.toString().c_str(), handle);
+
+				const uint64 droppedCount = mEventBuffers[threadIdx]->getDroppedZoneCount();
+				if (droppedCount > 0)
+					fprintf(handle, "\tDropped zones (full event buffer): %llu\n", (unsigned long long) droppedCount);
+
+				const uint64 overwrittenCount = profile.getOverwrittenEventCount();
+				if (overwrittenCount > 0)
+					fprintf(handle, "\tDropped zones (overwritten trace history): %llu\n", (unsigned long long) overwrittenCount);
+
+				const PerformanceCounters *counters = mPerformanceCounters[threadIdx];
+				if (counters && !counters->isAvailable())
+					fprintf(handle, "\tPerformance counters are not available (perf_event_open failed).\n");
+			}
+		uniqueLock.unlock();
+
+		// percentiles of zones merged over all call paths & threads
+		map<string, TimeMeasurements> zones;
+		getZoneStatistics(zones);
+		if (!zones.empty())
 		{
-			string text = mTimeMeasurements[i].toString();
-			fputs(text.c_str(), &file.getHandle());
-			fputc('\n', &file.getHandle());
+			fprintf(handle, "\nZone percentiles (all threads)\n%s\n", TimeMeasurements::getPercentileTableHeader().c_str());
+			for (map<string, TimeMeasurements>::const_iterator it = zones.begin(); it != zones.end(); ++it)
+				fprintf(handle, "%s\n", it->second.toPercentileString().c_str());
+		}
+
+		// task scheduling of the worker threads
+		if (Manager::exists() && Manager::getSingleton().getWorkerStatisticsCount() > 0)
+		{
+			const Manager &manager = Manager::getSingleton();
+			const uint32 workerCount = manager.getWorkerStatisticsCount();
+
+			WorkerStatistics total;
+			total.mBusyTime = total.mIdleTime = total.mLongestRunTime = total.mTaskCount = total.mEmptyWakeUpCount = 0;
+
+			fprintf(handle, "\nTask scheduler (times in microseconds)\n"
+				"Worker\tTasks\tBusy %%\tEmpty wake ups\tLatency p50\tLatency p99\tRun p50\tRun p99\tRun max\n");
+			for (uint32 workerIdx = 0; workerIdx <= workerCount; ++workerIdx)
+			{
+				// last line: all workers merged
+				WorkerStatistics statistics;
+				if (workerIdx < workerCount)
+				{
+					manager.getWorkerStatistics(statistics, workerIdx);
+					total.mQueueLatencies.merge(statistics.mQueueLatencies);
+					total.mRunTimes.merge(statistics.mRunTimes);
+					total.mBusyTime += statistics.mBusyTime;
+					total.mIdleTime += statistics.mIdleTime;
+					total.mTaskCount += statistics.mTaskCount;
+					total.mEmptyWakeUpCount += statistics.mEmptyWakeUpCount;
+					if (statistics.mLongestRunTime > total.mLongestRunTime)
+						total.mLongestRunTime = statistics.mLongestRunTime;
+
+					fprintf(handle, "%u", workerIdx);
+				}
+				else
+				{
+					statistics = total;
+					fprintf(handle, "All");
+				}
+
+				const uint64 activeTime = statistics.mBusyTime + statistics.mIdleTime;
+				fprintf(handle, "\t%llu\t%.1f\t%llu\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\n",
+					(unsigned long long) statistics.mTaskCount,
+					(activeTime > 0 ? 100.0 * statistics.mBusyTime / activeTime : 0.0),
+					(unsigned long long) statistics.mEmptyWakeUpCount,
+					statistics.mQueueLatencies.getPercentile(0.5) * 1e-3, statistics.mQueueLatencies.getPercentile(0.99) * 1e-3,
+					statistics.mRunTimes.getPercentile(0.5) * 1e-3, statistics.mRunTimes.getPercentile(0.99) * 1e-3,
+					statistics.mLongestRunTime * 1e-3);
+			}
 		}
 	#endif // PROFILING
 }
 
+void Profiler::saveTrace(const string &fileName, const uint64 begin, const uint64 end)
+{
+	#ifdef PROFILING
+		collect();
+
+		TraceWindow window;
+		copyTraceWindow(window, begin, end);
+		writeTrace(fileName, window);
+	#endif // PROFILING
+}
 
 void Profiler::startTimeMeasurement(uint32 index)
 {
 	#ifdef PROFILING
-		assert(index < mTimeMeasurements.size());
-
 		// store current time point
-		mMeasurementStarts[index] = ApplicationTimer::getSingleton().startTimeMeasurement();
+		const TimePoint start = ApplicationTimer::getSingleton().startTimeMeasurement();
+
+		unique_lock<mutex> uniqueLock(mMeasurementsMutex);
+			assert(index < mMeasurementStarts.size());
+			mMeasurementStarts[index] = start;
+		uniqueLock.unlock();
 	#endif // PROFILING
 }
+
+void Profiler::writeTrace(const string &fileName, const TraceWindow &window)
+{
+	TraceExporter exporter(fileName);
+
+	const size_t frameCount = window.mFrameStarts.size();
+	for (size_t frameIdx = 0; frameIdx < frameCount; ++frameIdx)
+		exporter.addFrameMarker(window.mFrameIndices[frameIdx], window.mFrameStarts[frameIdx]);
+
+	const size_t threadCount = window.mThreads.size();
+	for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+	{
+		const TraceWindow::Thread &thread = window.mThreads[threadIdx];
+		exporter.addThread(thread.mIndex, thread.mName, thread.mEvents);
+	}
+}
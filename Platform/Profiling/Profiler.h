@@ -9,79 +9,369 @@
 #ifndef _PROFILER_H_
 #define _PROFILER_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include "Patterns/Singleton.h"
 #include "Platform/DataTypes.h"
+#include "Platform/Profiling/EventBuffer.h"
+#include "Platform/Profiling/PerformanceCounters.h"
+#include "Platform/Profiling/ThreadProfile.h"
 #include "Platform/Profiling/TimeMeasurements.h"
 #include "Platform/Timing/ApplicationTimer.h"
 
 namespace Profiling
 {
 	/// Realizes typical profiling functionality for performance evaluation.
-	/** The Profiler class realizes helper functions for easy profiling, such as runtime measurements. */
+	/** The Profiler class realizes helper functions for easy profiling, such as runtime measurements.
+		Besides flat measurements identified by indices, it supports nested zones (see ScopedZone) which are recorded per thread
+		into a call tree and as trace events that can be exported together with frame markers as Chrome trace file.
+		Each thread records its zones into its own preallocated EventBuffer without locks or allocations.
+		A background collector thread regularly drains these buffers into ThreadProfile objects.
+		Trace events and frame markers are kept in rings of fixed capacity so that memory stays bounded if profiling runs for a long time.
+		Zones can optionally sample hardware performance counters of their thread, see ScopedCountedZone. */
 	class Profiler : public Patterns::Singleton<Profiler>
 	{
 	public:
-		/** Creates the profiler and allocates time measurement representations if wanted.
+		/** Sets the name of the calling thread which is used for its call tree and its trace track.
+			Can be called without a Profiler object, e.g., by worker threads which are started before the profiler is created.
+		@param name Set this to a descriptive name of the calling thread, e.g., "Worker 3". */
+		static void setCurrentThreadName(const std::string &name);
+
+	public:
+		/** Creates the profiler, allocates time measurement representations if wanted and starts the collector thread.
 			All created TimeMeasurement Objects are ordered in the same order as their names in measurementNames,
 			e.g. object with names[0] is identified by its index 0.
 		@param measurementNames Set this to an array of names for description of the measurement statistics to be created.
 		@param numberOfMeasurementNames Set this to the element count of measurementNames which is equal to the number of
-			TimeMeasurement representions to be created. */
-		Profiler(const std::string *measurementNames, uint32 numberOfMeasurementNames);
+			TimeMeasurement representions to be created.
+		@param traceHistoryCapacity Defines how many of the most recent zones are kept per thread for trace export, see saveTrace().
+			Older zones are overwritten and counted as dropped, see getDroppedZoneCount(). */
+		Profiler(const std::string *measurementNames, uint32 numberOfMeasurementNames,
+			const uint32 traceHistoryCapacity = DEFAULT_TRACE_HISTORY_CAPACITY);
 
-		/** Frees resources. */
+		/** Stops the collector thread and frees resources. */
 		~Profiler();
 
 		/** Adds a new TimeMeasurements object.
 		@param name This name describes the TimeMeasurements object.
+		@param windowLength Set this to a positive number of seconds to additionally get the percentiles of only the last windowLength seconds.
+			See TimeMeasurements::TimeMeasurements().
 		@return Returns the index of the new TimeMeasurements object which is necesary to access it. */
-		uint32 addMeasurementType(const std::string &name);
+		uint32 addMeasurementType(const std::string &name, const double windowLength = 0.0);
+
+		/** Enters a zone for the calling thread which is nested in the zone the thread entered most recently and did not leave so far.
+			Prefer ScopedZone or PROFILE_ZONE over calling this directly.
+			Does neither lock nor allocate except for the very first zone of a thread which creates the thread's EventBuffer.
+		@param name Identifies the zone. Must point to a string with static storage duration, e.g., a string literal.
+		@see endZone() */
+		inline void beginZone(const char *name);
+
+		/** Enters a zone like beginZone() and additionally samples the performance counters of the calling thread.
+			The counters of a thread are opened when it enters its first counted zone. Prefer ScopedCountedZone or PROFILE_COUNTED_ZONE.
+			Sampling costs a system call at zone entry and exit, so use it for zones which run at least several microseconds.
+		@param name Identifies the zone. Must point to a string with static storage duration, e.g., a string literal.
+		@param start Is filled with the counter values at zone entry and must be passed to endCountedZone().
+		@return Returns false if no counter is available. The zone is then entered without counters and must be left with endZone().
+		@see endCountedZone() */
+		inline bool beginCountedZone(const char *name, PerformanceCounters::Sample &start);
 
 		/** Adds a single time measurement, timePeriod, to the TimeMeasurements object identified by index.
 		@param index This identifies the TimeMeasurements object to which the time period is added. Objects order equals their creation order.
 		@param timePeriod Set this to the measured time period in seconds. */
 		void addTimeMeasurement(uint32 index, double timePeriod);
 
+		/** Moves all zone events recorded so far by all threads into their ThreadProfile objects.
+			This is regularly done by the collector thread and before saving, but can be called to get up to date call trees. */
+		void collect();
+
+		/** Leaves the counted zone the calling thread entered most recently and records the counter differences of the zone.
+		@param start Set this to the counter values which were returned by the corresponding beginCountedZone() call.
+		@see beginCountedZone() */
+		inline void endCountedZone(const PerformanceCounters::Sample &start);
+
+		/** Leaves the zone the calling thread entered most recently.
+		@see beginZone() */
+		inline void endZone();
+
 		/** Ends the measurement of a time period fo the TimeMeasurements object identified by index.
 			Time period measurement must be called for the same object (= index) before this call to start the measurement.
 		@param index This identifies the TimeMeasurements object. Objects order equals their creation order.
 		@see startTimeMeasurement(...) */
 		void endTimeMeasurement(uint32 index);
 
+		/** Returns how many zones are missing in traces since the EventBuffer of their thread was full
+			or since they were overwritten by newer zones in the trace history of their thread.
+		@return Returns the number of dropped zones of all threads. */
+		uint64 getDroppedZoneCount() const;
+
+		/** Merges the call tree statistics of each zone over all its call paths and threads, e.g., for reports or metrics.
+			Only contains the zones which were collected so far, see collect().
+		@param zones Is filled with the merged statistics of each zone, the zone names are the keys. */
+		void getZoneStatistics(std::map<std::string, TimeMeasurements> &zones) const;
+
+		/** Returns the elapsed time since creation of the profiler which is the reference for all zone and frame time stamps.
+		@return Returns the elapsed time in nanoseconds since the creation of this object. */
+		inline uint64 getTimeStamp() const;
+
+		/** Converts a time point into a time stamp relative to the creation of the profiler, e.g., to export the zones of a particular frame.
+		@param timePoint Set this to a time point after the creation of the profiler.
+		@return Returns the elapsed time in nanoseconds from the creation of this object until timePoint or 0 for earlier time points. */
+		inline uint64 getTimeStamp(const Timing::TimePoint &timePoint) const;
+
 		/** Provides access to all TimeMeasurements objects.
 		@param index This identifies the TimeMeasurements object. Objects order equals their creation order.
 		@return Returns the TimeMeasurements object identified by index. */
 		inline const TimeMeasurements &getTimeMeasurements(uint32 index) const;
 
+		/** Returns whether zones are currently recorded.
+		@return Returns true if new zones are recorded, see setEnabled(). */
+		inline bool isEnabled() const;
+
 		/** Starts the measurement of a time period for the TimeMeasurements object identified by index.
 			Use this to profile a single function call for example.
 			The time period end is measured by a call to endTimeMeasurement(index) with the same index.
+			Use zones to profile code which is executed concurrently by several threads.
 		@param index This identifies the TimeMeasurements object. Objects order equals their creation order.
 		@see endTimeMeasurement(...) */
 		void startTimeMeasurement(uint32 index);
 
-		/** Resets all TimeMeasurement representations. */
+		/** Marks the beginning of a new frame. Call this once per frame from the main loop thread, see Application::run().
+			Frame markers are exported with the zones to see where the time of each frame goes.
+			Only the most recent FRAME_HISTORY_CAPACITY frame markers are kept. */
+		void markFrame();
+
+		/** Saves the zones and frame markers of a time window as Chrome trace file on the collector thread, e.g., to capture a stutter.
+			The calling thread only queues the request, so it is not blocked by copying events or writing the file.
+			The collector copies the window from the trace histories after its next collection. Zones which are still open then are not saved.
+			If the file cannot be written, the collector prints the failure to std::cerr and drops the request instead of throwing.
+		@param fileName Set this to the complete file name including path and file extension, e.g., "Stutter.json".
+		@param begin Only zones and frame markers after this time stamp in nanoseconds are stored, see getTimeStamp().
+		@param end Only zones and frame markers before this time stamp in nanoseconds are stored. */
+		void requestTrace(const std::string &fileName, const uint64 begin, const uint64 end);
+
+		/** Resets all TimeMeasurement representations, call tree statistics, zone events and frame markers. */
 		void reset();
 
-		/** Stores the statistics of all measurements in a file.
+		/** Stores the statistics of all measurements and the call trees of all threads in a file.
+			Percentile tables are added for all measurements and for all zones whereas the statistics of each zone are merged over all its call paths and threads.
 		@param fileName Set this to the complete file name including path and file extension. */
-		void saveToFile(const std::string &fileName) const;
+		void saveToFile(const std::string &fileName);
+
+		/** Stores all zone events and frame markers as Chrome trace event JSON file, see TraceExporter.
+			Zones which are open while this is called are exported by later calls.
+			The file is written by the calling thread after the events of the window were copied, see requestTrace() for saving in the background.
+		@param fileName Set this to the complete file name including path and file extension, e.g., "Trace.json".
+		@param begin Only zones and frame markers after this time stamp in nanoseconds are stored, see getTimeStamp().
+		@param end Only zones and frame markers before this time stamp in nanoseconds are stored, e.g., to capture a single frame. */
+		void saveTrace(const std::string &fileName, const uint64 begin = 0, const uint64 end = (uint64) -1);
+
+		/** Enables or disables recording of zones at runtime. Zones which were entered while recording was enabled are always left properly.
+		@param enabled Set this to false to stop recording of new zones or to true to continue it. */
+		inline void setEnabled(const bool enabled);
+
+	public:
+		static const uint32 COLLECTOR_PERIOD = 10;				/// Defines how many milliseconds the collector thread waits between two collections.
+		static const uint32 DEFAULT_TRACE_HISTORY_CAPACITY = 1u << 15;	/// Default number of the most recent zones which are kept per thread.
+		static const uint32 EVENT_BUFFER_CAPACITY = 1u << 15;	/// Defines the maximum number of events per thread between two collections.
+		static const uint32 FRAME_HISTORY_CAPACITY = 1u << 12;	/// Defines how many of the most recent frame markers are kept.
+
+	private:
+		/// Copy of the zones and frame markers within a time window which is written without holding mThreadsMutex.
+		struct TraceWindow
+		{
+			/// Zones of a single thread within the window.
+			struct Thread
+			{
+				std::vector<ZoneEvent>	mEvents;	/// Zones which overlap the window in the order in which they were left.
+				std::string				mName;		/// Descriptive name of the thread.
+				uint32					mIndex;		/// Identifies the thread track.
+			};
+
+			std::vector<Thread>	mThreads;		/// Zones of all threads.
+			std::vector<uint64>	mFrameIndices;	/// Numbers of the frames which began within the window.
+			std::vector<uint64>	mFrameStarts;	/// Time stamps in nanoseconds of the frame markers within the window.
+		};
+
+		/// Trace file which is saved by the collector thread, see requestTrace().
+		struct TraceRequest
+		{
+			std::string	mFileName;	/// Complete file name of the trace.
+			uint64		mBegin;		/// Begin of the time window in nanoseconds relative to the profiler epoch.
+			uint64		mEnd;		/// End of the time window in nanoseconds relative to the profiler epoch.
+		};
+
+	private:
+		/** Writes a copied time window as Chrome trace event JSON file, see TraceExporter.
+		@param fileName Set this to the complete file name including path and file extension.
+		@param window Set this to the zones and frame markers to be written. */
+		static void writeTrace(const std::string &fileName, const TraceWindow &window);
+
+	private:
+		/** Copies the zones and frame markers of all threads which overlap a time window.
+		@param window Is filled with the zones and frame markers within [begin, end].
+		@param begin Only zones and frame markers after this time stamp in nanoseconds are copied.
+		@param end Only zones and frame markers before this time stamp in nanoseconds are copied. */
+		void copyTraceWindow(TraceWindow &window, const uint64 begin, const uint64 end) const;
+
+		/** Opens and registers the performance counters of the calling thread.
+		@return Returns the counters which are only used by the calling thread. */
+		PerformanceCounters &createPerformanceCounters();
+
+		/** Creates and registers the event buffer and profile of the calling thread.
+		@return Returns the buffer which is only filled by the calling thread. */
+		EventBuffer &createEventBuffer();
+
+		/** Executed by the collector thread which regularly calls collect() until the profiler is destroyed. */
+		void collectorFunction();
+
+		/** Returns the event buffer of the calling thread and creates it if it does not exist yet.
+		@return Returns the buffer which is only filled by the calling thread. */
+		inline EventBuffer &getEventBuffer();
+
+		/** Returns the performance counters of the calling thread and opens them if they do not exist yet.
+		@return Returns the counters which are only used by the calling thread. */
+		inline PerformanceCounters &getPerformanceCounters();
+
+	private:
+		static thread_local std::string msCurrentThreadName;		/// Name of the calling thread, see setCurrentThreadName().
+		static thread_local EventBuffer *msCurrentThreadBuffer;		/// Cached buffer of the calling thread, only valid if msCurrentThreadGeneration == msGeneration.
+		static thread_local PerformanceCounters *msCurrentThreadCounters;	/// Cached counters of the calling thread or NULL, only valid with msCurrentThreadBuffer.
+		static thread_local uint32 msCurrentThreadIdx;				/// Index of the profile of the calling thread, only valid with msCurrentThreadBuffer.
+		static thread_local uint32 msCurrentThreadGeneration;		/// Identifies the profiler object msCurrentThreadBuffer belongs to.
+		static std::atomic<uint32> msGeneration;					/// Is increased for each created profiler to invalidate buffers cached by threads.
 
 	private:
 		std::vector<TimeMeasurements>	mTimeMeasurements;	/// Stores all time measurement representations.
 		std::vector<Timing::TimePoint>	mMeasurementStarts;	/// Stores for each TimeMeasurements the most recent measure start time point.
+		std::mutex						mMeasurementsMutex;	/// Synchronizes access to mTimeMeasurements and mMeasurementStarts.
+
+		std::vector<EventBuffer *>		mEventBuffers;		/// Contains the buffers into which the threads record zones. Same order as mThreadProfiles.
+		std::vector<PerformanceCounters *> mPerformanceCounters;	/// Contains the counters of threads which entered counted zones or NULL. Same order as mThreadProfiles.
+		std::vector<ThreadProfile *>	mThreadProfiles;	/// Contains the call trees and zone events of all threads which entered zones.
+		std::vector<uint64>				mFrameStarts;		/// Ring buffer of the time stamps of the most recent frame markers in nanoseconds.
+		uint64							mFrameCount;		/// Number of frame markers since the last reset, the newest one is at (mFrameCount - 1) % FRAME_HISTORY_CAPACITY.
+		const uint32					mTraceHistoryCapacity;	/// Number of the most recent zones which are kept per thread.
+		mutable std::mutex				mThreadsMutex;		/// Synchronizes creation of and iteration over buffers and thread profiles.
+
+		std::thread						mCollector;			/// Regularly drains mEventBuffers into mThreadProfiles.
+		std::condition_variable			mCollectorCondition;/// Wakes up the collector thread to end it.
+		std::mutex						mCollectorMutex;	/// Protects mCollectorRunning and mTraceRequests for mCollectorCondition.
+		std::vector<TraceRequest>		mTraceRequests;		/// Trace files which the collector thread saves after its next collection.
+		bool							mCollectorRunning;	/// Is true as long as the collector thread should continue.
+
+		Timing::TimePoint				mEpoch;				/// Creation time point of the profiler which is the reference for zone time stamps.
+		std::atomic<bool>				mEnabled;			/// Is true if new zones are recorded.
 	};
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+	inline bool Profiler::beginCountedZone(const char *name, PerformanceCounters::Sample &start)
+	{
+		#ifdef PROFILING
+			PerformanceCounters &counters = getPerformanceCounters();
+			if (!counters.isAvailable())
+			{
+				beginZone(name);
+				return false;
+			}
+
+			// sample counters last to exclude the zone entry overhead
+			getEventBuffer().beginZone(name, getTimeStamp(), PerformanceCounters::COUNTER_COUNT);
+			counters.read(start);
+			return true;
+		#else
+			return false;
+		#endif // PROFILING
+	}
+
+	inline void Profiler::beginZone(const char *name)
+	{
+		#ifdef PROFILING
+			getEventBuffer().beginZone(name, getTimeStamp());
+		#endif // PROFILING
+	}
+
+	inline void Profiler::endCountedZone(const PerformanceCounters::Sample &start)
+	{
+		#ifdef PROFILING
+			// sample counters first to exclude the zone exit overhead
+			const PerformanceCounters &counters = *msCurrentThreadCounters;
+			PerformanceCounters::Sample end;
+			const bool valid = counters.read(end);
+			const uint64 timeStamp = getTimeStamp();
+
+			uint64 differences[PerformanceCounters::COUNTER_COUNT];
+			for (uint32 counterIdx = 0; counterIdx < PerformanceCounters::COUNTER_COUNT; ++counterIdx)
+			{
+				const bool available = valid && counters.isAvailable((PerformanceCounters::COUNTER) counterIdx);
+				differences[counterIdx] = (available ? end.mValues[counterIdx] - start.mValues[counterIdx] : PerformanceCounters::INVALID_VALUE);
+			}
+
+			getEventBuffer().endZone(timeStamp, differences, PerformanceCounters::COUNTER_COUNT);
+		#endif // PROFILING
+	}
+
+	inline void Profiler::endZone()
+	{
+		#ifdef PROFILING
+			const uint64 timeStamp = getTimeStamp();
+			getEventBuffer().endZone(timeStamp);
+		#endif // PROFILING
+	}
+
+	inline EventBuffer &Profiler::getEventBuffer()
+	{
+		// cached buffer of this profiler?
+		if (msCurrentThreadGeneration == msGeneration.load(std::memory_order_relaxed) && msCurrentThreadBuffer)
+			return *msCurrentThreadBuffer;
+
+		return createEventBuffer();
+	}
+
+	inline PerformanceCounters &Profiler::getPerformanceCounters()
+	{
+		// getEventBuffer() invalidates counters of previous profilers
+		getEventBuffer();
+		if (msCurrentThreadCounters)
+			return *msCurrentThreadCounters;
+
+		return createPerformanceCounters();
+	}
+
+	inline uint64 Profiler::getTimeStamp() const
+	{
+		const Timing::TimePoint now = std::chrono::high_resolution_clock::now();
+		return (uint64) std::chrono::duration_cast<std::chrono::nanoseconds>(now - mEpoch).count();
+	}
+
+	inline uint64 Profiler::getTimeStamp(const Timing::TimePoint &timePoint) const
+	{
+		if (timePoint < mEpoch)
+			return 0;
+		return (uint64) std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint - mEpoch).count();
+	}
+
 	inline const TimeMeasurements &Profiler::getTimeMeasurements(uint32 index) const
 	{
 		assert(index < mTimeMeasurements.size());
 		return mTimeMeasurements[index];
 	}
+
+	inline bool Profiler::isEnabled() const
+	{
+		return mEnabled.load(std::memory_order_relaxed);
+	}
+
+	inline void Profiler::setEnabled(const bool enabled)
+	{
+		mEnabled.store(enabled, std::memory_order_relaxed);
+	}
 }
 
 #endif // _PROFILER_H_
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _SCOPED_ZONE_H_
+#define _SCOPED_ZONE_H_
+
+#include "Platform/Profiling/Profiler.h"
+
+#ifdef PROFILING
+	#define PROFILING_CONCATENATE_IMPLEMENTATION(a, b) a##b
+	#define PROFILING_CONCATENATE(a, b) PROFILING_CONCATENATE_IMPLEMENTATION(a, b)
+
+	/** Profiles the rest of the enclosing scope as zone called name which must be a string literal. */
+	#define PROFILE_ZONE(name) Profiling::ScopedZone PROFILING_CONCATENATE(profilingZone, __LINE__)(name)
+
+	/** Profiles the rest of the enclosing scope as zone called name including hardware performance counters, see ScopedCountedZone. */
+	#define PROFILE_COUNTED_ZONE(name) Profiling::ScopedCountedZone PROFILING_CONCATENATE(profilingZone, __LINE__)(name)
+#else
+	#define PROFILE_ZONE(name)
+	#define PROFILE_COUNTED_ZONE(name)
+#endif // PROFILING
+
+namespace Profiling
+{
+	/// Profiles the scope in which it lives as zone of the Profiler, e.g., a function body.
+	/** The zone is entered at construction and left at destruction. Zones nest according to the scopes of their ScopedZone objects.
+		Nothing is measured if there is no Profiler object or if it is disabled, see Profiler::setEnabled(). Use the macro PROFILE_ZONE for code which should compile without PROFILING. */
+	class ScopedZone
+	{
+	public:
+		/** Enters the zone name for the calling thread.
+		@param name Identifies the zone. Must point to a string with static storage duration, e.g., a string literal. */
+		inline ScopedZone(const char *name);
+
+		/** Leaves the zone which was entered by the constructor. */
+		inline ~ScopedZone();
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		ScopedZone(const ScopedZone &copy) : mProfiler(NULL) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		ScopedZone &operator =(const ScopedZone &rhs) { assert(false); return *this; }
+
+	private:
+		Profiler *mProfiler;	/// Receives the zone or is NULL if there was no enabled profiler at construction.
+	};
+
+	/// Profiles the scope in which it lives as zone of the Profiler including the performance counters of the calling thread.
+	/** Behaves like ScopedZone, but additionally records counter differences, such as executed instructions and cache misses, see PerformanceCounters.
+		If no counter is available, e.g., since perf events are not permitted, then it behaves exactly like ScopedZone.
+		Sampling the counters costs a system call at construction and destruction, so do not use it for very short zones. */
+	class ScopedCountedZone
+	{
+	public:
+		/** Enters the zone name for the calling thread and samples its counters.
+		@param name Identifies the zone. Must point to a string with static storage duration, e.g., a string literal. */
+		inline ScopedCountedZone(const char *name);
+
+		/** Samples the counters and leaves the zone which was entered by the constructor. */
+		inline ~ScopedCountedZone();
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		ScopedCountedZone(const ScopedCountedZone &copy) : mProfiler(NULL), mCounted(false) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		ScopedCountedZone &operator =(const ScopedCountedZone &rhs) { assert(false); return *this; }
+
+	private:
+		PerformanceCounters::Sample	mStart;		/// Counter values at construction.
+		Profiler					*mProfiler;	/// Receives the zone or is NULL if there was no enabled profiler at construction.
+		bool						mCounted;	/// Is true if counters are available and the zone must be left with Profiler::endCountedZone().
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline ScopedCountedZone::ScopedCountedZone(const char *name) :
+		mProfiler(Profiler::exists() && Profiler::getSingleton().isEnabled() ? Profiler::getSingletonPointer() : NULL), mCounted(false)
+	{
+		if (mProfiler)
+			mCounted = mProfiler->beginCountedZone(name, mStart);
+	}
+
+	inline ScopedCountedZone::~ScopedCountedZone()
+	{
+		if (!mProfiler)
+			return;
+
+		if (mCounted)
+			mProfiler->endCountedZone(mStart);
+		else
+			mProfiler->endZone();
+	}
+
+	inline ScopedZone::ScopedZone(const char *name) :
+		mProfiler(Profiler::exists() && Profiler::getSingleton().isEnabled() ? Profiler::getSingletonPointer() : NULL)
+	{
+		if (mProfiler)
+			mProfiler->beginZone(name);
+	}
+
+	inline ScopedZone::~ScopedZone()
+	{
+		if (mProfiler)
+			mProfiler->endZone();
+	}
+}
+
+#endif // _SCOPED_ZONE_H_
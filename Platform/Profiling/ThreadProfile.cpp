@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include "Platform/Profiling/ThreadProfile.h"
+
+using namespace Profiling;
+using namespace std;
+
+CallTreeNode::CallTreeNode(const char *name, const uint32 parent) :
+	mTimes(name), mName(name), mParent(parent), mFirstChild(INVALID_INDEX), mNextSibling(INVALID_INDEX)
+{
+	for (uint32 counterIdx = 0; counterIdx < PerformanceCounters::COUNTER_COUNT; ++counterIdx)
+	{
+		mCounterSums[counterIdx] = 0;
+		mCountedCalls[counterIdx] = 0;
+	}
+}
+
+string CallTreeNode::getCountersString() const
+{
+	string text;
+	char buffer[100];
+
+	// instructions per cycle
+	const uint64 cycles = mCounterSums[PerformanceCounters::COUNTER_CYCLES];
+	const uint64 instructions = mCounterSums[PerformanceCounters::COUNTER_INSTRUCTIONS];
+	if (mCountedCalls[PerformanceCounters::COUNTER_CYCLES] > 0 && mCountedCalls[PerformanceCounters::COUNTER_INSTRUCTIONS] > 0 && cycles > 0)
+	{
+		snprintf(buffer, sizeof(buffer), " | IPC %.2f", (double) instructions / cycles);
+		text += buffer;
+	}
+
+	// average counts per call
+	for (uint32 counterIdx = 0; counterIdx < PerformanceCounters::COUNTER_COUNT; ++counterIdx)
+	{
+		if (0 == mCountedCalls[counterIdx])
+			continue;
+
+		const char *name = PerformanceCounters::getName((PerformanceCounters::COUNTER) counterIdx);
+		snprintf(buffer, sizeof(buffer), " | %s/call %.1f", name, (double) mCounterSums[counterIdx] / mCountedCalls[counterIdx]);
+		text += buffer;
+	}
+
+	return text;
+}
+
+ThreadProfile::ThreadProfile(const uint32 index, const string &name, const uint32 historyCapacity) :
+	mEvents(historyCapacity), mName(name), mIndex(index), mEventCount(0), mOverwrittenEventCount(0), mLastEndedNode(CallTreeNode::INVALID_INDEX)
+{
+	assert(historyCapacity > 0);
+	mCallTree.push_back(CallTreeNode("Root", CallTreeNode::INVALID_INDEX));
+}
+
+void ThreadProfile::addEvent(const ProfilingEvent &event)
+{
+	switch (event.mType)
+	{
+		case ProfilingEvent::TYPE_BEGIN_ZONE:
+			beginZone(event.mName, event.mTimeStamp);
+			break;
+
+		case ProfilingEvent::TYPE_END_ZONE:
+			endZone(event.mTimeStamp);
+			break;
+
+		case ProfilingEvent::TYPE_ZONE_COUNTER:
+		{
+			// counter of the zone which was just left
+			assert(CallTreeNode::INVALID_INDEX != mLastEndedNode && event.mCounter < PerformanceCounters::COUNTER_COUNT);
+			if (CallTreeNode::INVALID_INDEX == mLastEndedNode || PerformanceCounters::INVALID_VALUE == event.mCounterValue)
+				break;
+
+			CallTreeNode &node = mCallTree[mLastEndedNode];
+			node.mCounterSums[event.mCounter] += event.mCounterValue;
+			++node.mCountedCalls[event.mCounter];
+			break;
+		}
+
+		default:
+			assert(false);
+	}
+}
+
+void ThreadProfile::beginZone(const char *name, const uint64 timeStamp)
+{
+	// nested zone or top level zone?
+	const uint32 parent = (mOpenZones.empty() ? 0 : mOpenZones.back().mNode);
+
+	OpenZone zone;
+	zone.mStart = timeStamp;
+	zone.mNode = getChild(parent, name);
+	mOpenZones.push_back(zone);
+}
+
+void ThreadProfile::copyEvents(vector<ZoneEvent> &events, const uint64 begin, const uint64 end) const
+{
+	// events are ordered by their end time stamps -> binary search for the first zone which was not left before begin
+	const uint32 eventCount = getEventCount();
+	uint32 first = 0;
+	uint32 last = eventCount;
+	while (first < last)
+	{
+		const uint32 middle = first + (last - first) / 2;
+		if (getEvent(middle).mEnd < begin)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	// zones which were left later might still have been entered before end
+	for (uint32 eventIdx = first; eventIdx < eventCount; ++eventIdx)
+	{
+		const ZoneEvent &event = getEvent(eventIdx);
+		if (event.mStart <= end)
+			events.push_back(event);
+	}
+}
+
+void ThreadProfile::endZone(const uint64 timeStamp)
+{
+	assert(!mOpenZones.empty());
+	if (mOpenZones.empty())
+		return;
+
+	// close the most recently entered zone
+	const OpenZone zone = mOpenZones.back();
+	mOpenZones.pop_back();
+
+	// update call tree statistics
+	CallTreeNode &node = mCallTree[zone.mNode];
+	node.mTimes.add((timeStamp - zone.mStart) * 1e-9);
+	mLastEndedNode = zone.mNode;
+
+	// store trace event, overwrite the oldest one if the history is full
+	if (mEventCount >= mEvents.size())
+		++mOverwrittenEventCount;
+
+	ZoneEvent &event = mEvents[mEventCount % mEvents.size()];
+	event.mName = node.mName;
+	event.mStart = zone.mStart;
+	event.mEnd = timeStamp;
+	event.mDepth = (uint32) mOpenZones.size();
+	++mEventCount;
+}
+
+uint32 ThreadProfile::getChild(const uint32 parent, const char *name)
+{
+	// existing child? (zone names are usually literals -> pointer comparison first)
+	uint32 lastChild = CallTreeNode::INVALID_INDEX;
+	for (uint32 childIdx = mCallTree[parent].mFirstChild; CallTreeNode::INVALID_INDEX != childIdx; childIdx = mCallTree[childIdx].mNextSibling)
+	{
+		const char *childName = mCallTree[childIdx].mName;
+		if (childName == name || 0 == strcmp(childName, name))
+			return childIdx;
+		lastChild = childIdx;
+	}
+
+	// new child
+	const uint32 newIdx = (uint32) mCallTree.size();
+	mCallTree.push_back(CallTreeNode(name, parent));
+
+	if (CallTreeNode::INVALID_INDEX == lastChild)
+		mCallTree[parent].mFirstChild = newIdx;
+	else
+		mCallTree[lastChild].mNextSibling = newIdx;
+
+	return newIdx;
+}
+
+void ThreadProfile::reset()
+{
+	mEventCount = 0;
+
+	const size_t nodeCount = mCallTree.size();
+	for (size_t nodeIdx = 0; nodeIdx < nodeCount; ++nodeIdx)
+	{
+		CallTreeNode &node = mCallTree[nodeIdx];
+		node.mTimes.reset();
+
+		for (uint32 counterIdx = 0; counterIdx < PerformanceCounters::COUNTER_COUNT; ++counterIdx)
+		{
+			node.mCounterSums[counterIdx] = 0;
+			node.mCountedCalls[counterIdx] = 0;
+		}
+	}
+}
+
+string ThreadProfile::toString() const
+{
+	string text = "Thread ";
+	text += mName;
+	text += '\n';
+
+	// root is only a dummy node
+	for (uint32 childIdx = mCallTree[0].mFirstChild; CallTreeNode::INVALID_INDEX != childIdx; childIdx = mCallTree[childIdx].mNextSibling)
+		toString(text, childIdx, 1);
+
+	return text;
+}
+
+void ThreadProfile::toString(string &text, const uint32 nodeIdx, const uint32 depth) const
+{
+	const CallTreeNode &node = mCallTree[nodeIdx];
+
+	text.append(depth, '\t');
+	text += node.mTimes.toString();
+	text += node.getCountersString();
+	text += '\n';
+
+	for (uint32 childIdx = node.mFirstChild; CallTreeNode::INVALID_INDEX != childIdx; childIdx = mCallTree[childIdx].mNextSibling)
+		toString(text, childIdx, depth + 1);
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _THREAD_PROFILE_H_
+#define _THREAD_PROFILE_H_
+
+#include <cassert>
+#include <string>
+#include <vector>
+#include "Platform/DataTypes.h"
+#include "Platform/Profiling/EventBuffer.h"
+#include "Platform/Profiling/PerformanceCounters.h"
+#include "Platform/Profiling/TimeMeasurements.h"
+
+namespace Profiling
+{
+	/// Describes a single execution of a profiled zone, e.g., for export as trace event.
+	struct ZoneEvent
+	{
+		const char	*mName;		/// Identifies the zone. Must point to a string with static storage duration, e.g., a string literal.
+		uint64		mStart;		/// Time point in nanoseconds relative to the profiler epoch when the zone was entered.
+		uint64		mEnd;		/// Time point in nanoseconds relative to the profiler epoch when the zone was left.
+		uint32		mDepth;		/// Nesting depth of the zone within its thread. Top level zones have depth 0.
+	};
+
+	/// Node of a per thread call tree which accumulates the statistics of a zone w.r.t. its call path.
+	struct CallTreeNode
+	{
+		/** Creates a leaf node without children.
+		@param name Identifies the zone. Must point to a string with static storage duration, e.g., a string literal.
+		@param parent Set this to the index of the parent node or to INVALID_INDEX for the root. */
+		CallTreeNode(const char *name, const uint32 parent);
+
+		/** Converts the summed counter differences into per call statistics, such as instructions per cycle.
+		@return Returns an empty string if there are no counter values or a text like " | IPC 1.52 | cache misses/call 10.3 ...". */
+		std::string getCountersString() const;
+
+		TimeMeasurements	mTimes;			/// Contains the statistics of all executions of the zone along this call path.
+		uint64				mCounterSums[PerformanceCounters::COUNTER_COUNT];	/// Summed counter differences of all counted executions per counter.
+		uint32				mCountedCalls[PerformanceCounters::COUNTER_COUNT];	/// Number of executions with valid counter difference per counter.
+		const char			*mName;			/// Identifies the zone.
+		uint32				mParent;		/// Index of the parent node or INVALID_INDEX for the root.
+		uint32				mFirstChild;	/// Index of the first child node or INVALID_INDEX if there is no child.
+		uint32				mNextSibling;	/// Index of the next node with the same parent or INVALID_INDEX if there is none.
+
+		static const uint32 INVALID_INDEX = (uint32) -1;	/// Marks non-existing links between nodes.
+	};
+
+	/// Stores profiling data of a single thread, such as its call tree of nested zones and the trace events of these zones.
+	/** A ThreadProfile object is filled with the events the thread recorded into its EventBuffer, see Profiler::collect().
+		Nested zones are kept on an explicit stack so that recursive zones are measured correctly.
+		Only the most recent finished zones are kept as trace events in a ring of fixed capacity, older ones are overwritten and counted.
+		Counter events following an end event are added to the call tree node of the zone which was left, see PerformanceCounters. */
+	class ThreadProfile
+	{
+	public:
+		/** Creates an empty profile with only a root node.
+		@param index Set this to a unique number identifying the thread, e.g., for trace export.
+		@param name Set this to a descriptive name of the thread, e.g., "Main" or "Worker 3".
+		@param historyCapacity Set this to the maximum number of finished zones which are kept as trace events. Must be positive. */
+		ThreadProfile(const uint32 index, const std::string &name, const uint32 historyCapacity);
+
+		/** Processes a single event which was recorded by the thread, e.g., enters or leaves a zone.
+		@param event Set this to the next event recorded by the thread. */
+		void addEvent(const ProfilingEvent &event);
+
+		/** Enters a zone nested in the currently open zone or at top level if no zone is open.
+		@param name Identifies the zone. Must point to a string with static storage duration, e.g., a string literal.
+		@param timeStamp Set this to the current time in nanoseconds relative to the profiler epoch. */
+		void beginZone(const char *name, const uint64 timeStamp);
+
+		/** Appends copies of the stored trace events which overlap the time range [begin, end] to events.
+		@param events The overlapping zones are appended to this vector in the order in which they were left.
+		@param begin Zones which were left before this time point in nanoseconds relative to the profiler epoch are skipped.
+		@param end Zones which were entered after this time point in nanoseconds relative to the profiler epoch are skipped. */
+		void copyEvents(std::vector<ZoneEvent> &events, const uint64 begin = 0, const uint64 end = (uint64) -1) const;
+
+		/** Leaves the most recently entered zone, updates its call tree node and stores a trace event.
+			The oldest trace event is overwritten if the trace history is full.
+		@param timeStamp Set this to the current time in nanoseconds relative to the profiler epoch. */
+		void endZone(const uint64 timeStamp);
+
+		/** Provides access to the call tree with the root node at index 0.
+		@return Returns all call tree nodes of this thread. Node links are indices into the returned vector. */
+		inline const std::vector<CallTreeNode> &getCallTree() const;
+
+		/** Returns a stored trace event.
+		@param eventIdx Set this to 0 for the oldest stored zone, 1 for the zone left after it and so on. Must be smaller than getEventCount().
+		@return Returns the finished zone which was left eventIdx zones after the oldest stored one. */
+		inline const ZoneEvent &getEvent(const uint32 eventIdx) const;
+
+		/** Returns how many finished zones are currently stored as trace events.
+		@return Returns the number of stored trace events which is at most the trace history capacity. */
+		inline uint32 getEventCount() const;
+
+		/** Returns the unique number identifying the thread.
+		@return Returns the index which was set at construction. */
+		inline uint32 getIndex() const;
+
+		/** Returns the descriptive name of the thread.
+		@return Returns the name of the thread, e.g., "Main". */
+		inline const std::string &getName() const;
+
+		/** Returns the number of currently open zones.
+		@return Returns how many zones were entered but not left so far. */
+		inline uint32 getOpenZoneCount() const;
+
+		/** Returns how many trace events were overwritten by newer ones since the trace history was full.
+		@return Returns the number of finished zones which are missing in the trace history. */
+		inline uint64 getOverwrittenEventCount() const;
+
+		/** Removes all events and call tree statistics. Currently open zones stay open. */
+		void reset();
+
+		/** Changes the descriptive name of the thread.
+		@param name Set this to the new name, e.g., "Worker 3". */
+		inline void setName(const std::string &name);
+
+		/** Converts the call tree into an indented text with one line per node.
+		@return Returns the call tree as text. Each line contains the node statistics, see TimeMeasurements::toString(). */
+		std::string toString() const;
+
+	private:
+		/** Finds or creates the child node of parent for the zone name.
+		@param parent Identifies the node the returned child belongs to.
+		@param name Identifies the zone of the child.
+		@return Returns the index of the found or created child node. */
+		uint32 getChild(const uint32 parent, const char *name);
+
+		/** Appends the text of node and its descendants to text.
+		@param text The node text lines are appended to this string.
+		@param nodeIdx Identifies the subtree to be converted.
+		@param depth Defines the indentation of the node. */
+		void toString(std::string &text, const uint32 nodeIdx, const uint32 depth) const;
+
+	private:
+		/// Represents a zone which was entered but not left so far.
+		struct OpenZone
+		{
+			uint64 mStart;	/// Time point in nanoseconds relative to the profiler epoch when the zone was entered.
+			uint32 mNode;	/// Identifies the call tree node of the zone.
+		};
+
+	private:
+		std::vector<CallTreeNode>	mCallTree;	/// Contains the root node at index 0 and a node for each zone call path.
+		std::vector<ZoneEvent>		mEvents;	/// Ring buffer of the most recent finished zone executions with fixed capacity.
+		std::vector<OpenZone>		mOpenZones;	/// Stack of currently entered zones, the most recently entered one is at the back.
+		std::string					mName;		/// Descriptive name of the thread.
+		uint32						mIndex;		/// Unique number identifying the thread.
+		uint64						mEventCount;	/// Number of trace events stored since the last reset, the newest one is at (mEventCount - 1) % capacity.
+		uint64						mOverwrittenEventCount;	/// Number of trace events which were overwritten since the trace history was full.
+		uint32						mLastEndedNode;	/// Call tree node of the most recently left zone which receives counter events.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline const std::vector<CallTreeNode> &ThreadProfile::getCallTree() const
+	{
+		return mCallTree;
+	}
+
+	inline const ZoneEvent &ThreadProfile::getEvent(const uint32 eventIdx) const
+	{
+		assert(eventIdx < getEventCount());
+		const uint64 oldestIdx = mEventCount - getEventCount();
+		return mEvents[(oldestIdx + eventIdx) % mEvents.size()];
+	}
+
+	inline uint32 ThreadProfile::getEventCount() const
+	{
+		return (uint32) (mEventCount < mEvents.size() ? mEventCount : mEvents.size());
+	}
+
+	inline uint32 ThreadProfile::getIndex() const
+	{
+		return mIndex;
+	}
+
+	inline const std::string &ThreadProfile::getName() const
+	{
+		return mName;
+	}
+
+	inline uint32 ThreadProfile::getOpenZoneCount() const
+	{
+		return (uint32) mOpenZones.size();
+	}
+
+	inline uint64 ThreadProfile::getOverwrittenEventCount() const
+	{
+		return mOverwrittenEventCount;
+	}
+
+	inline void ThreadProfile::setName(const std::string &name)
+	{
+		mName = name;
+	}
+}
+
+#endif // _THREAD_PROFILE_H_
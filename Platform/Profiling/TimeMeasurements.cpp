@@ -5,15 +5,30 @@
  * This software may be modified and distributed under the terms
  * of the BSD 3-Clause license. See the License.txt file for details.
  */
+#include <chrono>
+#include <cstdio>
 #include "Platform/Profiling/TimeMeasurements.h"
 
 using namespace Profiling;
 using namespace std;
 
-TimeMeasurements::TimeMeasurements(const string &name) :
-	mName(name), mSummedTimes(0.0f),
+const double TimeMeasurements::PERCENTILES[TimeMeasurements::PERCENTILE_COUNT] = { 0.5, 0.9, 0.99, 0.999 };
+
+TimeMeasurements::TimeMeasurements(const string &name, const double windowLength) :
+	mName(name), mWindowSliceLength(windowLength / WINDOW_SLICE_COUNT), mSummedTimes(0.0f),
 	mMaxTime(REAL_MIN), mMinTime(REAL_MAX), mCount(0)
 {
+	// windowed mode?
+	if (windowLength > 0.0)
+	{
+		mWindowSlices.resize(WINDOW_SLICE_COUNT);
+		mWindowSliceIds.resize(WINDOW_SLICE_COUNT, 0);
+	}
+	else
+	{
+		mWindowSliceLength = 0.0;
+	}
+
 	reset();
 }
 
@@ -27,6 +42,107 @@ void TimeMeasurements::add(double time)
 
 	if (time < mMinTime)
 		mMinTime = time;
+
+	// histograms
+	const uint64 nanoseconds = (time > 0.0 ? (uint64) (time * 1e9 + 0.5) : 0);
+	mHistogram.add(nanoseconds);
+
+	if (mWindowSlices.empty())
+		return;
+
+	// start a new slice?
+	const uint64 sliceId = getCurrentSliceId();
+	const uint32 sliceIdx = (uint32) (sliceId % WINDOW_SLICE_COUNT);
+	if (mWindowSliceIds[sliceIdx] != sliceId)
+	{
+		mWindowSlices[sliceIdx].reset();
+		mWindowSliceIds[sliceIdx] = sliceId;
+	}
+
+	mWindowSlices[sliceIdx].add(nanoseconds);
+}
+
+uint64 TimeMeasurements::getCountUpTo(const double time) const
+{
+	const uint64 nanoseconds = (time > 0.0 ? (uint64) (time * 1e9 + 0.5) : 0);
+	return mHistogram.getCountUpTo(nanoseconds);
+}
+
+uint64 TimeMeasurements::getCurrentSliceId() const
+{
+	const chrono::high_resolution_clock::duration now = chrono::high_resolution_clock::now().time_since_epoch();
+	const double seconds = chrono::duration_cast<chrono::duration<double> >(now).count();
+	return (uint64) (seconds / mWindowSliceLength);
+}
+
+double TimeMeasurements::getPercentile(const double percentile) const
+{
+	return toSeconds(mHistogram, percentile);
+}
+
+uint64 TimeMeasurements::getWindowCount() const
+{
+	LatencyHistogram histogram;
+	getWindowHistogram(histogram);
+	return histogram.getCount();
+}
+
+void TimeMeasurements::getWindowHistogram(LatencyHistogram &histogram) const
+{
+	if (mWindowSlices.empty())
+		return;
+
+	// only slices of the last WINDOW_SLICE_COUNT slice periods
+	const uint64 currentId = getCurrentSliceId();
+	for (uint32 sliceIdx = 0; sliceIdx < WINDOW_SLICE_COUNT; ++sliceIdx)
+		if (mWindowSliceIds[sliceIdx] + WINDOW_SLICE_COUNT > currentId)
+			histogram.merge(mWindowSlices[sliceIdx]);
+}
+
+double TimeMeasurements::getWindowPercentile(const double percentile) const
+{
+	LatencyHistogram histogram;
+	getWindowHistogram(histogram);
+	if (0 == histogram.getCount())
+		return 0.0;
+
+	return toSeconds(histogram, percentile);
+}
+
+void TimeMeasurements::merge(const TimeMeasurements &other)
+{
+	if (0 == other.mCount)
+		return;
+
+	mSummedTimes += other.mSummedTimes;
+	mCount += other.mCount;
+
+	if (other.mMaxTime > mMaxTime)
+		mMaxTime = other.mMaxTime;
+
+	if (other.mMinTime < mMinTime)
+		mMinTime = other.mMinTime;
+
+	mHistogram.merge(other.mHistogram);
+
+	// compatible windows?
+	if (mWindowSlices.empty() || mWindowSliceLength != other.mWindowSliceLength)
+		return;
+
+	for (uint32 sliceIdx = 0; sliceIdx < WINDOW_SLICE_COUNT; ++sliceIdx)
+	{
+		const uint64 otherId = other.mWindowSliceIds[sliceIdx];
+		if (otherId < mWindowSliceIds[sliceIdx])
+			continue;
+
+		// keep the newer slice
+		if (otherId > mWindowSliceIds[sliceIdx])
+		{
+			mWindowSlices[sliceIdx].reset();
+			mWindowSliceIds[sliceIdx] = otherId;
+		}
+		mWindowSlices[sliceIdx].merge(other.mWindowSlices[sliceIdx]);
+	}
 }
 
 void TimeMeasurements::reset()
@@ -35,6 +151,78 @@ void TimeMeasurements::reset()
 	mMaxTime		= REAL_MIN;
 	mMinTime		= REAL_MAX;
 	mCount			= 0;
+
+	mHistogram.reset();
+	for (uint32 sliceIdx = 0; sliceIdx < mWindowSlices.size(); ++sliceIdx)
+	{
+		mWindowSlices[sliceIdx].reset();
+		mWindowSliceIds[sliceIdx] = 0;
+	}
+}
+
+double TimeMeasurements::toSeconds(const LatencyHistogram &histogram, const double percentile) const
+{
+	if (0 == histogram.getCount())
+		return 0.0;
+
+	// bucket middles might be outside of the measured range
+	double seconds = histogram.getPercentile(percentile) * 1e-9;
+	if (seconds < mMinTime)
+		seconds = mMinTime;
+	if (seconds > mMaxTime)
+		seconds = mMaxTime;
+
+	return seconds;
+}
+
+string TimeMeasurements::getPercentileTableHeader()
+{
+	char buffer[TIME_MEASUREMENTS_MAX_TEXT_LENGTH];
+	int length = snprintf(buffer, TIME_MEASUREMENTS_MAX_TEXT_LENGTH, "%-32s %10s %12s", "name", "count", "average");
+
+	for (uint32 i = 0; i < PERCENTILE_COUNT && length < (int) TIME_MEASUREMENTS_MAX_TEXT_LENGTH; ++i)
+		length += snprintf(buffer + length, TIME_MEASUREMENTS_MAX_TEXT_LENGTH - length, " %11gp", PERCENTILES[i] * 100.0);
+
+	if (length < (int) TIME_MEASUREMENTS_MAX_TEXT_LENGTH)
+		snprintf(buffer + length, TIME_MEASUREMENTS_MAX_TEXT_LENGTH - length, " %12s (microseconds)", "max");
+
+	return string(buffer);
+}
+
+string TimeMeasurements::toPercentileString() const
+{
+	char buffer[TIME_MEASUREMENTS_MAX_TEXT_LENGTH];
+	const double average = (mCount > 0 ? mSummedTimes / mCount : 0.0);
+	const double maximum = (mCount > 0 ? mMaxTime : 0.0);
+
+	// all time periods
+	int length = snprintf(buffer, TIME_MEASUREMENTS_MAX_TEXT_LENGTH, "%-32s %10u %12.3f", mName.c_str(), mCount, average * 1e6);
+	for (uint32 i = 0; i < PERCENTILE_COUNT && length < (int) TIME_MEASUREMENTS_MAX_TEXT_LENGTH; ++i)
+		length += snprintf(buffer + length, TIME_MEASUREMENTS_MAX_TEXT_LENGTH - length, " %12.3f", getPercentile(PERCENTILES[i]) * 1e6);
+	if (length < (int) TIME_MEASUREMENTS_MAX_TEXT_LENGTH)
+		length += snprintf(buffer + length, TIME_MEASUREMENTS_MAX_TEXT_LENGTH - length, " %12.3f", maximum * 1e6);
+
+	if (mWindowSlices.empty() || length >= (int) TIME_MEASUREMENTS_MAX_TEXT_LENGTH)
+		return string(buffer);
+
+	// time periods of the window
+	LatencyHistogram window;
+	getWindowHistogram(window);
+
+	char windowName[64];
+	snprintf(windowName, sizeof(windowName), "  (last %gs)", getWindowLength());
+
+	string text(buffer);
+	snprintf(buffer, TIME_MEASUREMENTS_MAX_TEXT_LENGTH, "\n%-32s %10llu %12s", windowName, (unsigned long long) window.getCount(), "");
+	text += buffer;
+
+	for (uint32 i = 0; i < PERCENTILE_COUNT; ++i)
+	{
+		snprintf(buffer, TIME_MEASUREMENTS_MAX_TEXT_LENGTH, " %12.3f", toSeconds(window, PERCENTILES[i]) * 1e6);
+		text += buffer;
+	}
+
+	return text;
 }
 
 string TimeMeasurements::toString() const
@@ -10,26 +10,61 @@
 #define _TIME_MEASUREMENTS_H_
 
 #include <string>
+#include <vector>
 #include "Platform/DataTypes.h"
+#include "Platform/Profiling/LatencyHistogram.h"
 
 namespace Profiling
 {
 	/// Represents several time measurements of a specific code area or for a particular purpose.
 	/** Represents time measurements of a specific type or for a particular purpose,
 		e.g. measuring the performance of a specific function.
-		TimeMeasurements must be fed with measured time periods to gather statistics, such as minimum, maximum and average time. */
+		TimeMeasurements must be fed with measured time periods to gather statistics, such as minimum, maximum and average time.
+		Percentiles, e.g., p99 frame times, are computed from a LatencyHistogram of all added time periods.
+		Optionally, a windowed mode additionally keeps statistics only for the time periods which were added in the last few seconds. */
 	class TimeMeasurements
 	{
 	public:
 		/** Creates an object with 0 time measurements in the beginning and dummy values for min, max & average time.
 		@param name Set this to short string identifying this object, e.g. use the name of the function to be profiled.
-			The name of a TimeMeasurements object is required by conversion to text. */
-		TimeMeasurements(const std::string &name);
+			The name of a TimeMeasurements object is required by conversion to text.
+		@param windowLength Set this to a positive number of seconds to enable the windowed mode which reports the percentiles of the last windowLength seconds.
+			The window moves in steps of windowLength / WINDOW_SLICE_COUNT. Set this to 0 to only gather statistics of all time periods. */
+		TimeMeasurements(const std::string &name, const double windowLength = 0.0);
 
 		/** Adds a single time measurement which updates the statistics of this object.
 		@param time Enter the time in seconds that was measured when profiling some code area.  */
 		void add(double time);
 
+		/** Returns how many added time periods are not larger than a bound, see LatencyHistogram::getCountUpTo().
+		@param time Set this to the bound in seconds.
+		@return Returns the number of time periods up to time with the precision of the percentiles. */
+		uint64 getCountUpTo(const double time) const;
+
+		/** Returns a time period which is larger than or equal to the fraction percentile of all added time periods.
+		@param percentile Set this to a value in [0, 1], e.g., 0.99 for the 99th percentile.
+		@return Returns the percentile in seconds with a relative error of at most 1 / LatencyHistogram::SUB_BUCKET_COUNT.
+		@see add(...) */
+		double getPercentile(const double percentile) const;
+
+		/** Returns a time period which is larger than or equal to the fraction percentile of the time periods added within the window.
+		@param percentile Set this to a value in [0, 1], e.g., 0.99 for the 99th percentile.
+		@return Returns the percentile of the last getWindowLength() seconds in seconds or 0 if the windowed mode is disabled or the window is empty. */
+		double getWindowPercentile(const double percentile) const;
+
+		/** Returns the number of time periods which were added within the window.
+		@return Returns the count of the last getWindowLength() seconds or 0 if the windowed mode is disabled. */
+		uint64 getWindowCount() const;
+
+		/** Returns the length of the window of the windowed mode.
+		@return Returns the window length in seconds or 0 if the windowed mode is disabled. */
+		inline double getWindowLength() const;
+
+		/** Combines the statistics of this object with the ones of other, e.g., to get statistics of the same zone of several threads.
+			Window statistics are only merged if both objects use the same window length.
+		@param other Its time periods are treated as if they had been added to this object. */
+		void merge(const TimeMeasurements &other);
+
 		/** Returns the average time of all added measurements in seconds.
 		@return The returned value is the average time of all added time period measurements. Unit: seconds
 		@see add(...) */
@@ -45,6 +80,10 @@ namespace Profiling
 		@see add(...), reset() */
 		inline uint32 getCount() const;
 
+		/** Returns the sum of all added measurements in seconds.
+		@return The returned value is the sum of all added time periods. Unit: seconds */
+		inline double getSummedTime() const;
+
 		/** Returns the minimum time of all added measurements in seconds.
 		@return The returned value is the minimum time of all added time period measurements. Unit: seconds
 		@see add(...) */
@@ -58,13 +97,44 @@ namespace Profiling
 		@return The returned string contains this object's name, average, minimum, maximum of added time periods and the number of measurings. */
 		std::string toString() const;
 
+		/** Converts the stored statistics into a line of a percentile table, see getPercentileTableHeader().
+		@return The returned string contains this object's name, count, average, the percentiles PERCENTILES and the maximum in microseconds.
+			If the windowed mode is enabled then a second line contains the same statistics for the window only. */
+		std::string toPercentileString() const;
+
+		/** Returns the column names of the lines created by toPercentileString().
+		@return The returned string describes the columns of a percentile table. */
+		static std::string getPercentileTableHeader();
+
 	public:
 		static const uint32 TIME_MEASUREMENTS_MAX_TEXT_LENGTH = 1000;	/// Defines the maximum text length for the toString function of the class TimeMeasurements. */
-		
-		
+		static const uint32 PERCENTILE_COUNT = 4;						/// Number of entries of PERCENTILES.
+		static const double PERCENTILES[PERCENTILE_COUNT];				/// Percentiles which are printed by toPercentileString().
+		static const uint32 WINDOW_SLICE_COUNT = 10;					/// Number of histograms the window is split into for the windowed mode.
+
+	private:
+		/** Computes the identifier of the window slice a time period added now belongs to.
+		@return Returns the number of slices since the clock epoch. */
+		uint64 getCurrentSliceId() const;
+
+		/** Merges the histograms of all slices which belong to the current window.
+		@param histogram Is filled with the time periods of the current window. */
+		void getWindowHistogram(LatencyHistogram &histogram) const;
+
+		/** Converts a percentile of histogram to seconds and clamps it to the measured range.
+		@param histogram Set this to the histogram from which the percentile is taken.
+		@param percentile Set this to a value in [0, 1].
+		@return Returns the percentile in seconds. */
+		double toSeconds(const LatencyHistogram &histogram, const double percentile) const;
+
 	private:
 		std::string mName;		/// A name for conversion to text.
 
+		LatencyHistogram mHistogram;				/// Counts all added time periods for percentile queries.
+		std::vector<LatencyHistogram> mWindowSlices;/// Ring of histograms of consecutive time slices for the windowed mode or empty.
+		std::vector<uint64> mWindowSliceIds;		/// Identifies the time slice of each histogram in mWindowSlices, see getCurrentSliceId().
+		double mWindowSliceLength;					/// Length of each time slice in seconds or 0 if the windowed mode is disabled.
+
 		double mSummedTimes;		/// This is the sum of all added time periods.
 		double mMaxTime;		/// Contains the maximum of all added time periods.
 		double mMinTime;		/// Contains the minimum of all added time periods.
@@ -94,6 +164,16 @@ namespace Profiling
 	{
 		return mMinTime;
 	}
+
+	inline double TimeMeasurements::getSummedTime() const
+	{
+		return mSummedTimes;
+	}
+
+	inline double TimeMeasurements::getWindowLength() const
+	{
+		return mWindowSliceLength * WINDOW_SLICE_COUNT;
+	}
 }
 
 #endif // _TIME_MEASUREMENTS_H_
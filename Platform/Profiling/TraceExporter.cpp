@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include "Platform/Profiling/TraceExporter.h"
+
+using namespace Profiling;
+using namespace std;
+using namespace Storage;
+
+TraceExporter::TraceExporter(const Path &fileName) :
+	mFile(fileName, File::CREATE_WRITING, false), mFirstEvent(true)
+{
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", &mFile.getHandle());
+}
+
+TraceExporter::~TraceExporter()
+{
+	fputs("\n]}\n", &mFile.getHandle());
+}
+
+void TraceExporter::addFrameMarker(const uint64 frameIdx, const uint64 timeStamp)
+{
+	beginEvent();
+	fprintf(&mFile.getHandle(), "{\"name\":\"Frame %" PRIu64 "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":%.3f}",
+		frameIdx, timeStamp * 1e-3);
+}
+
+void TraceExporter::addThread(const uint32 threadIdx, const string &name, const vector<ZoneEvent> &events)
+{
+	addThreadName(threadIdx, name);
+
+	const size_t eventCount = events.size();
+	for (size_t eventIdx = 0; eventIdx < eventCount; ++eventIdx)
+	{
+		const ZoneEvent &event = events[eventIdx];
+		addZone(threadIdx, event.mName, event.mStart, event.mEnd);
+	}
+}
+
+void TraceExporter::addThreadName(const uint32 threadIdx, const string &name)
+{
+	beginEvent();
+	fprintf(&mFile.getHandle(), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", threadIdx);
+	writeString(name.c_str());
+	fputs("}}", &mFile.getHandle());
+}
+
+void TraceExporter::addZone(const uint32 threadIdx, const char *name, const uint64 start, const uint64 end)
+{
+	beginEvent();
+	fputs("{\"name\":", &mFile.getHandle());
+	writeString(name);
+	fprintf(&mFile.getHandle(), ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+		threadIdx, start * 1e-3, (end - start) * 1e-3);
+}
+
+void TraceExporter::beginEvent()
+{
+	if (mFirstEvent)
+		mFirstEvent = false;
+	else
+		fputs(",\n", &mFile.getHandle());
+}
+
+void TraceExporter::writeString(const char *text)
+{
+	FILE *handle = &mFile.getHandle();
+
+	fputc('"', handle);
+	for (const char *c = text; '\0' != *c; ++c)
+	{
+		switch (*c)
+		{
+			case '"':	fputs("\\\"", handle); break;
+			case '\\':	fputs("\\\\", handle); break;
+			case '\n':	fputs("\\n", handle); break;
+			case '\r':	fputs("\\r", handle); break;
+			case '\t':	fputs("\\t", handle); break;
+			default:
+				if ((unsigned char) *c < 0x20)
+					fprintf(handle, "\\u%04x", (unsigned char) *c);
+				else
+					fputc(*c, handle);
+		}
+	}
+	fputc('"', handle);
+}
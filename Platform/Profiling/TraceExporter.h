@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _TRACE_EXPORTER_H_
+#define _TRACE_EXPORTER_H_
+
+#include <string>
+#include <vector>
+#include "Platform/DataTypes.h"
+#include "Platform/Profiling/ThreadProfile.h"
+#include "Platform/Storage/File.h"
+
+namespace Profiling
+{
+	/// Writes profiling data as Chrome trace event JSON file which can be viewed with chrome://tracing or https://ui.perfetto.dev.
+	/** The file is created by the constructor and the JSON event array is closed by the destructor.
+		All time stamps are in nanoseconds relative to the profiler epoch and are converted to the microseconds of the trace format. */
+	class TraceExporter
+	{
+	public:
+		/** Creates the trace file and begins the JSON event array.
+		@param fileName Set this to the complete file name including path and file extension, e.g., "Profile.json". */
+		TraceExporter(const Storage::Path &fileName);
+
+		/** Ends the JSON event array and closes the file. */
+		~TraceExporter();
+
+		/** Adds a global instant event which marks the beginning of a frame.
+		@param frameIdx Identifies the frame, e.g., the number of frames rendered before.
+		@param timeStamp Time point in nanoseconds relative to the profiler epoch when the frame began. */
+		void addFrameMarker(const uint64 frameIdx, const uint64 timeStamp);
+
+		/** Adds the name and finished zones of a thread, e.g., the zones of a time window, see ThreadProfile::copyEvents().
+		@param threadIdx Identifies the thread track.
+		@param name Set this to the name of the thread shown by trace viewers.
+		@param events The zones are added as complete events. */
+		void addThread(const uint32 threadIdx, const std::string &name, const std::vector<ZoneEvent> &events);
+
+		/** Adds a metadata event which names the track of a thread.
+		@param threadIdx Identifies the thread track.
+		@param name Set this to the name of the thread shown by trace viewers. */
+		void addThreadName(const uint32 threadIdx, const std::string &name);
+
+		/** Adds a complete event which represents a single zone execution.
+		@param threadIdx Identifies the thread track the zone belongs to.
+		@param name Identifies the zone.
+		@param start Time point in nanoseconds relative to the profiler epoch when the zone was entered.
+		@param end Time point in nanoseconds relative to the profiler epoch when the zone was left. */
+		void addZone(const uint32 threadIdx, const char *name, const uint64 start, const uint64 end);
+
+	private:
+		/** Copy constructor is forbidden and not defined.
+		@param copy Copy constructor is forbidden. */
+		TraceExporter(const TraceExporter &copy);
+
+		/** Assignment operator is forbidden and not defined.
+		@param rhs Operator is forbidden.*/
+		TraceExporter &operator =(const TraceExporter &rhs);
+
+		/** Writes the separator between events if necessary. */
+		void beginEvent();
+
+		/** Writes text as JSON string including quotes and escapes special characters.
+		@param text Set this to the text to be written as JSON string. */
+		void writeString(const char *text);
+
+	private:
+		Storage::File	mFile;			/// Receives the JSON text.
+		bool			mFirstEvent;	/// Is true as long as no event was written.
+	};
+}
+
+#endif // _TRACE_EXPORTER_H_
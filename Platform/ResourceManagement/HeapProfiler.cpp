@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#if defined(MEMORY_MANAGEMENT) && defined(HEAP_PROFILING)
+
+#ifdef _LINUX
+	#include <execinfo.h>
+#endif // _LINUX
+#ifdef _WINDOWS
+	#include <Windows.h>
+#endif // _WINDOWS
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Platform/ResourceManagement/HeapProfiler.h"
+
+using namespace ResourceManagement;
+using namespace std;
+
+namespace
+{
+	const uint32 SKIPPED_FRAME_COUNT = 1;	/// registerBlock is not part of call sites.
+	const uint32 CAPTURED_FRAME_COUNT = HeapProfiler::MAX_FRAME_COUNT + SKIPPED_FRAME_COUNT;	/// Number of return addresses which are captured at most.
+
+	thread_local uint64	tBytesUntilSample = 0;		/// Number of bytes the calling thread may request until the next sampled allocation.
+	thread_local uint64	tRandomState = 0;			/// xorshift state for the sampling points of the calling thread or 0 if not seeded yet.
+	thread_local bool	tInsideProfiler = false;	/// Is true while the calling thread works inside the profiler, e.g., while dumping.
+
+	/** Draws the distance to the next sampling point of the calling thread.
+	@param samplingInterval Set this to the mean distance.
+	@return Returns an exponentially distributed number of bytes which is at least 1. */
+	uint64 drawSamplingDistance(const uint64 samplingInterval)
+	{
+		if (0 == tRandomState)
+			tRandomState = (uint64) reinterpret_cast<size_t>(&tRandomState) ^ 0x9e3779b97f4a7c15ull;
+
+		// xorshift64*
+		tRandomState ^= tRandomState >> 12;
+		tRandomState ^= tRandomState << 25;
+		tRandomState ^= tRandomState >> 27;
+		const uint64 random = tRandomState * 2685821657736338717ull;
+
+		// uniform in (0, 1] -> exponential with mean samplingInterval
+		const double uniform = ((random >> 11) + 1) * (1.0 / 9007199254740992.0);
+		return 1 + (uint64) (-log(uniform) * samplingInterval);
+	}
+
+	/** Writes the entry of one call site or the profile header in legacy pprof heap profile format.
+	@param file Set this to the opened profile file.
+	@param statistics Set this to the sampled statistics of the entry. */
+	void writeCounts(FILE *file, const HeapProfiler::Statistics &statistics)
+	{
+		fprintf(file, "%llu: %llu [%llu: %llu] @",
+			(unsigned long long) statistics.mLiveCount, (unsigned long long) statistics.mLiveBytes,
+			(unsigned long long) statistics.mTotalCount, (unsigned long long) statistics.mTotalBytes);
+	}
+}
+
+HeapProfiler::HeapProfiler() :
+	mSites(NULL), mSamplingInterval(DEFAULT_SAMPLING_INTERVAL), mSiteCount(0), mActive(false)
+{
+	memset(&mStatistics, 0, sizeof(Statistics));
+}
+
+HeapProfiler::~HeapProfiler()
+{
+	free(mSites);
+	mSites = NULL;
+}
+
+bool HeapProfiler::dump(const char *fileName) const
+{
+	// the profiler must not sample its own allocations, e.g., by the file functions
+	const bool wasInside = tInsideProfiler;
+	tInsideProfiler = true;
+
+	FILE *file = fopen(fileName, "w");
+	if (!file)
+	{
+		tInsideProfiler = wasInside;
+		return false;
+	}
+
+	{
+		unique_lock<mutex> uniqueLock(mMutex);
+
+		// header with totals & sampling interval for pprof's unsampling
+		fputs("heap profile: ", file);
+		writeCounts(file, mStatistics);
+		fprintf(file, " heap_v2/%llu\n", (unsigned long long) mSamplingInterval);
+
+		// one line per call site
+		if (mSites)
+		{
+			for (uint32 siteIdx = 0; siteIdx <= MAX_SITE_COUNT; ++siteIdx)
+			{
+				const Site &site = mSites[siteIdx];
+				if (0 == site.mFrameCount || 0 == site.mStatistics.mTotalCount)
+					continue;
+
+				writeCounts(file, site.mStatistics);
+				for (uint32 frameIdx = 0; frameIdx < site.mFrameCount; ++frameIdx)
+					fprintf(file, " 0x%llx", (unsigned long long) reinterpret_cast<size_t>(site.mFrames[frameIdx]));
+				fputc('\n', file);
+			}
+		}
+	}
+
+	// memory mappings for symbolization
+	#ifdef _LINUX
+		fputs("\nMAPPED_LIBRARIES:\n", file);
+		FILE *maps = fopen("/proc/self/maps", "r");
+		if (maps)
+		{
+			char buffer[4096];
+			size_t count = 0;
+			while ((count = fread(buffer, 1, sizeof(buffer), maps)) > 0)
+				fwrite(buffer, 1, count, file);
+			fclose(maps);
+		}
+	#endif // _LINUX
+
+	const bool success = !ferror(file);
+	fclose(file);
+
+	tInsideProfiler = wasInside;
+	return success;
+}
+
+uint32 HeapProfiler::findSite(void *const *frames, const uint32 frameCount)
+{
+	// FNV-1a over the return addresses
+	uint64 hash = 14695981039346656037ull;
+	for (uint32 frameIdx = 0; frameIdx < frameCount; ++frameIdx)
+	{
+		hash ^= (uint64) reinterpret_cast<size_t>(frames[frameIdx]);
+		hash *= 1099511628211ull;
+	}
+
+	// linear probing
+	const uint32 mask = MAX_SITE_COUNT - 1;
+	for (uint32 siteIdx = (uint32) (hash ^ (hash >> 32)) & mask; ; siteIdx = (siteIdx + 1) & mask)
+	{
+		Site &site = mSites[siteIdx];
+		if (0 == site.mFrameCount)
+		{
+			// keep probe sequences short
+			if (mSiteCount >= MAX_SITE_COUNT / 4 * 3)
+				return MAX_SITE_COUNT;
+
+			memcpy(site.mFrames, frames, sizeof(void *) * frameCount);
+			site.mHash = hash;
+			site.mFrameCount = frameCount;
+			++mSiteCount;
+			return siteIdx;
+		}
+
+		if (site.mHash == hash && site.mFrameCount == frameCount && 0 == memcmp(site.mFrames, frames, sizeof(void *) * frameCount))
+			return siteIdx;
+	}
+}
+
+HeapProfiler::Statistics HeapProfiler::getStatistics() const
+{
+	unique_lock<mutex> uniqueLock(mMutex);
+	return mStatistics;
+}
+
+uint32 HeapProfiler::getSiteCount() const
+{
+	unique_lock<mutex> uniqueLock(mMutex);
+	if (!mSites)
+		return 0;
+	return mSiteCount + (mSites[MAX_SITE_COUNT].mStatistics.mTotalCount > 0 ? 1 : 0);
+}
+
+void *HeapProfiler::registerBlock(void *block, const size_t size)
+{
+	BlockHeader *header = reinterpret_cast<BlockHeader *>(block);
+	header->mSize = size;
+	header->mSite = UNSAMPLED;
+	header->mPadding = 0;
+
+	if (!mActive.load(memory_order_relaxed) || tInsideProfiler)
+		return header + 1;
+
+	// not sampled?
+	if (0 == tRandomState)
+		tBytesUntilSample = drawSamplingDistance(mSamplingInterval);
+	if (size < tBytesUntilSample)
+	{
+		tBytesUntilSample -= size;
+		return header + 1;
+	}
+	tBytesUntilSample = drawSamplingDistance(mSamplingInterval);
+
+	// sample it: capturing the backtrace directly here as registerBlock is the only skipped frame, it may allocate memory
+	tInsideProfiler = true;
+	void *frames[CAPTURED_FRAME_COUNT];
+	uint32 frameCount = 0;
+	#ifdef _LINUX
+		frameCount = (uint32) backtrace(frames, CAPTURED_FRAME_COUNT);
+	#endif // _LINUX
+	#ifdef _WINDOWS
+		frameCount = (uint32) CaptureStackBackTrace(0, CAPTURED_FRAME_COUNT, frames, NULL);
+	#endif // _WINDOWS
+
+	{
+		unique_lock<mutex> uniqueLock(mMutex);
+		const uint32 siteIdx = (frameCount > SKIPPED_FRAME_COUNT ?
+			findSite(frames + SKIPPED_FRAME_COUNT, frameCount - SKIPPED_FRAME_COUNT) : MAX_SITE_COUNT);
+
+		Site &site = mSites[siteIdx];
+		++site.mStatistics.mLiveCount;
+		++site.mStatistics.mTotalCount;
+		site.mStatistics.mLiveBytes += size;
+		site.mStatistics.mTotalBytes += size;
+
+		++mStatistics.mLiveCount;
+		++mStatistics.mTotalCount;
+		mStatistics.mLiveBytes += size;
+		mStatistics.mTotalBytes += size;
+		if (mStatistics.mLiveBytes > mStatistics.mPeakLiveBytes)
+			mStatistics.mPeakLiveBytes = mStatistics.mLiveBytes;
+
+		header->mSite = siteIdx;
+	}
+
+	tInsideProfiler = false;
+	return header + 1;
+}
+
+void HeapProfiler::start(const uint64 samplingInterval)
+{
+	assert(samplingInterval > 0);
+
+	// warm up backtrace which loads libraries at its first call
+	#ifdef _LINUX
+	{
+		const bool wasInside = tInsideProfiler;
+		tInsideProfiler = true;
+		void *frames[CAPTURED_FRAME_COUNT];
+		backtrace(frames, CAPTURED_FRAME_COUNT);
+		tInsideProfiler = wasInside;
+	}
+	#endif // _LINUX
+
+	unique_lock<mutex> uniqueLock(mMutex);
+	if (!mSites)
+	{
+		// call site table & overflow site with the single address 0
+		mSites = reinterpret_cast<Site *>(calloc(MAX_SITE_COUNT + 1, sizeof(Site)));
+		mSites[MAX_SITE_COUNT].mFrames[0] = NULL;
+		mSites[MAX_SITE_COUNT].mFrameCount = 1;
+	}
+
+	mSamplingInterval = samplingInterval;
+	mActive.store(true, memory_order_relaxed);
+}
+
+void HeapProfiler::stop()
+{
+	mActive.store(false, memory_order_relaxed);
+}
+
+void *HeapProfiler::unregisterBlock(void *pointer)
+{
+	BlockHeader *header = reinterpret_cast<BlockHeader *>(pointer) - 1;
+	if (UNSAMPLED == header->mSite)
+		return header;
+
+	unique_lock<mutex> uniqueLock(mMutex);
+	Site &site = mSites[header->mSite];
+	assert(site.mStatistics.mLiveCount > 0 && site.mStatistics.mLiveBytes >= header->mSize);
+
+	--site.mStatistics.mLiveCount;
+	site.mStatistics.mLiveBytes -= header->mSize;
+	--mStatistics.mLiveCount;
+	mStatistics.mLiveBytes -= header->mSize;
+	return header;
+}
+
+#endif // MEMORY_MANAGEMENT && HEAP_PROFILING
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _HEAP_PROFILER_H_
+#define _HEAP_PROFILER_H_
+#if defined(MEMORY_MANAGEMENT) && defined(HEAP_PROFILING)
+
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include "Platform/DataTypes.h"
+
+namespace ResourceManagement
+{
+	/// Samples heap allocations of the MemoryManager and attributes them to the call sites which requested them.
+	/** Each thread counts requested bytes and samples the allocation which crosses the next sampling point.
+		The distances between sampling points are exponentially distributed with the sampling interval as mean
+		which means that an allocation of s bytes is sampled with probability 1 - exp(-s / interval).
+		The backtrace of a sampled allocation identifies its call site which keeps live and cumulative counts and bytes of its sampled allocations.
+		Sampled blocks carry a small header which references their call site so that releasing them updates the live statistics in constant time.
+		Unsampled requests and releases only touch thread local data and the block header. Sampled ones lock the call site table.
+		The profiler never uses the new operator itself and ignores allocations which happen while it is working, e.g., while dumping.
+		dump() writes the legacy pprof heap profile format including the sampling interval so that pprof can estimate unsampled values, e.g.,
+		"pprof -sample_index=alloc_space program heap.prof" shows churn and "pprof -sample_index=inuse_space program heap.prof" shows live memory. */
+	class HeapProfiler
+	{
+	friend class MemoryManager;
+
+	public:
+		/// Sampled and thus unscaled statistics of all call sites or a single call site.
+		struct Statistics
+		{
+			uint64 mLiveBytes;		/// Bytes of sampled allocations which were not released yet.
+			uint64 mLiveCount;		/// Number of sampled allocations which were not released yet.
+			uint64 mPeakLiveBytes;	/// Maximum of mLiveBytes since the profiler was created.
+			uint64 mTotalBytes;		/// Bytes of all sampled allocations including the released ones.
+			uint64 mTotalCount;		/// Number of all sampled allocations including the released ones.
+		};
+
+		/// Prepended to each block of the MemoryManager to identify the call site of sampled blocks.
+		struct BlockHeader
+		{
+			uint64 mSize;		/// Number of bytes which were requested by the user of the block.
+			uint32 mSite;		/// Index of the call site of a sampled block or UNSAMPLED.
+			uint32 mPadding;	/// Keeps the 16 byte alignment of the user memory.
+		};
+
+	public:
+		/** Writes the call sites of all sampled allocations as legacy pprof heap profile together with the memory mappings of the process.
+		@param fileName Set this to the path of the created or overwritten profile file.
+		@return Returns false if the file could not be written. */
+		bool dump(const char *fileName) const;
+
+		/** Returns the sampled statistics of all allocations.
+		@return Returns the sums of all call site statistics and the peak of sampled live bytes. */
+		Statistics getStatistics() const;
+
+		/** Returns the number of distinct call sites of sampled allocations.
+		@return Returns the number of call sites including the overflow site if it collected allocations. */
+		uint32 getSiteCount() const;
+
+		/** Returns whether allocations are currently sampled.
+		@return Returns true between start() and stop(). */
+		inline bool isActive() const;
+
+		/** Starts or continues sampling of allocations with a possibly new sampling interval.
+			Statistics of previous runs are kept.
+		@param samplingInterval Set this to the average number of allocated bytes between two samples. Use 1 to sample every allocation. */
+		void start(const uint64 samplingInterval = DEFAULT_SAMPLING_INTERVAL);
+
+		/** Stops sampling new allocations. Releases of sampled blocks still update the live statistics. */
+		void stop();
+
+	public:
+		static const uint64 DEFAULT_SAMPLING_INTERVAL = 512 * 1024;	/// Average number of bytes between two sampled allocations, same as tcmalloc.
+		static const uint32 MAX_FRAME_COUNT = 32;					/// Maximum number of return addresses per call site.
+		static const uint32 MAX_SITE_COUNT = 8192;					/// Capacity of the call site table. Call sites beyond 3/4 of it share the overflow site.
+		static const uint32 UNSAMPLED = 0xffffffff;					/// Call site index of unsampled blocks.
+
+	private:
+		/// Backtrace and statistics of all sampled allocations from the same call stack.
+		struct Site
+		{
+			void		*mFrames[MAX_FRAME_COUNT];	/// Return addresses starting with the caller of the new operator.
+			Statistics	mStatistics;				/// Sampled allocations of this site. mPeakLiveBytes is unused.
+			uint64		mHash;						/// Hash of all frames for lookups.
+			uint32		mFrameCount;				/// Number of valid entries in mFrames. Zero for free sites.
+		};
+
+	private:
+		/** Creates an inactive profiler without call sites. */
+		HeapProfiler();
+
+		/** Frees the call site table. */
+		~HeapProfiler();
+
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		HeapProfiler(const HeapProfiler &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		HeapProfiler &operator =(const HeapProfiler &rhs) { assert(false); return *this; }
+
+		/** Finds or creates the call site with the entered backtrace. mMutex must be locked.
+		@param frames Set this to the return addresses of the call stack.
+		@param frameCount Set this to the number of return addresses.
+		@return Returns the index of the call site or MAX_SITE_COUNT for the overflow site if the table is too full. */
+		uint32 findSite(void *const *frames, const uint32 frameCount);
+
+		/** Fills the header of a new block and samples it if it crosses the next sampling point of the calling thread.
+		@param block Set this to the start of the block which begins with the header.
+		@param size Set this to the number of bytes which were requested for the user memory behind the header.
+		@return Returns the user memory behind the header. */
+		void *registerBlock(void *block, const size_t size);
+
+		/** Updates the live statistics of the call site of a sampled block which is about to be released.
+		@param pointer Set this to user memory which was returned by registerBlock.
+		@return Returns the start of the block including the header. */
+		void *unregisterBlock(void *pointer);
+
+	private:
+		mutable std::mutex	mMutex;					/// Protects the call site table and mStatistics.
+		Site				*mSites;				/// Open addressing hash table of MAX_SITE_COUNT call sites followed by the overflow site, allocated by malloc in start().
+		Statistics			mStatistics;			/// Sums of the statistics of all sites.
+		uint64				mSamplingInterval;		/// Average number of bytes between two samples.
+		uint32				mSiteCount;				/// Number of used entries in mSites without the overflow site.
+		std::atomic<bool>	mActive;				/// Defines whether new allocations are sampled.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline bool HeapProfiler::isActive() const
+	{
+		return mActive.load(std::memory_order_relaxed);
+	}
+}
+
+#endif // MEMORY_MANAGEMENT && HEAP_PROFILING
+#endif // _HEAP_PROFILER_H_
@@ -162,6 +162,11 @@ void MemoryManager::releaseMemory(void *pointer, bool arrayOperator)
 	if (NULL == pointer)
 		return;
 
+	#ifdef HEAP_PROFILING
+		// the profiler header is part of the block
+		pointer = mHeapProfiler.unregisterBlock(pointer);
+	#endif // HEAP_PROFILING
+
 	#ifdef CORRECT_DELETE_OPERATOR_AND_BOUNDS_CHECK
 		// check whether delete operator is correct
 		uint32 *memory1 = reinterpret_cast<uint32 *>(pointer) - 2;
@@ -199,6 +204,12 @@ void MemoryManager::releaseMemory(void *pointer, bool arrayOperator)
 
 void *MemoryManager::requestMemory(size_t capacity, bool arrayOperator)
 {
+	#ifdef HEAP_PROFILING
+		// extra space for the call site of sampled blocks
+		const size_t userCapacity = capacity;
+		capacity += sizeof(HeapProfiler::BlockHeader);
+	#endif // HEAP_PROFILING
+
 	#ifdef CORRECT_DELETE_OPERATOR_AND_BOUNDS_CHECK
 		// extra space for memory length, boundary guards and operator identifier
 		capacity += sizeof(size_t) + sizeof(uint32) + 2 * sizeof(uint32);
@@ -219,12 +230,18 @@ void *MemoryManager::requestMemory(size_t capacity, bool arrayOperator)
 		memset(startPos, GUARD_PATTERN, sizeof(uint32));
 		memset(endPos, GUARD_PATTERN, sizeof(uint32));
 
-		return memory1 + 2;
+		void *block = memory1 + 2;
 
 	#else
-		return getActiveMemoryPool().requestMemory(capacity);
+		void *block = getActiveMemoryPool().requestMemory(capacity);
 
 	#endif // CORRECT_DELETE_OPERATOR_AND_BOUNDS_CHECK
+
+	#ifdef HEAP_PROFILING
+		return mHeapProfiler.registerBlock(block, userCapacity);
+	#else
+		return block;
+	#endif // HEAP_PROFILING
 }
 
 MemoryPool &MemoryManager::getActiveMemoryPool()
@@ -11,6 +11,7 @@
 
 #include <cassert>
 #include <new>
+#include "Platform/ResourceManagement/HeapProfiler.h"
 #include "Platform/ResourceManagement/MagicConstants.h"
 #include "Platform/ResourceManagement/MemoryPool.h"
 
@@ -57,6 +58,22 @@ namespace ResourceManagement
 		 Relative order of the other pools is preserved that is if there are the pools 0, 1, 2, 3, 4 and pool 2 is deleted then 0->0, 1->1, 3->2, 4->3*/
 		void deleteMemoryPool(uint32 memoryPoolIndex);
 
+		/** Returns the usage of a pool, e.g., for metrics.
+			Pools must not be added or deleted concurrently, which is also required for new and delete calls.
+		@param memoryPoolIndex Identifies the pool, see getMemoryPoolCount() and setActiveMemoryPool().
+		@return Returns the bucket capacity and the current usage of the pool. */
+		inline MemoryPool::Statistics getMemoryPoolStatistics(const uint32 memoryPoolIndex) const;
+
+		/** Returns the number of existing pools.
+		@return Returns the number of pools which were added and not deleted yet. */
+		inline uint32 getMemoryPoolCount() const;
+
+		#ifdef HEAP_PROFILING
+			/** Provides access to the heap profiler which samples all allocations of this manager, see HeapProfiler::start() and HeapProfiler::dump().
+			@return Returns the profiler which attributes sampled allocations to their call sites. */
+			inline HeapProfiler &getHeapProfiler();
+		#endif // HEAP_PROFILING
+
 		/** Provides access to memory management functionality
 		@return Returns a reference to the one and only MemoryManager object. */
 		static MemoryManager &getSingleton();
@@ -115,6 +132,10 @@ namespace ResourceManagement
         static MemoryManager *msManager;                /// Pointer to the one and only memory manager object.
         static void          *msMemoryManagerMemory;    /// This is the memory where the MemoryManager is placed.
 
+		#ifdef HEAP_PROFILING
+			HeapProfiler	mHeapProfiler;	/// samples requests and releases, each block begins with a HeapProfiler::BlockHeader
+		#endif // HEAP_PROFILING
+
 		MemoryPool	**mMemoryPools;			/// array of all dynamically created MemoryPool objects
 		uint32		mActiveMemoryPool;		/// index of the currently activie / responsible MemoryPool object in mMemoryPools
 		uint32		mMaxNumOfMemoryPools;	/// size of the array mMemoryPools
@@ -126,6 +147,24 @@ namespace ResourceManagement
 ///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#ifdef HEAP_PROFILING
+	inline ResourceManagement::HeapProfiler &ResourceManagement::MemoryManager::getHeapProfiler()
+	{
+		return mHeapProfiler;
+	}
+#endif // HEAP_PROFILING
+
+inline ResourceManagement::MemoryPool::Statistics ResourceManagement::MemoryManager::getMemoryPoolStatistics(const uint32 memoryPoolIndex) const
+{
+	assert(memoryPoolIndex < mNumOfMemoryPools);
+	return mMemoryPools[memoryPoolIndex]->getStatistics();
+}
+
+inline uint32 ResourceManagement::MemoryManager::getMemoryPoolCount() const
+{
+	return mNumOfMemoryPools;
+}
+
 inline ResourceManagement::MemoryManager &ResourceManagement::MemoryManager::getSingleton()
 {
 	return *getSingletonPointer();
@@ -14,12 +14,9 @@
 using namespace ResourceManagement;
 
 MemoryPool::MemoryPool(const uint16 *bucketCapacities, const uint16 *bucketGranularities, uint32 numOfBuckets) :
-	mNumOfBuckets(numOfBuckets)
+	mNumOfBuckets(numOfBuckets), mBucketCapacity(0), mBucketBytesInUse(0), mNumOfRemainingFrees(0)
 {
 	assert(bucketCapacities && bucketGranularities && numOfBuckets > 0);
-	#ifdef _DEBUG
-		mNumOfRemainingFrees = 0;
-	#endif // _DEBUG
 
 	uint32 sizeOfBaseMemory = sizeof(Bucket *) * mNumOfBuckets; // compute size of memory required by the buckets
 	for (uint32 i = 0; i < mNumOfBuckets; ++i)
@@ -36,14 +33,14 @@ MemoryPool::MemoryPool(const uint16 *bucketCapacities, const uint16 *bucketGranu
 	{
 		mBuckets[i] = new(bucketStoragePosition) Bucket(bucketGranularities[i], bucketCapacities[i]);
 		bucketStoragePosition += sizeof(Bucket) + bucketCapacities[i] * (sizeof(uint16) + bucketGranularities[i]);
+		mBucketCapacity += (uint64) bucketCapacities[i] * bucketGranularities[i];
 	}
 } 
 
 MemoryPool::~MemoryPool()
 {
-	#ifdef _DEBUG 	// all chunks that were requested by malloc instead of a bucket must also be freed
-		assert(0 == mNumOfRemainingFrees);
-	#endif // _DEBUG
+	// all chunks that were requested by malloc instead of a bucket must also be freed
+	assert(0 == mNumOfRemainingFrees.load(std::memory_order_relaxed));
 
 	#ifdef ACTIVE_MEMORY_DESTRUCTION	// buckets already memset the memory they manage, but this is also done to destroy admin's and buckets' data
 		uint32 sizeOfBaseMemory = sizeof(Bucket *) * mNumOfBuckets;
@@ -65,12 +62,13 @@ void *MemoryPool::requestMemory(size_t capacity)
 {
 	for (uint32 i = 0; i < mNumOfBuckets; ++i)	// can a bucket handle this request?
 		if (mBuckets[i]->getGranularity() >= capacity && !mBuckets[i]->isFull())
+		{
+			mBucketBytesInUse.fetch_add(mBuckets[i]->getGranularity(), std::memory_order_relaxed);
 			return mBuckets[i]->requestMemory(capacity);
+		}
 
 	void *memory = malloc(capacity);	// malloc is necessary
-    #ifdef _DEBUG
-        ++mNumOfRemainingFrees;
-    #endif // _DEBUG
+	mNumOfRemainingFrees.fetch_add(1, std::memory_order_relaxed);
     #ifdef ACTIVE_MEMORY_DESTRUCTION
         memset(memory, 0xcd, capacity);
     #endif // ACTIVE_MEMORY_DESTRUCTION
@@ -84,12 +82,23 @@ void MemoryPool::releaseMemory(void *pointer)
 
 	for (uint32 i = 0; i < mNumOfBuckets; ++i)	// is a bucket responsible?
 		if (mBuckets[i]->releaseMemory(pointer))
-            return;
+		{
+			mBucketBytesInUse.fetch_sub(mBuckets[i]->getGranularity(), std::memory_order_relaxed);
+			return;
+		}
 
-    #ifdef _DEBUG	// memory was requested by malloc
-        assert(mNumOfRemainingFrees > 0);
-        --mNumOfRemainingFrees;
-    #endif // _DEBUG
+	// memory was requested by malloc
+	assert(mNumOfRemainingFrees.load(std::memory_order_relaxed) > 0);
+	mNumOfRemainingFrees.fetch_sub(1, std::memory_order_relaxed);
 
 	free(pointer);
 }
+
+MemoryPool::Statistics MemoryPool::getStatistics() const
+{
+	Statistics statistics;
+	statistics.mBucketCapacity = mBucketCapacity;
+	statistics.mBucketBytesInUse = mBucketBytesInUse.load(std::memory_order_relaxed);
+	statistics.mFallbackBlockCount = mNumOfRemainingFrees.load(std::memory_order_relaxed);
+	return statistics;
+}
@@ -8,6 +8,7 @@
 #ifndef _MEMORY_POOL_H_
 #define _MEMORY_POOL_H_
 
+#include <atomic>
 #include "Platform/DataTypes.h"
 #include "Bucket.h"
 
@@ -16,6 +17,15 @@ namespace ResourceManagement
     /// Realizes memory management by means of pools which consist of Bucket objcts containing equally sized memory chunks.
 	class MemoryPool
 	{
+	public:
+		/// Usage of a pool, e.g., for metrics.
+		struct Statistics
+		{
+			uint64 mBucketCapacity;		/// Number of bytes which are managed by all buckets of the pool.
+			uint64 mBucketBytesInUse;	/// Number of bytes of all chunks which are currently requested from buckets.
+			uint64 mFallbackBlockCount;	/// Number of requested blocks which are currently provided by malloc since no bucket could serve them.
+		};
+
 	public:
         /** Creates a memory pool consisting of several Bucket objects for efficient memory requests.
         @param bucketCapacities Defines the chunk count for each Bucket object to be created.
@@ -36,14 +46,18 @@ namespace ResourceManagement
             Function call does nothing if pointer is NULL. */
 		void releaseMemory(void *pointer);
 
+		/** Returns the current usage of this pool. Can be called from any thread, e.g., by a metrics collector.
+		@return Returns the bucket capacity, the bytes of all requested bucket chunks and the number of malloc fallback blocks. */
+		Statistics getStatistics() const;
+
 	private:
         Bucket  **mBuckets;             /// These container manage equally sized memory pieces per bucket.
         uint8   *mBaseMemory;           /// Buckets are placed in this memory and are used to implement an own new operator.
         uint32  mNumOfBuckets;          /// Defines the number of bucket pointers in mBuckets.
 
-		#ifdef _DEBUG
-			uint32 mNumOfRemainingFrees;    /// Tracks how many memory pieces that couldn't be retrieved from a Bucket must be freed.
-		#endif // _DEBUG
+		uint64					mBucketCapacity;		/// Number of bytes which are managed by all buckets.
+		std::atomic<uint64>		mBucketBytesInUse;		/// Number of bytes of all chunks which are currently requested from buckets.
+		std::atomic<uint64>		mNumOfRemainingFrees;	/// Tracks how many memory pieces that couldn't be retrieved from a Bucket must be freed.
 	};
 }
 
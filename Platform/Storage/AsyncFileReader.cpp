@@ -0,0 +1,507 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifdef _LINUX
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#ifdef IO_URING
+		#include <linux/io_uring.h>
+		#include <sys/mman.h>
+		#include <sys/syscall.h>
+	#endif // IO_URING
+#endif // _LINUX
+#include <algorithm>
+#include <cstring>
+#include "Platform/FailureHandling/FileAccessException.h"
+#include "Platform/Storage/AsyncFileReader.h"
+
+using namespace FailureHandling;
+using namespace std;
+using namespace Storage;
+
+#if defined(_LINUX) && defined(IO_URING)
+	/// Memory which is shared with the kernel for queueing reads and receiving their results.
+	struct AsyncFileReader::IOURing
+	{
+		std::vector<iovec>	mVectors;		/// Target memory of the queued read of each buffer.
+		io_uring_sqe		*mEntries;		/// Submission queue entries.
+		io_uring_cqe		*mCompletions;	/// Completion queue entries.
+		void				*mCQMemory;		/// Mapped completion queue ring or NULL if it shares mSQMemory.
+		void				*mSQMemory;		/// Mapped submission queue ring.
+		uint32				*mCQHead;		/// Next completion to be consumed by the reader.
+		uint32				*mCQTail;		/// End of completions written by the kernel.
+		uint32				*mSQArray;		/// Indices into mEntries in submission order.
+		uint32				*mSQTail;		/// End of entries submitted by the reader.
+		size_t				mCQMemorySize;	/// Size of mCQMemory in bytes.
+		size_t				mEntriesSize;	/// Size of mEntries in bytes.
+		size_t				mSQMemorySize;	/// Size of mSQMemory in bytes.
+		uint32				mCQMask;		/// Maps completion counters to indices of mCompletions.
+		uint32				mSQMask;		/// Maps submission counters to indices of mSQArray.
+		int					mDescriptor;	/// io_uring instance.
+	};
+
+	namespace
+	{
+		/** Creates an io_uring instance, there is no wrapper for this system call in the C library.
+		@param entryCount Set this to the minimum number of submission queue entries.
+		@param parameters Is filled with the offsets of the queue fields.
+		@return Returns the io_uring file descriptor or a negative value on failure. */
+		int setUpRing(const uint32 entryCount, io_uring_params &parameters)
+		{
+			return (int) syscall(__NR_io_uring_setup, entryCount, &parameters);
+		}
+
+		/** Submits queued entries to the kernel and optionally waits for finished operations.
+		@param ring Set this to the io_uring file descriptor.
+		@param submittedCount Set this to the number of newly queued submission entries.
+		@param minCompletedCount Set this to the number of finished operations to wait for if flags contains IORING_ENTER_GETEVENTS.
+		@param flags Set this to IORING_ENTER_* flags.
+		@return Returns the number of consumed submission entries or a negative value on failure. */
+		int enterRing(const int ring, const uint32 submittedCount, const uint32 minCompletedCount, const uint32 flags)
+		{
+			return (int) syscall(__NR_io_uring_enter, ring, submittedCount, minCompletedCount, flags, NULL, 0);
+		}
+	}
+#else
+	/// Not used without io_uring support.
+	struct AsyncFileReader::IOURing
+	{
+	};
+#endif // _LINUX && IO_URING
+
+AsyncFileReader::AsyncFileReader(const Path &fileName, const uint32 chunkSize, const uint32 bufferCount, const BACKEND backend,
+	const uint64 offset, const uint64 size) :
+	mName(fileName), mRing(NULL),
+	mAcquiredCount(0), mChunkCount(0), mFileSize(0), mRangeOffset(0), mRangeSize(0), mReadCount(0), mReleasedCount(0), mRequestedCount(0), mStallCount(0),
+	mStreamPosition(0), mBufferCount(bufferCount), mChunkSize(chunkSize), mPendingCount(0), mBackend(BACKEND_THREAD),
+	mError(false), mHolding(false), mRunning(true)
+{
+	assert(chunkSize > 0);
+	assert(bufferCount >= 2);
+	assert(backend < BACKEND_COUNT);
+
+	mStreamChunk.mData = NULL;
+	mStreamChunk.mOffset = 0;
+	mStreamChunk.mSize = 0;
+
+	// open the file & get its size
+	#ifdef _WINDOWS
+		mHandle = fopen(mName.getCString(), "rb");
+		if (!mHandle)
+			throw FileAccessException("Could not open a file for asynchronous reading.", mName, -1);
+
+		_fseeki64(mHandle, 0, SEEK_END);
+		mFileSize = (uint64) _ftelli64(mHandle);
+	#else
+		mDescriptor = open(mName.getCString(), O_RDONLY | O_CLOEXEC);
+		if (-1 == mDescriptor)
+			throw FileAccessException("Could not open a file for asynchronous reading.", mName, errno);
+
+		struct stat status;
+		if (0 != fstat(mDescriptor, &status))
+		{
+			const int errorCode = errno;
+			close(mDescriptor);
+			throw FileAccessException("Could not get the size of a file for asynchronous reading.", mName, errorCode);
+		}
+		mFileSize = (uint64) status.st_size;
+
+		// the kernel should read ahead aggressively as well
+		posix_fadvise(mDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+	#endif // _WINDOWS
+
+	// only the requested range is read
+	mRangeOffset = min<uint64>(offset, mFileSize);
+	mRangeSize = min<uint64>(size, mFileSize - mRangeOffset);
+	mStreamChunk.mOffset = mRangeOffset;
+	#ifdef _WINDOWS
+		_fseeki64(mHandle, (int64) mRangeOffset, SEEK_SET);
+	#endif // _WINDOWS
+
+	mChunkCount = (mRangeSize + mChunkSize - 1) / mChunkSize;
+	mBuffers.resize((size_t) mBufferCount * mChunkSize);
+	mFilledSizes.resize(mBufferCount, 0);
+
+	// start reading the first chunks
+	if (BACKEND_IO_URING == backend && setUpIOURing())
+	{
+		mBackend = BACKEND_IO_URING;
+		while (mRequestedCount < mBufferCount && mRequestedCount < mChunkCount)
+			submitRead(mRequestedCount++);
+		return;
+	}
+
+	mIOThread = thread(&AsyncFileReader::ioThreadFunction, this);
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+	if (BACKEND_IO_URING == mBackend)
+	{
+		tearDownIOURing();
+	}
+	else
+	{
+		{
+			unique_lock<mutex> uniqueLock(mMutex);
+			mRunning = false;
+		}
+		mCondition.notify_all();
+		mIOThread.join();
+	}
+
+	#ifdef _WINDOWS
+		fclose(mHandle);
+	#else
+		close(mDescriptor);
+	#endif // _WINDOWS
+}
+
+bool AsyncFileReader::acquireChunk(Chunk &chunk)
+{
+	chunk.mData = NULL;
+	chunk.mOffset = 0;
+	chunk.mSize = 0;
+
+	if (BACKEND_IO_URING == mBackend)
+	{
+		// the released buffer receives the chunk which is bufferCount chunks ahead
+		if (mHolding)
+		{
+			mHolding = false;
+			++mReleasedCount;
+			if (mRequestedCount < mChunkCount && !mError)
+			{
+				mFilledSizes[mRequestedCount % mBufferCount] = 0;
+				submitRead(mRequestedCount++);
+			}
+		}
+
+		if (mAcquiredCount >= mChunkCount || mError)
+			return false;
+
+		// wait for the next chunk
+		const uint32 bufferIdx = (uint32) (mAcquiredCount % mBufferCount);
+		const uint32 size = getChunkSize(mAcquiredCount);
+		if (mFilledSizes[bufferIdx] < size)
+		{
+			processCompletions(false);
+			if (mFilledSizes[bufferIdx] < size)
+				++mStallCount;
+		}
+
+		while (mFilledSizes[bufferIdx] < size && !mError)
+			if (!processCompletions(true))
+				mError = true;
+
+		if (mError)
+			return false;
+	}
+	else
+	{
+		unique_lock<mutex> uniqueLock(mMutex);
+		if (mHolding)
+		{
+			mHolding = false;
+			++mReleasedCount;
+			mCondition.notify_all();
+		}
+
+		if (mAcquiredCount >= mChunkCount)
+			return false;
+
+		// wait for the next chunk
+		if (mReadCount <= mAcquiredCount && !mError)
+		{
+			++mStallCount;
+			do
+			{
+				mCondition.wait(uniqueLock);
+			} while (mReadCount <= mAcquiredCount && !mError);
+		}
+
+		if (mReadCount <= mAcquiredCount)
+			return false;
+	}
+
+	// hand the chunk to the caller
+	const uint32 bufferIdx = (uint32) (mAcquiredCount % mBufferCount);
+	chunk.mData = mBuffers.data() + (size_t) bufferIdx * mChunkSize;
+	chunk.mOffset = mRangeOffset + mAcquiredCount * mChunkSize;
+	chunk.mSize = getChunkSize(mAcquiredCount);
+
+	++mAcquiredCount;
+	mHolding = true;
+	return true;
+}
+
+uint32 AsyncFileReader::getChunkSize(const uint64 chunkIdx) const
+{
+	const uint64 offset = chunkIdx * mChunkSize;
+	return (uint32) min<uint64>(mChunkSize, mRangeSize - offset);
+}
+
+void AsyncFileReader::ioThreadFunction()
+{
+	unique_lock<mutex> uniqueLock(mMutex);
+
+	while (mRunning && mReadCount < mChunkCount)
+	{
+		// the buffer of the next chunk is still held by the caller or not yet processed?
+		if (mReadCount >= mReleasedCount + mBufferCount)
+		{
+			mCondition.wait(uniqueLock);
+			continue;
+		}
+
+		// read it without blocking the caller
+		const uint64 chunkIdx = mReadCount;
+		uniqueLock.unlock();
+		const bool success = readChunk(chunkIdx);
+		uniqueLock.lock();
+
+		if (!success)
+		{
+			mError = true;
+			mCondition.notify_all();
+			return;
+		}
+
+		++mReadCount;
+		mCondition.notify_all();
+	}
+}
+
+bool AsyncFileReader::readChunk(const uint64 chunkIdx)
+{
+	const uint32 bufferIdx = (uint32) (chunkIdx % mBufferCount);
+	const uint32 size = getChunkSize(chunkIdx);
+	uint8 *target = mBuffers.data() + (size_t) bufferIdx * mChunkSize;
+
+	#ifdef _WINDOWS
+		// chunks are read in order
+		return (size == fread(target, 1, size, mHandle));
+	#else
+		uint32 filledSize = 0;
+		while (filledSize < size)
+		{
+			const ssize_t count = pread(mDescriptor, target + filledSize, size - filledSize, (off_t) (mRangeOffset + chunkIdx * mChunkSize + filledSize));
+			if (count < 0 && EINTR == errno)
+				continue;
+			if (count <= 0)
+				return false;
+			filledSize += (uint32) count;
+		}
+
+		return true;
+	#endif // _WINDOWS
+}
+
+uint64 AsyncFileReader::read(void *target, const uint64 size)
+{
+	uint8 *bytes = reinterpret_cast<uint8 *>(target);
+	uint64 copiedCount = 0;
+
+	while (copiedCount < size)
+	{
+		// current chunk completely copied? keep the position of the last chunk at the end
+		if (mStreamPosition >= mStreamChunk.mSize)
+		{
+			Chunk chunk;
+			if (!acquireChunk(chunk))
+				break;
+			mStreamChunk = chunk;
+			mStreamPosition = 0;
+		}
+
+		const uint64 count = min<uint64>(size - copiedCount, mStreamChunk.mSize - mStreamPosition);
+		memcpy(bytes + copiedCount, mStreamChunk.mData + mStreamPosition, (size_t) count);
+		mStreamPosition += count;
+		copiedCount += count;
+	}
+
+	return copiedCount;
+}
+
+#if defined(_LINUX) && defined(IO_URING)
+	bool AsyncFileReader::setUpIOURing()
+	{
+		io_uring_params parameters;
+		memset(&parameters, 0, sizeof(io_uring_params));
+
+		// e.g., fails with ENOSYS on old kernels and EPERM in restricted containers
+		const int descriptor = setUpRing(mBufferCount, parameters);
+		if (descriptor < 0)
+			return false;
+
+		IOURing *ring = new IOURing();
+		ring->mDescriptor = descriptor;
+		ring->mSQMemorySize = parameters.sq_off.array + parameters.sq_entries * sizeof(uint32);
+		ring->mCQMemorySize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+		ring->mEntriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+
+		// map the queues, both rings can share a single mapping on newer kernels
+		const bool singleMapping = (0 != (parameters.features & IORING_FEAT_SINGLE_MMAP));
+		if (singleMapping)
+			ring->mSQMemorySize = ring->mCQMemorySize = max(ring->mSQMemorySize, ring->mCQMemorySize);
+
+		ring->mSQMemory = mmap(NULL, ring->mSQMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_SQ_RING);
+		ring->mCQMemory = (singleMapping ? NULL :
+			mmap(NULL, ring->mCQMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_CQ_RING));
+		ring->mEntries = reinterpret_cast<io_uring_sqe *>(
+			mmap(NULL, ring->mEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_SQES));
+
+		if (MAP_FAILED == ring->mSQMemory || MAP_FAILED == ring->mCQMemory || MAP_FAILED == (void *) ring->mEntries)
+		{
+			if (MAP_FAILED != ring->mSQMemory)
+				munmap(ring->mSQMemory, ring->mSQMemorySize);
+			if (MAP_FAILED != ring->mCQMemory && ring->mCQMemory)
+				munmap(ring->mCQMemory, ring->mCQMemorySize);
+			if (MAP_FAILED != (void *) ring->mEntries)
+				munmap(ring->mEntries, ring->mEntriesSize);
+			close(descriptor);
+			delete ring;
+			return false;
+		}
+
+		// queue fields
+		uint8 *sq = reinterpret_cast<uint8 *>(ring->mSQMemory);
+		uint8 *cq = reinterpret_cast<uint8 *>(singleMapping ? ring->mSQMemory : ring->mCQMemory);
+		ring->mSQTail = reinterpret_cast<uint32 *>(sq + parameters.sq_off.tail);
+		ring->mSQMask = *reinterpret_cast<uint32 *>(sq + parameters.sq_off.ring_mask);
+		ring->mSQArray = reinterpret_cast<uint32 *>(sq + parameters.sq_off.array);
+		ring->mCQHead = reinterpret_cast<uint32 *>(cq + parameters.cq_off.head);
+		ring->mCQTail = reinterpret_cast<uint32 *>(cq + parameters.cq_off.tail);
+		ring->mCQMask = *reinterpret_cast<uint32 *>(cq + parameters.cq_off.ring_mask);
+		ring->mCompletions = reinterpret_cast<io_uring_cqe *>(cq + parameters.cq_off.cqes);
+		ring->mVectors.resize(mBufferCount);
+
+		mRing = ring;
+		return true;
+	}
+
+	void AsyncFileReader::submitRead(const uint64 chunkIdx)
+	{
+		// read the missing rest of the chunk into its buffer
+		const uint32 bufferIdx = (uint32) (chunkIdx % mBufferCount);
+		const uint32 filledSize = mFilledSizes[bufferIdx];
+		iovec &vector = mRing->mVectors[bufferIdx];
+		vector.iov_base = mBuffers.data() + (size_t) bufferIdx * mChunkSize + filledSize;
+		vector.iov_len = getChunkSize(chunkIdx) - filledSize;
+
+		// fill a submission queue entry, there is always one free since at most mBufferCount reads are pending
+		const uint32 tail = *mRing->mSQTail;
+		const uint32 entryIdx = tail & mRing->mSQMask;
+		io_uring_sqe &entry = mRing->mEntries[entryIdx];
+		memset(&entry, 0, sizeof(io_uring_sqe));
+		entry.opcode = IORING_OP_READV;
+		entry.fd = mDescriptor;
+		entry.off = mRangeOffset + chunkIdx * mChunkSize + filledSize;
+		entry.addr = (uint64) &vector;
+		entry.len = 1;
+		entry.user_data = chunkIdx;
+
+		mRing->mSQArray[entryIdx] = entryIdx;
+		__atomic_store_n(mRing->mSQTail, tail + 1, __ATOMIC_RELEASE);
+		++mPendingCount;
+
+		// hand it to the kernel
+		int result;
+		do
+		{
+			result = enterRing(mRing->mDescriptor, 1, 0, 0);
+		} while (result < 0 && (EINTR == errno || EAGAIN == errno));
+
+		if (result < 0)
+		{
+			--mPendingCount;
+			mError = true;
+		}
+	}
+
+	bool AsyncFileReader::processCompletions(const bool wait)
+	{
+		if (wait)
+		{
+			const int result = enterRing(mRing->mDescriptor, 0, 1, IORING_ENTER_GETEVENTS);
+			if (result < 0 && EINTR != errno)
+				return false;
+		}
+
+		uint32 head = *mRing->mCQHead;
+		const uint32 tail = __atomic_load_n(mRing->mCQTail, __ATOMIC_ACQUIRE);
+
+		for (; head != tail; ++head)
+		{
+			const io_uring_cqe &completion = mRing->mCompletions[head & mRing->mCQMask];
+			const uint64 chunkIdx = completion.user_data;
+			const uint32 bufferIdx = (uint32) (chunkIdx % mBufferCount);
+			--mPendingCount;
+
+			if (-EINTR == completion.res || -EAGAIN == completion.res)
+			{
+				submitRead(chunkIdx);
+				continue;
+			}
+
+			// failed or the file was truncated meanwhile
+			if (completion.res <= 0)
+			{
+				mError = true;
+				continue;
+			}
+
+			// short reads are continued
+			mFilledSizes[bufferIdx] += (uint32) completion.res;
+			if (mFilledSizes[bufferIdx] < getChunkSize(chunkIdx))
+				submitRead(chunkIdx);
+		}
+
+		__atomic_store_n(mRing->mCQHead, head, __ATOMIC_RELEASE);
+		return true;
+	}
+
+	void AsyncFileReader::tearDownIOURing()
+	{
+		// the kernel must not write into the buffers after they were freed
+		while (mPendingCount > 0)
+			if (!processCompletions(true))
+				break;
+
+		if (mRing->mCQMemory)
+			munmap(mRing->mCQMemory, mRing->mCQMemorySize);
+		munmap(mRing->mSQMemory, mRing->mSQMemorySize);
+		munmap(mRing->mEntries, mRing->mEntriesSize);
+		close(mRing->mDescriptor);
+
+		delete mRing;
+		mRing = NULL;
+	}
+#else
+	bool AsyncFileReader::setUpIOURing()
+	{
+		return false;
+	}
+
+	void AsyncFileReader::submitRead(const uint64 chunkIdx)
+	{
+		assert(false);
+	}
+
+	bool AsyncFileReader::processCompletions(const bool wait)
+	{
+		assert(false);
+		return false;
+	}
+
+	void AsyncFileReader::tearDownIOURing()
+	{
+		assert(false);
+	}
+#endif // _LINUX && IO_URING
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _STORAGE_ASYNC_FILE_READER_H_
+#define _STORAGE_ASYNC_FILE_READER_H_
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Platform/DataTypes.h"
+#include "Platform/Storage/Path.h"
+
+namespace Storage
+{
+	/// Reads a file or a range of it from front to back in chunks while the caller processes previously read chunks.
+	/** The file or range is split into chunks of equal size which are read into a ring of buffers.
+		While the caller processes the chunk it acquired last, the following chunks are already being read into the other buffers.
+		With the default of three buffers, chunk N is processed while chunks N + 1 and N + 2 are read (triple buffering).
+		On Linux, reads are queued via io_uring if the kernel supports it and the reader is built with IO_URING.
+		Otherwise, a dedicated I/O thread reads the chunks. */
+	class AsyncFileReader
+	{
+	public:
+		/// Defines how chunks are read in the background.
+		enum BACKEND
+		{
+			BACKEND_IO_URING,	/// Reads are queued in an io_uring of the kernel. Falls back to BACKEND_THREAD if io_uring is not available.
+			BACKEND_THREAD,		/// A dedicated I/O thread reads the chunks with blocking reads.
+			BACKEND_COUNT		/// Number of backends.
+		};
+
+		/// Read-only view of a completely read chunk.
+		struct Chunk
+		{
+			const uint8	*mData;		/// Chunk bytes which stay valid until the next call of acquireChunk(), read() or the destructor.
+			uint64		mOffset;	/// Offset of mData[0] from the file start.
+			uint32		mSize;		/// Number of bytes at mData which is only smaller than the chunk size for the last chunk.
+		};
+
+	public:
+		/** Opens a file and immediately starts reading its first chunks.
+		@param fileName Identifies the file which is read.
+		@param chunkSize Set this to the number of bytes of each chunk. Must not be zero.
+		@param bufferCount Set this to the number of chunk buffers, i.e., the caller holds one chunk and bufferCount - 1 chunks are read ahead. Must be at least 2.
+		@param backend Set this to the preferred way of reading, see getBackend() for the actually used one.
+		@param offset Set this to the file offset of the first read byte, e.g., to skip a file header. It is clamped to the file size.
+		@param size Set this to the maximum number of read bytes or (uint64) -1 to read until the file end.
+		@throws FileAccessException Is thrown if the file cannot be opened. */
+		AsyncFileReader(const Path &fileName, const uint32 chunkSize = DEFAULT_CHUNK_SIZE,
+			const uint32 bufferCount = DEFAULT_BUFFER_COUNT, const BACKEND backend = BACKEND_IO_URING,
+			const uint64 offset = 0, const uint64 size = (uint64) -1);
+
+		/** Cancels reading ahead, waits for pending reads and closes the file. */
+		~AsyncFileReader();
+
+		/** Releases the previously acquired chunk and waits until the next chunk was read.
+		@param chunk Is set to the next chunk of the file.
+		@return Returns false if all chunks were already acquired or if the next chunk could not be read, see errorOccured(). */
+		bool acquireChunk(Chunk &chunk);
+
+		/** Returns true if a chunk could not be read.
+		@return Returns true if reading failed. Following chunks are not delivered anymore in this case. */
+		inline bool errorOccured() const;
+
+		/** Returns the backend which actually reads the file.
+		@return Returns BACKEND_IO_URING only if io_uring is supported and was requested, otherwise BACKEND_THREAD. */
+		inline BACKEND getBackend() const;
+
+		/** Returns the size of the read file.
+		@return Returns the file size in bytes at the time of opening. */
+		inline uint64 getFileSize() const;
+
+		/** Returns the path of the read file.
+		@return Returns the name which was used to open the file. */
+		inline const Path &getName() const;
+
+		/** Returns the position of read() within the file.
+		@return Returns the file offset of the next byte which is copied by read(), i.e., the range offset plus the number of bytes copied so far. */
+		inline uint64 getPosition() const;
+
+		/** Returns how often the caller had to wait for a chunk which was not completely read yet.
+		@return Returns the number of acquireChunk() calls which blocked, e.g., 0 if I/O was entirely overlapped with processing. */
+		inline uint64 getStallCount() const;
+
+		/** Copies the next bytes of the file like a stream and acquires chunks as necessary.
+			Do not mix read() with acquireChunk() since read() continues within the chunk it acquired last.
+		@param target Set this to the memory which is filled with the next file bytes.
+		@param size Set this to the number of bytes to copy.
+		@return Returns the number of copied bytes which is only smaller than size at the file end or after a read error. */
+		uint64 read(void *target, const uint64 size);
+
+	public:
+		static const uint32 DEFAULT_BUFFER_COUNT = 3;		/// Triple buffering by default.
+		static const uint32 DEFAULT_CHUNK_SIZE = 1u << 20;	/// 1 MiB chunks by default.
+
+	private:
+		/// Kernel ring buffers of io_uring, defined in the source file.
+		struct IOURing;
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		AsyncFileReader(const AsyncFileReader &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		AsyncFileReader &operator =(const AsyncFileReader &rhs) { assert(false); return *this; }
+
+		/** Returns the number of bytes of a chunk.
+		@param chunkIdx Identifies the chunk.
+		@return Returns the chunk size or the smaller size of the last chunk. */
+		uint32 getChunkSize(const uint64 chunkIdx) const;
+
+		/** Executed by the I/O thread of BACKEND_THREAD which reads chunks as soon as their buffers were released. */
+		void ioThreadFunction();
+
+		/** Reads a complete chunk with blocking calls.
+		@param chunkIdx Identifies the chunk which is read into its buffer.
+		@return Returns false if the chunk could not be read completely. */
+		bool readChunk(const uint64 chunkIdx);
+
+		/** Creates mRing for BACKEND_IO_URING.
+		@return Returns false if io_uring is not supported or the reader is built without IO_URING. */
+		bool setUpIOURing();
+
+		/** Queues the read of the part of a chunk which is still missing in its buffer according to mFilledSizes. */
+		void submitRead(const uint64 chunkIdx);
+
+		/** Processes finished reads of mRing and waits for them if requested.
+		@param wait Set this to true to block until at least one read finished.
+		@return Returns false if waiting failed. */
+		bool processCompletions(const bool wait);
+
+		/** Waits for all queued reads of mRing and releases the ring. */
+		void tearDownIOURing();
+
+	private:
+		const Path				mName;				/// Name of the read file.
+		std::vector<uint8>		mBuffers;			/// Ring of bufferCount chunk buffers, chunk i is read into buffer i % bufferCount.
+		std::vector<uint32>		mFilledSizes;		/// Number of bytes which were already read into each buffer.
+		std::thread				mIOThread;			/// Reads chunks for BACKEND_THREAD.
+		std::condition_variable	mCondition;			/// Signals read or released chunks between the caller and mIOThread.
+		std::mutex				mMutex;				/// Protects the chunk counters for BACKEND_THREAD.
+		IOURing					*mRing;				/// Queues reads for BACKEND_IO_URING or NULL.
+		#ifdef _WINDOWS
+			FILE				*mHandle;			/// Read file.
+		#else
+			int					mDescriptor;		/// Read file.
+		#endif // _WINDOWS
+		uint64					mAcquiredCount;		/// Number of chunks which were handed to the caller.
+		uint64					mChunkCount;		/// Number of chunks of the file.
+		uint64					mFileSize;			/// Number of bytes of the file.
+		uint64					mRangeOffset;		/// File offset of the first read byte.
+		uint64					mRangeSize;			/// Number of read bytes starting at mRangeOffset.
+		uint64					mReadCount;			/// Number of chunks which were completely read for BACKEND_THREAD.
+		uint64					mReleasedCount;		/// Number of chunks the caller does not access anymore.
+		uint64					mRequestedCount;	/// Number of chunks which were queued for BACKEND_IO_URING.
+		uint64					mStallCount;		/// Number of acquireChunk() calls which had to wait.
+		uint64					mStreamPosition;	/// Position of read() within mStreamChunk.
+		Chunk					mStreamChunk;		/// Chunk which is copied by read().
+		uint32					mBufferCount;		/// Number of chunk buffers.
+		uint32					mChunkSize;			/// Number of bytes of each chunk but the last one.
+		uint32					mPendingCount;		/// Number of queued and not yet finished reads of mRing.
+		BACKEND					mBackend;			/// Actually used backend.
+		std::atomic<bool>		mError;				/// Is true if a chunk could not be read.
+		bool					mHolding;			/// Is true if the caller holds the chunk which was acquired last.
+		bool					mRunning;			/// Is true as long as mIOThread should continue.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline bool AsyncFileReader::errorOccured() const
+	{
+		return mError;
+	}
+
+	inline AsyncFileReader::BACKEND AsyncFileReader::getBackend() const
+	{
+		return mBackend;
+	}
+
+	inline uint64 AsyncFileReader::getFileSize() const
+	{
+		return mFileSize;
+	}
+
+	inline const Path &AsyncFileReader::getName() const
+	{
+		return mName;
+	}
+
+	inline uint64 AsyncFileReader::getPosition() const
+	{
+		return mStreamChunk.mOffset + mStreamPosition;
+	}
+
+	inline uint64 AsyncFileReader::getStallCount() const
+	{
+		return mStallCount;
+	}
+}
+
+#endif // _STORAGE_ASYNC_FILE_READER_H_
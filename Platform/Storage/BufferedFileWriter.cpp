@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifdef _LINUX
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <sys/uio.h>
+	#include <unistd.h>
+#endif // _LINUX
+#include "Platform/FailureHandling/FileAccessException.h"
+#include "Platform/Storage/BufferedFileWriter.h"
+
+using namespace FailureHandling;
+using namespace std;
+using namespace Storage;
+using namespace Utilities;
+
+#ifdef _LINUX
+	namespace
+	{
+		/** Writes all bytes of up to two memory blocks with as few system calls as possible.
+		@param descriptor Set this to the written file.
+		@param vectors Set this to the memory blocks which are modified to track partial writes.
+		@param vectorCount Set this to the number of memory blocks.
+		@return Returns 0 on success or the errno value of the failed call. */
+		int writeVectors(const int descriptor, iovec *vectors, int vectorCount)
+		{
+			while (vectorCount > 0)
+			{
+				const ssize_t writtenCount = writev(descriptor, vectors, vectorCount);
+				if (writtenCount < 0)
+				{
+					if (EINTR == errno)
+						continue;
+					return errno;
+				}
+
+				// skip completely written blocks & continue partially written ones
+				size_t rest = (size_t) writtenCount;
+				while (vectorCount > 0 && rest >= vectors->iov_len)
+				{
+					rest -= vectors->iov_len;
+					++vectors;
+					--vectorCount;
+				}
+
+				if (vectorCount > 0)
+				{
+					vectors->iov_base = reinterpret_cast<uint8 *>(vectors->iov_base) + rest;
+					vectors->iov_len -= rest;
+				}
+			}
+
+			return 0;
+		}
+
+		/** Switches a file from O_DIRECT to writing via the page cache.
+		@param descriptor Set this to the file which was opened with O_DIRECT. */
+		void disableDirectIO(const int descriptor)
+		{
+			const int flags = fcntl(descriptor, F_GETFL);
+			if (-1 != flags)
+				fcntl(descriptor, F_SETFL, flags & ~O_DIRECT);
+		}
+	}
+#endif // _LINUX
+
+BufferedFileWriter::BufferedFileWriter(File &file, const uint32 bufferSize) :
+	mFile(&file), mBuffer(NULL), mWrittenSize(0), mCapacity(0), mFill(0), mDescriptor(-1),
+	mDirect(false), mError(false), mHostBigEndian(isHostBigEndian()), mOwnsFile(false)
+{
+	allocateBuffer(bufferSize);
+}
+
+BufferedFileWriter::BufferedFileWriter(const Path &fileName, const uint32 bufferSize, const bool directIO) :
+	mFile(NULL), mBuffer(NULL), mWrittenSize(0), mCapacity(0), mFill(0), mDescriptor(-1),
+	mDirect(false), mError(false), mHostBigEndian(isHostBigEndian()), mOwnsFile(false)
+{
+	allocateBuffer(bufferSize);
+
+	#ifdef _LINUX
+		// file systems like tmpfs do not support O_DIRECT
+		const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+		if (directIO)
+		{
+			mDescriptor = open(fileName.getCString(), flags | O_DIRECT, 0666);
+			mDirect = (-1 != mDescriptor);
+		}
+
+		if (-1 == mDescriptor)
+			mDescriptor = open(fileName.getCString(), flags, 0666);
+		if (-1 == mDescriptor)
+			throw FileAccessException("Could not create a file for buffered writing.", fileName, errno);
+	#else
+		// written via stdio
+		mFile = new File(fileName, File::CREATE_WRITING, true);
+		mOwnsFile = true;
+	#endif // _LINUX
+}
+
+BufferedFileWriter::~BufferedFileWriter()
+{
+	flush();
+
+	#ifdef _LINUX
+		if (-1 != mDescriptor)
+			close(mDescriptor);
+	#endif // _LINUX
+
+	if (mOwnsFile)
+		delete mFile;
+	mFile = NULL;
+}
+
+void BufferedFileWriter::allocateBuffer(const uint32 bufferSize)
+{
+	// aligned start & size for O_DIRECT
+	mCapacity = max(bufferSize, MIN_BUFFER_SIZE);
+	mCapacity = (mCapacity + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+	mMemory.resize((size_t) mCapacity + DIRECT_IO_ALIGNMENT);
+
+	const size_t address = reinterpret_cast<size_t>(mMemory.data());
+	mBuffer = mMemory.data() + (DIRECT_IO_ALIGNMENT - address % DIRECT_IO_ALIGNMENT) % DIRECT_IO_ALIGNMENT;
+}
+
+bool BufferedFileWriter::flush()
+{
+	return writeBuffer(true);
+}
+
+bool BufferedFileWriter::writeBuffer(const bool complete)
+{
+	if (mError)
+		return false;
+	if (0 == mFill)
+		return true;
+
+	// append to the file
+	if (mFile)
+	{
+		mError = (mFill != mFile->write(mBuffer, sizeof(uint8), mFill));
+		if (!mError)
+			mWrittenSize += mFill;
+		mFill = 0;
+		return !mError;
+	}
+
+	#ifdef _LINUX
+		// O_DIRECT requires aligned sizes, the unaligned rest is kept or written via the page cache
+		uint32 size = mFill;
+		if (mDirect)
+		{
+			if (complete)
+			{
+				if (0 != size % DIRECT_IO_ALIGNMENT)
+				{
+					disableDirectIO(mDescriptor);
+					mDirect = false;
+				}
+			}
+			else
+			{
+				size -= size % DIRECT_IO_ALIGNMENT;
+				if (0 == size)
+					return true;
+			}
+		}
+
+		iovec vector;
+		vector.iov_base = mBuffer;
+		vector.iov_len = size;
+		int errorCode = writeVectors(mDescriptor, &vector, 1);
+
+		// some file systems only reject O_DIRECT on the first write
+		if (EINVAL == errorCode && mDirect && 0 == mWrittenSize)
+		{
+			disableDirectIO(mDescriptor);
+			mDirect = false;
+
+			vector.iov_base = mBuffer;
+			vector.iov_len = size;
+			errorCode = writeVectors(mDescriptor, &vector, 1);
+		}
+
+		if (0 != errorCode)
+		{
+			mError = true;
+			mFill = 0;
+			return false;
+		}
+
+		mWrittenSize += size;
+		mFill -= size;
+		if (mFill > 0)
+			memmove(mBuffer, mBuffer + size, mFill);
+	#endif // _LINUX
+
+	return true;
+}
+
+bool BufferedFileWriter::writeLarge(const uint8 *data, const uint64 size)
+{
+	if (mError)
+		return false;
+
+	// File::write writes at most 4 GiB at once
+	if (mFile)
+	{
+		if (!writeBuffer(true))
+			return false;
+
+		const uint64 MAX_BLOCK_SIZE = 1u << 30;
+		for (uint64 writtenCount = 0; writtenCount < size; )
+		{
+			const uint32 blockSize = (uint32) min(MAX_BLOCK_SIZE, size - writtenCount);
+			if (blockSize != mFile->write(data + writtenCount, sizeof(uint8), blockSize))
+			{
+				mError = true;
+				return false;
+			}
+
+			writtenCount += blockSize;
+			mWrittenSize += blockSize;
+		}
+
+		return true;
+	}
+
+	// O_DIRECT: copy through the aligned buffer
+	if (mDirect)
+	{
+		for (uint64 copiedCount = 0; copiedCount < size; )
+		{
+			if (mFill == mCapacity && !writeBuffer(false))
+				return false;
+
+			const uint32 blockSize = (uint32) min<uint64>(mCapacity - mFill, size - copiedCount);
+			memcpy(mBuffer + mFill, data + copiedCount, blockSize);
+			mFill += blockSize;
+			copiedCount += blockSize;
+		}
+
+		return true;
+	}
+
+	#ifdef _LINUX
+		// buffered bytes and data by a single call without copying data
+		iovec vectors[2];
+		vectors[0].iov_base = mBuffer;
+		vectors[0].iov_len = mFill;
+		vectors[1].iov_base = const_cast<uint8 *>(data);
+		vectors[1].iov_len = (size_t) size;
+
+		const bool empty = (0 == mFill);
+		if (0 != writeVectors(mDescriptor, vectors + (empty ? 1 : 0), (empty ? 1 : 2)))
+		{
+			mError = true;
+			mFill = 0;
+			return false;
+		}
+
+		mWrittenSize += mFill + size;
+		mFill = 0;
+	#endif // _LINUX
+
+	return true;
+}
+
+int32 BufferedFileWriter::writeString(const string &source, const Encoding encoding)
+{
+	assert(encoding < ENCODING_COUNT);
+
+	const uint32 numberOfCharacters = (uint32) source.size();
+	if (!writeInt32(numberOfCharacters, encoding))
+		return -1;
+
+	if (numberOfCharacters != write(source.data(), sizeof(char), numberOfCharacters))
+		return -1;
+	return (int32) numberOfCharacters;
+}
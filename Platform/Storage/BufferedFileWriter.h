@@ -0,0 +1,371 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _STORAGE_BUFFERED_FILE_WRITER_H_
+#define _STORAGE_BUFFERED_FILE_WRITER_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Platform/DataTypes.h"
+#include "Platform/Storage/File.h"
+#include "Platform/Storage/Path.h"
+#include "Platform/Utilities/ByteSwapping.h"
+#include "Platform/Utilities/NumberFormatting.h"
+
+namespace Storage
+{
+	/// Collects many small writes in a large user space buffer and passes them to the operating system in big blocks.
+	/** The writing functions have the same names, parameters and encodings as those of File, e.g., writeFloat(), but only copy or format values into the buffer.
+		ASCII numbers are formatted without printf, see Utilities::formatFixed() and Utilities::formatReal().
+		The buffer is written when it is full, by flush() and by the destructor.
+		A writer either appends to the current position of an open File or writes a file on its own.
+		On Linux, files written on their own use write and writev system calls directly.
+		Writes which are larger than the buffer are then passed on together with the buffered bytes by a single writev call without copying them.
+		Optionally, such files can be written with O_DIRECT to bypass the page cache, e.g., for huge exports which are not read again soon. */
+	class BufferedFileWriter
+	{
+	public:
+		/** Creates a writer which appends to the current position of an already opened file.
+			The file must not be written otherwise until the writer was flushed.
+		@param file Set this to a file which was opened for writing and which lives longer than the writer.
+		@param bufferSize Set this to the number of bytes which are collected before they are passed to file, at least MIN_BUFFER_SIZE. */
+		BufferedFileWriter(File &file, const uint32 bufferSize = DEFAULT_BUFFER_SIZE);
+
+		/** Creates or truncates a file and writes it on its own.
+		@param fileName Identifies the created file.
+		@param bufferSize Set this to the number of bytes which are collected before they are written, at least MIN_BUFFER_SIZE and rounded up to a multiple of DIRECT_IO_ALIGNMENT.
+		@param directIO Set this to true to bypass the page cache via O_DIRECT on Linux. It is silently ignored if the file system or system does not support it.
+		@throws FileAccessException Is thrown if the file cannot be created. */
+		BufferedFileWriter(const Path &fileName, const uint32 bufferSize = DEFAULT_BUFFER_SIZE, const bool directIO = false);
+
+		/** Writes all buffered bytes and closes the file if it was opened by the writer. */
+		~BufferedFileWriter();
+
+		/** Returns true if a write to the operating system or the file failed.
+		@return Returns true if some bytes could not be written. All following writes are dropped in this case. */
+		inline bool errorOccured() const;
+
+		/** Writes all buffered bytes. Files which are written with O_DIRECT are written via the page cache afterwards since the file end might be unaligned.
+		@return Returns false if the bytes could not be written completely. */
+		bool flush();
+
+		/** Returns the number of bytes which were passed to the writer, i.e., the file size for files written on their own.
+		@return Returns the number of buffered and already written bytes. */
+		inline uint64 getSize() const;
+
+		/** Returns true if the writer bypasses the page cache.
+		@return Returns true if the file is written on its own with O_DIRECT. */
+		inline bool isDirect() const;
+
+		/** Writes elements like File::write() does.
+		@param data Set this to the written elements.
+		@param elementSize Set this to the size of each element in bytes.
+		@param elementCount Set this to the number of elements at data.
+		@return Returns elementCount or 0 if an error occurred so far. */
+		inline uint64 write(const void *data, const uint32 elementSize, const uint64 elementCount);
+
+		/** Writes an array of numbers like File::writeArray() does.
+		@param source Set this to the first of count numbers in host order.
+		@param count Set this to the number of written numbers.
+		@param encoding Set this to the encoding of all numbers.
+		@return Returns count or 0 if an error occurred so far. */
+		template <class T>
+		uint64 writeArray(const T *source, const uint64 count, const Encoding encoding);
+
+		/** Writes a single character, e.g., a separator of ASCII encoded values.
+		@param c Set this to the written character. */
+		inline void writeCharacter(const char c);
+
+		/** Writes a 64 bit floating point number like File::writeDouble() does, i.e., with 6 decimals for ENCODING_ASCII. */
+		inline bool writeDouble(const double value, const Encoding encoding);
+
+		/** Writes a 32 bit floating point number like File::writeFloat() does, i.e., with 6 decimals for ENCODING_ASCII. */
+		inline bool writeFloat(const float value, const Encoding encoding);
+
+		/** Writes an integer like File::writeInt32() does. */
+		inline bool writeInt32(const int32 integer, const Encoding encoding);
+
+		/** Writes a float or double depending on DOUBLE_PRECISION like File::writeReal() does. */
+		inline bool writeReal(const Real value, const Encoding encoding);
+
+		/** Writes a string like File::writeString() does, i.e., its length followed by its characters.
+		@return Returns the number of written characters or -1 if an error occurred so far. */
+		int32 writeString(const std::string &source, const Encoding encoding);
+
+		/** Writes a zero terminated string without its terminating zero, e.g., a line break.
+		@param text Set this to the written characters. */
+		inline void writeText(const char *text);
+
+		/** Writes an unsigned byte like File::writeUInt8() does. */
+		inline bool writeUInt8(const uint8 integer, const Encoding encoding);
+
+	public:
+		static const uint32 DEFAULT_BUFFER_SIZE = 1u << 22;	/// 4 MiB are collected by default.
+		static const uint32 DIRECT_IO_ALIGNMENT = 4096;		/// Alignment of buffer addresses, sizes and file offsets for O_DIRECT.
+		static const uint32 MIN_BUFFER_SIZE = 1u << 16;		/// Smaller buffers are enlarged to this size.
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		BufferedFileWriter(const BufferedFileWriter &copy) : mFile(NULL) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		BufferedFileWriter &operator =(const BufferedFileWriter &rhs) { assert(false); return *this; }
+
+		/** Allocates mBuffer aligned to DIRECT_IO_ALIGNMENT.
+		@param bufferSize Set this to the requested buffer size in bytes. */
+		void allocateBuffer(const uint32 bufferSize);
+
+		/** Makes room for at least byteCount bytes in mBuffer by writing the buffered bytes if necessary.
+		@param byteCount Set this to the number of bytes which are going to be appended, at most mCapacity.
+		@return Returns a pointer to the free space or NULL after a write error. */
+		inline uint8 *reserve(const uint32 byteCount);
+
+		/** Passes buffered bytes to the operating system or the file.
+		@param complete Set this to false to keep an unaligned rest for O_DIRECT in mBuffer.
+		@return Returns false if the bytes could not be written. */
+		bool writeBuffer(const bool complete);
+
+		/** Writes the buffered bytes followed by a large block of bytes without copying the block into mBuffer if possible.
+		@param data Set this to the written bytes.
+		@param size Set this to the number of bytes at data.
+		@return Returns false if the bytes could not be written. */
+		bool writeLarge(const uint8 *data, const uint64 size);
+
+		/** Encodes a 32 or 64 bit value as binary number in the requested byte order.
+		@param bytes Set this to the host order bytes of the value.
+		@param size Set this to 4 or 8.
+		@param encoding Set this to ENCODING_BINARY_LITTLE_ENDIAN or ENCODING_BINARY_BIG_ENDIAN.
+		@return Returns false if an error occurred so far. */
+		inline bool writeBinary(const void *bytes, const uint32 size, const Encoding encoding);
+
+	private:
+		std::vector<uint8>	mMemory;		/// Memory of mBuffer including alignment padding.
+		File				*mFile;			/// File which is appended to or NULL if the writer writes on its own.
+		uint8				*mBuffer;		/// Buffered bytes which were not written so far.
+		uint64				mWrittenSize;	/// Number of bytes which were passed on to the operating system or to mFile.
+		uint32				mCapacity;		/// Size of mBuffer in bytes.
+		uint32				mFill;			/// Number of buffered bytes at mBuffer.
+		int					mDescriptor;	/// File which is written on its own on Linux or -1.
+		bool				mDirect;		/// Is true if mDescriptor was opened with O_DIRECT.
+		bool				mError;			/// Is true if a write failed.
+		bool				mHostBigEndian;	/// Is true if binary numbers must be swapped for ENCODING_BINARY_LITTLE_ENDIAN.
+		bool				mOwnsFile;		/// Is true if mFile was opened by the writer.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline & template function definitions   /////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline bool BufferedFileWriter::errorOccured() const
+	{
+		return mError;
+	}
+
+	inline uint64 BufferedFileWriter::getSize() const
+	{
+		return mWrittenSize + mFill;
+	}
+
+	inline bool BufferedFileWriter::isDirect() const
+	{
+		return mDirect;
+	}
+
+	inline uint8 *BufferedFileWriter::reserve(const uint32 byteCount)
+	{
+		assert(byteCount <= mCapacity);
+		if (mFill + byteCount > mCapacity && !writeBuffer(false))
+			return NULL;
+		if (mError)
+			return NULL;
+
+		return mBuffer + mFill;
+	}
+
+	inline uint64 BufferedFileWriter::write(const void *data, const uint32 elementSize, const uint64 elementCount)
+	{
+		const uint64 size = elementSize * elementCount;
+
+		// small writes are copied into the buffer
+		if (size <= mCapacity - mFill)
+		{
+			if (mError)
+				return 0;
+
+			memcpy(mBuffer + mFill, data, (size_t) size);
+			mFill += (uint32) size;
+			return elementCount;
+		}
+
+		return (writeLarge(reinterpret_cast<const uint8 *>(data), size) ? elementCount : 0);
+	}
+
+	template <class T>
+	uint64 BufferedFileWriter::writeArray(const T *source, const uint64 count, const Encoding encoding)
+	{
+		static_assert(std::is_arithmetic<T>::value, "BufferedFileWriter::writeArray() only supports numbers.");
+
+		// binary: copy as is or convert blocks right into the buffer
+		if (ENCODING_ASCII != encoding)
+		{
+			const bool swap = ((ENCODING_BINARY_BIG_ENDIAN == encoding) != mHostBigEndian);
+			if (!swap || 1 == sizeof(T))
+				return write(source, sizeof(T), count);
+
+			for (uint64 writtenCount = 0; writtenCount < count; )
+			{
+				uint8 *target = reserve(sizeof(T));
+				if (!target)
+					return 0;
+
+				const uint32 blockCount = (uint32) std::min<uint64>((mCapacity - mFill) / sizeof(T), count - writtenCount);
+				Utilities::swapBytes(target, source + writtenCount, sizeof(T), blockCount);
+				mFill += blockCount * sizeof(T);
+				writtenCount += blockCount;
+			}
+
+			return count;
+		}
+
+		// ASCII: separated by spaces and restorable exactly like File::writeArray()
+		for (uint64 valueIdx = 0; valueIdx < count; ++valueIdx)
+		{
+			char *target = reinterpret_cast<char *>(reserve(Utilities::MAX_NUMBER_LENGTH + 1));
+			if (!target)
+				return 0;
+
+			char *end = target;
+			if (valueIdx > 0)
+				*end++ = ' ';
+
+			if (std::is_floating_point<T>::value)
+				end = (sizeof(T) <= sizeof(float) ?
+					Utilities::formatReal(end, (float) source[valueIdx]) : Utilities::formatReal(end, (double) source[valueIdx]));
+			else if (std::is_signed<T>::value)
+				end = Utilities::formatSigned(end, (int64) source[valueIdx]);
+			else
+				end = Utilities::formatUnsigned(end, (uint64) source[valueIdx]);
+
+			mFill += (uint32) (end - target);
+		}
+
+		return count;
+	}
+
+	inline bool BufferedFileWriter::writeBinary(const void *bytes, const uint32 size, const Encoding encoding)
+	{
+		uint8 *target = reserve(size);
+		if (!target)
+			return false;
+
+		if ((ENCODING_BINARY_BIG_ENDIAN == encoding) == mHostBigEndian)
+		{
+			memcpy(target, bytes, size);
+		}
+		else
+		{
+			const uint8 *source = reinterpret_cast<const uint8 *>(bytes);
+			for (uint32 byteIdx = 0; byteIdx < size; ++byteIdx)
+				target[byteIdx] = source[size - 1 - byteIdx];
+		}
+
+		mFill += size;
+		return true;
+	}
+
+	inline void BufferedFileWriter::writeCharacter(const char c)
+	{
+		uint8 *target = reserve(1);
+		if (!target)
+			return;
+
+		*target = (uint8) c;
+		++mFill;
+	}
+
+	inline bool BufferedFileWriter::writeDouble(const double value, const Encoding encoding)
+	{
+		assert(encoding < ENCODING_COUNT);
+		if (ENCODING_ASCII != encoding)
+			return writeBinary(&value, sizeof(double), encoding);
+
+		char *target = reinterpret_cast<char *>(reserve(Utilities::MAX_FIXED_NUMBER_LENGTH));
+		if (!target)
+			return false;
+
+		mFill += (uint32) (Utilities::formatFixed(target, value, 6) - target);
+		return true;
+	}
+
+	inline bool BufferedFileWriter::writeFloat(const float value, const Encoding encoding)
+	{
+		assert(encoding < ENCODING_COUNT);
+		if (ENCODING_ASCII != encoding)
+			return writeBinary(&value, sizeof(float), encoding);
+
+		char *target = reinterpret_cast<char *>(reserve(Utilities::MAX_FIXED_NUMBER_LENGTH));
+		if (!target)
+			return false;
+
+		mFill += (uint32) (Utilities::formatFixed(target, value, 6) - target);
+		return true;
+	}
+
+	inline bool BufferedFileWriter::writeInt32(const int32 integer, const Encoding encoding)
+	{
+		assert(encoding < ENCODING_COUNT);
+		if (ENCODING_ASCII != encoding)
+			return writeBinary(&integer, sizeof(int32), encoding);
+
+		char *target = reinterpret_cast<char *>(reserve(Utilities::MAX_NUMBER_LENGTH));
+		if (!target)
+			return false;
+
+		mFill += (uint32) (Utilities::formatSigned(target, integer) - target);
+		return true;
+	}
+
+	inline bool BufferedFileWriter::writeReal(const Real value, const Encoding encoding)
+	{
+		#ifdef DOUBLE_PRECISION
+			return writeDouble(value, encoding);
+		#else
+			return writeFloat(value, encoding);
+		#endif
+	}
+
+	inline void BufferedFileWriter::writeText(const char *text)
+	{
+		write(text, sizeof(char), strlen(text));
+	}
+
+	inline bool BufferedFileWriter::writeUInt8(const uint8 integer, const Encoding encoding)
+	{
+		assert(encoding < ENCODING_COUNT);
+		uint8 *target = reserve(Utilities::MAX_NUMBER_LENGTH);
+		if (!target)
+			return false;
+
+		if (ENCODING_ASCII == encoding)
+		{
+			mFill += (uint32) (Utilities::formatUnsigned(reinterpret_cast<char *>(target), integer) - reinterpret_cast<char *>(target));
+			return true;
+		}
+
+		*target = integer;
+		++mFill;
+		return true;
+	}
+}
+
+#endif // _STORAGE_BUFFERED_FILE_WRITER_H_
@@ -0,0 +1,751 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <zlib.h>
+#ifdef ZSTD
+	#include <zstd.h>
+#endif // ZSTD
+#include "Platform/FailureHandling/FileAccessException.h"
+#include "Platform/FailureHandling/FileCorruptionException.h"
+#include "Platform/Multithreading/Manager.h"
+#include "Platform/Storage/CompressedStream.h"
+
+using namespace FailureHandling;
+using namespace Platform::Multithreading;
+using namespace std;
+using namespace Storage;
+
+namespace
+{
+	const uint32 GZIP_HEADER_SIZE = 24;				/// Size of the member header with the block sizes in an extra field.
+	const uint32 GZIP_TRAILER_SIZE = 8;				/// CRC32 & uncompressed size behind each gzip member.
+	const uint32 MAX_TASK_COUNT = 16;				/// Maximum number of blocks which are compressed at the same time.
+	const uint32 SKIP_BUFFER_SIZE = 1u << 16;		/// Decompressed bytes which are discarded at once when seeking forward.
+	const uint32 STDIO_BUFFER_SIZE = 1u << 16;		/// Buffer of the stdio handle to call the stream for large pieces only.
+	const uint32 ZSTD_HEADER_SIZE = 16;				/// Size of the skippable frame with the block sizes in front of each zstd frame.
+	const uint32 ZSTD_BLOCK_MAGIC = 0x184D2A5B;		/// Skippable frame magic number of the block size frames.
+	const uint32 ZSTD_FRAME_MAGIC = 0xFD2FB528;		/// Magic number of zstd frames.
+
+	/// gzip member header of each block: deflate, FEXTRA, no time, unknown OS, XLEN 12 and subfield "BP" with 8 bytes of block sizes.
+	const uint8 GZIP_HEADER[GZIP_HEADER_SIZE - 8] = { 0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 12, 0, 'B', 'P', 8, 0 };
+
+	/** Reads an unsigned little endian 32 bit integer.
+	@param source Set this to the first of 4 bytes.
+	@return Returns the integer in host order. */
+	inline uint32 readLittleEndian32(const uint8 *source)
+	{
+		return (uint32) source[0] | ((uint32) source[1] << 8) | ((uint32) source[2] << 16) | ((uint32) source[3] << 24);
+	}
+
+	/** Writes an unsigned 32 bit integer in little endian byte order.
+	@param target Set this to 4 writable bytes.
+	@param value Set this to the written integer. */
+	inline void writeLittleEndian32(uint8 *target, const uint32 value)
+	{
+		target[0] = (uint8) value;
+		target[1] = (uint8) (value >> 8);
+		target[2] = (uint8) (value >> 16);
+		target[3] = (uint8) (value >> 24);
+	}
+
+	/** Sets the position of the compressed file, also for files larger than 2 GiB.
+	@param file Set this to the compressed file.
+	@param offset Set this to the new position relative to the file start in bytes.
+	@return Returns false if the position could not be changed. */
+	bool seekFile(FILE *file, const uint64 offset)
+	{
+		#ifdef _WINDOWS
+			return (0 == _fseeki64(file, (__int64) offset, SEEK_SET));
+		#else
+			return (0 == fseeko(file, (off_t) offset, SEEK_SET));
+		#endif // _WINDOWS
+	}
+
+	#ifdef __GLIBC__
+		// stdio cookie functions which forward to the stream
+
+		ssize_t readCookie(void *cookie, char *buffer, size_t size)
+		{
+			return (ssize_t) static_cast<CompressedStream *>(cookie)->read(reinterpret_cast<uint8 *>(buffer), size);
+		}
+
+		ssize_t writeCookie(void *cookie, const char *buffer, size_t size)
+		{
+			// 0 signals an error to stdio
+			const int64 writtenCount = static_cast<CompressedStream *>(cookie)->write(reinterpret_cast<const uint8 *>(buffer), size);
+			return (writtenCount < 0 ? 0 : (ssize_t) writtenCount);
+		}
+
+		int seekCookie(void *cookie, off64_t *offset, int whence)
+		{
+			int64 position = (int64) *offset;
+			if (!static_cast<CompressedStream *>(cookie)->seek(position, whence))
+				return -1;
+
+			*offset = (off64_t) position;
+			return 0;
+		}
+
+		int closeCookie(void *cookie)
+		{
+			CompressedStream *stream = static_cast<CompressedStream *>(cookie);
+			const bool finished = stream->finish();
+			delete stream;
+
+			return (finished ? 0 : EOF);
+		}
+	#endif // __GLIBC__
+}
+
+bool CompressedStream::isSupported(const File::Compression compression)
+{
+	switch (compression)
+	{
+		case File::COMPRESSION_NONE:
+			return true;
+
+		#ifdef __GLIBC__
+			case File::COMPRESSION_GZIP:
+				return true;
+
+			#ifdef ZSTD
+				case File::COMPRESSION_ZSTD:
+					return true;
+			#endif // ZSTD
+		#endif // __GLIBC__
+
+		default:
+			return false;
+	}
+}
+
+FILE *CompressedStream::open(const Path &fileName, const File::FileMode mode, const File::Compression compression)
+{
+	const bool writing = (File::CREATE_WRITING == mode || File::APPEND_WRITING == mode);
+	if (!writing && File::OPEN_READING != mode && File::OPEN_READING_MAPPED != mode)
+		throw FileAccessException("Compressed files can only be read or written, but not both at once.", fileName, EINVAL);
+	if (File::COMPRESSION_NONE == compression || !isSupported(compression))
+		throw FileAccessException("The requested file compression is not supported.", fileName, EINVAL);
+
+	#ifdef __GLIBC__
+		// compressed file
+		const char *fileMode = (File::CREATE_WRITING == mode ? "wb" : (File::APPEND_WRITING == mode ? "ab" : "rb"));
+		FILE *file = fopen(fileName.getCString(), fileMode);
+		if (!file)
+			throw FileAccessException("Could not open a compressed file.", fileName, errno);
+
+		CompressedStream *stream = new CompressedStream(file, writing, compression);
+		if (!writing && !stream->detectFormat())
+		{
+			delete stream;
+			throw FileCorruptionException("The file is neither gzip, zlib nor zstd compressed or its compression is not supported.", fileName);
+		}
+
+		// stdio handle which owns the stream
+		cookie_io_functions_t functions;
+		functions.read = readCookie;
+		functions.write = writeCookie;
+		functions.seek = seekCookie;
+		functions.close = closeCookie;
+
+		FILE *handle = fopencookie(stream, (writing ? "wb" : "rb"), functions);
+		if (!handle)
+		{
+			delete stream;
+			throw FileAccessException("Could not create a stream for a compressed file.", fileName, errno);
+		}
+
+		setvbuf(handle, NULL, _IOFBF, STDIO_BUFFER_SIZE);
+		return handle;
+	#else
+		return NULL;
+	#endif // __GLIBC__
+}
+
+CompressedStream::BlockTask::BlockTask() :
+	Task(), mContext(NULL), mCompression(File::COMPRESSION_NONE), mQueued(false)
+{
+
+}
+
+CompressedStream::BlockTask::~BlockTask()
+{
+	if (!mContext)
+		return;
+
+	if (File::COMPRESSION_GZIP == mCompression)
+	{
+		z_stream *deflater = static_cast<z_stream *>(mContext);
+		deflateEnd(deflater);
+		delete deflater;
+	}
+	#ifdef ZSTD
+		else if (File::COMPRESSION_ZSTD == mCompression)
+		{
+			ZSTD_freeCCtx(static_cast<ZSTD_CCtx *>(mContext));
+		}
+	#endif // ZSTD
+
+	mContext = NULL;
+}
+
+void CompressedStream::BlockTask::function()
+{
+	const uint32 size = (uint32) mInput.size();
+	mOutput.clear();
+
+	if (File::COMPRESSION_GZIP == mCompression)
+	{
+		// the deflate state is reused for all blocks of the task
+		z_stream *deflater = static_cast<z_stream *>(mContext);
+		if (!deflater)
+		{
+			deflater = new z_stream;
+			memset(deflater, 0, sizeof(z_stream));
+			if (Z_OK != deflateInit2(deflater, GZIP_LEVEL, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY))
+			{
+				delete deflater;
+				return;
+			}
+			mContext = deflater;
+		}
+		else
+		{
+			deflateReset(deflater);
+		}
+
+		// raw deflate data between the own header & the trailer
+		const uint32 bound = (uint32) deflateBound(deflater, size);
+		mOutput.resize(GZIP_HEADER_SIZE + bound + GZIP_TRAILER_SIZE);
+
+		deflater->next_in = const_cast<Bytef *>(mInput.data());
+		deflater->avail_in = size;
+		deflater->next_out = mOutput.data() + GZIP_HEADER_SIZE;
+		deflater->avail_out = bound;
+		if (Z_STREAM_END != deflate(deflater, Z_FINISH))
+		{
+			mOutput.clear();
+			return;
+		}
+
+		const uint32 memberSize = GZIP_HEADER_SIZE + (uint32) deflater->total_out + GZIP_TRAILER_SIZE;
+		memcpy(mOutput.data(), GZIP_HEADER, sizeof(GZIP_HEADER));
+		writeLittleEndian32(mOutput.data() + 16, size);
+		writeLittleEndian32(mOutput.data() + 20, memberSize);
+
+		uint8 *trailer = mOutput.data() + memberSize - GZIP_TRAILER_SIZE;
+		writeLittleEndian32(trailer, (uint32) crc32(crc32(0, Z_NULL, 0), mInput.data(), size));
+		writeLittleEndian32(trailer + 4, size);
+		mOutput.resize(memberSize);
+		return;
+	}
+
+	#ifdef ZSTD
+		if (File::COMPRESSION_ZSTD == mCompression)
+		{
+			ZSTD_CCtx *context = static_cast<ZSTD_CCtx *>(mContext);
+			if (!context)
+			{
+				context = ZSTD_createCCtx();
+				if (!context)
+					return;
+				mContext = context;
+			}
+
+			// skippable size frame & the data frame
+			const size_t bound = ZSTD_compressBound(size);
+			mOutput.resize(ZSTD_HEADER_SIZE + bound);
+
+			const size_t frameSize = ZSTD_compressCCtx(context, mOutput.data() + ZSTD_HEADER_SIZE, bound, mInput.data(), size, ZSTD_LEVEL);
+			if (ZSTD_isError(frameSize))
+			{
+				mOutput.clear();
+				return;
+			}
+
+			writeLittleEndian32(mOutput.data(), ZSTD_BLOCK_MAGIC);
+			writeLittleEndian32(mOutput.data() + 4, 8);
+			writeLittleEndian32(mOutput.data() + 8, size);
+			writeLittleEndian32(mOutput.data() + 12, (uint32) frameSize);
+			mOutput.resize(ZSTD_HEADER_SIZE + frameSize);
+		}
+	#endif // ZSTD
+}
+
+CompressedStream::CompressedStream(FILE *file, const bool writing, const File::Compression compression) :
+	mTasks(NULL), mFile(file), mDecoder(NULL), mPosition(0), mCompressedPosition(0), mInputStart(0), mInputEnd(0),
+	mTaskCount(0), mTaskIdx(0), mCompression(compression), mFormat(FORMAT_GZIP), mEndOfStream(false), mError(false),
+	mIndexed(false), mUseTasks(false), mWriting(writing)
+{
+	if (!mWriting)
+	{
+		mInput.resize(INPUT_BUFFER_SIZE);
+		return;
+	}
+
+	// several blocks are compressed at once by the workers, but not if this thread is a worker which must not wait for other tasks
+	mTaskCount = 1;
+	if (Manager::exists() && Manager::getSingleton().isRunning() && !Manager::isWorkerThread())
+	{
+		const uint32 threadCount = Manager::getSingleton().getThreadCount();
+		mTaskCount = (threadCount < MAX_TASK_COUNT ? threadCount : MAX_TASK_COUNT) + 1;
+		mUseTasks = (threadCount > 0);
+	}
+
+	mTasks = new BlockTask[mTaskCount];
+	for (uint32 taskIdx = 0; taskIdx < mTaskCount; ++taskIdx)
+		mTasks[taskIdx].mCompression = mCompression;
+}
+
+CompressedStream::~CompressedStream()
+{
+	// the workers must not access the tasks anymore
+	for (uint32 taskIdx = 0; taskIdx < mTaskCount; ++taskIdx)
+		if (mTasks[taskIdx].mQueued)
+			mTasks[taskIdx].waitUntilFinished();
+	delete [] mTasks;
+	mTasks = NULL;
+
+	if (mDecoder)
+	{
+		if (FORMAT_GZIP == mFormat)
+		{
+			z_stream *inflater = static_cast<z_stream *>(mDecoder);
+			inflateEnd(inflater);
+			delete inflater;
+		}
+		#ifdef ZSTD
+			else
+			{
+				ZSTD_freeDStream(static_cast<ZSTD_DStream *>(mDecoder));
+			}
+		#endif // ZSTD
+		mDecoder = NULL;
+	}
+
+	fclose(mFile);
+	mFile = NULL;
+}
+
+bool CompressedStream::completeBlock(BlockTask &task)
+{
+	task.mQueued = false;
+	if (task.mOutput.empty())
+		mError = true;
+	if (mError)
+		return false;
+
+	if (task.mOutput.size() != fwrite(task.mOutput.data(), sizeof(uint8), task.mOutput.size(), mFile))
+		mError = true;
+	return !mError;
+}
+
+bool CompressedStream::detectFormat()
+{
+	// empty files have empty content
+	if (!refillInput())
+	{
+		mEndOfStream = true;
+		return !mError;
+	}
+
+	const uint8 *start = mInput.data();
+	const uint32 size = mInputEnd;
+	const uint32 magic = (size >= 4 ? readLittleEndian32(start) : 0);
+
+	if (size >= 2 && 0x1f == start[0] && 0x8b == start[1])
+	{
+		mFormat = FORMAT_GZIP;
+		mIndexed = (size >= GZIP_HEADER_SIZE && 0 == memcmp(start, GZIP_HEADER, sizeof(GZIP_HEADER)));
+	}
+	else if (size >= 2 && 8 == (start[0] & 0x0f) && 0 == (((uint32) start[0] << 8) | start[1]) % 31)
+	{
+		// zlib stream
+		mFormat = FORMAT_GZIP;
+	}
+	else if (ZSTD_FRAME_MAGIC == magic || 0x184D2A50 == (magic & 0xFFFFFFF0))
+	{
+		mFormat = FORMAT_ZSTD;
+		mIndexed = (size >= ZSTD_HEADER_SIZE && ZSTD_BLOCK_MAGIC == magic && 8 == readLittleEndian32(start + 4));
+	}
+	else
+	{
+		return false;
+	}
+
+	// decoder for the detected format
+	if (FORMAT_GZIP == mFormat)
+	{
+		// gzip or zlib header detection
+		z_stream *inflater = new z_stream;
+		memset(inflater, 0, sizeof(z_stream));
+		if (Z_OK != inflateInit2(inflater, MAX_WBITS + 32))
+		{
+			delete inflater;
+			return false;
+		}
+
+		mDecoder = inflater;
+		return true;
+	}
+
+	#ifdef ZSTD
+		mDecoder = ZSTD_createDStream();
+		return (mDecoder && !ZSTD_isError(ZSTD_initDStream(static_cast<ZSTD_DStream *>(mDecoder))));
+	#else
+		return false;
+	#endif // ZSTD
+}
+
+bool CompressedStream::finish()
+{
+	if (!mWriting || !mTasks)
+		return !mError;
+
+	// the last partial block or an empty block to create a valid file
+	if (!mTasks[mTaskIdx].mInput.empty() || 0 == mPosition)
+		submitBlock();
+
+	// remaining blocks in order
+	for (uint32 i = 0; i < mTaskCount; ++i)
+	{
+		BlockTask &task = mTasks[(mTaskIdx + i) % mTaskCount];
+		if (!task.mQueued)
+			continue;
+
+		task.waitUntilFinished();
+		completeBlock(task);
+	}
+
+	mWriting = false;
+	if (0 != fflush(mFile))
+		mError = true;
+	return !mError;
+}
+
+bool CompressedStream::indexNextBlock()
+{
+	if (!mIndexed)
+		return false;
+
+	// the header of the block behind the last known one
+	BlockEntry entry;
+	entry.mCompressedOffset = 0;
+	entry.mOffset = 0;
+	if (!mBlocks.empty())
+	{
+		entry.mCompressedOffset = mBlocks.back().mCompressedOffset + mBlocks.back().mCompressedSize;
+		entry.mOffset = mBlocks.back().mOffset + mBlocks.back().mSize;
+	}
+
+	uint8 header[GZIP_HEADER_SIZE];
+	const uint32 headerSize = (FORMAT_GZIP == mFormat ? GZIP_HEADER_SIZE : ZSTD_HEADER_SIZE);
+	const bool read = (seekFile(mFile, entry.mCompressedOffset) && headerSize == fread(header, 1, headerSize, mFile));
+
+	// continue streaming where it was
+	if (!seekFile(mFile, mCompressedPosition))
+		mError = true;
+	if (!read)
+		return false;
+
+	if (FORMAT_GZIP == mFormat)
+	{
+		if (0 != memcmp(header, GZIP_HEADER, sizeof(GZIP_HEADER)))
+			mIndexed = false;
+		entry.mSize = readLittleEndian32(header + 16);
+		entry.mCompressedSize = readLittleEndian32(header + 20);
+	}
+	else
+	{
+		if (ZSTD_BLOCK_MAGIC != readLittleEndian32(header) || 8 != readLittleEndian32(header + 4))
+			mIndexed = false;
+		entry.mSize = readLittleEndian32(header + 8);
+		entry.mCompressedSize = ZSTD_HEADER_SIZE + readLittleEndian32(header + 12);
+	}
+
+	// blocks of other writers, e.g., appended by gzip, end the index
+	if (!mIndexed || 0 == entry.mCompressedSize)
+	{
+		mIndexed = false;
+		return false;
+	}
+
+	mBlocks.push_back(entry);
+	return true;
+}
+
+bool CompressedStream::moveTo(const uint64 position)
+{
+	// find the closest known block start in front of position
+	while (mIndexed && (mBlocks.empty() || position >= mBlocks.back().mOffset + mBlocks.back().mSize))
+		if (!indexNextBlock())
+			break;
+
+	BlockEntry start;
+	start.mCompressedOffset = 0;
+	start.mOffset = 0;
+	for (size_t left = 0, right = mBlocks.size(); left < right; )
+	{
+		const size_t middle = (left + right) / 2;
+		if (mBlocks[middle].mOffset <= position)
+		{
+			start = mBlocks[middle];
+			left = middle + 1;
+		}
+		else
+		{
+			right = middle;
+		}
+	}
+
+	// restart decompression if continuing from the current position is not closer
+	if (position < mPosition || start.mOffset > mPosition)
+		if (!restartAt(start.mCompressedOffset, start.mOffset))
+			return false;
+
+	// decompress & discard the bytes in front of position
+	uint8 skipped[SKIP_BUFFER_SIZE];
+	while (mPosition < position)
+	{
+		const int64 skippedCount = read(skipped, min<uint64>(SKIP_BUFFER_SIZE, position - mPosition));
+		if (skippedCount < 0)
+			return false;
+		if (0 == skippedCount)
+			break;
+	}
+
+	return true;
+}
+
+int64 CompressedStream::read(uint8 *target, const uint64 size)
+{
+	if (mWriting || mError)
+		return -1;
+
+	uint64 producedCount = 0;
+	while (producedCount < size && !mEndOfStream)
+	{
+		// more compressed bytes
+		if (mInputStart == mInputEnd && !refillInput())
+		{
+			if (mError)
+				return -1;
+
+			mEndOfStream = true;
+			break;
+		}
+
+		const uint32 availableCount = mInputEnd - mInputStart;
+		const uint32 requestedCount = (uint32) min<uint64>(size - producedCount, 1u << 30);
+		uint32 consumedCount = 0;
+		uint32 decompressedCount = 0;
+		bool frameEnd = false;
+
+		if (FORMAT_GZIP == mFormat)
+		{
+			z_stream *inflater = static_cast<z_stream *>(mDecoder);
+			inflater->next_in = mInput.data() + mInputStart;
+			inflater->avail_in = availableCount;
+			inflater->next_out = target + producedCount;
+			inflater->avail_out = requestedCount;
+
+			const int result = inflate(inflater, Z_NO_FLUSH);
+			if (Z_OK != result && Z_STREAM_END != result && Z_BUF_ERROR != result)
+			{
+				mError = true;
+				return -1;
+			}
+
+			consumedCount = availableCount - inflater->avail_in;
+			decompressedCount = requestedCount - inflater->avail_out;
+			frameEnd = (Z_STREAM_END == result);
+			if (frameEnd)
+				inflateReset(inflater);
+		}
+		#ifdef ZSTD
+			else
+			{
+				ZSTD_inBuffer input = { mInput.data() + mInputStart, availableCount, 0 };
+				ZSTD_outBuffer output = { target + producedCount, requestedCount, 0 };
+
+				const size_t result = ZSTD_decompressStream(static_cast<ZSTD_DStream *>(mDecoder), &output, &input);
+				if (ZSTD_isError(result))
+				{
+					mError = true;
+					return -1;
+				}
+
+				consumedCount = (uint32) input.pos;
+				decompressedCount = (uint32) output.pos;
+				frameEnd = (0 == result);
+			}
+		#endif // ZSTD
+
+		mInputStart += consumedCount;
+		mPosition += decompressedCount;
+		producedCount += decompressedCount;
+
+		// only further gzip members are decompressed, trailing zeros etc. are ignored like gzip does
+		if (frameEnd && FORMAT_GZIP == mFormat)
+		{
+			if (mInputStart == mInputEnd && !refillInput())
+			{
+				if (mError)
+					return -1;
+
+				mEndOfStream = true;
+			}
+			else if (0x1f != mInput[mInputStart])
+			{
+				mEndOfStream = true;
+			}
+		}
+		else if (frameEnd && mInputStart == mInputEnd && !refillInput())
+		{
+			if (mError)
+				return -1;
+			mEndOfStream = true;
+		}
+		else if (!frameEnd && 0 == consumedCount && 0 == decompressedCount && mInputStart != mInputEnd)
+		{
+			// no progress with input & output space left means corrupt data
+			mError = true;
+			return -1;
+		}
+	}
+
+	return (int64) producedCount;
+}
+
+bool CompressedStream::refillInput()
+{
+	if (mInputStart < mInputEnd)
+		return true;
+
+	const size_t readCount = fread(mInput.data(), sizeof(uint8), INPUT_BUFFER_SIZE, mFile);
+	if (0 == readCount && ferror(mFile))
+		mError = true;
+
+	mCompressedPosition += readCount;
+	mInputStart = 0;
+	mInputEnd = (uint32) readCount;
+	return (readCount > 0);
+}
+
+bool CompressedStream::restartAt(const uint64 compressedOffset, const uint64 offset)
+{
+	if (!seekFile(mFile, compressedOffset))
+	{
+		mError = true;
+		return false;
+	}
+
+	mCompressedPosition = compressedOffset;
+	mInputStart = 0;
+	mInputEnd = 0;
+	mPosition = offset;
+	mEndOfStream = false;
+
+	if (FORMAT_GZIP == mFormat)
+		return (Z_OK == inflateReset(static_cast<z_stream *>(mDecoder)));
+
+	#ifdef ZSTD
+		return !ZSTD_isError(ZSTD_DCtx_reset(static_cast<ZSTD_DStream *>(mDecoder), ZSTD_reset_session_only));
+	#else
+		return false;
+	#endif // ZSTD
+}
+
+bool CompressedStream::seek(int64 &offset, const int whence)
+{
+	// written files are only appended to
+	if (mWriting)
+	{
+		if (SEEK_CUR != whence || 0 != offset)
+			return false;
+
+		offset = (int64) mPosition;
+		return true;
+	}
+
+	int64 position = offset;
+	if (SEEK_CUR == whence)
+	{
+		position += (int64) mPosition;
+	}
+	else if (SEEK_END == whence)
+	{
+		// requires the complete size
+		if (!moveTo((uint64) -1))
+			return false;
+		position += (int64) mPosition;
+	}
+
+	if (position < 0 || !moveTo((uint64) position))
+		return false;
+
+	offset = (int64) mPosition;
+	return true;
+}
+
+bool CompressedStream::submitBlock()
+{
+	// compress the current block
+	BlockTask &task = mTasks[mTaskIdx];
+	task.mQueued = true;
+	if (mUseTasks)
+	{
+		task.redo();
+		Manager::getSingleton().enqueue(&task);
+	}
+	else
+	{
+		task.function();
+		completeBlock(task);
+	}
+
+	// the oldest block is written to free its task for the next block
+	mTaskIdx = (mTaskIdx + 1) % mTaskCount;
+	BlockTask &next = mTasks[mTaskIdx];
+	if (next.mQueued)
+	{
+		next.waitUntilFinished();
+		completeBlock(next);
+	}
+
+	next.mInput.clear();
+	return !mError;
+}
+
+int64 CompressedStream::write(const uint8 *data, uint64 size)
+{
+	if (!mWriting || mError)
+		return -1;
+
+	const int64 writtenCount = (int64) size;
+	while (size > 0)
+	{
+		vector<uint8> &block = mTasks[mTaskIdx].mInput;
+		if (block.capacity() < BLOCK_SIZE)
+			block.reserve(BLOCK_SIZE);
+
+		const uint64 copiedCount = min<uint64>(BLOCK_SIZE - block.size(), size);
+		block.insert(block.end(), data, data + copiedCount);
+		data += copiedCount;
+		size -= copiedCount;
+		mPosition += copiedCount;
+
+		if (BLOCK_SIZE == block.size() && !submitBlock())
+			return -1;
+	}
+
+	return writtenCount;
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _STORAGE_COMPRESSED_STREAM_H_
+#define _STORAGE_COMPRESSED_STREAM_H_
+
+#include <cassert>
+#include <cstdio>
+#include <vector>
+#include "Platform/DataTypes.h"
+#include "Platform/Multithreading/Task.h"
+#include "Platform/Storage/File.h"
+#include "Platform/Storage/Path.h"
+
+namespace Storage
+{
+	/// Compresses or decompresses a file on the fly behind a stdio file handle, see File::Compression.
+	/** Written data is split into blocks of BLOCK_SIZE bytes which are compressed independently and in parallel by tasks of the
+		Platform::Multithreading::Manager if it is running. Each block is stored as a complete gzip member or zstd frame,
+		so the files can be read by the usual gzip and zstd tools. Every block is preceded by its compressed and uncompressed size,
+		stored in an extra field of the gzip member header or in a zstd skippable frame.
+		When reading, these sizes are used to jump to the block containing a requested position instead of decompressing all data in front of it.
+		Other gzip, zlib or zstd files are decompressed as a stream and seeking backwards restarts decompression at the file start.
+		The handle is created with fopencookie and thus only available with the GNU C library. */
+	class CompressedStream
+	{
+	public:
+		/** Checks whether files can be compressed with a particular format on this system.
+		@param compression Set this to the requested compression.
+		@return Returns true if File can read and write files with the compression. COMPRESSION_ZSTD requires a build with ZSTD. */
+		static bool isSupported(const File::Compression compression);
+
+		/** Opens a compressed file and provides its uncompressed content via a stdio file handle which owns the stream.
+		@param fileName Identifies the compressed file.
+		@param mode Set this to OPEN_READING, OPEN_READING_MAPPED, CREATE_WRITING or APPEND_WRITING.
+		@param compression Set this to the compression of written files. Reading detects the compression of the file content.
+		@return Returns a handle which must be closed with fclose to write the last block and to close the file.
+		@throws FileAccessException Is thrown if the file cannot be opened or if the mode or compression is not supported.
+		@throws FileCorruptionException Is thrown if a read file is not compressed with a supported format. */
+		static FILE *open(const Path &fileName, const File::FileMode mode, const File::Compression compression);
+
+	public:
+		/** Closes the compressed file without writing pending blocks, see finish(). */
+		~CompressedStream();
+
+		/** Writes all pending blocks of a written file. Called when the stdio handle is closed.
+		@return Returns false if a block could not be compressed or written. */
+		bool finish();
+
+		/** Decompresses the next bytes of a read file.
+		@param target Set this to the memory which is filled with uncompressed bytes.
+		@param size Set this to the number of requested bytes.
+		@return Returns the number of decompressed bytes which is only smaller than size at the file end or -1 if the file is corrupt. */
+		int64 read(uint8 *target, const uint64 size);
+
+		/** Moves the uncompressed position of a read file or queries the position of a written file.
+		@param offset Set this to the offset relative to whence. Is set to the new position relative to the uncompressed file start.
+		@param whence Set this to SEEK_SET, SEEK_CUR or SEEK_END. Written files only support querying via SEEK_CUR and offset 0.
+		@return Returns false if the position could not be changed. Positions behind the file end are clamped to the uncompressed file size. */
+		bool seek(int64 &offset, const int whence);
+
+		/** Appends bytes to the uncompressed content of a written file and compresses full blocks.
+		@param data Set this to the written bytes.
+		@param size Set this to the number of bytes at data.
+		@return Returns size or -1 if a block could not be compressed or written. */
+		int64 write(const uint8 *data, uint64 size);
+
+	public:
+		static const uint32 BLOCK_SIZE = 1u << 20;			/// Number of uncompressed bytes per independently compressed block.
+		static const int32 GZIP_LEVEL = 6;					/// zlib compression level of gzip blocks.
+		static const uint32 INPUT_BUFFER_SIZE = 1u << 18;	/// Number of compressed bytes which are read at once.
+		static const int32 ZSTD_LEVEL = 3;					/// zstd compression level.
+
+	private:
+		/// Detected format of a read file.
+		enum FORMAT
+		{
+			FORMAT_GZIP,	/// gzip members or a zlib stream.
+			FORMAT_ZSTD,	/// zstd frames.
+			FORMAT_COUNT	/// Number of formats.
+		};
+
+		/// Position of a block within a file which was written by a CompressedStream.
+		struct BlockEntry
+		{
+			uint64 mCompressedOffset;	/// Offset of the block in the compressed file.
+			uint64 mOffset;				/// Offset of the first uncompressed byte of the block.
+			uint32 mCompressedSize;		/// Number of bytes of the block in the compressed file including its header.
+			uint32 mSize;				/// Number of uncompressed bytes of the block.
+		};
+
+		/// Compresses a single block, possibly on a worker thread.
+		class BlockTask : public Platform::Multithreading::Task
+		{
+		public:
+			BlockTask();
+			~BlockTask();
+
+			/** Compresses mInput into mOutput. */
+			virtual void function();
+
+		public:
+			std::vector<uint8>	mInput;			/// Uncompressed block bytes.
+			std::vector<uint8>	mOutput;		/// Compressed block including its size header or empty if compression failed.
+			void				*mContext;		/// Reused z_stream or ZSTD_CCtx for compression or NULL.
+			File::Compression	mCompression;	/// Format of mOutput.
+			bool				mQueued;		/// Is true if the task was enqueued and its output was not written so far.
+
+		private:
+			/** Copy constructor is forbidden.
+			@param copy Copy constructor is forbidden. */
+			BlockTask(const BlockTask &copy) : Task() { assert(false); }
+		};
+
+	private:
+		/** Creates a stream for an opened file.
+		@param file Set this to the compressed file which is owned by the stream from now on.
+		@param writing Set this to true to compress written data or false to decompress read data.
+		@param compression Set this to the compression of written data. */
+		CompressedStream(FILE *file, const bool writing, const File::Compression compression);
+
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		CompressedStream(const CompressedStream &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		CompressedStream &operator =(const CompressedStream &rhs) { assert(false); return *this; }
+
+		/** Writes the compressed output of a finished block task to the file.
+		@param task Set this to the finished task.
+		@return Returns false if the block could not be compressed or written. */
+		bool completeBlock(BlockTask &task);
+
+		/** Detects the format of the read file by its first bytes.
+		@return Returns false if the file is neither gzip, zlib nor zstd compressed. */
+		bool detectFormat();
+
+		/** Extends mBlocks by the following block headers of a file written by a CompressedStream.
+		@return Returns false if there is no next block header, e.g., at the file end or if the file was not written by a CompressedStream. */
+		bool indexNextBlock();
+
+		/** Moves the decompression to an uncompressed position.
+		@param position Set this to the requested offset from the uncompressed file start.
+		@return Returns false if the file is corrupt. The position is clamped to the uncompressed file size. */
+		bool moveTo(const uint64 position);
+
+		/** Reads compressed bytes into mInput if all of them were consumed.
+		@return Returns false if there are no bytes left or if reading failed. */
+		bool refillInput();
+
+		/** Restarts decompression at a compressed file offset.
+		@param compressedOffset Set this to the start of a gzip member or zstd frame.
+		@param offset Set this to the uncompressed position at compressedOffset.
+		@return Returns false if the file could not be repositioned. */
+		bool restartAt(const uint64 compressedOffset, const uint64 offset);
+
+		/** Passes the current block to a block task and writes the oldest block if all tasks are busy.
+		@return Returns false if a block could not be compressed or written. */
+		bool submitBlock();
+
+	private:
+		std::vector<BlockEntry>	mBlocks;			/// Known blocks of a read file written by a CompressedStream.
+		std::vector<uint8>		mInput;				/// Compressed bytes read from mFile.
+		BlockTask				*mTasks;			/// Ring of block tasks for writing, mTasks[mTaskIdx] collects the current block.
+		FILE					*mFile;				/// Compressed file.
+		void					*mDecoder;			/// z_stream or ZSTD_DStream for reading.
+		uint64					mPosition;			/// Number of uncompressed bytes in front of the next read or written byte.
+		uint64					mCompressedPosition;/// Offset of mInput[mInputEnd] in the compressed file.
+		uint32					mInputStart;		/// Index of the first unconsumed byte in mInput.
+		uint32					mInputEnd;			/// Number of valid bytes in mInput.
+		uint32					mTaskCount;			/// Number of block tasks in mTasks.
+		uint32					mTaskIdx;			/// Task which collects the current block.
+		File::Compression		mCompression;		/// Compression of written blocks.
+		FORMAT					mFormat;			/// Format of a read file.
+		bool					mEndOfStream;		/// Is true if all content of a read file was decompressed.
+		bool					mError;				/// Is true if compression, decompression or file access failed.
+		bool					mIndexed;			/// Is true if mBlocks can be extended, i.e., the read file was written by a CompressedStream.
+		bool					mUseTasks;			/// Is true if blocks are compressed by tasks of the Manager.
+		bool					mWriting;			/// Is true if the stream compresses.
+	};
+}
+
+#endif // _STORAGE_COMPRESSED_STREAM_H_
@@ -15,8 +15,10 @@
 #endif // _WINDOWS
 
 #include <cassert>
+#include <mutex>
 #include "Platform/FailureHandling/DirectoryAccessException.h"
 #include "Platform/Storage/Directory.h"
+#include "Platform/Storage/DirectoryWalker.h"
 #include "Platform/Utilities/HelperFunctions.h"
 
 using namespace FailureHandling;
@@ -144,34 +146,16 @@ void Directory::findChildren(vector<string> &children, const Path &path, const s
 }
 
 void Directory::findDescendants(vector<Path> &descendants, const Path &root, const string &ending)
-{	
-	// find direct children
-	vector<string> children;
-	Directory::findChildren(children, root);
-	const uint32 childCount = (uint32) children.size();
-	
-	// for all direct children: add fitting files & go through folders
-	for (uint32 childIdx = 0; childIdx < childCount; ++childIdx)
+{
+	// collect the files the parallel walker finds
+	mutex descendantsMutex;
+	const DirectoryWalker::FileCallback addDescendant = [&descendants, &descendantsMutex] (const Path &filePath)
 	{
-		const string &childName = children[childIdx];
-		
-		// next directory to search through?
-		Path childFolder(root);
-		childFolder.appendChild(childName);
-		if (Directory::exists(childFolder))
-		{
-			Directory::findDescendants(descendants, childFolder, ending);
-			continue;
-		}
-		
-		// file but wrong ending?
-		if (!Utilities::hasEnding(childName, ending))
-			continue;
-		
-		// add wanted file
-		Path filePath(root);
-		filePath.appendChild(childName);
-		descendants.push_back(filePath);			
-	}
-}
+		unique_lock<mutex> uniqueLock(descendantsMutex);
+		descendants.push_back(filePath);
+	};
 
+	const vector<string> endings(ending.empty() ? 0 : 1, ending);
+	DirectoryWalker walker(addDescendant, endings);
+	walker.walk(root);
+}
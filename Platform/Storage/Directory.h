@@ -27,6 +27,12 @@ namespace Storage
 
 		static void findChildren(std::vector<std::string> &children,
 			const Path &path, const std::string &ending = "");
+
+		/** Finds all files below a directory in parallel via DirectoryWalker, see DirectoryWalker::walk() for callers which process files while walking.
+		@param descendants Found files are appended to this vector in no particular order.
+		@param root Set this to the directory which is searched recursively.
+		@param ending Set this to the ending of wanted files or leave it empty to find all files.
+		@throws DirectoryAccessException Is thrown if root or one of its descendant directories could not be listed. */
 		static void findDescendants(std::vector<Path> &descendants, const Path &root, const std::string &ending = "");
 
 	private:
@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+
+#ifdef _LINUX
+	#include <cerrno>
+	#include <dirent.h>
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif // _LINUX
+
+#include <cstring>
+#include <memory>
+#include "Platform/FailureHandling/DirectoryAccessException.h"
+#include "Platform/Multithreading/Manager.h"
+#include "Platform/Storage/Directory.h"
+#include "Platform/Storage/DirectoryWalker.h"
+
+using namespace FailureHandling;
+using namespace Platform::Multithreading;
+using namespace std;
+using namespace Storage;
+
+#ifdef _LINUX
+	namespace
+	{
+		/// Entry layout of the getdents64 system call which is not declared by the C library headers.
+		struct DirectoryEntry64
+		{
+			uint64	mInode;			/// Inode number of the entry.
+			int64	mNextOffset;	/// Directory offset of the next entry.
+			uint16	mRecordLength;	/// Size of this entry including its name and padding.
+			uint8	mType;			/// DT_DIR, DT_REG, DT_LNK, DT_UNKNOWN etc.
+			char	mName[1];		/// Zero terminated entry name.
+		};
+
+		/// Size of the buffer which is filled by each getdents64 call, i.e., several hundred entries per call.
+		const uint32 ENTRIES_BUFFER_SIZE = 1u << 15;
+
+		/** Checks whether a directory entry is "." or "..".
+		@param name Set this to the zero terminated entry name.
+		@return Returns true if name refers to the directory itself or its parent. */
+		inline bool isFakeEntry(const char *name)
+		{
+			return ('.' == name[0] && ('\0' == name[1] || ('.' == name[1] && '\0' == name[2])));
+		}
+	}
+#endif // _LINUX
+
+void DirectoryWalker::HelperTask::function()
+{
+	mWalker->processDirectories();
+}
+
+DirectoryWalker::DirectoryWalker(const FileCallback &callback, const vector<string> &endings) :
+	mEndings(endings), mCallback(callback), mDirectoryCount(0), mFileCount(0), mErrorCode(0), mListingCount(0)
+{
+
+}
+
+bool DirectoryWalker::hasWantedEnding(const char *name, const size_t length) const
+{
+	if (mEndings.empty())
+		return true;
+
+	for (size_t endingIdx = 0; endingIdx < mEndings.size(); ++endingIdx)
+	{
+		const string &ending = mEndings[endingIdx];
+		if (length >= ending.size() && 0 == memcmp(name + length - ending.size(), ending.data(), ending.size()))
+			return true;
+	}
+
+	return false;
+}
+
+int32 DirectoryWalker::listDirectory(vector<Subdirectory> &subdirectories, DirectoryID &id, const string &directory)
+{
+	#ifdef _LINUX
+		const int descriptor = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (-1 == descriptor)
+			return errno;
+
+		struct stat directoryStatus;
+		if (0 == fstat(descriptor, &directoryStatus))
+			id = DirectoryID((uint64) directoryStatus.st_dev, (uint64) directoryStatus.st_ino);
+
+		// each call returns as many entries as fit into the buffer
+		unique_ptr<uint64[]> buffer(new uint64[ENTRIES_BUFFER_SIZE / sizeof(uint64)]);
+		int32 errorCode = 0;
+
+		while (true)
+		{
+			const long bufferFill = syscall(SYS_getdents64, descriptor, buffer.get(), ENTRIES_BUFFER_SIZE);
+			if (0 == bufferFill)
+				break;
+			if (bufferFill < 0)
+			{
+				if (EINTR == errno)
+					continue;
+
+				errorCode = errno;
+				break;
+			}
+
+			for (long offset = 0; offset < bufferFill; )
+			{
+				const DirectoryEntry64 *entry = reinterpret_cast<const DirectoryEntry64 *>(reinterpret_cast<const uint8 *>(buffer.get()) + offset);
+				offset += entry->mRecordLength;
+
+				const char *name = entry->mName;
+				if (isFakeEntry(name))
+					continue;
+
+				// only links & entries of file systems without types require stat
+				struct stat status;
+				bool isDirectory = (DT_DIR == entry->mType);
+				const bool stated = (DT_LNK == entry->mType || DT_UNKNOWN == entry->mType);
+				if (stated)
+					isDirectory = (0 == fstatat(descriptor, name, &status, 0) && S_ISDIR(status.st_mode));
+
+				const size_t length = strlen(name);
+				if (!isDirectory)
+				{
+					reportFile(directory, name, length);
+					continue;
+				}
+
+				subdirectories.push_back(Subdirectory());
+				Subdirectory &subdirectory = subdirectories.back();
+				subdirectory.mPath.reserve(directory.size() + 1 + length);
+				subdirectory.mPath += directory;
+				subdirectory.mPath += '/';
+				subdirectory.mPath.append(name, length);
+				subdirectory.mLinked = (DT_LNK == entry->mType);
+				if (stated)
+					subdirectory.mTarget = DirectoryID((uint64) status.st_dev, (uint64) status.st_ino);
+			}
+		}
+
+		close(descriptor);
+		return errorCode;
+	#else
+		// portable but slower with a stat call per entry
+		vector<string> children;
+		try
+		{
+			Directory::findChildren(children, directory);
+		}
+		catch (DirectoryAccessException &exception)
+		{
+			return (0 != exception.getErrorCode() ? exception.getErrorCode() : -1);
+		}
+
+		for (size_t childIdx = 0; childIdx < children.size(); ++childIdx)
+		{
+			const string &child = children[childIdx];
+			if ("." == child || ".." == child)
+				continue;
+
+			Subdirectory subdirectory;
+			subdirectory.mPath = directory + '/' + child;
+			subdirectory.mLinked = false;
+
+			if (Directory::exists(subdirectory.mPath))
+				subdirectories.push_back(subdirectory);
+			else
+				reportFile(directory, child.c_str(), child.size());
+		}
+
+		return 0;
+	#endif // _LINUX
+}
+
+void DirectoryWalker::processDirectories()
+{
+	vector<Subdirectory> subdirectories;
+	PendingDirectory directory;
+
+	unique_lock<mutex> uniqueLock(mMutex);
+	while (true)
+	{
+		// wait for directories as long as other threads might still find some
+		if (mPending.empty())
+		{
+			if (0 == mListingCount)
+				break;
+
+			mCondition.wait(uniqueLock);
+			continue;
+		}
+
+		directory.mPath.swap(mPending.back().mPath);
+		directory.mParent.swap(mPending.back().mParent);
+		mPending.pop_back();
+		++mListingCount;
+		uniqueLock.unlock();
+
+		// list it without blocking the other threads
+		shared_ptr<ListedDirectory> listed(new ListedDirectory());
+		listed->mID = DirectoryID(0, 0);
+		listed->mParent.swap(directory.mParent);
+
+		subdirectories.clear();
+		const int32 errorCode = listDirectory(subdirectories, listed->mID, directory.mPath);
+		++mDirectoryCount;
+
+		// links to directories on the way from root are cycles
+		for (size_t subdirectoryIdx = 0; subdirectoryIdx < subdirectories.size(); ++subdirectoryIdx)
+		{
+			Subdirectory &subdirectory = subdirectories[subdirectoryIdx];
+			if (!subdirectory.mLinked)
+				continue;
+
+			for (const ListedDirectory *ancestor = listed.get(); ancestor; ancestor = ancestor->mParent.get())
+			{
+				if (ancestor->mID != subdirectory.mTarget)
+					continue;
+
+				subdirectory.mPath.clear();
+				break;
+			}
+		}
+
+		uniqueLock.lock();
+		--mListingCount;
+
+		if (0 != errorCode && 0 == mErrorCode)
+		{
+			mErrorCode = errorCode;
+			mFailedDirectory = directory.mPath;
+		}
+
+		const size_t oldPendingCount = mPending.size();
+		for (size_t subdirectoryIdx = 0; subdirectoryIdx < subdirectories.size(); ++subdirectoryIdx)
+		{
+			Subdirectory &subdirectory = subdirectories[subdirectoryIdx];
+			if (subdirectory.mPath.empty())
+				continue;
+
+			mPending.push_back(PendingDirectory());
+			mPending.back().mPath.swap(subdirectory.mPath);
+			mPending.back().mParent = listed;
+		}
+
+		// wake up waiting threads for new directories or the end of the walk
+		if (oldPendingCount != mPending.size() || (0 == mListingCount && mPending.empty()))
+			mCondition.notify_all();
+	}
+}
+
+void DirectoryWalker::reportFile(const string &directory, const char *name, const size_t length)
+{
+	if (!hasWantedEnding(name, length))
+		return;
+
+	string filePath;
+	filePath.reserve(directory.size() + 1 + length);
+	filePath += directory;
+	filePath += '/';
+	filePath.append(name, length);
+
+	++mFileCount;
+	mCallback(Path(filePath));
+}
+
+void DirectoryWalker::walk(const Path &root)
+{
+	// start with root only
+	mPending.assign(1, PendingDirectory());
+	mPending.back().mPath = root.getString();
+	mFailedDirectory.clear();
+	mDirectoryCount = 0;
+	mFileCount = 0;
+	mErrorCode = 0;
+	mListingCount = 0;
+
+	// helpers on the task manager if it is available & if waiting for them cannot block it
+	uint32 helperCount = 0;
+	if (Manager::exists() && Manager::getSingleton().isRunning() && !Manager::isWorkerThread())
+		helperCount = Manager::getSingleton().getThreadCount();
+	if (helperCount > MAX_HELPER_COUNT)
+		helperCount = MAX_HELPER_COUNT;
+
+	unique_ptr<HelperTask[]> helpers(new HelperTask[helperCount]);
+	for (uint32 helperIdx = 0; helperIdx < helperCount; ++helperIdx)
+	{
+		helpers[helperIdx].mWalker = this;
+		Manager::getSingleton().enqueue(&helpers[helperIdx]);
+	}
+
+	// this thread works as well & thus also finishes the walk without any helper
+	processDirectories();
+	for (uint32 helperIdx = 0; helperIdx < helperCount; ++helperIdx)
+		helpers[helperIdx].waitUntilFinished();
+
+	if (0 != mErrorCode)
+		throw DirectoryAccessException("Could not list a directory while walking a directory tree.", mFailedDirectory, mErrorCode);
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _STORAGE_DIRECTORY_WALKER_H_
+#define _STORAGE_DIRECTORY_WALKER_H_
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Platform/DataTypes.h"
+#include "Platform/Multithreading/Task.h"
+#include "Platform/Storage/Path.h"
+
+namespace Storage
+{
+	/// Finds all files below a root directory with several threads and reports each file as soon as it is found.
+	/** Directories which still need to be listed are kept in a shared stack.
+		The thread calling walk() and helper tasks on the Platform::Multithreading::Manager (if it is running) take directories from the stack,
+		list them and push found subdirectories back onto it until no directory is left.
+		On Linux, directories are listed with getdents64 and the entry types it returns, so stat is only called for symbolic links and
+		on file systems which do not report entry types. Like Directory::findDescendants(), symbolic links to directories are followed,
+		except for links to a directory which is already on the way from root to the link since they would be walked infinitely.
+		Files are filtered by their endings while walking and passed to a callback immediately, i.e., consumers can start before the walk finished. */
+	class DirectoryWalker
+	{
+	public:
+		/** Is called for each found file, possibly by several threads at the same time.
+		@param filePath Path of the found file which starts with the root path given to walk(). */
+		typedef std::function<void (const Path &filePath)> FileCallback;
+
+	public:
+		/** Prepares walking directory trees.
+		@param callback Set this to the thread safe function which is called for each found file. It must not throw exceptions.
+		@param endings Set this to the accepted file endings, e.g., ".ply", or leave it empty to report all files. */
+		DirectoryWalker(const FileCallback &callback, const std::vector<std::string> &endings = std::vector<std::string>());
+
+		/** Returns the number of directories which were listed by the last walk() call.
+		@return Returns the number of listed directories including the root. */
+		inline uint64 getDirectoryCount() const;
+
+		/** Returns the number of files which were passed to the callback by the last walk() call.
+		@return Returns the number of reported files. */
+		inline uint64 getFileCount() const;
+
+		/** Reports all files below root with matching endings and returns when all of them were reported.
+			Tasks of the Platform::Multithreading::Manager can call it as well, but then walk without helper tasks.
+		@param root Set this to the directory which is searched recursively.
+		@throws DirectoryAccessException Is thrown after all accessible directories were walked if root or one of its descendant directories could not be listed. */
+		void walk(const Path &root);
+
+	public:
+		static const uint32 MAX_HELPER_COUNT = 16;	/// Maximum number of helper tasks per walk, listing directories does not scale much further.
+
+	private:
+		/// Identifies a directory by its device and inode number.
+		typedef std::pair<uint64, uint64> DirectoryID;
+
+		/// Listed directory which is an ancestor of pending directories.
+		struct ListedDirectory
+		{
+			DirectoryID								mID;		/// Identifies the listed directory.
+			std::shared_ptr<const ListedDirectory>	mParent;	/// Directory in which the listed one was found or NULL for the root.
+		};
+
+		/// Directory which was found but not listed so far.
+		struct PendingDirectory
+		{
+			std::string								mPath;		/// Path of the directory starting with the root of the walk.
+			std::shared_ptr<const ListedDirectory>	mParent;	/// Directory in which the pending one was found or NULL for the root.
+		};
+
+		/// Directory which was found while listing its parent.
+		struct Subdirectory
+		{
+			std::string	mPath;		/// Path of the directory starting with the root of the walk.
+			DirectoryID	mTarget;	/// Identifies the directory if it was reached via a symbolic link.
+			bool		mLinked;	/// Is true if the directory was reached via a symbolic link.
+		};
+
+		/// Helper task which lists directories for the walker until there are none left.
+		class HelperTask : public Platform::Multithreading::Task
+		{
+		public:
+			HelperTask() : Task(), mWalker(NULL) { }
+			virtual void function();
+
+		public:
+			DirectoryWalker *mWalker;	/// Walker which provides the directories to list.
+		};
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		DirectoryWalker(const DirectoryWalker &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		DirectoryWalker &operator =(const DirectoryWalker &rhs) { assert(false); return *this; }
+
+		/** Checks whether a file is wanted by the caller.
+		@param name Set this to the zero terminated file name without its directory.
+		@param length Set this to the number of characters of name.
+		@return Returns true if name ends with one of mEndings or if mEndings is empty. */
+		bool hasWantedEnding(const char *name, const size_t length) const;
+
+		/** Lists a single directory, reports its wanted files and collects its subdirectories.
+		@param subdirectories Is filled with all subdirectories.
+		@param id Is set to the device & inode number of the listed directory.
+		@param directory Set this to the path of the listed directory.
+		@return Returns 0 on success or the error code of the failed system call. */
+		int32 listDirectory(std::vector<Subdirectory> &subdirectories, DirectoryID &id, const std::string &directory);
+
+		/** Lists directories of mPending until all directories of the walk were listed. */
+		void processDirectories();
+
+		/** Reports a file to the callback if it has a wanted ending.
+		@param directory Set this to the path of the directory containing the file.
+		@param name Set this to the zero terminated file name.
+		@param length Set this to the number of characters of name. */
+		void reportFile(const std::string &directory, const char *name, const size_t length);
+
+	private:
+		std::vector<std::string>		mEndings;			/// Accepted file endings or empty for all files.
+		std::vector<PendingDirectory>	mPending;			/// Stack of directories which were found but not listed so far.
+		FileCallback					mCallback;			/// Is called for each wanted file.
+		std::string						mFailedDirectory;	/// First directory which could not be listed.
+		std::condition_variable			mCondition;			/// Signals new pending directories and the end of the walk.
+		std::mutex						mMutex;				/// Protects mPending, mFailedDirectory, mErrorCode and mListingCount.
+		std::atomic<uint64>				mDirectoryCount;	/// Number of listed directories.
+		std::atomic<uint64>				mFileCount;			/// Number of reported files.
+		int32							mErrorCode;			/// Error code of listing mFailedDirectory or 0.
+		uint32							mListingCount;		/// Number of threads which are currently listing a directory.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline uint64 DirectoryWalker::getDirectoryCount() const
+	{
+		return mDirectoryCount;
+	}
+
+	inline uint64 DirectoryWalker::getFileCount() const
+	{
+		return mFileCount;
+	}
+}
+
+#endif // _STORAGE_DIRECTORY_WALKER_H_
@@ -5,13 +5,29 @@
  * This software may be modified and distributed under the terms
  * of the BSD 3-Clause license. See the License.txt file for details.
  */
+#ifdef _WINDOWS
+	#include <io.h>
+	#include <Windows.h>
+#elif _LINUX
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif // _WINDOWS
+
+#include <algorithm>
 #include <cassert>
 #include <cstdarg>
+#include <cstdlib>
+#include <cstring>
 #include "Platform/FailureHandling/FileCorruptionException.h"
 #include "Platform/FailureHandling/FileAccessException.h"
 #include "Platform/FailureHandling/FileVersionException.h"
+#include "Platform/Storage/CompressedStream.h"
 #include "Platform/Storage/File.h"
+#include "Platform/Utilities/ByteSwapping.h"
 #include "Platform/Utilities/HelperFunctions.h"
+#include "Platform/Utilities/NumberFormatting.h"
+#include "Platform/Utilities/NumberParsing.h"
 
 using namespace FailureHandling;
 using namespace Storage;
@@ -24,6 +40,81 @@ const uint32 File::INVALID_VERSION = (uint32) - 1;
 	uint32 File::sOpenFilesCount = 0;
 #endif // _DEBUG
 
+namespace
+{
+	/** Reads a character from a stream which was locked by the calling thread without locking it again.
+	@param handle Set this to the locked stream.
+	@return Returns the read character or EOF. */
+	inline int getLockedCharacter(FILE *handle)
+	{
+		#ifdef _WINDOWS
+			return _getc_nolock(handle);
+		#else
+			return getc_unlocked(handle);
+		#endif // _WINDOWS
+	}
+
+	/** Sets the position of a stdio file handle, also for files larger than 2 GiB.
+	@param handle Set this to the file which is moved.
+	@param offset Set this to the new position relative to the file start in bytes.
+	@return Returns false if the position could not be changed. */
+	bool seekFile(FILE *handle, const uint64 offset)
+	{
+		#ifdef _WINDOWS
+			return (0 == _fseeki64(handle, (__int64) offset, SEEK_SET));
+		#else
+			return (0 == fseeko(handle, (off_t) offset, SEEK_SET));
+		#endif // _WINDOWS
+	}
+
+	/** Returns the position of a stdio file handle, also for files larger than 2 GiB.
+	@param handle Set this to the queried file.
+	@return Returns the position relative to the file start in bytes. */
+	uint64 tellFile(FILE *handle)
+	{
+		#ifdef _WINDOWS
+			return (uint64) _ftelli64(handle);
+		#else
+			return (uint64) ftello(handle);
+		#endif // _WINDOWS
+	}
+}
+
+bool File::exists(const Path &fileName)
+{
+	FILE *file = openFile(fileName, "rb");
+	if (!file)
+		return false;
+
+	fclose(file);
+	return true;
+}
+
+bool File::getFileInfo(uint64 &size, int64 &modificationTime, const Path &fileName)
+{
+	#ifdef _WINDOWS
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (0 == GetFileAttributesExA(fileName.getCString(), GetFileExInfoStandard, &attributes) ||
+			0 != (FILE_ATTRIBUTE_DIRECTORY & attributes.dwFileAttributes))
+			return false;
+
+		// FILETIME counts 100 ns intervals
+		size = ((uint64) attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+		modificationTime = (int64) ((((uint64) attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime) * 100);
+		return true;
+	#elif _LINUX
+		struct stat status;
+		if (0 != stat(fileName.getCString(), &status) || !S_ISREG(status.st_mode))
+			return false;
+
+		size = (uint64) status.st_size;
+		modificationTime = (int64) status.st_mtim.tv_sec * 1000000000 + (int64) status.st_mtim.tv_nsec;
+		return true;
+	#else
+		return false;
+	#endif // _WINDOWS
+}
+
 void File::loadTextFile(string &fileContent, const Path &fileName)
 {
 	char buffer[File::READING_BUFFER_SIZE];
@@ -37,7 +128,7 @@ void File::loadTextFile(string &fileContent, const Path &fileName)
 }
 
 File::File(const Path &fileName, const File::FileMode mode, const bool binaryFile, const uint32 fileVersion) :
-	mName(fileName)
+	mName(fileName), mData(NULL), mMapping(NULL), mMappingSize(0), mPosition(0), mSize(0), mEndOfFileReached(false)
 {
 	assert(!fileName.getString().empty());
 	FILE *file = NULL;
@@ -81,10 +172,29 @@ File::File(const Path &fileName, const File::FileMode mode, const bool binaryFil
 			break;
 		}
 
+		case OPEN_READING_MAPPED:
+		{
+			// the mapping contains the raw file bytes
+			file = openFile(fileName, "rb");
+			break;
+		}
+
 		default:
 			assert(false);
 	}
 
+	initialize(file, mode, binaryFile, COMPRESSION_NONE, fileVersion);
+}
+
+File::File(const Path &fileName, const File::FileMode mode, const Compression compression, const uint32 fileVersion) :
+	mName(fileName), mData(NULL), mMapping(NULL), mMappingSize(0), mPosition(0), mSize(0), mEndOfFileReached(false)
+{
+	assert(!fileName.getString().empty());
+	initialize(CompressedStream::open(fileName, mode, compression), mode, true, compression, fileVersion);
+}
+
+void File::initialize(FILE *file, const FileMode mode, const bool binaryFile, const Compression compression, const uint32 fileVersion)
+{
 	// error checking
 	const char *text = "Could not open, create or modify a file.";
 	if (NULL == file)
@@ -104,12 +214,15 @@ File::File(const Path &fileName, const File::FileMode mode, const bool binaryFil
 		++sOpenFilesCount;
 	#endif // _DEBUG
 
+	if (OPEN_READING_MAPPED == mode)
+		map();
+
 	// Does file versioning matter?
 	if (INVALID_VERSION == fileVersion)
 		return;
 	
 	// file is opened: check expected file version
-	if (mode == OPEN_READING || mode == OPEN_READING_AND_WRITING)
+	if (mode == OPEN_READING || mode == OPEN_READING_AND_WRITING || mode == OPEN_READING_MAPPED)
 	{
 		uint32 actualFileVersion;
 		read(&actualFileVersion, sizeof(uint32), sizeof(uint32), 1);
@@ -121,7 +234,10 @@ File::File(const Path &fileName, const File::FileMode mode, const bool binaryFil
 	if (mode == APPEND_READING_AND_WRITING || mode == APPEND_WRITING)
 	{
 		// open the file at the beginning for only file version checking - see above
-		File file(fileName, OPEN_READING, binaryFile, fileVersion);
+		if (COMPRESSION_NONE == compression)
+			File file(mName, OPEN_READING, binaryFile, fileVersion);
+		else
+			File file(mName, OPEN_READING, compression, fileVersion);
 		return;
 	}
 
@@ -132,6 +248,17 @@ File::File(const Path &fileName, const File::FileMode mode, const bool binaryFil
 
 File::~File()
 {
+	if (mMapping)
+	{
+		#ifdef _WINDOWS
+			UnmapViewOfFile(mMapping);
+		#elif _LINUX
+			munmap(mMapping, mMappingSize);
+		#endif // _WINDOWS
+		mMapping = NULL;
+		mData = NULL;
+	}
+
 	int returnValue = fclose(mHandle);
 	mHandle			= NULL;
 
@@ -143,21 +270,124 @@ File::~File()
 	#endif // _DEBUG
 }
 
+void File::advise(const AccessHint hint, const uint64 offset, const uint64 size)
+{
+	#ifdef _LINUX
+		if (!mMapping || offset >= mSize)
+			return;
+
+		const int ADVICES[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED };
+		assert(hint < sizeof(ADVICES) / sizeof(ADVICES[0]));
+
+		// madvise requires a page aligned start
+		const uint64 pageSize = (uint64) sysconf(_SC_PAGESIZE);
+		const uint64 start = offset - offset % pageSize;
+		const uint64 end = ((0 == size || size > mSize - offset) ? mSize : offset + size);
+		madvise(reinterpret_cast<uint8 *>(mMapping) + start, end - start, ADVICES[hint]);
+	#endif // _LINUX
+}
+
 bool File::endOfFileReached() const
 {
+	if (mData)
+		return mEndOfFileReached;
 	return (0 != feof(mHandle));
 }
 
 bool File::errorOccured() const
 {
+	if (mData)
+		return false;
 	return (0 != ferror(mHandle));
 }
 
+void File::map()
+{
+	#ifdef _WINDOWS
+		// the zero byte behind the content requires a file end within a page
+		const HANDLE file = (HANDLE) _get_osfhandle(_fileno(mHandle));
+		LARGE_INTEGER fileSize;
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0 && 0 != fileSize.QuadPart % systemInfo.dwPageSize)
+		{
+			const HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mapping)
+			{
+				// the view keeps the mapping alive
+				void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				CloseHandle(mapping);
+
+				if (view)
+				{
+					mMapping = view;
+					mMappingSize = (uint64) fileSize.QuadPart;
+					mData = reinterpret_cast<const uint8 *>(view);
+					mSize = (uint64) fileSize.QuadPart;
+					return;
+				}
+			}
+		}
+	#elif _LINUX
+		// map regular files into a zero filled range which is at least one page larger to get a zero byte behind the content
+		const int descriptor = fileno(mHandle);
+		struct stat status;
+
+		if (0 == fstat(descriptor, &status) && S_ISREG(status.st_mode) && status.st_size > 0)
+		{
+			const uint64 pageSize = (uint64) sysconf(_SC_PAGESIZE);
+			const uint64 fileSize = (uint64) status.st_size;
+			const uint64 rangeSize = ((fileSize + pageSize - 1) / pageSize + 1) * pageSize;
+
+			void *range = mmap(NULL, rangeSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (MAP_FAILED != range)
+			{
+				if (MAP_FAILED != mmap(range, fileSize, PROT_READ, MAP_PRIVATE | MAP_FIXED, descriptor, 0))
+				{
+					mMapping = range;
+					mMappingSize = rangeSize;
+					mData = reinterpret_cast<const uint8 *>(range);
+					mSize = fileSize;
+					return;
+				}
+
+				munmap(range, rangeSize);
+			}
+		}
+	#endif // _WINDOWS
+
+	// fallback for empty files, pipes etc.: copy the content
+	read(mCopiedData, COPY_CHUNK_SIZE);
+	mSize = mCopiedData.size();
+	mCopiedData.push_back(0);
+	mData = mCopiedData.data();
+}
+
+uint64 File::getPosition() const
+{
+	if (mData)
+		return mPosition;
+	return tellFile(mHandle);
+}
+
 bool File::hasLeftData() const
 {
 	return !errorOccured() && !endOfFileReached();
 }
 
+bool File::setPosition(const uint64 position)
+{
+	if (mData)
+	{
+		mPosition = std::min(position, mSize);
+		mEndOfFileReached = false;
+		return true;
+	}
+
+	return seekFile(mHandle, position);
+}
+
 FILE *File::openFile(const Path &fileName, const char *mode)
 {
 	#ifdef _WINDOWS
@@ -171,6 +401,29 @@ FILE *File::openFile(const Path &fileName, const char *mode)
 
 uint32 File::read(void *buffer, const uint64 bufferSize, const uint32 elementSize, uint64 elementCount)
 {
+	if (mData)
+	{
+		// copy complete elements like fread
+		if (0 == elementSize)
+			return 0;
+		if (bufferSize < elementSize * elementCount)
+			elementCount = bufferSize / elementSize;
+
+		const uint64 leftCount = (mSize - mPosition) / elementSize;
+		const uint64 copiedCount = std::min(elementCount, leftCount);
+		memcpy(buffer, mData + mPosition, copiedCount * elementSize);
+		mPosition += copiedCount * elementSize;
+
+		// partial elements are consumed
+		if (copiedCount < elementCount)
+		{
+			mPosition = mSize;
+			mEndOfFileReached = true;
+		}
+
+		return (uint32) copiedCount;
+	}
+
 	#ifdef _WINDOWS
 		return (uint32) fread_s(buffer, bufferSize, elementSize, elementCount, mHandle);
 	#else
@@ -188,6 +441,15 @@ uint32 File::read(void *buffer, const uint64 bufferSize, const uint32 elementSiz
 
 uint64 File::read(vector<uint8> &target, const uint32 chunkSize)
 {
+	if (mData)
+	{
+		const uint64 readBytes = mSize - mPosition;
+		target.insert(target.end(), mData + mPosition, mData + mSize);
+		mPosition = mSize;
+		mEndOfFileReached = true;
+		return readBytes;
+	}
+
 	uint64 readBytes = 0;
 	while (hasLeftData())
 	{
@@ -200,6 +462,38 @@ uint64 File::read(vector<uint8> &target, const uint32 chunkSize)
 }
 
 
+uint64 File::readBinaryArray(void *destination, const uint32 elementSize, const uint64 count, const Encoding encoding)
+{
+	assert(ENCODING_BINARY_LITTLE_ENDIAN == encoding || ENCODING_BINARY_BIG_ENDIAN == encoding);
+	const bool swap = ((ENCODING_BINARY_BIG_ENDIAN == encoding) != isHostBigEndian());
+	uint64 readCount = count;
+
+	if (mData)
+	{
+		// convert straight from the mapped memory
+		const uint64 leftCount = (mSize - mPosition) / elementSize;
+		if (readCount > leftCount)
+		{
+			readCount = leftCount;
+			mEndOfFileReached = true;
+		}
+
+		if (swap)
+			swapBytes(destination, mData + mPosition, elementSize, readCount);
+		else
+			memcpy(destination, mData + mPosition, readCount * elementSize);
+
+		mPosition = (mEndOfFileReached ? mSize : mPosition + readCount * elementSize);
+		return readCount;
+	}
+
+	// single read call & conversion in place
+	readCount = fread(destination, elementSize, count, mHandle);
+	if (swap)
+		swapBytes(destination, destination, elementSize, readCount);
+	return readCount;
+}
+
 uint8 File::readByte(const Encoding encoding)
 {
 	uint8 data;
@@ -208,10 +502,10 @@ uint8 File::readByte(const Encoding encoding)
 	{
 		case ENCODING_ASCII:
 		{
-			uint32 temp;
-			scanf("%d", &temp);
+			int64 temp;
+			readASCIIInteger(temp);
 
-			if (temp > 255)
+			if (temp > 255 || temp < 0)
 				throw FileCorruptionException("ASCII encoded byte to be read is larger than 255", mName);
 			else
 				data = temp;
@@ -238,7 +532,7 @@ double File::readDouble(const Encoding encoding)
 	{
 		case ENCODING_ASCII:
 		{
-			scanf("%lf", &data);
+			readASCIIReal(data);
 			break;
 		}
 			
@@ -273,7 +567,7 @@ float File::readFloat(const Encoding encoding)
 	switch (encoding)
 	{
 		case ENCODING_ASCII:
-			scanf("%f", &data);
+			readASCIIReal(data);
 			break;
 			
 		case ENCODING_BINARY_LITTLE_ENDIAN:
@@ -308,8 +602,8 @@ int8 File::readInt8(const Encoding encoding)
 	{
 		case ENCODING_ASCII:
 		{
-			int32 temp;
-			scanf("%d", &temp);
+			int64 temp;
+			readASCIIInteger(temp);
 			data = (int8) temp;
 			break;
 		}
@@ -337,8 +631,12 @@ int16 File::readInt16(const Encoding encoding)
 	switch (encoding)
 	{
 		case ENCODING_ASCII:
-			scanf("%d", &data);
+		{
+			int64 temp;
+			readASCIIInteger(temp);
+			data = (int16) temp;
 			break;
+		}
 
 		case ENCODING_BINARY_BIG_ENDIAN:
 			read(&data, sizeof(int16), sizeof(int16), 1);
@@ -364,8 +662,12 @@ int32 File::readInt32(const Encoding encoding)
 	switch (encoding)
 	{
 		case ENCODING_ASCII:
-			scanf("%d", &data);
+		{
+			int64 temp;
+			readASCIIInteger(temp);
+			data = (int32) temp;
 			break;
+		}
 
 		case ENCODING_BINARY_BIG_ENDIAN:
 			read(&data, sizeof(int32), sizeof(int32), 1);
@@ -391,8 +693,12 @@ int64 File::readInt64(const Encoding encoding)
 	switch (encoding)
 	{
 		case ENCODING_ASCII:
-			scanf("%d", &data);
+		{
+			int64 temp;
+			readASCIIInteger(temp);
+			data = (int64) temp;
 			break;
+		}
 
 		case ENCODING_BINARY_BIG_ENDIAN:
 			read(&data, sizeof(int64), sizeof(int64), 1);
@@ -411,6 +717,143 @@ int64 File::readInt64(const Encoding encoding)
 	return data;
 }
 
+bool File::readASCIIInteger(int64 &value)
+{
+	value = 0;
+	if (mData)
+	{
+		// skip white space like scanf
+		while (mPosition < mSize && isWhiteSpace(mData[mPosition]))
+			++mPosition;
+		if (mPosition >= mSize)
+		{
+			mEndOfFileReached = true;
+			return false;
+		}
+
+		const char *start = reinterpret_cast<const char *>(mData + mPosition);
+		const char *end = parseInteger(value, start, reinterpret_cast<const char *>(mData + mSize));
+		mPosition += end - start;
+		return (end != start);
+	}
+
+	// parse a token instead of letting scanf interpret a format string
+	const uint32 tokenLength = readASCIIToken();
+	const char *end = parseInteger(value, mBuffer, mBuffer + tokenLength);
+	const uint32 usedLength = (uint32) (end - mBuffer);
+
+	if (usedLength != tokenLength)
+		unreadASCIIToken(tokenLength, usedLength);
+	return (0 != usedLength);
+}
+
+bool File::readASCIIReal(double &value)
+{
+	value = 0.0;
+	if (mData)
+	{
+		// skip white space like scanf
+		while (mPosition < mSize && isWhiteSpace(mData[mPosition]))
+			++mPosition;
+		if (mPosition >= mSize)
+		{
+			mEndOfFileReached = true;
+			return false;
+		}
+
+		const char *start = reinterpret_cast<const char *>(mData + mPosition);
+		const char *end = parseReal(value, start, reinterpret_cast<const char *>(mData + mSize));
+		mPosition += end - start;
+		return (end != start);
+	}
+
+	// parse a token instead of letting scanf interpret a format string
+	const uint32 tokenLength = readASCIIToken();
+	const char *end = parseReal(value, mBuffer, mBuffer + tokenLength);
+	const uint32 usedLength = (uint32) (end - mBuffer);
+
+	if (usedLength != tokenLength)
+		unreadASCIIToken(tokenLength, usedLength);
+	return (0 != usedLength);
+}
+
+bool File::readASCIIReal(float &value)
+{
+	value = 0.0f;
+	if (mData)
+	{
+		// skip white space like scanf
+		while (mPosition < mSize && isWhiteSpace(mData[mPosition]))
+			++mPosition;
+		if (mPosition >= mSize)
+		{
+			mEndOfFileReached = true;
+			return false;
+		}
+
+		const char *start = reinterpret_cast<const char *>(mData + mPosition);
+		const char *end = parseReal(value, start, reinterpret_cast<const char *>(mData + mSize));
+		mPosition += end - start;
+		return (end != start);
+	}
+
+	// parse a token instead of letting scanf interpret a format string
+	const uint32 tokenLength = readASCIIToken();
+	const char *end = parseReal(value, mBuffer, mBuffer + tokenLength);
+	const uint32 usedLength = (uint32) (end - mBuffer);
+
+	if (usedLength != tokenLength)
+		unreadASCIIToken(tokenLength, usedLength);
+	return (0 != usedLength);
+}
+
+uint32 File::readASCIIToken()
+{
+	uint32 length = 0;
+
+	// lock the stream once for all characters of the token
+	#ifdef _WINDOWS
+		_lock_file(mHandle);
+	#else
+		flockfile(mHandle);
+	#endif // _WINDOWS
+
+		// skip white space
+		int c = getLockedCharacter(mHandle);
+		while (EOF != c && isWhiteSpace((char) c))
+			c = getLockedCharacter(mHandle);
+
+		// gather the token and give back the first character behind it
+		while (EOF != c && isNumberCharacter((char) c) && length < READING_BUFFER_SIZE - 1)
+		{
+			mBuffer[length++] = (char) c;
+			c = getLockedCharacter(mHandle);
+		}
+
+		if (EOF != c)
+			ungetc(c, mHandle);
+
+	#ifdef _WINDOWS
+		_unlock_file(mHandle);
+	#else
+		funlockfile(mHandle);
+	#endif // _WINDOWS
+
+	mBuffer[length] = '\0';
+	return length;
+}
+
+void File::unreadASCIIToken(const uint32 tokenLength, const uint32 usedLength)
+{
+	// e.g., "1.5abc" -> continue at "abc" like scanf
+	assert(usedLength < tokenLength);
+	#ifdef _WINDOWS
+		_fseeki64(mHandle, -((__int64) (tokenLength - usedLength)), SEEK_CUR);
+	#else
+		fseeko(mHandle, -((off_t) (tokenLength - usedLength)), SEEK_CUR);
+	#endif // _WINDOWS
+}
+
 bool File::readString(std::string &target, const Encoding encoding)
 {
 	const uint32 numberOfCharacters = readInt32(encoding);
@@ -424,6 +867,28 @@ bool File::readString(std::string &target, const Encoding encoding)
 
 bool File::readTextLine(string &target)
 {
+	if (mData)
+	{
+		// like fgets: the line including its new line character but at most READING_BUFFER_SIZE - 1 characters
+		if (mPosition >= mSize)
+		{
+			mEndOfFileReached = true;
+			target.clear();
+			return false;
+		}
+
+		const uint8 *start = mData + mPosition;
+		const uint64 maxLength = std::min<uint64>(READING_BUFFER_SIZE - 1, mSize - mPosition);
+		const uint8 *newLine = reinterpret_cast<const uint8 *>(memchr(start, '\n', (size_t) maxLength));
+		const uint64 length = (newLine ? newLine - start + 1 : maxLength);
+
+		target.assign(reinterpret_cast<const char *>(start), (size_t) length);
+		mPosition += length;
+		if (!newLine && mPosition >= mSize)
+			mEndOfFileReached = true;
+		return true;
+	}
+
 	char *temp = fgets(mBuffer, READING_BUFFER_SIZE, mHandle);
 	target = mBuffer;
 
@@ -456,8 +921,8 @@ uint8 File::readUInt8(const Encoding encoding)
 	{
 		case ENCODING_ASCII:
 		{
-			int32 temp;
-			scanf("%d", &temp);
+			int64 temp;
+			readASCIIInteger(temp);
 			data = (uint8) temp;
 			break;
 		}
@@ -485,8 +950,12 @@ uint16 File::readUInt16(const Encoding encoding)
 	switch (encoding)
 	{
 		case ENCODING_ASCII:
-			scanf("%d", &data);
+		{
+			int64 temp;
+			readASCIIInteger(temp);
+			data = (uint16) temp;
 			break;
+		}
 
 		case ENCODING_BINARY_BIG_ENDIAN:
 			read(&data, sizeof(uint16), sizeof(uint16), 1);
@@ -512,8 +981,12 @@ uint32 File::readUInt32(const Encoding encoding)
 	switch (encoding)
 	{
 		case ENCODING_ASCII:
-			scanf("%d", &data);
+		{
+			int64 temp;
+			readASCIIInteger(temp);
+			data = (uint32) temp;
 			break;
+		}
 
 		case ENCODING_BINARY_BIG_ENDIAN:
 			read(&data, sizeof(uint32), sizeof(uint32), 1);
@@ -539,8 +1012,12 @@ uint64 File::readUInt64(const Encoding encoding)
 	switch (encoding)
 	{
 		case ENCODING_ASCII:
-			scanf("%d", &data);
+		{
+			int64 temp;
+			readASCIIInteger(temp);
+			data = (uint64) temp;
 			break;
+		}
 
 		case ENCODING_BINARY_BIG_ENDIAN:
 			read(&data, sizeof(uint64), sizeof(uint64), 1);
@@ -564,6 +1041,10 @@ int32 File::scanf(const char *format, ...)
 	int32	readArgumentsCount = 0;
 	va_list	arguments;
 
+	// let stdio parse mapped files at the reading position
+	if (mData)
+		seekFile(mHandle, mPosition);
+
 	va_start(arguments, format);
 		#ifdef _WINDOWS
 			readArgumentsCount = vfscanf_s(mHandle, format, arguments);
@@ -572,6 +1053,12 @@ int32 File::scanf(const char *format, ...)
 		#endif // _WINDOWS
 	va_end(arguments);
 
+	if (mData)
+	{
+		mPosition = tellFile(mHandle);
+		mEndOfFileReached = (0 != feof(mHandle));
+	}
+
 	return readArgumentsCount;
 }
 
@@ -591,11 +1078,23 @@ int32 File::scanfString(const char *formatBegin, const char *formatEnd, char *bu
 	#endif // _WINDOWS
 	format += formatEnd;
 
+	// let stdio parse mapped files at the reading position
+	if (mData)
+		seekFile(mHandle, mPosition);
+
 	#ifdef _WINDOWS
-		return fscanf_s(mHandle, format.c_str(), buffer, bufferSize - 1);
+		const int32 readStringsCount = fscanf_s(mHandle, format.c_str(), buffer, bufferSize - 1);
 	#else
-		return fscanf(mHandle, format.c_str(), buffer);
+		const int32 readStringsCount = fscanf(mHandle, format.c_str(), buffer);
 	#endif // _WINDOWS
+
+	if (mData)
+	{
+		mPosition = tellFile(mHandle);
+		mEndOfFileReached = (0 != feof(mHandle));
+	}
+
+	return readStringsCount;
 }
 
 uint32 File::write(const void *data, const uint32 elementSize, const uint64 elementCount)
@@ -603,6 +1102,73 @@ uint32 File::write(const void *data, const uint32 elementSize, const uint64 elem
 	return (uint32) fwrite(data, elementSize, elementCount, mHandle);
 }
 
+bool File::writeASCIIReal(const double value, const bool singlePrecision, const bool separate)
+{
+	// 9 digits or the shortest of at most 17 digits are enough to restore each float or double
+	char text[MAX_NUMBER_LENGTH + 1];
+	char *end = text;
+	if (separate)
+		*end++ = ' ';
+	end = (singlePrecision ? formatReal(end, (float) value) : formatReal(end, value));
+
+	return writeASCIIText(text, end);
+}
+
+bool File::writeASCIISigned(const int64 value, const bool separate)
+{
+	char text[MAX_NUMBER_LENGTH + 1];
+	char *end = text;
+	if (separate)
+		*end++ = ' ';
+
+	return writeASCIIText(text, formatSigned(end, value));
+}
+
+bool File::writeASCIIText(const char *start, const char *end)
+{
+	const size_t length = end - start;
+	return (length == fwrite(start, sizeof(char), length, mHandle));
+}
+
+bool File::writeASCIIUnsigned(const uint64 value, const bool separate)
+{
+	char text[MAX_NUMBER_LENGTH + 1];
+	char *end = text;
+	if (separate)
+		*end++ = ' ';
+
+	return writeASCIIText(text, formatUnsigned(end, value));
+}
+
+uint64 File::writeBinaryArray(const void *source, const uint32 elementSize, const uint64 count, const Encoding encoding)
+{
+	assert(ENCODING_BINARY_LITTLE_ENDIAN == encoding || ENCODING_BINARY_BIG_ENDIAN == encoding);
+	const bool swap = ((ENCODING_BINARY_BIG_ENDIAN == encoding) != isHostBigEndian());
+	if (!swap || 1 == elementSize)
+		return fwrite(source, elementSize, count, mHandle);
+
+	// convert & write blocks of values
+	if (mArrayBuffer.empty())
+		mArrayBuffer.resize(ARRAY_BUFFER_SIZE);
+
+	const uint8 *values = reinterpret_cast<const uint8 *>(source);
+	const uint64 blockSize = ARRAY_BUFFER_SIZE / elementSize;
+	uint64 writtenCount = 0;
+
+	while (writtenCount < count)
+	{
+		const uint64 blockCount = min(blockSize, count - writtenCount);
+		swapBytes(mArrayBuffer.data(), values + writtenCount * elementSize, elementSize, blockCount);
+
+		const uint64 blockWrittenCount = fwrite(mArrayBuffer.data(), elementSize, blockCount, mHandle);
+		writtenCount += blockWrittenCount;
+		if (blockWrittenCount != blockCount)
+			break;
+	}
+
+	return writtenCount;
+}
+
 bool File::writeReal(const Real value, const Encoding encoding)
 {
 	#ifdef DOUBLE_PRECISION
@@ -618,7 +1184,8 @@ bool File::writeDouble(const double value, const Encoding encoding)
 	{
 		case ENCODING_ASCII:
 		{
-			return (0 < fprintf(mHandle, "%f", value));
+			char text[MAX_FIXED_NUMBER_LENGTH];
+			return writeASCIIText(text, formatFixed(text, value, 6));
 		}
 
 		case ENCODING_BINARY_LITTLE_ENDIAN:
@@ -649,7 +1216,8 @@ bool File::writeFloat(const float value, const Encoding encoding)
 	{
 		case ENCODING_ASCII:
 		{
-			return (0 < fprintf(mHandle, "%f", value));
+			char text[MAX_FIXED_NUMBER_LENGTH];
+			return writeASCIIText(text, formatFixed(text, value, 6));
 		}
 
 		case ENCODING_BINARY_LITTLE_ENDIAN:
@@ -680,7 +1248,8 @@ bool File::writeInt32(const int32 integer, const Encoding encoding)
 	{
 		case ENCODING_ASCII:
 		{
-			return (0 < fprintf(mHandle, "%d", integer));
+			char text[MAX_NUMBER_LENGTH];
+			return writeASCIIText(text, formatSigned(text, integer));
 		}
 
 		case ENCODING_BINARY_LITTLE_ENDIAN:
@@ -736,7 +1305,8 @@ bool File::writeUInt8(const uint8 integer, const Encoding encoding)
 	{
 		case ENCODING_ASCII:
 		{
-			return (0 < fprintf(mHandle, "%u", integer));
+			char text[MAX_NUMBER_LENGTH];
+			return writeASCIIText(text, formatUnsigned(text, integer));
 		}
 
 		case ENCODING_BINARY_LITTLE_ENDIAN:
@@ -11,6 +11,7 @@
 #include <cassert>
 #include <cstdio>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include "Platform/DataTypes.h"
 #include "Platform/Storage/Path.h"
@@ -30,10 +31,41 @@ namespace Storage
             CREATE_WRITING,             /// Create a file and only write to it.
             CREATE_READING_AND_WRITING, /// Create a file and read from it and write to it.
             APPEND_WRITING,             /// Open a file to only write data at its end.
-            APPEND_READING_AND_WRITING  /// Open a file for reading and writing at its end.
+            APPEND_READING_AND_WRITING, /// Open a file for reading and writing at its end.
+            OPEN_READING_MAPPED         /// Map an existing file into memory for reading only, see getData().
+		};
+
+		/// Hints for the operating system about how the content of a mapped file is going to be accessed, see advise().
+		enum AccessHint
+		{
+			ACCESS_NORMAL,		/// No special treatment.
+			ACCESS_SEQUENTIAL,	/// Content is read from front to back, e.g., pages can be read ahead aggressively and freed soon after being read.
+			ACCESS_RANDOM,		/// Content is read in random order, e.g., read ahead is useless.
+			ACCESS_WILL_NEED	/// Content is needed soon, e.g., it should be loaded in the background right away.
+		};
+
+		/// Compression of file content which is transparently compressed when writing and decompressed when reading, see CompressedStream.
+		enum Compression
+		{
+			COMPRESSION_NONE,	/// Raw file bytes.
+			COMPRESSION_GZIP,	/// gzip members which can be read by gzip. Reading also accepts zlib streams.
+			COMPRESSION_ZSTD,	/// zstd frames which can be read by zstd. Requires a build with ZSTD.
+			COMPRESSION_COUNT	/// Number of compressions.
 		};
 
 	public:
+		/** Checks whether a file exists and can be opened for reading.
+		@param fileName Identifies the file.
+		@return Returns true if the file identified by fileName can be opened for reading. */
+		static bool exists(const Path &fileName);
+
+		/** Queries the size and the time of the last modification of a file, e.g., to find out whether data derived from it is outdated.
+		@param size Is set to the number of bytes of the file.
+		@param modificationTime Is set to the time of the last content change in nanoseconds since an arbitrary but fixed epoch of the platform.
+		@param fileName Identifies the file.
+		@return Returns false if the file does not exist or cannot be queried, size and modificationTime are not changed then. */
+		static bool getFileInfo(uint64 &size, int64 &modificationTime, const Path &fileName);
+
 		/** Loads the complete content of a text (not binary) file and stores it in fileContent.
 		@param fileContent This string will be filled with the complete text of the specified file.
 		@param fileName Specifies the file from which the text is loaded. */
@@ -43,17 +75,38 @@ namespace Storage
 		/** Opens or creates a specific file.
 		@param fileName The name and path of the file the access of which is requested.
 		@param mode Defines the way the file is used, corresponds to the file mode options of fopen. See FileMode.
+			OPEN_READING_MAPPED provides the file content as read-only memory and all reading functions directly parse this memory.
+			Files which cannot be mapped, e.g., pipes, are completely copied into memory instead, see isMapped().
 		@param binaryFile If binaryFile is true than the file is opened as binary file
 						  otherwise it is opened as text file (some characters are treated in a special way.)
+						  Mapped files always provide the unchanged file bytes.
 		@param fileVersion Use this to manage file formats.
 			If a file is opened then this is the expected file version and an exception is thrown if the expected file version does not match the version in the opened file.
 			If a file is created then this version is written into the very beginning of the file directly after creation.
 			Set it to INVALID_VERSION to ignore it and open or create the file without regarding any version. */
 		File(const Path &fileName, const FileMode mode, const bool binaryFile, const uint32 fileVersion = File::INVALID_VERSION);
 
-		/** Releases the file handle. */
+		/** Opens or creates a compressed binary file which provides the same reading and writing functions as uncompressed files.
+		@param fileName The name and path of the compressed file.
+		@param mode Set this to OPEN_READING, OPEN_READING_MAPPED, CREATE_WRITING or APPEND_WRITING.
+			Mapped files are decompressed completely into memory. Reading files which were not written by File can only seek forward efficiently.
+		@param compression Set this to the compression of written content. Reading detects gzip, zlib and zstd content regardless of compression,
+			but compression must not be COMPRESSION_NONE. See CompressedStream::isSupported().
+		@param fileVersion Same as for the uncompressed constructor, but stored in the uncompressed content.
+		@throws FileAccessException Is thrown if the file cannot be opened or if mode or compression is not supported.
+		@throws FileCorruptionException Is thrown if a read file is not compressed. */
+		File(const Path &fileName, const FileMode mode, const Compression compression, const uint32 fileVersion = File::INVALID_VERSION);
+
+		/** Releases the file handle and the file mapping. */
 		~File();
 
+		/** Tells the operating system how the content of a mapped file is going to be accessed.
+			Does nothing for files which are not mapped and on systems other than Linux.
+		@param hint Set this to the expected access pattern.
+		@param offset Set this to the first byte the hint applies to.
+		@param size Set this to the number of bytes the hint applies to or to 0 for all bytes from offset to the file end. */
+		void advise(const AccessHint hint, const uint64 offset = 0, const uint64 size = 0);
+
 		#ifdef _DEBUG
 			/** Queries how many files are currently open / exist.
 			@return Returns the number of currently existing / opened files. */
@@ -72,8 +125,44 @@ namespace Storage
 		@return Returns true if the end of the file hasn't been reached so far and if no error was encountered.*/
 		bool hasLeftData() const;
 
+		/** Provides the complete file content for files which were opened with OPEN_READING_MAPPED.
+			The content is followed by a zero byte which is not part of the file, e.g., to safely parse text at the very file end.
+		@return Returns the read-only file content or NULL if the file was opened with another mode. */
+		inline const uint8 *getData() const;
+
+		/** Returns the reading or writing position within the file.
+		@return Returns the offset in bytes from the file start, e.g., from getData(), to the next byte which is read or written. */
+		uint64 getPosition() const;
+
+		/** Returns the size of the content of a file which was opened with OPEN_READING_MAPPED.
+		@return Returns the number of file bytes at getData() or 0 if the file was opened with another mode. */
+		inline uint64 getSize() const;
+
+		/** Provides zero-copy access to an array of binary values in a file which was opened with OPEN_READING_MAPPED.
+			The values are not converted, i.e., the file must store them in host order.
+		@param offset Set this to the position of the first value in bytes relative to getData().
+		@param count Set this to the number of requested values.
+		@return Returns the values or NULL if they are not completely within the file or not properly aligned for T. */
+		template <class T>
+		const T *getView(const uint64 offset, const uint64 count) const;
+
+		/** Moves the reading or writing position and clears the end of file indicator.
+		@param position Set this to the new offset in bytes from the file start. It is clamped to getSize() for files which were opened with OPEN_READING_MAPPED.
+		@return Returns false if the position could not be changed. */
+		bool setPosition(const uint64 position);
+
+		/** Checks whether the file content is really mapped or only copied into memory, see OPEN_READING_MAPPED.
+		@return Returns true if getData() refers to mapped pages of the file. */
+		inline bool isMapped() const;
+
+		/** Same as getView() for values at the reading position which is moved behind the values on success.
+		@param count Set this to the number of requested values.
+		@return Returns the values or NULL if they are not completely within the rest of the file or not properly aligned for T. */
+		template <class T>
+		const T *readView(const uint64 count);
+
 		// TODO this should be removed
-		/** Provides access to the file handle.
+		/** Provides access to the file handle. Its position is not updated by reading a file which was opened with OPEN_READING_MAPPED.
 		@return A reference to the file handle is returned. */
 		FILE &getHandle() { return *mHandle; }
 
@@ -98,6 +187,16 @@ namespace Storage
 		@return Returns the number of bytes that have been read. */
 		uint64 read(std::vector<uint8> &target, const uint32 chunkSize = File::READING_BUFFER_SIZE);
 		
+		/** Reads an array of numbers and decides only once how to decode them, e.g., to load large blocks of binary data without a read call per value.
+			Binary values are read by a single read call and converted to host order in place, see Utilities::swapBytes().
+			ASCII values must be separated by white space.
+		@param destination Set this to an array of at least count elements which is filled with the read values.
+		@param count Set this to the number of values to be read.
+		@param encoding Set this to the encoding of the data to be read to ensure right interpretation of the read file bits.
+		@return Returns the number of completely read values which is smaller than count if the file end was reached or if an error occurred. */
+		template <class T>
+		uint64 readArray(T *destination, const uint64 count, const Encoding encoding);
+
 		/** Reads an 8 Bit integer from the file whereas it is considered to have the entered encoding.
 		@param encoding Set this to the encoding of the data to be read to ensure right interpretation of the read file bits.
 		@return Returns the read bits interpreted as uint8 whereas the file bits were considered to be encoded with the specified encoding. */
@@ -200,6 +299,16 @@ namespace Storage
 		@param elementCount Set this to the number of elements which are stored in the memory area to which data refers to.
 		@return Returns the number of elements which were successfully written to the file which can be fewer than elementCount due to possible errors.*/
 		uint32 write(const void *data, const uint32 elementSize, const uint64 elementCount);
+
+		/** Writes an array of numbers and decides only once how to encode them.
+			Binary values which need a byte order conversion are converted in blocks of ARRAY_BUFFER_SIZE bytes, other binary values are written by a single write call.
+			ASCII values are separated by single spaces, but not from data in front of the array, and floating point numbers are written with enough digits to be read back exactly.
+		@param source Set this to the host order values which are written.
+		@param count Set this to the number of values in source.
+		@param encoding Specifies how the values are represented in the file. E.g. they might be converted to big endian format.
+		@return Returns the number of successfully written values. */
+		template <class T>
+		uint64 writeArray(const T *source, const uint64 count, const Encoding encoding);
 		
 		/** Writes a 64 bit floating point number in host order to the file with the specified encoding.
 		@param value Set this to the host order floating point number you want to convert if necessary and write to this file.
@@ -245,10 +354,88 @@ namespace Storage
 		@returns Returns the file handle which belongs to the opened file. */
 		static FILE *openFile(const Path &fileName, const char *mode);
 
+	private:
+		/** Takes over an opened file and checks or writes its version.
+		@param file Set this to the opened file or NULL if opening failed.
+		@param mode Set this to the mode file was opened with.
+		@param binaryFile Set this to true if file was opened as binary file.
+		@param compression Set this to the compression of file.
+		@param fileVersion Set this to the version which is checked or written, see the constructors. */
+		void initialize(FILE *file, const FileMode mode, const bool binaryFile, const Compression compression, const uint32 fileVersion);
+
+		/** Maps the file content into memory or copies it into memory if it cannot be mapped. mHandle must be opened for binary reading. */
+		void map();
+
+		/** Reads an ASCII encoded integer which is preceded by optional white space.
+		@param value Is set to the read integer or to 0 if there is no integer.
+		@return Returns true if an integer was read. */
+		bool readASCIIInteger(int64 &value);
+
+		/** Reads an ASCII encoded floating point number which is preceded by optional white space.
+		@param value Is set to the read number or to 0 if there is no number.
+		@return Returns true if a number was read. */
+		bool readASCIIReal(double &value);
+
+		/** Same as readASCIIReal() for doubles, but with the same rounding as scanf("%f").
+		@param value Is set to the read number or to 0 if there is no number.
+		@return Returns true if a number was read. */
+		bool readASCIIReal(float &value);
+
+		/** Reads the next characters which might belong to an ASCII encoded number from mHandle into mBuffer, e.g., "-1.5e3" or "inf".
+			Leading white space is skipped and the first character behind the token is not consumed.
+		@return Returns the number of characters in mBuffer. */
+		uint32 readASCIIToken();
+
+		/** Moves the reading position of mHandle back to the first character which was not used of the last token read by readASCIIToken().
+		@param tokenLength Set this to the length of the last token.
+		@param usedLength Set this to the number of characters at the token start which were used. */
+		void unreadASCIIToken(const uint32 tokenLength, const uint32 usedLength);
+
+		/** Reads binary values and converts them to host order, see readArray().
+		@param destination Set this to memory for count values.
+		@param elementSize Set this to the size of a single value in bytes, must be 1, 2, 4 or 8.
+		@param count Set this to the number of values to be read.
+		@param encoding Set this to ENCODING_BINARY_LITTLE_ENDIAN or ENCODING_BINARY_BIG_ENDIAN.
+		@return Returns the number of completely read values. */
+		uint64 readBinaryArray(void *destination, const uint32 elementSize, const uint64 count, const Encoding encoding);
+
+		/** Writes an ASCII encoded floating point number which can be read back exactly.
+		@param value Set this to the written number.
+		@param singlePrecision Set this to true if value is a float to write only as many digits as required for floats.
+		@param separate Set this to true to write a space in front of the number.
+		@return Returns true if the number was successfully written. */
+		bool writeASCIIReal(const double value, const bool singlePrecision, const bool separate);
+
+		/** Writes an ASCII encoded signed integer.
+		@param value Set this to the written integer.
+		@param separate Set this to true to write a space in front of the integer.
+		@return Returns true if the integer was successfully written. */
+		bool writeASCIISigned(const int64 value, const bool separate);
+
+		/** Writes already formatted characters, e.g., a number created by Utilities::formatFixed().
+		@param start Set this to the first written character.
+		@param end Set this to the position behind the last written character.
+		@return Returns true if all characters were successfully written. */
+		bool writeASCIIText(const char *start, const char *end);
+
+		/** Writes an ASCII encoded unsigned integer.
+		@param value Set this to the written integer.
+		@param separate Set this to true to write a space in front of the integer.
+		@return Returns true if the integer was successfully written. */
+		bool writeASCIIUnsigned(const uint64 value, const bool separate);
+
+		/** Converts binary values from host order if necessary and writes them, see writeArray().
+		@param source Set this to count host order values.
+		@param elementSize Set this to the size of a single value in bytes, must be 1, 2, 4 or 8.
+		@param count Set this to the number of values to be written.
+		@param encoding Set this to ENCODING_BINARY_LITTLE_ENDIAN or ENCODING_BINARY_BIG_ENDIAN.
+		@return Returns the number of successfully written values. */
+		uint64 writeBinaryArray(const void *source, const uint32 elementSize, const uint64 count, const Encoding encoding);
+
     private:
         /** Copy constructor is forbidden.
         @param copy Copy constructor is forbidden. */
-        File(const File &copy) : mHandle(NULL) { assert(false); }
+        File(const File &copy) : mHandle(NULL), mData(NULL) { assert(false); }
 
         /** Assignment operator is forbidden.
         @param rhs Operator is forbidden.*/
@@ -257,6 +444,8 @@ namespace Storage
 	public:
 		/** This value should be the same as the maximum number of characters in a file line. */
 		static const uint32 READING_BUFFER_SIZE = 1024u;
+		static const uint32 COPY_CHUNK_SIZE = 1u << 20;	/// Number of bytes which are read at once to copy files which cannot be mapped.
+		static const uint32 ARRAY_BUFFER_SIZE = 1u << 16;	/// Size of the buffer in bytes which is used by writeArray() to convert values to another byte order.
 		static const uint32 INVALID_VERSION;
 
 	private:
@@ -267,16 +456,127 @@ namespace Storage
 		const Path mName;					/// file name, e.g., used for file exceptions for specific messages
         FILE *mHandle;						/// points to the file on mass storage
 		char mBuffer[READING_BUFFER_SIZE];	/// temporary buffer for reading text
+
+		std::vector<uint8> mArrayBuffer;	/// Converted values for writeArray(), allocated on first use.
+		std::vector<uint8> mCopiedData;		/// Content and terminating zero of a file which was opened with OPEN_READING_MAPPED but could not be mapped.
+		const uint8 *mData;					/// Mapped or copied content of a file which was opened with OPEN_READING_MAPPED, otherwise NULL.
+		void *mMapping;						/// Start of the mapped memory range or NULL if nothing is mapped.
+		uint64 mMappingSize;				/// Size of the mapped memory range in bytes.
+		uint64 mPosition;					/// Reading position within mData.
+		uint64 mSize;						/// Number of file bytes at mData.
+		bool mEndOfFileReached;				/// Is set to true by attempts to read beyond the end of mData like the end of file indicator of mHandle.
 	};
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	///   inline & template function definitions   /////////////////////////////////////////////////////////////////////////
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	
+	inline const uint8 *File::getData() const
+	{
+		return mData;
+	}
+
 	inline const Path &File::getName() const
 	{
 		return mName;
 	}
+
+	inline uint64 File::getSize() const
+	{
+		return mSize;
+	}
+
+	template <class T>
+	const T *File::getView(const uint64 offset, const uint64 count) const
+	{
+		if (!mData || offset > mSize || count > (mSize - offset) / sizeof(T))
+			return NULL;
+
+		const uint8 *start = mData + offset;
+		if (0 != ((size_t) start) % alignof(T))
+			return NULL;
+
+		return reinterpret_cast<const T *>(start);
+	}
+
+	template <class T>
+	uint64 File::readArray(T *destination, const uint64 count, const Encoding encoding)
+	{
+		static_assert(std::is_arithmetic<T>::value, "File::readArray() only supports numbers.");
+
+		if (ENCODING_ASCII != encoding)
+			return readBinaryArray(destination, sizeof(T), count, encoding);
+
+		// ASCII
+		for (uint64 valueIdx = 0; valueIdx < count; ++valueIdx)
+		{
+			if (std::is_same<T, float>::value)
+			{
+				float value;
+				if (!readASCIIReal(value))
+					return valueIdx;
+				destination[valueIdx] = (T) value;
+			}
+			else if (std::is_floating_point<T>::value)
+			{
+				double value;
+				if (!readASCIIReal(value))
+					return valueIdx;
+				destination[valueIdx] = (T) value;
+			}
+			else
+			{
+				int64 value;
+				if (!readASCIIInteger(value))
+					return valueIdx;
+				destination[valueIdx] = (T) value;
+			}
+		}
+
+		return count;
+	}
+
+	template <class T>
+	uint64 File::writeArray(const T *source, const uint64 count, const Encoding encoding)
+	{
+		static_assert(std::is_arithmetic<T>::value, "File::writeArray() only supports numbers.");
+
+		if (ENCODING_ASCII != encoding)
+			return writeBinaryArray(source, sizeof(T), count, encoding);
+
+		// ASCII
+		for (uint64 valueIdx = 0; valueIdx < count; ++valueIdx)
+		{
+			bool written;
+			if (std::is_floating_point<T>::value)
+				written = writeASCIIReal((double) source[valueIdx], (sizeof(T) <= sizeof(float)), (valueIdx > 0));
+			else if (std::is_signed<T>::value)
+				written = writeASCIISigned((int64) source[valueIdx], (valueIdx > 0));
+			else
+				written = writeASCIIUnsigned((uint64) source[valueIdx], (valueIdx > 0));
+
+			if (!written)
+				return valueIdx;
+		}
+
+		return count;
+	}
+
+	inline bool File::isMapped() const
+	{
+		return (NULL != mMapping);
+	}
+
+	template <class T>
+	const T *File::readView(const uint64 count)
+	{
+		const T *view = getView<T>(mPosition, count);
+		if (!view)
+			return NULL;
+
+		mPosition += count * sizeof(T);
+		return view;
+	}
 }
 
 #endif // _STORAGE_FILE_H_
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include "Platform/Storage/TextTokenizer.h"
+#include "Platform/Utilities/NumberParsing.h"
+
+using namespace Storage;
+using namespace std;
+using namespace Utilities;
+
+const char *TextTokenizer::DEFAULT_DELIMITERS = " \t\r\n";
+
+TextTokenizer::TextTokenizer(File &file, const char *delimiters) :
+	mFile(file), mData(NULL), mDataFilePosition(0), mPosition(0), mSize(0), mFileEndReached(false)
+{
+	memset(mDelimiters, 0, sizeof(mDelimiters));
+	for (const char *delimiter = delimiters; '\0' != *delimiter; ++delimiter)
+		mDelimiters[(uint8) *delimiter] = true;
+
+	// mapped files are split in place
+	if (mFile.getData())
+	{
+		mData = reinterpret_cast<const char *>(mFile.getData());
+		mPosition = mFile.getPosition();
+		mSize = mFile.getSize();
+		mFileEndReached = true;
+		return;
+	}
+
+	mBuffer.resize(BUFFER_SIZE);
+	mData = mBuffer.data();
+	mDataFilePosition = mFile.getPosition();
+}
+
+TextTokenizer::~TextTokenizer()
+{
+	mFile.setPosition(mDataFilePosition + mPosition);
+}
+
+bool TextTokenizer::readInteger(int64 &value)
+{
+	value = 0;
+
+	Token token;
+	if (!readToken(token))
+		return false;
+
+	if (token.mEnd == parseInteger(value, token.mStart, token.mEnd))
+		return true;
+
+	value = 0;
+	return false;
+}
+
+bool TextTokenizer::readLine(Token &line)
+{
+	if (mPosition >= mSize && !refill())
+		return false;
+
+	// find the line break
+	uint64 end = mPosition;
+	while (true)
+	{
+		const void *lineBreak = memchr(mData + end, '\n', (size_t) (mSize - end));
+		if (lineBreak)
+		{
+			end = reinterpret_cast<const char *>(lineBreak) - mData;
+			break;
+		}
+
+		// line continues in the next block?
+		const uint64 checkedCount = mSize - mPosition;
+		if (!refill())
+		{
+			end = mSize;
+			break;
+		}
+		end = mPosition + checkedCount;
+	}
+
+	// consume the line & its line break, but do not return the line break
+	line.mStart = mData + mPosition;
+	line.mEnd = mData + end;
+	if (line.mEnd > line.mStart && '\r' == line.mEnd[-1])
+		--line.mEnd;
+
+	mPosition = (end < mSize ? end + 1 : end);
+	return true;
+}
+
+bool TextTokenizer::readReal(double &value)
+{
+	value = 0.0;
+
+	Token token;
+	if (!readToken(token))
+		return false;
+
+	if (token.mEnd == parseReal(value, token.mStart, token.mEnd))
+		return true;
+
+	value = 0.0;
+	return false;
+}
+
+bool TextTokenizer::readReal(float &value)
+{
+	value = 0.0f;
+
+	Token token;
+	if (!readToken(token))
+		return false;
+
+	if (token.mEnd == parseReal(value, token.mStart, token.mEnd))
+		return true;
+
+	value = 0.0f;
+	return false;
+}
+
+bool TextTokenizer::readToken(Token &token)
+{
+	// skip delimiters
+	while (true)
+	{
+		while (mPosition < mSize && mDelimiters[(uint8) mData[mPosition]])
+			++mPosition;
+
+		if (mPosition < mSize)
+			break;
+		if (!refill())
+			return false;
+	}
+
+	// find the token end which might be in the next block
+	uint64 end = mPosition;
+	while (true)
+	{
+		while (end < mSize && !mDelimiters[(uint8) mData[end]])
+			++end;
+
+		if (end < mSize)
+			break;
+
+		// refill moves the token start to the buffer start
+		const uint64 checkedCount = end - mPosition;
+		const bool refilled = refill();
+		end = mPosition + checkedCount;
+		if (!refilled)
+			break;
+	}
+
+	token.mStart = mData + mPosition;
+	token.mEnd = mData + end;
+	mPosition = end;
+	return true;
+}
+
+bool TextTokenizer::refill()
+{
+	if (mFileEndReached)
+		return false;
+
+	// keep unconsumed characters
+	const uint64 keptCount = mSize - mPosition;
+	if (keptCount > 0 && mPosition > 0)
+		memmove(mBuffer.data(), mBuffer.data() + mPosition, (size_t) keptCount);
+	mDataFilePosition += mPosition;
+	mPosition = 0;
+	mSize = keptCount;
+
+	// tokens which are longer than the buffer
+	if (mSize == mBuffer.size())
+		mBuffer.resize(2 * mBuffer.size());
+	mData = mBuffer.data();
+
+	// append the next block
+	const uint64 freeCount = mBuffer.size() - mSize;
+	const uint64 readCount = mFile.read(mBuffer.data() + mSize, freeCount, 1, freeCount);
+	mSize += readCount;
+	if (0 == readCount)
+		mFileEndReached = true;
+
+	return (0 != readCount);
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _STORAGE_TEXT_TOKENIZER_H_
+#define _STORAGE_TEXT_TOKENIZER_H_
+
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Platform/DataTypes.h"
+#include "Platform/Storage/File.h"
+
+namespace Storage
+{
+	/// Splits the text of a File into tokens and lines without copying them, e.g., to quickly parse large ASCII files.
+	/** Files which were opened with File::OPEN_READING_MAPPED are split in place.
+		Other files are read in blocks of BUFFER_SIZE bytes into a buffer of the tokenizer.
+		Tokens refer to this memory and are only valid until the next call of a reading function of the tokenizer.
+		The tokenizer starts at the reading position of the file and moves it behind the consumed text when it is destroyed.
+		The file must not be read otherwise as long as the tokenizer exists. */
+	class TextTokenizer
+	{
+	public:
+		/// Characters of a token or line which are not zero terminated.
+		struct Token
+		{
+		public:
+			/** Compares the token with a zero terminated string.
+			@param text Set this to the compared string.
+			@return Returns true if the token consists of exactly the characters of text. */
+			inline bool equals(const char *text) const;
+
+			/** Returns the number of characters of the token.
+			@return Returns mEnd - mStart. */
+			inline uint64 getLength() const;
+
+			/** Copies the token, e.g., to keep it after the next call of the tokenizer.
+			@return Returns a string with the characters of the token. */
+			inline std::string toString() const;
+
+		public:
+			const char *mStart;	/// First character of the token.
+			const char *mEnd;	/// Points behind the last character of the token.
+		};
+
+	public:
+		/** Prepares splitting the text of file.
+		@param file Set this to the file which is read from its current reading position on.
+		@param delimiters Set this to the characters which separate tokens. Line breaks always end lines. */
+		TextTokenizer(File &file, const char *delimiters = DEFAULT_DELIMITERS);
+
+		/** Moves the reading position of the file behind the consumed text. */
+		~TextTokenizer();
+
+		/** Reads the next token and converts it to an integer.
+		@param value Is set to the integer or to 0 if the next token is not a complete decimal integer.
+		@return Returns false if there is no token left or if the token is not a complete integer. The token is consumed in any case. */
+		bool readInteger(int64 &value);
+
+		/** Reads the next line without its line break ("\n" or "\r\n").
+		@param line Is set to the characters of the line which can be empty.
+		@return Returns false if there is no character left. */
+		bool readLine(Token &line);
+
+		/** Reads the next token and converts it to a floating point number like strtod.
+		@param value Is set to the number or to 0 if the next token is not a complete number.
+		@return Returns false if there is no token left or if the token is not a complete number. The token is consumed in any case. */
+		bool readReal(double &value);
+
+		/** Same as readReal() for doubles, but converts like strtof. */
+		bool readReal(float &value);
+
+		/** Skips delimiters and reads all following characters until the next delimiter or the end of the file.
+		@param token Is set to the characters of the token.
+		@return Returns false if there is no token left. */
+		bool readToken(Token &token);
+
+	public:
+		static const char *DEFAULT_DELIMITERS;		/// White space: " \t\r\n".
+		static const uint32 BUFFER_SIZE = 1u << 16;	/// Initial size in bytes of the buffer for files which are not mapped.
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		TextTokenizer(const TextTokenizer &copy) : mFile(copy.mFile) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		TextTokenizer &operator =(const TextTokenizer &rhs) { assert(false); return *this; }
+
+		/** Moves the unconsumed characters to the buffer start and appends the next file block. Does nothing for mapped files.
+		@return Returns false if no character could be appended since the file end was reached. */
+		bool refill();
+
+	private:
+		std::vector<char>	mBuffer;				/// Unconsumed characters of files which are not mapped.
+		File				&mFile;					/// Split file.
+		const char			*mData;					/// Either the content of the mapped file or mBuffer.data().
+		uint64				mDataFilePosition;		/// File position of mData[0].
+		uint64				mPosition;				/// Index of the next unconsumed character in mData.
+		uint64				mSize;					/// Number of valid characters at mData.
+		bool				mDelimiters[256];		/// Is true for each character which separates tokens.
+		bool				mFileEndReached;		/// Is true if there are no more characters in the file behind mData + mSize.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline bool TextTokenizer::Token::equals(const char *text) const
+	{
+		const size_t length = strlen(text);
+		return (length == (size_t) (mEnd - mStart) && 0 == memcmp(mStart, text, length));
+	}
+
+	inline uint64 TextTokenizer::Token::getLength() const
+	{
+		return (uint64) (mEnd - mStart);
+	}
+
+	inline std::string TextTokenizer::Token::toString() const
+	{
+		return std::string(mStart, mEnd);
+	}
+}
+
+#endif // _STORAGE_TEXT_TOKENIZER_H_
@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cstring>
+#include <memory>
+#include "Math/MathHelper.h"
+#include "Math/SIMD.h"
+#include "Platform/Multithreading/Manager.h"
+#include "Platform/Utilities/BatchTransforms.h"
+
+using namespace Math;
+using namespace Platform::Multithreading;
+using namespace std;
+using namespace Utilities;
+
+void BatchTransforms::RangeTask::function()
+{
+	BatchTransforms::transform(*mBatch, mFirst, mCount);
+}
+
+void BatchTransforms::transformPoints(Vector3 *targets, const Vector3 *points, const uint64 count,
+	const Matrix4x4 &transformation, const bool parallel)
+{
+	run(createBatch(targets, points, count, transformation, OPERATION_AFFINE), parallel);
+}
+
+void BatchTransforms::transformPoints(Real *targetsX, Real *targetsY, Real *targetsZ, const Real *x, const Real *y, const Real *z, const uint64 count,
+	const Matrix4x4 &transformation, const bool parallel)
+{
+	run(createBatch(targetsX, targetsY, targetsZ, x, y, z, count, transformation, OPERATION_AFFINE), parallel);
+}
+
+void BatchTransforms::transformNormals(Vector3 *targets, const Vector3 *normals, const uint64 count,
+	const Matrix4x4 &transformation, const bool normalize, const bool parallel)
+{
+	const OPERATION operation = (normalize ? OPERATION_LINEAR_NORMALIZED : OPERATION_LINEAR);
+	run(createBatch(targets, normals, count, createNormalMatrix(transformation), operation), parallel);
+}
+
+void BatchTransforms::transformNormals(Real *targetsX, Real *targetsY, Real *targetsZ, const Real *x, const Real *y, const Real *z, const uint64 count,
+	const Matrix4x4 &transformation, const bool normalize, const bool parallel)
+{
+	const OPERATION operation = (normalize ? OPERATION_LINEAR_NORMALIZED : OPERATION_LINEAR);
+	run(createBatch(targetsX, targetsY, targetsZ, x, y, z, count, createNormalMatrix(transformation), operation), parallel);
+}
+
+void BatchTransforms::rotate(Vector3 *targets, const Vector3 *vectors, const uint64 count,
+	const Quaternion &rotation, const bool parallel)
+{
+	run(createBatch(targets, vectors, count, createMatrix4x4FromQuaternion(rotation), OPERATION_LINEAR), parallel);
+}
+
+void BatchTransforms::rotate(Real *targetsX, Real *targetsY, Real *targetsZ, const Real *x, const Real *y, const Real *z, const uint64 count,
+	const Quaternion &rotation, const bool parallel)
+{
+	run(createBatch(targetsX, targetsY, targetsZ, x, y, z, count, createMatrix4x4FromQuaternion(rotation), OPERATION_LINEAR), parallel);
+}
+
+void BatchTransforms::projectPoints(Vector3 *targets, const Vector3 *points, const uint64 count,
+	const Matrix4x4 &projection, const bool parallel)
+{
+	run(createBatch(targets, points, count, projection, OPERATION_PROJECTIVE), parallel);
+}
+
+void BatchTransforms::projectPoints(Real *targetsX, Real *targetsY, Real *targetsZ, const Real *x, const Real *y, const Real *z, const uint64 count,
+	const Matrix4x4 &projection, const bool parallel)
+{
+	run(createBatch(targetsX, targetsY, targetsZ, x, y, z, count, projection, OPERATION_PROJECTIVE), parallel);
+}
+
+BatchTransforms::Batch BatchTransforms::createBatch(Vector3 *targets, const Vector3 *sources, const uint64 count,
+	const Matrix4x4 &matrix, const OPERATION operation)
+{
+	Batch batch;
+	memcpy(batch.mRows, matrix.values, sizeof(batch.mRows));
+	batch.mSources = sources;
+	batch.mTargets = targets;
+	for (uint32 componentIdx = 0; componentIdx < 3; ++componentIdx)
+	{
+		batch.mSourceComponents[componentIdx] = NULL;
+		batch.mTargetComponents[componentIdx] = NULL;
+	}
+	batch.mCount = count;
+	batch.mOperation = operation;
+
+	return batch;
+}
+
+BatchTransforms::Batch BatchTransforms::createBatch(Real *targetsX, Real *targetsY, Real *targetsZ, const Real *x, const Real *y, const Real *z, const uint64 count,
+	const Matrix4x4 &matrix, const OPERATION operation)
+{
+	Batch batch;
+	memcpy(batch.mRows, matrix.values, sizeof(batch.mRows));
+	batch.mSources = NULL;
+	batch.mTargets = NULL;
+	batch.mSourceComponents[0] = x;
+	batch.mSourceComponents[1] = y;
+	batch.mSourceComponents[2] = z;
+	batch.mTargetComponents[0] = targetsX;
+	batch.mTargetComponents[1] = targetsY;
+	batch.mTargetComponents[2] = targetsZ;
+	batch.mCount = count;
+	batch.mOperation = operation;
+
+	return batch;
+}
+
+Matrix4x4 BatchTransforms::createNormalMatrix(const Matrix4x4 &transformation)
+{
+	// the upper left part of the inverse of an affine transformation is the inverse of its upper left part
+	Matrix4x4 normalMatrix = Matrix4x4::createInverse(transformation);
+	normalMatrix.transpose();
+
+	for (uint32 idx = 0; idx < 4; ++idx)
+	{
+		normalMatrix.values[idx][3] = 0.0f;
+		normalMatrix.values[3][idx] = 0.0f;
+	}
+
+	return normalMatrix;
+}
+
+void BatchTransforms::run(const Batch &batch, const bool parallel)
+{
+	// ranges for the calling thread and the workers, but not if this thread is a worker which must not wait for other tasks
+	uint64 rangeCount = 1;
+	if (parallel && Manager::exists() && Manager::getSingleton().isRunning() && !Manager::isWorkerThread())
+	{
+		const uint64 threadCount = Manager::getSingleton().getThreadCount() + 1;
+		rangeCount = batch.mCount / PARALLEL_ELEMENT_COUNT;
+		if (rangeCount > threadCount)
+			rangeCount = threadCount;
+		if (rangeCount > MAX_TASK_COUNT)
+			rangeCount = MAX_TASK_COUNT;
+	}
+
+	if (rangeCount < 2)
+	{
+		transform(batch, 0, batch.mCount);
+		return;
+	}
+
+	// the calling thread transforms the first range while the workers transform the others
+	const uint64 rangeSize = batch.mCount / rangeCount;
+	unique_ptr<RangeTask[]> tasks(new RangeTask[rangeCount - 1]);
+	Manager &manager = Manager::getSingleton();
+
+	for (uint64 rangeIdx = 1; rangeIdx < rangeCount; ++rangeIdx)
+	{
+		RangeTask &task = tasks[rangeIdx - 1];
+		task.mBatch = &batch;
+		task.mFirst = rangeIdx * rangeSize;
+		task.mCount = (rangeIdx + 1 < rangeCount ? rangeSize : batch.mCount - task.mFirst);
+		manager.enqueue(&task);
+	}
+
+	transform(batch, 0, rangeSize);
+	for (uint64 taskIdx = 0; taskIdx < rangeCount - 1; ++taskIdx)
+		tasks[taskIdx].waitUntilFinished();
+}
+
+void BatchTransforms::transform(const Batch &batch, const uint64 first, const uint64 count)
+{
+	if (batch.mSources)
+	{
+		switch (batch.mOperation)
+		{
+			case OPERATION_AFFINE:				transformStructures<OPERATION_AFFINE>(batch, first, count); return;
+			case OPERATION_LINEAR:				transformStructures<OPERATION_LINEAR>(batch, first, count); return;
+			case OPERATION_LINEAR_NORMALIZED:	transformStructures<OPERATION_LINEAR_NORMALIZED>(batch, first, count); return;
+			case OPERATION_PROJECTIVE:			transformStructures<OPERATION_PROJECTIVE>(batch, first, count); return;
+			default:
+				assert(false);
+				return;
+		}
+	}
+
+	switch (batch.mOperation)
+	{
+		case OPERATION_AFFINE:				transformComponents<OPERATION_AFFINE>(batch, first, count); return;
+		case OPERATION_LINEAR:				transformComponents<OPERATION_LINEAR>(batch, first, count); return;
+		case OPERATION_LINEAR_NORMALIZED:	transformComponents<OPERATION_LINEAR_NORMALIZED>(batch, first, count); return;
+		case OPERATION_PROJECTIVE:			transformComponents<OPERATION_PROJECTIVE>(batch, first, count); return;
+		default:
+			assert(false);
+			return;
+	}
+}
+
+template <BatchTransforms::OPERATION OPERATION_TYPE>
+void BatchTransforms::transformStructures(const Batch &batch, const uint64 first, const uint64 count)
+{
+	// each result is a linear combination of the matrix rows like in Vector4::operator *()
+	const SIMDReal4 row0 = SIMDReal4::load(batch.mRows[0]);
+	const SIMDReal4 row1 = SIMDReal4::load(batch.mRows[1]);
+	const SIMDReal4 row2 = SIMDReal4::load(batch.mRows[2]);
+	const SIMDReal4 row3 = SIMDReal4::load(batch.mRows[3]);
+	const SIMDReal4 one = SIMDReal4::splat(1.0f);
+
+	const Vector3 *sources = batch.mSources + first;
+	Vector3 *targets = batch.mTargets + first;
+
+	for (uint64 idx = 0; idx < count; ++idx)
+	{
+		// read the complete source before writing the target which might be the same vector
+		const Vector3 &source = sources[idx];
+		SIMDReal4 result = SIMDReal4::splat(source.x) * row0 + SIMDReal4::splat(source.y) * row1 + SIMDReal4::splat(source.z) * row2;
+		if (OPERATION_AFFINE == OPERATION_TYPE || OPERATION_PROJECTIVE == OPERATION_TYPE)
+			result = result + row3;
+		if (OPERATION_PROJECTIVE == OPERATION_TYPE)
+			result = result * (one / result.shuffle<3, 3, 3, 3>());
+
+		Vector3 &target = targets[idx];
+		result.store3(target.getData());
+
+		// same arithmetic as Vector3::normalize() and as the lane-wise normalization in transformComponents()
+		if (OPERATION_LINEAR_NORMALIZED == OPERATION_TYPE)
+			target *= 1.0f / sqrtr(target.x * target.x + target.y * target.y + target.z * target.z);
+	}
+}
+
+template <BatchTransforms::OPERATION OPERATION_TYPE>
+void BatchTransforms::transformComponents(const Batch &batch, const uint64 first, const uint64 count)
+{
+	// every matrix entry in all lanes for 4 vectors at once
+	SIMDReal4 matrix[4][4];
+	for (uint32 rowIdx = 0; rowIdx < 4; ++rowIdx)
+		for (uint32 columnIdx = 0; columnIdx < 4; ++columnIdx)
+			matrix[rowIdx][columnIdx] = SIMDReal4::splat(batch.mRows[rowIdx][columnIdx]);
+	const SIMDReal4 one = SIMDReal4::splat(1.0f);
+
+	// component c of each result = x * m0c + y * m1c + z * m2c (+ m3c) like in Vector4::operator *()
+	auto transformBlock = [&matrix, &one] (SIMDReal4 &x, SIMDReal4 &y, SIMDReal4 &z)
+	{
+		SIMDReal4 resultX = x * matrix[0][0] + y * matrix[1][0] + z * matrix[2][0];
+		SIMDReal4 resultY = x * matrix[0][1] + y * matrix[1][1] + z * matrix[2][1];
+		SIMDReal4 resultZ = x * matrix[0][2] + y * matrix[1][2] + z * matrix[2][2];
+		if (OPERATION_AFFINE == OPERATION_TYPE || OPERATION_PROJECTIVE == OPERATION_TYPE)
+		{
+			resultX = resultX + matrix[3][0];
+			resultY = resultY + matrix[3][1];
+			resultZ = resultZ + matrix[3][2];
+		}
+
+		if (OPERATION_PROJECTIVE == OPERATION_TYPE)
+		{
+			const SIMDReal4 w = x * matrix[0][3] + y * matrix[1][3] + z * matrix[2][3] + matrix[3][3];
+			const SIMDReal4 scale = one / w;
+			resultX = resultX * scale;
+			resultY = resultY * scale;
+			resultZ = resultZ * scale;
+		}
+		else if (OPERATION_LINEAR_NORMALIZED == OPERATION_TYPE)
+		{
+			const SIMDReal4 lengths = (resultX * resultX + resultY * resultY + resultZ * resultZ).squareRoot();
+			const SIMDReal4 scale = one / lengths;
+			resultX = resultX * scale;
+			resultY = resultY * scale;
+			resultZ = resultZ * scale;
+		}
+
+		x = resultX;
+		y = resultY;
+		z = resultZ;
+	};
+
+	const Real *sources[3];
+	Real *targets[3];
+	for (uint32 componentIdx = 0; componentIdx < 3; ++componentIdx)
+	{
+		sources[componentIdx] = batch.mSourceComponents[componentIdx] + first;
+		targets[componentIdx] = batch.mTargetComponents[componentIdx] + first;
+	}
+
+	// complete blocks of 4 vectors, all sources of a block are loaded before its targets are written
+	const uint64 blockEnd = count - count % 4;
+	for (uint64 idx = 0; idx < blockEnd; idx += 4)
+	{
+		SIMDReal4 x = SIMDReal4::load(sources[0] + idx);
+		SIMDReal4 y = SIMDReal4::load(sources[1] + idx);
+		SIMDReal4 z = SIMDReal4::load(sources[2] + idx);
+
+		transformBlock(x, y, z);
+		x.store(targets[0] + idx);
+		y.store(targets[1] + idx);
+		z.store(targets[2] + idx);
+	}
+
+	// remaining vectors as a zero padded block
+	const uint64 remainder = count - blockEnd;
+	if (0 == remainder)
+		return;
+
+	Real padded[3][4];
+	for (uint32 componentIdx = 0; componentIdx < 3; ++componentIdx)
+		for (uint64 laneIdx = 0; laneIdx < 4; ++laneIdx)
+			padded[componentIdx][laneIdx] = (laneIdx < remainder ? sources[componentIdx][blockEnd + laneIdx] : 0.0f);
+
+	SIMDReal4 x = SIMDReal4::load(padded[0]);
+	SIMDReal4 y = SIMDReal4::load(padded[1]);
+	SIMDReal4 z = SIMDReal4::load(padded[2]);
+
+	transformBlock(x, y, z);
+	x.store(padded[0]);
+	y.store(padded[1]);
+	z.store(padded[2]);
+
+	for (uint32 componentIdx = 0; componentIdx < 3; ++componentIdx)
+		for (uint64 laneIdx = 0; laneIdx < remainder; ++laneIdx)
+			targets[componentIdx][blockEnd + laneIdx] = padded[componentIdx][laneIdx];
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _UTILITIES_BATCH_TRANSFORMS_H_
+#define _UTILITIES_BATCH_TRANSFORMS_H_
+
+#include "Math/MathCore.h"
+#include "Math/Matrix4x4.h"
+#include "Math/Quaternion.h"
+#include "Math/Vector3.h"
+#include "Platform/DataTypes.h"
+#include "Platform/Multithreading/Task.h"
+
+namespace Utilities
+{
+	/// Transforms complete arrays of points or normals with SIMD inner loops instead of one operator *() call per element.
+	/** Each transformation exists for arrays of structures (Math::Vector3 arrays) and for structures of arrays (separate x, y and z arrays).
+		All matrices follow the row vector convention of Math::Matrix4x4, i.e., a point p is transformed to p * matrix.
+		Targets can be the source arrays for in-place transformation, but must not partially overlap with them.
+		Results equal those of the corresponding Math operators up to rounding.
+		If parallel is set, arrays with at least 2 * PARALLEL_ELEMENT_COUNT elements are split into ranges which are transformed by tasks of the
+		Platform::Multithreading::Manager and the calling thread. Without a running Manager or on one of its workers, the calling thread transforms all elements. */
+	class BatchTransforms
+	{
+	public:
+		/** Applies an affine transformation to points, i.e., computes (x, y, z, 1) * transformation without its fourth column.
+		@param targets Is filled with count transformed points.
+		@param points Set this to count points which are transformed.
+		@param count Set this to the number of points.
+		@param transformation Set this to the affine transformation which is applied to the points.
+		@param parallel Set this to true to split large arrays across the worker threads. */
+		static void transformPoints(Math::Vector3 *targets, const Math::Vector3 *points, const uint64 count,
+			const Math::Matrix4x4 &transformation, const bool parallel = false);
+
+		/** Applies an affine transformation to points, i.e., computes (x, y, z, 1) * transformation without its fourth column.
+		@param targetsX Is filled with the x-coordinates of count transformed points.
+		@param targetsY Is filled with the y-coordinates of count transformed points.
+		@param targetsZ Is filled with the z-coordinates of count transformed points.
+		@param x Set this to the x-coordinates of count points which are transformed.
+		@param y Set this to the y-coordinates of count points which are transformed.
+		@param z Set this to the z-coordinates of count points which are transformed.
+		@param count Set this to the number of points.
+		@param transformation Set this to the affine transformation which is applied to the points.
+		@param parallel Set this to true to split large arrays across the worker threads. */
+		static void transformPoints(Real *targetsX, Real *targetsY, Real *targetsZ, const Real *x, const Real *y, const Real *z, const uint64 count,
+			const Math::Matrix4x4 &transformation, const bool parallel = false);
+
+		/** Transforms surface normals of points which are transformed by transformation, i.e., multiplies them with the inverse transpose
+			of the upper left 3x3 part of transformation.
+		@param targets Is filled with count transformed normals.
+		@param normals Set this to count normals which are transformed.
+		@param count Set this to the number of normals.
+		@param transformation Set this to the invertible, affine transformation of the points with the normals.
+		@param normalize Set this to true to scale all transformed normals to unit length like Math::Vector3::normalize() does.
+		@param parallel Set this to true to split large arrays across the worker threads. */
+		static void transformNormals(Math::Vector3 *targets, const Math::Vector3 *normals, const uint64 count,
+			const Math::Matrix4x4 &transformation, const bool normalize, const bool parallel = false);
+
+		/** Transforms surface normals of points which are transformed by transformation, i.e., multiplies them with the inverse transpose
+			of the upper left 3x3 part of transformation.
+		@param targetsX Is filled with the x-components of count transformed normals.
+		@param targetsY Is filled with the y-components of count transformed normals.
+		@param targetsZ Is filled with the z-components of count transformed normals.
+		@param x Set this to the x-components of count normals which are transformed.
+		@param y Set this to the y-components of count normals which are transformed.
+		@param z Set this to the z-components of count normals which are transformed.
+		@param count Set this to the number of normals.
+		@param transformation Set this to the invertible, affine transformation of the points with the normals.
+		@param normalize Set this to true to scale all transformed normals to unit length like Math::Vector3::normalize() does.
+		@param parallel Set this to true to split large arrays across the worker threads. */
+		static void transformNormals(Real *targetsX, Real *targetsY, Real *targetsZ, const Real *x, const Real *y, const Real *z, const uint64 count,
+			const Math::Matrix4x4 &transformation, const bool normalize, const bool parallel = false);
+
+		/** Rotates vectors like Math::Quaternion::rotateVector(), but via the rotation matrix of the quaternion.
+		@param targets Is filled with count rotated vectors.
+		@param vectors Set this to count vectors which are rotated.
+		@param count Set this to the number of vectors.
+		@param rotation Set this to the unit quaternion which defines the rotation.
+		@param parallel Set this to true to split large arrays across the worker threads. */
+		static void rotate(Math::Vector3 *targets, const Math::Vector3 *vectors, const uint64 count,
+			const Math::Quaternion &rotation, const bool parallel = false);
+
+		/** Rotates vectors like Math::Quaternion::rotateVector(), but via the rotation matrix of the quaternion.
+		@param targetsX Is filled with the x-components of count rotated vectors.
+		@param targetsY Is filled with the y-components of count rotated vectors.
+		@param targetsZ Is filled with the z-components of count rotated vectors.
+		@param x Set this to the x-components of count vectors which are rotated.
+		@param y Set this to the y-components of count vectors which are rotated.
+		@param z Set this to the z-components of count vectors which are rotated.
+		@param count Set this to the number of vectors.
+		@param rotation Set this to the unit quaternion which defines the rotation.
+		@param parallel Set this to true to split large arrays across the worker threads. */
+		static void rotate(Real *targetsX, Real *targetsY, Real *targetsZ, const Real *x, const Real *y, const Real *z, const uint64 count,
+			const Math::Quaternion &rotation, const bool parallel = false);
+
+		/** Projects points, i.e., computes (x, y, z, 1) * projection and divides the first three components by the fourth one.
+			Like Math::Vector4::operator /(), the components are multiplied with the reciprocal of the fourth component.
+		@param targets Is filled with count projected points.
+		@param points Set this to count points which are projected.
+		@param count Set this to the number of points.
+		@param projection Set this to the projective transformation, e.g., a view projection matrix.
+		@param parallel Set this to true to split large arrays across the worker threads. */
+		static void projectPoints(Math::Vector3 *targets, const Math::Vector3 *points, const uint64 count,
+			const Math::Matrix4x4 &projection, const bool parallel = false);
+
+		/** Projects points, i.e., computes (x, y, z, 1) * projection and divides the first three components by the fourth one.
+			Like Math::Vector4::operator /(), the components are multiplied with the reciprocal of the fourth component.
+		@param targetsX Is filled with the x-coordinates of count projected points.
+		@param targetsY Is filled with the y-coordinates of count projected points.
+		@param targetsZ Is filled with the z-coordinates of count projected points.
+		@param x Set this to the x-coordinates of count points which are projected.
+		@param y Set this to the y-coordinates of count points which are projected.
+		@param z Set this to the z-coordinates of count points which are projected.
+		@param count Set this to the number of points.
+		@param projection Set this to the projective transformation, e.g., a view projection matrix.
+		@param parallel Set this to true to split large arrays across the worker threads. */
+		static void projectPoints(Real *targetsX, Real *targetsY, Real *targetsZ, const Real *x, const Real *y, const Real *z, const uint64 count,
+			const Math::Matrix4x4 &projection, const bool parallel = false);
+
+	public:
+		static const uint64 PARALLEL_ELEMENT_COUNT = 1u << 16;	/// Minimum number of elements per range which is transformed by a single thread.
+		static const uint32 MAX_TASK_COUNT = 32;				/// Maximum number of ranges which are transformed at once.
+
+	private:
+		/// Arithmetic which is applied to each element.
+		enum OPERATION
+		{
+			OPERATION_AFFINE,			/// Multiplication of (x, y, z, 1) with the matrix.
+			OPERATION_LINEAR,			/// Multiplication of (x, y, z, 0) with the matrix.
+			OPERATION_LINEAR_NORMALIZED,/// Multiplication of (x, y, z, 0) with the matrix and normalization of the result.
+			OPERATION_PROJECTIVE,		/// Multiplication of (x, y, z, 1) with the matrix and division by the fourth component.
+			OPERATION_COUNT				/// Number of operations.
+		};
+
+		/// Complete description of a single batch transformation.
+		struct Batch
+		{
+			Real				mRows[4][4];			/// Rows of the applied matrix.
+			const Math::Vector3	*mSources;				/// Transformed vectors or NULL for separate component arrays.
+			Math::Vector3		*mTargets;				/// Results for mSources.
+			const Real			*mSourceComponents[3];	/// Separate x, y and z arrays of the transformed vectors if mSources is NULL.
+			Real				*mTargetComponents[3];	/// Separate x, y and z arrays of the results for mSourceComponents.
+			uint64				mCount;					/// Number of transformed vectors.
+			OPERATION			mOperation;				/// Arithmetic for each vector.
+		};
+
+		/// Transforms a single range of a batch on a worker thread.
+		class RangeTask : public Platform::Multithreading::Task
+		{
+		public:
+			RangeTask() : Task(), mBatch(NULL), mFirst(0), mCount(0) { }
+			virtual void function();
+
+		public:
+			const Batch	*mBatch;	/// Batch which contains the range.
+			uint64		mFirst;		/// Index of the first vector of the range.
+			uint64		mCount;		/// Number of vectors of the range.
+		};
+
+	private:
+		/** Creates a batch for vector arrays.
+		@param targets Set this to the results.
+		@param sources Set this to the transformed vectors.
+		@param count Set this to the number of vectors.
+		@param matrix Set this to the applied matrix.
+		@param operation Set this to the arithmetic for each vector.
+		@return Returns the complete description of the batch. */
+		static Batch createBatch(Math::Vector3 *targets, const Math::Vector3 *sources, const uint64 count,
+			const Math::Matrix4x4 &matrix, const OPERATION operation);
+
+		/** Creates a batch for separate component arrays.
+		@param targetsX Set this to the x-components of the results.
+		@param targetsY Set this to the y-components of the results.
+		@param targetsZ Set this to the z-components of the results.
+		@param x Set this to the x-components of the transformed vectors.
+		@param y Set this to the y-components of the transformed vectors.
+		@param z Set this to the z-components of the transformed vectors.
+		@param count Set this to the number of vectors.
+		@param matrix Set this to the applied matrix.
+		@param operation Set this to the arithmetic for each vector.
+		@return Returns the complete description of the batch. */
+		static Batch createBatch(Real *targetsX, Real *targetsY, Real *targetsZ, const Real *x, const Real *y, const Real *z, const uint64 count,
+			const Math::Matrix4x4 &matrix, const OPERATION operation);
+
+		/** Computes the matrix which transforms normals of points that are transformed by transformation.
+		@param transformation Set this to the invertible, affine transformation of the points.
+		@return Returns the inverse transpose of the upper left 3x3 part of transformation with zeros in the fourth row and column. */
+		static Math::Matrix4x4 createNormalMatrix(const Math::Matrix4x4 &transformation);
+
+		/** Transforms all vectors of a batch, possibly in parallel ranges.
+		@param batch Set this to the complete description of the transformation.
+		@param parallel Set this to true to split large batches across the worker threads. */
+		static void run(const Batch &batch, const bool parallel);
+
+		/** Transforms a range of vectors of a batch by the calling thread.
+		@param batch Set this to the batch which contains the range.
+		@param first Set this to the index of the first vector of the range.
+		@param count Set this to the number of vectors of the range. */
+		static void transform(const Batch &batch, const uint64 first, const uint64 count);
+
+		/** Transforms a range of vectors of a batch with vector arrays.
+		@tparam OPERATION_TYPE Set this to the arithmetic of the batch.
+		@param batch Set this to the batch which contains the range.
+		@param first Set this to the index of the first vector of the range.
+		@param count Set this to the number of vectors of the range. */
+		template <OPERATION OPERATION_TYPE>
+		static void transformStructures(const Batch &batch, const uint64 first, const uint64 count);
+
+		/** Transforms a range of vectors of a batch with separate component arrays.
+		@tparam OPERATION_TYPE Set this to the arithmetic of the batch.
+		@param batch Set this to the batch which contains the range.
+		@param first Set this to the index of the first vector of the range.
+		@param count Set this to the number of vectors of the range. */
+		template <OPERATION OPERATION_TYPE>
+		static void transformComponents(const Batch &batch, const uint64 first, const uint64 count);
+	};
+}
+
+#endif // _UTILITIES_BATCH_TRANSFORMS_H_
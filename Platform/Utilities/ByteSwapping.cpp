@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cassert>
+#include <cstring>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define BYTE_SWAPPING_X86_SIMD
+#endif // defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#ifdef _WINDOWS
+	#include <cstdlib>
+#endif // _WINDOWS
+#include "Platform/Utilities/ByteSwapping.h"
+
+using namespace Utilities;
+
+namespace
+{
+	#ifdef BYTE_SWAPPING_X86_SIMD
+		/// Signature of the kernels which convert the large leading part of an array.
+		typedef uint64 (*SwapKernel)(uint8 *destination, const uint8 *source, const uint64 byteCount, const uint8 *shuffleMask);
+
+		/// pshufb masks which reverse the bytes of each 2, 4 or 8 byte value in a 16 byte block.
+		const uint8 SHUFFLE_MASKS[3][16] =
+		{
+			{ 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 },
+			{ 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 },
+			{ 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 }
+		};
+	#endif // BYTE_SWAPPING_X86_SIMD
+
+	/** Reverses the byte order of a single value.
+	@param value Set this to the value which is converted.
+	@return Returns value with reversed byte order. */
+	inline uint16 swap16(const uint16 value)
+	{
+		#ifdef _WINDOWS
+			return _byteswap_ushort(value);
+		#else
+			return __builtin_bswap16(value);
+		#endif // _WINDOWS
+	}
+
+	/** See swap16(). */
+	inline uint32 swap32(const uint32 value)
+	{
+		#ifdef _WINDOWS
+			return _byteswap_ulong(value);
+		#else
+			return __builtin_bswap32(value);
+		#endif // _WINDOWS
+	}
+
+	/** See swap16(). */
+	inline uint64 swap64(const uint64 value)
+	{
+		#ifdef _WINDOWS
+			return _byteswap_uint64(value);
+		#else
+			return __builtin_bswap64(value);
+		#endif // _WINDOWS
+	}
+
+	/** Converts values one by one, e.g., the rest of an array which is too short for a SIMD block.
+	@param destination Receives the converted values.
+	@param source Set this to the converted values.
+	@param elementSize Set this to 2, 4 or 8.
+	@param count Set this to the number of values. */
+	void swapScalar(uint8 *destination, const uint8 *source, const uint32 elementSize, const uint64 count)
+	{
+		// memcpy for unaligned values
+		switch (elementSize)
+		{
+			case 2:
+				for (uint64 valueIdx = 0; valueIdx < count; ++valueIdx)
+				{
+					uint16 value;
+					memcpy(&value, source + 2 * valueIdx, 2);
+					value = swap16(value);
+					memcpy(destination + 2 * valueIdx, &value, 2);
+				}
+				return;
+
+			case 4:
+				for (uint64 valueIdx = 0; valueIdx < count; ++valueIdx)
+				{
+					uint32 value;
+					memcpy(&value, source + 4 * valueIdx, 4);
+					value = swap32(value);
+					memcpy(destination + 4 * valueIdx, &value, 4);
+				}
+				return;
+
+			case 8:
+				for (uint64 valueIdx = 0; valueIdx < count; ++valueIdx)
+				{
+					uint64 value;
+					memcpy(&value, source + 8 * valueIdx, 8);
+					value = swap64(value);
+					memcpy(destination + 8 * valueIdx, &value, 8);
+				}
+				return;
+
+			default:
+				assert(false);
+		}
+	}
+
+	#ifdef BYTE_SWAPPING_X86_SIMD
+		/** Converts all complete 16 byte blocks with pshufb.
+		@return Returns the number of converted bytes. */
+		__attribute__((target("ssse3")))
+		uint64 swapSSSE3(uint8 *destination, const uint8 *source, const uint64 byteCount, const uint8 *shuffleMask)
+		{
+			const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffleMask));
+			uint64 byteIdx = 0;
+
+			for (; byteIdx + 16 <= byteCount; byteIdx += 16)
+			{
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + byteIdx));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + byteIdx), _mm_shuffle_epi8(block, mask));
+			}
+
+			return byteIdx;
+		}
+
+		/** Converts all complete 32 byte blocks with vpshufb, values never cross the 16 byte lanes.
+		@return Returns the number of converted bytes. */
+		__attribute__((target("avx2")))
+		uint64 swapAVX2(uint8 *destination, const uint8 *source, const uint64 byteCount, const uint8 *shuffleMask)
+		{
+			const __m128i laneMask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffleMask));
+			const __m256i mask = _mm256_broadcastsi128_si256(laneMask);
+			uint64 byteIdx = 0;
+
+			// two blocks per iteration to hide the shuffle latency
+			for (; byteIdx + 64 <= byteCount; byteIdx += 64)
+			{
+				const __m256i block0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + byteIdx));
+				const __m256i block1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + byteIdx + 32));
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + byteIdx), _mm256_shuffle_epi8(block0, mask));
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + byteIdx + 32), _mm256_shuffle_epi8(block1, mask));
+			}
+
+			for (; byteIdx + 32 <= byteCount; byteIdx += 32)
+			{
+				const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + byteIdx));
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + byteIdx), _mm256_shuffle_epi8(block, mask));
+			}
+
+			return byteIdx;
+		}
+
+		/** Chooses the widest kernel the CPU supports.
+		@return Returns the kernel or NULL if only scalar conversion is supported. */
+		SwapKernel selectKernel()
+		{
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2"))
+				return swapAVX2;
+			if (__builtin_cpu_supports("ssse3"))
+				return swapSSSE3;
+			return NULL;
+		}
+	#endif // BYTE_SWAPPING_X86_SIMD
+}
+
+bool Utilities::isHostBigEndian()
+{
+	const uint16 value = 1;
+	uint8 firstByte;
+	memcpy(&firstByte, &value, 1);
+	return (0 == firstByte);
+}
+
+void Utilities::swapBytes(void *destination, const void *source, const uint32 elementSize, const uint64 count)
+{
+	uint8 *target = reinterpret_cast<uint8 *>(destination);
+	const uint8 *values = reinterpret_cast<const uint8 *>(source);
+
+	if (1 == elementSize)
+	{
+		if (target != values)
+			memcpy(target, values, count);
+		return;
+	}
+
+	assert(2 == elementSize || 4 == elementSize || 8 == elementSize);
+	uint64 convertedBytes = 0;
+
+	#ifdef BYTE_SWAPPING_X86_SIMD
+		// CPU features are checked only once
+		static const SwapKernel kernel = selectKernel();
+		if (kernel)
+		{
+			const uint32 maskIdx = (2 == elementSize ? 0 : (4 == elementSize ? 1 : 2));
+			convertedBytes = kernel(target, values, count * elementSize, SHUFFLE_MASKS[maskIdx]);
+		}
+	#endif // BYTE_SWAPPING_X86_SIMD
+
+	const uint64 convertedCount = convertedBytes / elementSize;
+	swapScalar(target + convertedBytes, values + convertedBytes, elementSize, count - convertedCount);
+}
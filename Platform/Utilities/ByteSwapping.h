@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _UTILITIES_BYTE_SWAPPING_H_
+#define _UTILITIES_BYTE_SWAPPING_H_
+
+#include "Platform/DataTypes.h"
+
+namespace Utilities
+{
+	/** Checks the byte order of this machine.
+	@return Returns true if integers are stored in big endian format. */
+	bool isHostBigEndian();
+
+	/** Copies an array of 2, 4 or 8 byte values and reverses the byte order of each value, e.g., to convert big endian file data to little endian host data.
+		Uses AVX2 or SSSE3 byte shuffles if the CPU supports them. 1 byte values are only copied.
+	@param destination Set this to the memory which receives count converted values. It may be equal to source but must not partially overlap it.
+	@param source Set this to the values which are converted.
+	@param elementSize Set this to the size of a single value in bytes, must be 1, 2, 4 or 8.
+	@param count Set this to the number of values. */
+	void swapBytes(void *destination, const void *source, const uint32 elementSize, const uint64 count);
+}
+
+#endif // _UTILITIES_BYTE_SWAPPING_H_
@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <zlib.h>
+#include "Platform/FailureHandling/FileAccessException.h"
+#include "Platform/Storage/BufferedFileWriter.h"
+#include "Platform/Utilities/MeshCache.h"
+
+using namespace FailureHandling;
+using namespace Math;
+using namespace std;
+using namespace Storage;
+using namespace Utilities;
+
+static_assert(sizeof(Vector2) == 2 * sizeof(Real) && sizeof(Vector3) == 3 * sizeof(Real),
+	"MeshCache blocks require vectors without padding.");
+
+const char MeshCache::MAGIC[8] = { 'B', 'P', 'M', 'E', 'S', 'H', '\0', '\0' };
+
+namespace
+{
+	/** Returns the next multiple of MeshCache::BLOCK_ALIGNMENT.
+	@param offset Set this to a file offset in bytes.
+	@return Returns offset if it is aligned or the next aligned offset. */
+	inline uint64 alignOffset(const uint64 offset)
+	{
+		const uint64 alignment = MeshCache::BLOCK_ALIGNMENT;
+		return ((offset + alignment - 1) / alignment) * alignment;
+	}
+
+	/** Copies a cached attribute into an array.
+	@param target Is set to the count elements at source or cleared if source is NULL.
+	@param source Set this to the cached attribute or NULL if it is not stored.
+	@param count Set this to the number of elements at source. */
+	template <class T>
+	void assignOrClear(vector<T> &target, const T *source, const uint64 count)
+	{
+		if (source)
+			target.assign(source, source + count);
+		else
+			target.clear();
+	}
+
+	/** Extends a crc32 checksum by arbitrarily many bytes since zlib only processes 32 bit lengths at once.
+	@param checksum Set this to the checksum of the preceding bytes.
+	@param data Set this to the added bytes or NULL for size zero bytes.
+	@param size Set this to the number of added bytes.
+	@return Returns the checksum of the preceding and the added bytes. */
+	uint32 updateChecksum(uint32 checksum, const uint8 *data, uint64 size)
+	{
+		const uint8 zeros[MeshCache::BLOCK_ALIGNMENT] = { 0 };
+		const uint64 maxPartSize = (data ? 1u << 30 : MeshCache::BLOCK_ALIGNMENT);
+
+		while (size > 0)
+		{
+			const uint64 partSize = (size < maxPartSize ? size : maxPartSize);
+			checksum = (uint32) crc32(checksum, (data ? data : zeros), (uInt) partSize);
+
+			size -= partSize;
+			if (data)
+				data += partSize;
+		}
+
+		return checksum;
+	}
+}
+
+void MeshCache::save(const Path &fileName, const PlyVertices &vertices, const vector<uint32> &indices,
+	const uint64 sourceSize, const int64 sourceModificationTime)
+{
+	const uint64 vertexCount = vertices.mPositions.size();
+	assert(0 == indices.size() % 3);
+	assert(vertices.mNormals.empty() || vertices.mNormals.size() == vertexCount);
+	assert(vertices.mColors.empty() || vertices.mColors.size() == vertexCount);
+	assert(vertices.mUVCoords.empty() || vertices.mUVCoords.size() == vertexCount);
+	assert(vertices.mConfidences.empty() || vertices.mConfidences.size() == vertexCount);
+	assert(vertices.mValues.empty() || vertices.mValues.size() == vertexCount);
+	assert(vertices.mViewIDs.empty() || vertices.mViewIDs.size() == vertexCount * vertices.mViewsPerVertex);
+
+	// small meshes get 16 bit indices
+	vector<uint16> shortIndices;
+	const bool shortIndexing = (vertexCount <= MAX_16_BIT_VERTEX_COUNT);
+	if (shortIndexing)
+		shortIndices.assign(indices.begin(), indices.end());
+
+	// source of each block
+	const void *blocks[BLOCK_COUNT];
+	blocks[PlyVertexDecoder::ATTRIBUTE_POSITION] = vertices.mPositions.data();
+	blocks[PlyVertexDecoder::ATTRIBUTE_NORMAL] = (vertices.mNormals.empty() ? NULL : vertices.mNormals.data());
+	blocks[PlyVertexDecoder::ATTRIBUTE_COLOR] = (vertices.mColors.empty() ? NULL : vertices.mColors.data());
+	blocks[PlyVertexDecoder::ATTRIBUTE_UV_COORDS] = (vertices.mUVCoords.empty() ? NULL : vertices.mUVCoords.data());
+	blocks[PlyVertexDecoder::ATTRIBUTE_CONFIDENCE] = (vertices.mConfidences.empty() ? NULL : vertices.mConfidences.data());
+	blocks[PlyVertexDecoder::ATTRIBUTE_VALUE] = (vertices.mValues.empty() ? NULL : vertices.mValues.data());
+	blocks[PlyVertexDecoder::ATTRIBUTE_VIEW_IDS] = (vertices.mViewIDs.empty() ? NULL : vertices.mViewIDs.data());
+	blocks[BLOCK_INDICES] = (shortIndexing ? (const void *) shortIndices.data() : (const void *) indices.data());
+
+	// header with aligned block offsets
+	Header header;
+	memset(&header, 0, sizeof(Header));
+	memcpy(header.mMagic, MAGIC, sizeof(MAGIC));
+	header.mByteOrderMark = BYTE_ORDER_MARK;
+	header.mVersion = VERSION;
+	header.mSourceSize = sourceSize;
+	header.mSourceModificationTime = sourceModificationTime;
+	header.mVertexCount = vertexCount;
+	header.mTriangleCount = indices.size() / 3;
+	header.mRealSize = sizeof(Real);
+	header.mIndexSize = (shortIndexing ? sizeof(uint16) : sizeof(uint32));
+	header.mViewsPerVertex = (vertices.mViewIDs.empty() ? 0 : vertices.mViewsPerVertex);
+
+	// positions and indices are always stored, also for empty meshes
+	uint64 fileSize = sizeof(Header);
+	for (uint32 block = 0; block < BLOCK_COUNT; ++block)
+	{
+		if (!blocks[block] && PlyVertexDecoder::ATTRIBUTE_POSITION != block && BLOCK_INDICES != block)
+			continue;
+
+		header.mBlockOffsets[block] = alignOffset(fileSize);
+		fileSize = header.mBlockOffsets[block] + getBlockSize(header, block);
+	}
+	header.mFileSize = fileSize;
+
+	// checksum of the blocks and their padding
+	uint32 checksum = (uint32) crc32(0, Z_NULL, 0);
+	uint64 offset = sizeof(Header);
+	for (uint32 block = 0; block < BLOCK_COUNT; ++block)
+	{
+		if (0 == header.mBlockOffsets[block])
+			continue;
+
+		const uint64 blockSize = getBlockSize(header, block);
+		checksum = updateChecksum(checksum, NULL, header.mBlockOffsets[block] - offset);
+		checksum = updateChecksum(checksum, (const uint8 *) blocks[block], blockSize);
+		offset = header.mBlockOffsets[block] + blockSize;
+	}
+	header.mChecksum = checksum;
+
+	// write a temporary file which replaces fileName when it is complete
+	const Path temporaryName = Path::extendLeafName(fileName, ".tmp");
+	bool written = false;
+	{
+		BufferedFileWriter writer(temporaryName);
+		writer.write(&header, sizeof(Header), 1);
+
+		const uint8 zeros[BLOCK_ALIGNMENT] = { 0 };
+		for (uint32 block = 0; block < BLOCK_COUNT; ++block)
+		{
+			if (0 == header.mBlockOffsets[block])
+				continue;
+
+			writer.write(zeros, 1, header.mBlockOffsets[block] - writer.getSize());
+			writer.write(blocks[block], 1, getBlockSize(header, block));
+		}
+
+		written = (writer.flush() && !writer.errorOccured());
+	}
+
+	if (!written)
+	{
+		const int errorCode = errno;
+		remove(temporaryName.getCString());
+		throw FileAccessException("Could not write a mesh cache file.", temporaryName, errorCode);
+	}
+
+	#ifdef _WINDOWS
+		// rename does not replace existing files on Windows
+		remove(fileName.getCString());
+	#endif // _WINDOWS
+	if (0 != rename(temporaryName.getCString(), fileName.getCString()))
+	{
+		const int errorCode = errno;
+		remove(temporaryName.getCString());
+		throw FileAccessException("Could not replace a mesh cache file.", fileName, errorCode);
+	}
+}
+
+uint64 MeshCache::getBlockSize(const Header &header, const uint32 block)
+{
+	switch (block)
+	{
+	case PlyVertexDecoder::ATTRIBUTE_POSITION:
+	case PlyVertexDecoder::ATTRIBUTE_NORMAL:
+	case PlyVertexDecoder::ATTRIBUTE_COLOR:
+		return header.mVertexCount * sizeof(Vector3);
+
+	case PlyVertexDecoder::ATTRIBUTE_UV_COORDS:
+		return header.mVertexCount * sizeof(Vector2);
+
+	case PlyVertexDecoder::ATTRIBUTE_CONFIDENCE:
+	case PlyVertexDecoder::ATTRIBUTE_VALUE:
+		return header.mVertexCount * sizeof(Real);
+
+	case PlyVertexDecoder::ATTRIBUTE_VIEW_IDS:
+		return header.mVertexCount * header.mViewsPerVertex * sizeof(uint32);
+
+	case BLOCK_INDICES:
+		return header.mTriangleCount * 3 * header.mIndexSize;
+
+	default:
+		assert(false);
+		return 0;
+	}
+}
+
+MeshCache::MeshCache() :
+	mFile(NULL), mHeader(NULL)
+{
+
+}
+
+MeshCache::~MeshCache()
+{
+	close();
+}
+
+void MeshCache::close()
+{
+	delete mFile;
+	mFile = NULL;
+	mHeader = NULL;
+}
+
+void MeshCache::copyIndices(vector<uint32> &indices) const
+{
+	const uint64 indexCount = 3 * getTriangleCount();
+	const uint16 *shortIndices = getIndices16();
+	const uint32 *longIndices = getIndices32();
+
+	if (shortIndices)
+		indices.assign(shortIndices, shortIndices + indexCount);
+	else if (longIndices)
+		indices.assign(longIndices, longIndices + indexCount);
+	else
+		indices.clear();
+}
+
+void MeshCache::copyVertices(PlyVertices &vertices) const
+{
+	const uint64 vertexCount = getVertexCount();
+	const Vector3 *positions = getPositions();
+	const Vector3 *normals = getNormals();
+	const Vector3 *colors = getColors();
+	const Vector2 *uvCoords = getUVCoords();
+	const Real *confidences = getConfidences();
+	const Real *values = getValues();
+	const uint32 *viewIDs = getViewIDs();
+
+	assignOrClear(vertices.mPositions, positions, vertexCount);
+	assignOrClear(vertices.mNormals, normals, vertexCount);
+	assignOrClear(vertices.mColors, colors, vertexCount);
+	assignOrClear(vertices.mUVCoords, uvCoords, vertexCount);
+	assignOrClear(vertices.mConfidences, confidences, vertexCount);
+	assignOrClear(vertices.mValues, values, vertexCount);
+	assignOrClear(vertices.mViewIDs, viewIDs, vertexCount * getViewsPerVertex());
+
+	vertices.mViewsPerVertex = getViewsPerVertex();
+}
+
+bool MeshCache::open(const Path &fileName)
+{
+	close();
+
+	uint64 size;
+	int64 modificationTime;
+	if (!File::getFileInfo(size, modificationTime, fileName) || size < sizeof(Header))
+		return false;
+
+	mFile = new File(fileName, File::OPEN_READING_MAPPED, true);
+	const uint8 *data = mFile->getData();
+	size = mFile->getSize();
+
+	// compatible layout?
+	const Header *header = (const Header *) data;
+	if (!data || size < sizeof(Header) ||
+		0 != memcmp(header->mMagic, MAGIC, sizeof(MAGIC)) ||
+		BYTE_ORDER_MARK != header->mByteOrderMark ||
+		VERSION != header->mVersion ||
+		sizeof(Real) != header->mRealSize ||
+		(sizeof(uint16) != header->mIndexSize && sizeof(uint32) != header->mIndexSize) ||
+		size != header->mFileSize)
+	{
+		close();
+		return false;
+	}
+
+	// counts must fit into the file before they are multiplied by element sizes
+	const bool validCounts = (header->mVertexCount <= size && header->mTriangleCount <= size &&
+		(0 == header->mViewsPerVertex || header->mVertexCount <= size / header->mViewsPerVertex));
+	bool validBlocks = validCounts &&
+		0 != header->mBlockOffsets[PlyVertexDecoder::ATTRIBUTE_POSITION] && 0 != header->mBlockOffsets[BLOCK_INDICES];
+
+	for (uint32 block = 0; validBlocks && block < BLOCK_COUNT; ++block)
+	{
+		const uint64 offset = header->mBlockOffsets[block];
+		if (0 == offset)
+			continue;
+
+		validBlocks = (0 == offset % BLOCK_ALIGNMENT && offset >= sizeof(Header) && offset <= size &&
+			getBlockSize(*header, block) <= size - offset);
+	}
+
+	if (!validBlocks)
+	{
+		close();
+		return false;
+	}
+
+	mHeader = header;
+	return true;
+}
+
+bool MeshCache::verifyChecksum() const
+{
+	if (!mHeader)
+		return false;
+
+	const uint32 initialChecksum = (uint32) crc32(0, Z_NULL, 0);
+	const uint8 *blocks = mFile->getData() + sizeof(Header);
+	return (mHeader->mChecksum == updateChecksum(initialChecksum, blocks, mHeader->mFileSize - sizeof(Header)));
+}
@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _UTILITIES_MESH_CACHE_H_
+#define _UTILITIES_MESH_CACHE_H_
+
+#include <cassert>
+#include <vector>
+#include "Math/Vector2.h"
+#include "Math/Vector3.h"
+#include "Platform/DataTypes.h"
+#include "Platform/Storage/File.h"
+#include "Platform/Utilities/PlyVertexDecoder.h"
+
+namespace Utilities
+{
+	/// Native binary container of a triangle mesh which is used directly from mapped memory without any parsing or conversion.
+	/** A cache file starts with a Header which describes the stored vertex attributes, the numbers of vertices and triangles and
+		the offset of each block. Each vertex attribute is stored in its own block with exactly the memory layout of the corresponding
+		PlyVertices array, i.e., with Real values in host byte order, followed by a block of three 16 bit indices per triangle for
+		at most 65536 vertices and otherwise three 32 bit indices per triangle. All blocks start at multiples of BLOCK_ALIGNMENT bytes.
+		The header also stores a crc32 checksum of all bytes behind it as well as the size and modification time of the file which the mesh was
+		converted from, see File::getFileInfo(), so that outdated caches can be detected.
+		Caches are written in the byte order and precision of the writing build. Files of other builds are not opened but considered to be invalid.
+		See PlyFile::loadCached() for the automatic cache mode of ply files. */
+	class MeshCache
+	{
+	public:
+		/** Writes a mesh into a cache file. The file is written to a temporary file next to it which then replaces fileName,
+			so that readers never see partially written caches.
+		@param fileName Identifies the created or replaced cache file.
+		@param vertices Set this to the vertices of the mesh. Each attribute array must be empty or contain one entry per vertex.
+		@param indices Set this to three vertex indices per triangle.
+		@param sourceSize Set this to the size of the file the mesh was loaded from or 0.
+		@param sourceModificationTime Set this to the modification time of the file the mesh was loaded from or 0, see File::getFileInfo().
+		@throws FileAccessException Is thrown if the cache file cannot be written. */
+		static void save(const Storage::Path &fileName, const PlyVertices &vertices, const std::vector<uint32> &indices,
+			const uint64 sourceSize, const int64 sourceModificationTime);
+
+	public:
+		/** Creates a closed cache, see open(). */
+		MeshCache();
+
+		/** Unmaps the cache file if it is open. */
+		~MeshCache();
+
+		/** Unmaps the cache file. All pointers returned by the getters become invalid. */
+		void close();
+
+		/** Copies the vertex indices of all triangles independent of the stored index size.
+		@param indices Is set to three vertex indices per triangle. */
+		void copyIndices(std::vector<uint32> &indices) const;
+
+		/** Copies all vertex attributes into separate arrays, e.g., for meshes which are modified.
+		@param vertices Is filled with the cached attributes. Arrays of attributes which are not stored are cleared. */
+		void copyVertices(PlyVertices &vertices) const;
+
+		/** Returns the colors of all vertices.
+		@return Returns getVertexCount() colors in mapped memory or NULL if the cache has no colors. */
+		inline const Math::Vector3 *getColors() const;
+
+		/** Returns the confidences of all vertices.
+		@return Returns getVertexCount() confidences in mapped memory or NULL if the cache has no confidences. */
+		inline const Real *getConfidences() const;
+
+		/** Returns the 16 bit vertex indices of all triangles.
+		@return Returns 3 * getTriangleCount() indices in mapped memory or NULL if indices are stored with 32 bits, see getIndexSize(). */
+		inline const uint16 *getIndices16() const;
+
+		/** Returns the 32 bit vertex indices of all triangles.
+		@return Returns 3 * getTriangleCount() indices in mapped memory or NULL if indices are stored with 16 bits, see getIndexSize(). */
+		inline const uint32 *getIndices32() const;
+
+		/** Returns the size of each stored vertex index.
+		@return Returns 2 or 4 bytes. */
+		inline uint32 getIndexSize() const;
+
+		/** Returns the normals of all vertices.
+		@return Returns getVertexCount() normals in mapped memory or NULL if the cache has no normals. */
+		inline const Math::Vector3 *getNormals() const;
+
+		/** Returns the positions of all vertices.
+		@return Returns getVertexCount() positions in mapped memory or NULL if the cache has no positions. */
+		inline const Math::Vector3 *getPositions() const;
+
+		/** Returns the size of the file the mesh was converted from.
+		@return Returns the size which was passed to save(). */
+		inline uint64 getSourceSize() const;
+
+		/** Returns the modification time of the file the mesh was converted from.
+		@return Returns the modification time which was passed to save(). */
+		inline int64 getSourceModificationTime() const;
+
+		/** Returns the number of triangles of the mesh.
+		@return Returns the number of triangles with three indices each. */
+		inline uint64 getTriangleCount() const;
+
+		/** Returns the texture coordinates of all vertices.
+		@return Returns getVertexCount() texture coordinates in mapped memory or NULL if the cache has no texture coordinates. */
+		inline const Math::Vector2 *getUVCoords() const;
+
+		/** Returns the scalars of all vertices.
+		@return Returns getVertexCount() scalars in mapped memory or NULL if the cache has no scalars. */
+		inline const Real *getValues() const;
+
+		/** Returns the number of vertices of the mesh.
+		@return Returns the number of entries of each stored attribute. */
+		inline uint64 getVertexCount() const;
+
+		/** Returns the view IDs of all vertices.
+		@return Returns getViewsPerVertex() view IDs per vertex in mapped memory or NULL if the cache has no view IDs. */
+		inline const uint32 *getViewIDs() const;
+
+		/** Returns the number of view IDs of each vertex.
+		@return Returns the number of view IDs per vertex or 0 if the cache has no view IDs. */
+		inline uint32 getViewsPerVertex() const;
+
+		/** Checks whether an attribute is stored in the cache.
+		@param attribute Set this to the requested attribute.
+		@return Returns true if the cache has one entry of attribute per vertex. */
+		inline bool hasAttribute(const PlyVertexDecoder::ATTRIBUTE attribute) const;
+
+		/** Checks whether the cache was converted from a file with a specific size and modification time.
+		@param sourceSize Set this to the current size of the converted file.
+		@param sourceModificationTime Set this to the current modification time of the converted file, see File::getFileInfo().
+		@return Returns true if the cache is open and was created from a file with the same size and modification time. */
+		inline bool isUpToDate(const uint64 sourceSize, const int64 sourceModificationTime) const;
+
+		/** Returns true if a cache file is open.
+		@return Returns true if the last call of open() succeeded and close() was not called afterwards. */
+		inline bool isOpen() const;
+
+		/** Maps a cache file into memory and checks its header. The blocks are not read, see verifyChecksum().
+			An already open cache file is closed first.
+		@param fileName Identifies the cache file.
+		@return Returns false if the file does not exist, was written by a build with another byte order or precision,
+			has an unknown version or is too small for the blocks which are described by its header. */
+		bool open(const Storage::Path &fileName);
+
+		/** Reads all blocks once to compare their crc32 checksum with the checksum in the header, e.g., to detect corrupted files.
+		@return Returns true if the cache is open and its blocks are unchanged. */
+		bool verifyChecksum() const;
+
+	public:
+		static const uint32 BLOCK_ALIGNMENT = 64;				/// Each block starts at a multiple of BLOCK_ALIGNMENT bytes from the file start.
+		static const uint32 BYTE_ORDER_MARK = 0x01020304u;		/// Stored in host byte order to detect files of other byte orders.
+		static const uint32 MAX_16_BIT_VERTEX_COUNT = 1u << 16;	/// Meshes with at most this number of vertices store 16 bit indices.
+		static const uint32 VERSION = 1;						/// Version of the file layout which is written by save().
+
+	private:
+		/// Blocks of a cache file in file order, i.e., one block per PlyVertexDecoder::ATTRIBUTE followed by the indices.
+		enum BLOCK
+		{
+			BLOCK_INDICES = PlyVertexDecoder::ATTRIBUTE_COUNT,	/// Vertex indices of all triangles.
+			BLOCK_COUNT											/// Number of blocks.
+		};
+
+		/// Description of the cache content at the start of each cache file.
+		struct Header
+		{
+			char	mMagic[8];						/// MAGIC to identify cache files.
+			uint32	mByteOrderMark;					/// BYTE_ORDER_MARK in the byte order of the writer.
+			uint32	mVersion;						/// VERSION of the writer.
+			uint64	mFileSize;						/// Size of the complete cache file in bytes to detect truncated files.
+			uint64	mSourceSize;					/// Size of the file the mesh was converted from.
+			int64	mSourceModificationTime;		/// Modification time of the file the mesh was converted from.
+			uint64	mVertexCount;					/// Number of entries of each stored vertex attribute.
+			uint64	mTriangleCount;					/// Number of triangles with three vertex indices each.
+			uint64	mBlockOffsets[BLOCK_COUNT];		/// Offset of each block from the file start or 0 if the block is not stored.
+			uint32	mRealSize;						/// sizeof(Real) of the writer, i.e., 4 or 8.
+			uint32	mIndexSize;						/// Size of each vertex index in bytes, i.e., 2 or 4.
+			uint32	mViewsPerVertex;				/// Number of view IDs per vertex.
+			uint32	mChecksum;						/// crc32 checksum of all bytes behind the header.
+		};
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		MeshCache(const MeshCache &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		MeshCache &operator =(const MeshCache &rhs) { assert(false); return *this; }
+
+		/** Returns the size of a block.
+		@param header Set this to the header which describes the cache content.
+		@param block Set this to the block which is measured.
+		@return Returns the number of bytes of block without alignment padding. */
+		static uint64 getBlockSize(const Header &header, const uint32 block);
+
+		/** Returns a block in mapped memory.
+		@param block Set this to the requested block.
+		@return Returns the first byte of the block or NULL if it is not stored. */
+		inline const void *getBlock(const uint32 block) const;
+
+	private:
+		static const char MAGIC[8];		/// Identifies cache files.
+
+	private:
+		Storage::File	*mFile;		/// Mapped cache file or NULL if the cache is closed.
+		const Header	*mHeader;	/// Header at the start of the mapped file or NULL if the cache is closed.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline & template function definitions   /////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline const void *MeshCache::getBlock(const uint32 block) const
+	{
+		if (!mHeader || 0 == mHeader->mBlockOffsets[block])
+			return NULL;
+		return mFile->getData() + mHeader->mBlockOffsets[block];
+	}
+
+	inline const Math::Vector3 *MeshCache::getColors() const
+	{
+		return (const Math::Vector3 *) getBlock(PlyVertexDecoder::ATTRIBUTE_COLOR);
+	}
+
+	inline const Real *MeshCache::getConfidences() const
+	{
+		return (const Real *) getBlock(PlyVertexDecoder::ATTRIBUTE_CONFIDENCE);
+	}
+
+	inline const uint16 *MeshCache::getIndices16() const
+	{
+		return (2 == getIndexSize() ? (const uint16 *) getBlock(BLOCK_INDICES) : NULL);
+	}
+
+	inline const uint32 *MeshCache::getIndices32() const
+	{
+		return (4 == getIndexSize() ? (const uint32 *) getBlock(BLOCK_INDICES) : NULL);
+	}
+
+	inline uint32 MeshCache::getIndexSize() const
+	{
+		return (mHeader ? mHeader->mIndexSize : 0);
+	}
+
+	inline const Math::Vector3 *MeshCache::getNormals() const
+	{
+		return (const Math::Vector3 *) getBlock(PlyVertexDecoder::ATTRIBUTE_NORMAL);
+	}
+
+	inline const Math::Vector3 *MeshCache::getPositions() const
+	{
+		return (const Math::Vector3 *) getBlock(PlyVertexDecoder::ATTRIBUTE_POSITION);
+	}
+
+	inline uint64 MeshCache::getSourceSize() const
+	{
+		return (mHeader ? mHeader->mSourceSize : 0);
+	}
+
+	inline int64 MeshCache::getSourceModificationTime() const
+	{
+		return (mHeader ? mHeader->mSourceModificationTime : 0);
+	}
+
+	inline uint64 MeshCache::getTriangleCount() const
+	{
+		return (mHeader ? mHeader->mTriangleCount : 0);
+	}
+
+	inline const Math::Vector2 *MeshCache::getUVCoords() const
+	{
+		return (const Math::Vector2 *) getBlock(PlyVertexDecoder::ATTRIBUTE_UV_COORDS);
+	}
+
+	inline const Real *MeshCache::getValues() const
+	{
+		return (const Real *) getBlock(PlyVertexDecoder::ATTRIBUTE_VALUE);
+	}
+
+	inline uint64 MeshCache::getVertexCount() const
+	{
+		return (mHeader ? mHeader->mVertexCount : 0);
+	}
+
+	inline const uint32 *MeshCache::getViewIDs() const
+	{
+		return (const uint32 *) getBlock(PlyVertexDecoder::ATTRIBUTE_VIEW_IDS);
+	}
+
+	inline uint32 MeshCache::getViewsPerVertex() const
+	{
+		return (mHeader && 0 != mHeader->mBlockOffsets[PlyVertexDecoder::ATTRIBUTE_VIEW_IDS] ? mHeader->mViewsPerVertex : 0);
+	}
+
+	inline bool MeshCache::hasAttribute(const PlyVertexDecoder::ATTRIBUTE attribute) const
+	{
+		return (NULL != getBlock(attribute));
+	}
+
+	inline bool MeshCache::isOpen() const
+	{
+		return (NULL != mHeader);
+	}
+
+	inline bool MeshCache::isUpToDate(const uint64 sourceSize, const int64 sourceModificationTime) const
+	{
+		return (mHeader && sourceSize == mHeader->mSourceSize && sourceModificationTime == mHeader->mSourceModificationTime);
+	}
+}
+
+#endif // _UTILITIES_MESH_CACHE_H_
@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "Platform/Utilities/NumberFormatting.h"
+
+using namespace std;
+using namespace Utilities;
+
+namespace
+{
+	/// Powers of ten which are exactly representable as doubles.
+	const double EXACT_DOUBLE_POWERS[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	/// Largest exponent of EXACT_DOUBLE_POWERS.
+	const int32 MAX_EXACT_POWER = 22;
+
+	/// Powers of ten as integers.
+	const uint64 INTEGER_POWERS[] =
+	{
+		1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+		10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull,
+		1000000000000000ull, 10000000000000000ull, 100000000000000000ull
+	};
+
+	/// All two digit numbers for converting two digits at once.
+	const char DIGIT_PAIRS[] =
+		"0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+		"5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+	/** Multiplies a number with a power of ten with exact powers as far as possible.
+	@param value Set this to the scaled number.
+	@param exponent Set this to the power of ten.
+	@return Returns value * 10^exponent which is only correctly rounded if |exponent| <= MAX_EXACT_POWER. */
+	double scaleByPowerOf10(double value, int32 exponent)
+	{
+		for (; exponent > MAX_EXACT_POWER; exponent -= MAX_EXACT_POWER)
+			value *= EXACT_DOUBLE_POWERS[MAX_EXACT_POWER];
+		for (; exponent < -MAX_EXACT_POWER; exponent += MAX_EXACT_POWER)
+			value /= EXACT_DOUBLE_POWERS[MAX_EXACT_POWER];
+
+		return (exponent >= 0 ? value * EXACT_DOUBLE_POWERS[exponent] : value / EXACT_DOUBLE_POWERS[-exponent]);
+	}
+
+	/** Estimates the decimal exponent of a positive number.
+	@param value Set this to a positive finite number.
+	@return Returns floor(log10(value)) or a value which is one too small. */
+	int32 estimateDecimalExponent(const double value)
+	{
+		int binaryExponent;
+		frexp(value, &binaryExponent);
+		return (int32) floor((binaryExponent - 1) * 0.30102999566398120);
+	}
+
+	/** Rounds a positive number to a given number of significant digits.
+	@param mantissa Is set to the significant digits as integer in [10^(digitCount - 1), 10^digitCount).
+	@param decimalExponent Set this to an estimate of floor(log10(value)). Is set to the exponent of the first digit of mantissa.
+	@param value Set this to the positive finite number.
+	@param digitCount Set this to the number of significant digits, at most 17.
+	@param exactOnly Set this to true to fail if the scaling of value by a power of ten is not correctly rounded.
+	@return Returns false if exactOnly is true and the scaling is not correctly rounded. */
+	bool roundToDigits(uint64 &mantissa, int32 &decimalExponent, const double value, const uint32 digitCount, const bool exactOnly)
+	{
+		// the exponent estimate is corrected by at most one step, exact ties are rounded to even like printf
+		for (uint32 attempt = 0; attempt < 3; ++attempt)
+		{
+			const int32 scaleExponent = (int32) digitCount - 1 - decimalExponent;
+			if (exactOnly && (scaleExponent > MAX_EXACT_POWER || scaleExponent < -MAX_EXACT_POWER))
+				return false;
+
+			mantissa = (uint64) nearbyint(scaleByPowerOf10(value, scaleExponent));
+			if (mantissa >= INTEGER_POWERS[digitCount])
+				++decimalExponent;
+			else if (mantissa < INTEGER_POWERS[digitCount - 1])
+				--decimalExponent;
+			else
+				return true;
+		}
+
+		// rounding up to 10^digitCount
+		mantissa = INTEGER_POWERS[digitCount - 1];
+		return !exactOnly;
+	}
+
+	/** Writes digits like printf("%g") does for a precision of digitCount.
+	@param target Set this to enough writable characters.
+	@param negative Set this to true to write a minus sign.
+	@param mantissa Set this to the significant digits as integer in [10^(digitCount - 1), 10^digitCount).
+	@param decimalExponent Set this to the power of ten of the first digit of mantissa.
+	@param digitCount Set this to the number of significant digits of mantissa.
+	@return Returns a pointer behind the last written character. */
+	char *writeGeneral(char *target, const bool negative, uint64 mantissa, const int32 decimalExponent, uint32 digitCount)
+	{
+		// like %g: no trailing zeros
+		const bool scientific = (decimalExponent < -4 || decimalExponent >= (int32) digitCount);
+		while (digitCount > 1 && 0 == mantissa % 10)
+		{
+			mantissa /= 10;
+			--digitCount;
+		}
+
+		char digits[MAX_NUMBER_LENGTH];
+		formatUnsigned(digits, mantissa);
+
+		char *c = target;
+		if (negative)
+			*c++ = '-';
+
+		if (scientific)
+		{
+			// d.ddde+XX
+			*c++ = digits[0];
+			if (digitCount > 1)
+			{
+				*c++ = '.';
+				memcpy(c, digits + 1, digitCount - 1);
+				c += digitCount - 1;
+			}
+
+			*c++ = 'e';
+			*c++ = (decimalExponent < 0 ? '-' : '+');
+			const uint32 exponent = (uint32) (decimalExponent < 0 ? -decimalExponent : decimalExponent);
+			if (exponent < 10)
+				*c++ = '0';
+			return formatUnsigned(c, exponent);
+		}
+
+		if (decimalExponent < 0)
+		{
+			// 0.000ddd
+			*c++ = '0';
+			*c++ = '.';
+			for (int32 zeroIdx = -1; zeroIdx > decimalExponent; --zeroIdx)
+				*c++ = '0';
+			memcpy(c, digits, digitCount);
+			return c + digitCount;
+		}
+
+		// ddd.ddd or ddd000
+		const uint32 integerDigitCount = (uint32) decimalExponent + 1;
+		if (digitCount <= integerDigitCount)
+		{
+			memcpy(c, digits, digitCount);
+			c += digitCount;
+			for (uint32 zeroIdx = digitCount; zeroIdx < integerDigitCount; ++zeroIdx)
+				*c++ = '0';
+			return c;
+		}
+
+		memcpy(c, digits, integerDigitCount);
+		c += integerDigitCount;
+		*c++ = '.';
+		memcpy(c, digits + integerDigitCount, digitCount - integerDigitCount);
+		return c + (digitCount - integerDigitCount);
+	}
+
+	/** Writes a number with snprintf, e.g., for special values or numbers which cannot be formatted exactly without it.
+	@param target Set this to at least capacity writable characters.
+	@param capacity Set this to the number of writable characters at target.
+	@param format Set this to the printf format for a single double and an optional precision.
+	@param value Set this to the formatted number.
+	@return Returns a pointer behind the last written character. */
+	char *writeViaLibrary(char *target, const uint32 capacity, const char *format, const double value)
+	{
+		const int length = snprintf(target, capacity, format, value);
+		return target + (length < 0 ? 0 : (length >= (int) capacity ? capacity - 1 : length));
+	}
+}
+
+char *Utilities::formatFixed(char *target, const double value, const uint32 decimalCount)
+{
+	assert(decimalCount <= MAX_FIXED_DECIMALS);
+
+	// with less than 2^43 the product is precise enough to decide the rounding direction unless it is close to a tie
+	const double magnitude = fabs(value);
+	const double scaled = magnitude * EXACT_DOUBLE_POWERS[decimalCount];
+	const double FAST_LIMIT = 8796093022208.0;
+	const double TIE_DISTANCE = 1.0 / 256.0;
+
+	const double lower = floor(scaled);
+	const double fraction = scaled - lower;
+	if (!(scaled < FAST_LIMIT) || fabs(fraction - 0.5) < TIE_DISTANCE)
+	{
+		char format[8];
+		snprintf(format, sizeof(format), "%%.%uf", decimalCount);
+		return writeViaLibrary(target, MAX_FIXED_NUMBER_LENGTH, format, value);
+	}
+
+	// integer part & zero padded decimals
+	const uint64 rounded = (uint64) lower + (fraction > 0.5 ? 1 : 0);
+	const uint64 divisor = INTEGER_POWERS[decimalCount];
+
+	char *c = target;
+	if (signbit(value))
+		*c++ = '-';
+	c = formatUnsigned(c, rounded / divisor);
+	if (0 == decimalCount)
+		return c;
+
+	*c++ = '.';
+	uint64 decimals = rounded % divisor;
+	for (uint32 digitIdx = decimalCount; digitIdx > 0; --digitIdx)
+	{
+		c[digitIdx - 1] = (char) ('0' + decimals % 10);
+		decimals /= 10;
+	}
+
+	return c + decimalCount;
+}
+
+char *Utilities::formatReal(char *target, const double value)
+{
+	if (!isfinite(value))
+		return writeViaLibrary(target, MAX_NUMBER_LENGTH, "%.17g", value);
+
+	if (0.0 == value)
+	{
+		char *c = target;
+		if (signbit(value))
+			*c++ = '-';
+		*c++ = '0';
+		return c;
+	}
+
+	// try 15 and 16 significant digits which are exactly converted back if the mantissa fits into the 53 bit double mantissa
+	const double magnitude = fabs(value);
+	const uint64 MAX_EXACT_MANTISSA = 1ull << 53;
+
+	for (uint32 digitCount = 15; digitCount <= 16; ++digitCount)
+	{
+		uint64 mantissa;
+		int32 decimalExponent = estimateDecimalExponent(magnitude);
+		if (!roundToDigits(mantissa, decimalExponent, magnitude, digitCount, true) || mantissa > MAX_EXACT_MANTISSA)
+			continue;
+
+		// read back exactly like strtod does it for such numbers
+		const int32 scaleExponent = (int32) digitCount - 1 - decimalExponent;
+		const double readBack = (scaleExponent >= 0 ?
+			(double) mantissa / EXACT_DOUBLE_POWERS[scaleExponent] : (double) mantissa * EXACT_DOUBLE_POWERS[-scaleExponent]);
+		if (readBack == magnitude)
+			return writeGeneral(target, value < 0.0, mantissa, decimalExponent, digitCount);
+	}
+
+	return writeViaLibrary(target, MAX_NUMBER_LENGTH, "%.17g", value);
+}
+
+char *Utilities::formatReal(char *target, const float value)
+{
+	if (!isfinite(value))
+		return writeViaLibrary(target, MAX_NUMBER_LENGTH, "%.9g", value);
+
+	if (0.0f == value)
+	{
+		char *c = target;
+		if (signbit(value))
+			*c++ = '-';
+		*c++ = '0';
+		return c;
+	}
+
+	// 9 digits restore each float even if the last digit is off by one due to inexact scaling
+	const uint32 DIGIT_COUNT = 9;
+	const double magnitude = fabs((double) value);
+
+	uint64 mantissa;
+	int32 decimalExponent = estimateDecimalExponent(magnitude);
+	roundToDigits(mantissa, decimalExponent, magnitude, DIGIT_COUNT, false);
+	return writeGeneral(target, value < 0.0f, mantissa, decimalExponent, DIGIT_COUNT);
+}
+
+char *Utilities::formatSigned(char *target, const int64 value)
+{
+	if (value >= 0)
+		return formatUnsigned(target, (uint64) value);
+
+	// -INT64_MIN is not representable as int64
+	*target = '-';
+	return formatUnsigned(target + 1, 0 - (uint64) value);
+}
+
+char *Utilities::formatUnsigned(char *target, const uint64 value)
+{
+	// write backwards two digits at a time
+	char digits[MAX_NUMBER_LENGTH];
+	char *c = digits + MAX_NUMBER_LENGTH;
+	uint64 rest = value;
+
+	while (rest >= 100)
+	{
+		const uint32 pairIdx = (uint32) (rest % 100) * 2;
+		rest /= 100;
+		*--c = DIGIT_PAIRS[pairIdx + 1];
+		*--c = DIGIT_PAIRS[pairIdx];
+	}
+
+	if (rest >= 10)
+	{
+		const uint32 pairIdx = (uint32) rest * 2;
+		*--c = DIGIT_PAIRS[pairIdx + 1];
+		*--c = DIGIT_PAIRS[pairIdx];
+	}
+	else
+	{
+		*--c = (char) ('0' + rest);
+	}
+
+	const size_t length = (digits + MAX_NUMBER_LENGTH) - c;
+	memcpy(target, c, length);
+	return target + length;
+}
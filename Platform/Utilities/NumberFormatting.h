@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _UTILITIES_NUMBER_FORMATTING_H_
+#define _UTILITIES_NUMBER_FORMATTING_H_
+
+#include "Platform/DataTypes.h"
+
+namespace Utilities
+{
+	/// Number of characters which are always enough for formatReal(), formatSigned() and formatUnsigned().
+	const uint32 MAX_NUMBER_LENGTH = 32;
+
+	/// Maximum number of decimals of formatFixed().
+	const uint32 MAX_FIXED_DECIMALS = 9;
+
+	/// Number of characters which are always enough for formatFixed(), e.g., 309 integer digits of the largest doubles.
+	const uint32 MAX_FIXED_NUMBER_LENGTH = 330;
+
+	/** Writes a floating point number with a fixed number of decimals exactly like printf("%.*f") without locale lookups or a terminating zero.
+		Numbers with up to about 13 significant integer and decimal digits are converted without printf, all others are passed to snprintf.
+	@param target Set this to at least MAX_FIXED_NUMBER_LENGTH writable characters.
+	@param value Set this to the formatted number.
+	@param decimalCount Set this to the number of digits behind the decimal point, at most MAX_FIXED_DECIMALS, e.g., 6 like "%f".
+	@return Returns a pointer behind the last written character. */
+	char *formatFixed(char *target, const double value, const uint32 decimalCount);
+
+	/** Writes the shortest decimal number with at most 17 significant digits which is read back as exactly the same double, formatted like printf("%g").
+		Numbers with up to 16 significant digits and usual exponents are converted without printf, all others are written like printf("%.17g").
+	@param target Set this to at least MAX_NUMBER_LENGTH writable characters.
+	@param value Set this to the formatted number.
+	@return Returns a pointer behind the last written character. No terminating zero is written. */
+	char *formatReal(char *target, const double value);
+
+	/** Writes 9 significant digits, which are always read back as exactly the same float, without trailing zeros like printf("%.9g").
+	@param target Set this to at least MAX_NUMBER_LENGTH writable characters.
+	@param value Set this to the formatted number.
+	@return Returns a pointer behind the last written character. No terminating zero is written. */
+	char *formatReal(char *target, const float value);
+
+	/** Writes a decimal integer like printf("%lld") without locale lookups or a terminating zero.
+	@param target Set this to at least MAX_NUMBER_LENGTH writable characters.
+	@param value Set this to the formatted integer.
+	@return Returns a pointer behind the last written character. */
+	char *formatSigned(char *target, const int64 value);
+
+	/** Writes a decimal integer like printf("%llu") without locale lookups or a terminating zero.
+	@param target Set this to at least MAX_NUMBER_LENGTH writable characters.
+	@param value Set this to the formatted integer.
+	@return Returns a pointer behind the last written character. */
+	char *formatUnsigned(char *target, const uint64 value);
+}
+
+#endif // _UTILITIES_NUMBER_FORMATTING_H_
@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "Platform/Utilities/NumberParsing.h"
+
+using namespace std;
+using namespace Utilities;
+
+namespace
+{
+	/// Maximum number of significant decimal digits which always fit into an uint64.
+	const uint32 MAX_SIGNIFICANT_DIGITS = 19;
+
+	/// Powers of ten which are exactly representable as doubles.
+	const double EXACT_DOUBLE_POWERS[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	/// Powers of ten which are exactly representable as floats.
+	const float EXACT_FLOAT_POWERS[] =
+	{
+		1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+	};
+
+	/// Decimal floating point number split into its parts, see scanDecimal().
+	struct Decimal
+	{
+		uint64		mMantissa;	/// At most MAX_SIGNIFICANT_DIGITS significant digits.
+		int64		mExponent;	/// Power of ten which mMantissa is multiplied with.
+		const char	*mEnd;		/// Points behind the last character of the number.
+		bool		mNegative;	/// Is true if the number has a minus sign.
+		bool		mTruncated;	/// Is true if nonzero digits were dropped since there are more than MAX_SIGNIFICANT_DIGITS.
+	};
+
+	/** Checks whether a character is a decimal digit without locale lookups.
+	@param c Set this to the checked character.
+	@return Returns true for '0' to '9'. */
+	inline bool isDigit(const char c)
+	{
+		return (c >= '0' && c <= '9');
+	}
+
+	/** Splits a decimal number of the format [+-]digits[.digits][(e|E)[+-]digits] into its parts.
+	@param decimal Is filled with the parts of the number.
+	@param start Set this to the first character of the number.
+	@param end Set this to the end of the readable characters.
+	@return Returns false if there is no decimal number, e.g., for inf, nan or hexadecimal numbers which are left to strtod. */
+	bool scanDecimal(Decimal &decimal, const char *start, const char *end)
+	{
+		const char *c = start;
+		decimal.mMantissa = 0;
+		decimal.mExponent = 0;
+		decimal.mNegative = false;
+		decimal.mTruncated = false;
+
+		// sign
+		if (c < end && ('+' == *c || '-' == *c))
+		{
+			decimal.mNegative = ('-' == *c);
+			++c;
+		}
+
+		// hexadecimal numbers
+		if (c + 1 < end && '0' == c[0] && ('x' == c[1] || 'X' == c[1]))
+			return false;
+
+		// integer part, leading zeros are not significant
+		uint32 significantCount = 0;
+		bool anyDigit = false;
+		for (; c < end && isDigit(*c); ++c)
+		{
+			const uint32 digit = *c - '0';
+			anyDigit = true;
+
+			if (0 == decimal.mMantissa && 0 == digit)
+				continue;
+
+			if (significantCount < MAX_SIGNIFICANT_DIGITS)
+			{
+				decimal.mMantissa = decimal.mMantissa * 10 + digit;
+				++significantCount;
+			}
+			else
+			{
+				++decimal.mExponent;
+				decimal.mTruncated |= (0 != digit);
+			}
+		}
+
+		// fraction
+		if (c < end && '.' == *c)
+		{
+			for (++c; c < end && isDigit(*c); ++c)
+			{
+				const uint32 digit = *c - '0';
+				anyDigit = true;
+
+				if (0 == decimal.mMantissa && 0 == digit)
+				{
+					--decimal.mExponent;
+					continue;
+				}
+
+				if (significantCount < MAX_SIGNIFICANT_DIGITS)
+				{
+					decimal.mMantissa = decimal.mMantissa * 10 + digit;
+					++significantCount;
+					--decimal.mExponent;
+				}
+				else
+				{
+					decimal.mTruncated |= (0 != digit);
+				}
+			}
+		}
+
+		if (!anyDigit)
+			return false;
+
+		// exponent, only if there is at least one digit
+		if (c < end && ('e' == *c || 'E' == *c))
+		{
+			const char *exponentStart = c + 1;
+			bool negativeExponent = false;
+			if (exponentStart < end && ('+' == *exponentStart || '-' == *exponentStart))
+			{
+				negativeExponent = ('-' == *exponentStart);
+				++exponentStart;
+			}
+
+			if (exponentStart < end && isDigit(*exponentStart))
+			{
+				// saturate far beyond the double range
+				int64 exponent = 0;
+				for (c = exponentStart; c < end && isDigit(*c); ++c)
+					if (exponent < 100000)
+						exponent = exponent * 10 + (*c - '0');
+
+				decimal.mExponent += (negativeExponent ? -exponent : exponent);
+			}
+		}
+
+		decimal.mEnd = c;
+		return true;
+	}
+
+	/** Calls strtod or strtof depending on T.
+	@param text Set this to a zero terminated number.
+	@param end Is set to the end of the number.
+	@return Returns the converted number. */
+	template <class T>
+	T convert(const char *text, char **end);
+
+	template <>
+	double convert<double>(const char *text, char **end)
+	{
+		return strtod(text, end);
+	}
+
+	template <>
+	float convert<float>(const char *text, char **end)
+	{
+		return strtof(text, end);
+	}
+
+	/** Converts a number via strtod or strtof on a zero terminated copy since the characters might not be zero terminated.
+	@param value Is set to the converted number.
+	@param start Set this to the first character of the number.
+	@param end Set this to the end of the readable characters.
+	@param numberEnd Set this to the end of the number if it is known or to NULL to let strtod find it within the first 127 characters.
+	@return Returns a pointer behind the last converted character or start if there is no number. */
+	template <class T>
+	const char *parseViaLibrary(T &value, const char *start, const char *end, const char *numberEnd)
+	{
+		char buffer[128];
+		string longNumber;
+		const char *text = buffer;
+
+		size_t length = (size_t) ((numberEnd ? numberEnd : end) - start);
+		if (length >= sizeof(buffer))
+		{
+			if (numberEnd)
+			{
+				longNumber.assign(start, length);
+				text = longNumber.c_str();
+			}
+			else
+			{
+				length = sizeof(buffer) - 1;
+			}
+		}
+
+		if (text == buffer)
+		{
+			memcpy(buffer, start, length);
+			buffer[length] = '\0';
+		}
+
+		char *textEnd = NULL;
+		value = convert<T>(text, &textEnd);
+		return start + (textEnd - text);
+	}
+
+	/** Implements parseReal() for floats and doubles.
+	@param exactPowers Set this to the powers of ten which are exact for T.
+	@param maxPowerExponent Set this to the largest exponent in exactPowers.
+	@param maxExactMantissa Set this to the largest integer up to which all integers are exact for T. */
+	template <class T>
+	const char *parse(T &value, const char *start, const char *end,
+		const T *exactPowers, const int64 maxPowerExponent, const uint64 maxExactMantissa)
+	{
+		value = 0;
+		if (start >= end || isWhiteSpace(*start))
+			return start;
+
+		Decimal decimal;
+		if (!scanDecimal(decimal, start, end))
+			return parseViaLibrary(value, start, end, NULL);
+
+		// exact mantissa & power of ten -> a single correctly rounded operation
+		if (!decimal.mTruncated && decimal.mMantissa <= maxExactMantissa &&
+			decimal.mExponent >= -maxPowerExponent && decimal.mExponent <= maxPowerExponent)
+		{
+			T result = (T) decimal.mMantissa;
+			if (decimal.mExponent < 0)
+				result /= exactPowers[-decimal.mExponent];
+			else
+				result *= exactPowers[decimal.mExponent];
+
+			value = (decimal.mNegative ? -result : result);
+			return decimal.mEnd;
+		}
+
+		return parseViaLibrary(value, start, end, decimal.mEnd);
+	}
+}
+
+const char *Utilities::parseInteger(int64 &value, const char *start, const char *end)
+{
+	const char *c = start;
+	bool negative = false;
+	value = 0;
+
+	if (c < end && ('+' == *c || '-' == *c))
+	{
+		negative = ('-' == *c);
+		++c;
+	}
+
+	// accumulate the magnitude and detect overflows
+	const char *digitsStart = c;
+	const uint64 MAX_MAGNITUDE = (uint64) -1;
+	uint64 magnitude = 0;
+	bool overflow = false;
+
+	for (; c < end && isDigit(*c); ++c)
+	{
+		const uint32 digit = *c - '0';
+		if (magnitude > (MAX_MAGNITUDE - digit) / 10)
+			overflow = true;
+		else
+			magnitude = magnitude * 10 + digit;
+	}
+
+	if (c == digitsStart)
+		return start;
+
+	// saturate like strtoll
+	const uint64 MIN_MAGNITUDE = ((uint64) 1) << 63;
+	if (negative)
+		value = ((overflow || magnitude >= MIN_MAGNITUDE) ? (int64) MIN_MAGNITUDE : -(int64) magnitude);
+	else
+		value = ((overflow || magnitude >= MIN_MAGNITUDE) ? (int64) (MIN_MAGNITUDE - 1) : (int64) magnitude);
+
+	return c;
+}
+
+const char *Utilities::parseReal(double &value, const char *start, const char *end)
+{
+	return parse<double>(value, start, end, EXACT_DOUBLE_POWERS, 22, ((uint64) 1) << 53);
+}
+
+const char *Utilities::parseReal(float &value, const char *start, const char *end)
+{
+	return parse<float>(value, start, end, EXACT_FLOAT_POWERS, 10, ((uint64) 1) << 24);
+}
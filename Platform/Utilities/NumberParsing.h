@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _UTILITIES_NUMBER_PARSING_H_
+#define _UTILITIES_NUMBER_PARSING_H_
+
+#include "Platform/DataTypes.h"
+
+namespace Utilities
+{
+	/** Checks whether a character can be part of an ASCII encoded number, e.g., to find the end of a number token.
+	@param c Set this to the checked character.
+	@return Returns true for digits, letters (exponents, hexadecimal digits, inf, nan), signs and the decimal point. */
+	inline bool isNumberCharacter(const char c);
+
+	/** Checks whether a character is white space like isspace in the "C" locale.
+	@param c Set this to the checked character.
+	@return Returns true for ' ', '\t', '\n', '\v', '\f' and '\r'. */
+	inline bool isWhiteSpace(const char c);
+
+	/** Parses a decimal integer with optional sign at the beginning of a character range like strtoll, but without locale or string length lookups.
+	@param value Is set to the parsed integer, saturated to the int64 range like strtoll, or to 0 if there is no integer.
+	@param start Set this to the first character of the number. Leading white space is not skipped.
+	@param end Set this to the end of the readable characters.
+	@return Returns a pointer behind the last character of the integer or start if there is no integer. */
+	const char *parseInteger(int64 &value, const char *start, const char *end);
+
+	/** Parses a floating point number at the beginning of a character range with exactly the same result as strtod.
+		Usual decimal numbers with up to 19 significant digits and small exponents are converted without strtod, all other numbers are passed to strtod.
+	@param value Is set to the parsed number or to 0 if there is no number.
+	@param start Set this to the first character of the number. Leading white space is not skipped.
+	@param end Set this to the end of the readable characters.
+	@return Returns a pointer behind the last character of the number or start if there is no number. */
+	const char *parseReal(double &value, const char *start, const char *end);
+
+	/** Same as parseReal() for doubles, but with exactly the same result as strtof. */
+	const char *parseReal(float &value, const char *start, const char *end);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline bool isNumberCharacter(const char c)
+	{
+		return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || '+' == c || '-' == c || '.' == c;
+	}
+
+	inline bool isWhiteSpace(const char c)
+	{
+		return (' ' == c || (c >= '\t' && c <= '\r'));
+	}
+}
+
+#endif // _UTILITIES_NUMBER_PARSING_H_
@@ -7,6 +7,7 @@
  */
 #include <cctype>
 #include "Platform/Storage/File.h"
+#include "Platform/Storage/TextTokenizer.h"
 #include "Platform/Utilities/HelperFunctions.h"
 #include "Platform/Utilities/ParametersManager.h"
 
@@ -26,17 +27,19 @@ ParametersManager::ParametersManager(const Path &fileName, const string &nameSpa
 void ParametersManager::loadFromFile(const Path &fileName, const string &nameSpace)
 {
 	const string beginning = (nameSpace.empty() ? "" : nameSpace + "::");
-	File file(fileName, File::OPEN_READING, false);
+	File file(fileName, File::OPEN_READING_MAPPED, false);
 	if (file.errorOccured())
 		return;
 	
 	// load file data
+	TextTokenizer tokenizer(file);
+	TextTokenizer::Token line;
 	string textLine;
 	vector<string> lineParts;
 
-	while (file.hasLeftData())
+	while (tokenizer.readLine(line))
 	{
-		file.readTextLine(textLine);
+		textLine.assign(line.mStart, line.mEnd);
 
 		// comment?
 		const size_t commentStart = textLine.find("//");
@@ -9,12 +9,21 @@
 #ifdef _DEBUG
 	#include <iostream>
 #endif // _DEBUG
+#include <cerrno>
+#include <cstring>
+#include <memory>
 #include <sstream>
 #include "Graphics/VerticesDescription.h"
 #include "Math/Vector2.h"
+#include "Platform/FailureHandling/FileAccessException.h"
 #include "Platform/FailureHandling/FileCorruptionException.h"
+#include "Platform/Storage/BufferedFileWriter.h"
+#include "Platform/Utilities/ByteSwapping.h"
 #include "Platform/Utilities/HelperFunctions.h"
+#include "Platform/Utilities/NumberParsing.h"
 #include "Platform/Utilities/PlyFile.h"
+#include "Platform/Utilities/PlyMeshEncoder.h"
+#include "Platform/Utilities/PlyTextParser.h"
 
 using namespace FailureHandling;
 using namespace Graphics;
@@ -23,6 +32,21 @@ using namespace std;
 using namespace Storage;
 using namespace Utilities;
 
+namespace
+{
+	/** Copies a possibly unaligned value which is already in host byte order.
+	@param bytes Set this to the first byte of the value.
+	@return Returns the value. */
+	template <class T>
+	inline T loadHostValue(const uint8 *bytes)
+	{
+		T value;
+		memcpy(&value, bytes, sizeof(T));
+		return value;
+	}
+}
+
+const char *PlyFile::CACHE_FILE_EXTENSION = ".meshcache";
 const char *PlyFile::DELIMETERS = " \r\n";
 const char *PlyFile::HEADER_COMMENT_START = "comment";
 const char *PlyFile::HEADER_ELEMENT = "element";
@@ -35,10 +59,69 @@ const char *PlyFile::HEADER_START_LINE = "ply";
 const char *PlyFile::HEADER_VERTEX = "vertex";
 const char *PlyFile::HEADER_VERTEX_INDICES = "vertex_indices";
 
+Path PlyFile::getCachePath(const Path &fileName)
+{
+	return Path::extendLeafName(fileName, CACHE_FILE_EXTENSION);
+}
+
+void PlyFile::loadCached(MeshCache &cache, const Path &fileName, const bool verifyChecksum)
+{
+	uint64 size;
+	int64 modificationTime;
+	if (!File::getFileInfo(size, modificationTime, fileName))
+		throw FileAccessException("Could not query a ply file for its mesh cache.", fileName, errno);
+
+	// reuse an up to date cache
+	const Path cachePath = getCachePath(fileName);
+	if (cache.open(cachePath) && cache.isUpToDate(size, modificationTime) && (!verifyChecksum || cache.verifyChecksum()))
+		return;
+	cache.close();
+
+	// convert the ply file
+	PlyVertices vertices;
+	vector<uint32> indices;
+	{
+		PlyFile file(fileName, File::OPEN_READING_MAPPED, true);
+
+		VerticesDescription verticesFormat;
+		FacesDescription facesFormat;
+		file.loadHeader(verticesFormat, &facesFormat);
+		file.loadVertices(vertices, verticesFormat);
+		file.loadTriangles(indices, facesFormat);
+	}
+
+	MeshCache::save(cachePath, vertices, indices, size, modificationTime);
+	if (!cache.open(cachePath))
+		throw FileCorruptionException("Could not open a freshly written mesh cache file.", cachePath);
+}
+
 PlyFile::PlyFile(const Path &fileName, FileMode mode, bool binaryFile) :
-	File(fileName, mode, binaryFile), mName(fileName)
+	File(fileName, mode, binaryFile), mTextOffset(0), mName(fileName)
 {
+	// ply files are parsed from front to back
+	if (OPEN_READING_MAPPED == mode)
+		advise(ACCESS_SEQUENTIAL);
+}
 
+const char *PlyFile::getRemainingText(const char *&end)
+{
+	const uint64 position = getPosition();
+	if (getData())
+	{
+		end = (const char *) getData() + getSize();
+		return (const char *) getData() + position;
+	}
+
+	// read the rest of the file once for all following elements
+	if (mText.empty() || position < mTextOffset || position > mTextOffset + mText.size())
+	{
+		mText.clear();
+		mTextOffset = position;
+		File::read(mText, COPY_CHUNK_SIZE);
+	}
+
+	end = (const char *) mText.data() + mText.size();
+	return (const char *) mText.data() + (position - mTextOffset);
 }
 
 void PlyFile::loadHeader(VerticesDescription &verticesFormat, FacesDescription *facesFormat)
@@ -234,6 +317,79 @@ void PlyFile::loadVertexStructure(VerticesDescription &structure)
 	}
 }
 
+void PlyFile::loadVertices(PlyVertices &vertices, const VerticesDescription &format)
+{
+	const PlyVertexDecoder decoder(format);
+	decoder.prepare(vertices, format.getElementCount());
+	loadVertices(&vertices, NULL, decoder, format.getElementCount());
+}
+
+void PlyFile::loadInterleavedVertices(uint8 *buffer, const PlyVertexDecoder::InterleavedLayout &layout, const VerticesDescription &format)
+{
+	const PlyVertexDecoder decoder(format, layout);
+	loadVertices(NULL, buffer, decoder, format.getElementCount());
+}
+
+void PlyFile::loadVertices(PlyVertices *vertices, uint8 *buffer, const PlyVertexDecoder &decoder, const uint64 vertexCount)
+{
+	if (!decoder.isValid())
+		throw FileCorruptionException("Unsupported vertex property type or semantic.", mName);
+
+	// text vertices have no fixed size and are parsed line by line
+	if (ENCODING_ASCII == mEncoding)
+	{
+		const uint64 position = getPosition();
+		const char *end = NULL;
+		const char *start = getRemainingText(end);
+
+		PlyTextParser parser(mName);
+		const char *sectionEnd = (vertices ? parser.parseVertices(*vertices, decoder, vertexCount, start, end) :
+			parser.parseVertices(buffer, decoder, vertexCount, start, end));
+		setPosition(position + (sectionEnd - start));
+		return;
+	}
+
+	const uint64 vertexSize = decoder.getVertexSize();
+	if (0 == vertexSize || 0 == vertexCount)
+		return;
+
+	// mapped files are decoded in place
+	if (getData())
+	{
+		const uint64 start = getPosition();
+		if ((getSize() - start) / vertexSize < vertexCount)
+			throw FileCorruptionException("The ply file ends within its vertices.", mName);
+
+		if (vertices)
+			decoder.decode(*vertices, 0, getData() + start, vertexCount);
+		else
+			decoder.decode(buffer, 0, getData() + start, vertexCount);
+		setPosition(start + vertexCount * vertexSize);
+		return;
+	}
+
+	// other files are read ahead asynchronously while chunks of complete vertices are decoded
+	const uint64 start = getPosition();
+	const uint64 chunkVertexCount = (vertexSize < VERTEX_CHUNK_SIZE ? VERTEX_CHUNK_SIZE / vertexSize : 1);
+	vector<uint8> chunk((size_t) (chunkVertexCount * vertexSize));
+	AsyncFileReader reader(mName, VERTEX_CHUNK_SIZE, AsyncFileReader::DEFAULT_BUFFER_COUNT, AsyncFileReader::BACKEND_IO_URING,
+		start, vertexCount * vertexSize);
+
+	for (uint64 firstVertexIdx = 0; firstVertexIdx < vertexCount; firstVertexIdx += chunkVertexCount)
+	{
+		const uint64 count = (vertexCount - firstVertexIdx < chunkVertexCount ? vertexCount - firstVertexIdx : chunkVertexCount);
+		if (count * vertexSize != reader.read(chunk.data(), count * vertexSize))
+			throw FileCorruptionException("The ply file ends within its vertices.", mName);
+
+		if (vertices)
+			decoder.decode(*vertices, firstVertexIdx, chunk.data(), count);
+		else
+			decoder.decode(buffer, firstVertexIdx, chunk.data(), count);
+	}
+
+	setPosition(start + vertexCount * vertexSize);
+}
+
 void PlyFile::loadTriangles(vector<uint32> &indices, const FacesDescription &facesFormat)
 {
 	// get format
@@ -243,10 +399,37 @@ void PlyFile::loadTriangles(vector<uint32> &indices, const FacesDescription &fac
 	const uint32 faceCount = facesFormat.getElementCount();
 	const uint32 propertyCount = facesFormat.getPropertyCount();
 
+	// text faces are parsed line by line
+	if (ENCODING_ASCII == mEncoding)
+	{
+		const uint64 position = getPosition();
+		const char *end = NULL;
+		const char *start = getRemainingText(end);
+
+		PlyTextParser parser(mName);
+		const char *sectionEnd = parser.parseFaces(indices, facesFormat, start, end);
+		setPosition(position + (sectionEnd - start));
+		return;
+	}
+
 	// reserve memory
 	const uint32 maxTriangles = faceCount * 3 * 2; // file potentially contains quads
 	indices.reserve(maxTriangles);
 
+	// files which are not mapped are read ahead asynchronously from the first face on while the faces are decoded
+	if (!getData())
+	{
+		AsyncFileReader reader(mName, AsyncFileReader::DEFAULT_CHUNK_SIZE, AsyncFileReader::DEFAULT_BUFFER_COUNT,
+			AsyncFileReader::BACKEND_IO_URING, getPosition());
+		const bool swap = (isHostBigEndian() != (ENCODING_BINARY_BIG_ENDIAN == mEncoding));
+
+		for (uint32 faceIdx = 0; faceIdx < faceCount; ++faceIdx)
+			readBinaryFace(indices, reader, facesFormat, swap);
+
+		setPosition(reader.getPosition());
+		return;
+	}
+
 	// read each face
 	for (uint32 faceIdx = 0; faceIdx < faceCount; ++faceIdx)
 	{
@@ -263,6 +446,88 @@ void PlyFile::loadTriangles(vector<uint32> &indices, const FacesDescription &fac
 	}
 }
 
+void PlyFile::readBinaryFace(vector<uint32> &indices, AsyncFileReader &reader, const FacesDescription &facesFormat, const bool swap)
+{
+	const ElementsSyntax &listSizeTypes = facesFormat.getListSizeTypes();
+	const ElementsSyntax &types = facesFormat.getTypeStructure();
+	const uint32 propertyCount = facesFormat.getPropertyCount();
+
+	for (uint32 propertyIdx = 0; propertyIdx < propertyCount; ++propertyIdx)
+	{
+		// single properties of faces are ignored
+		const ElementsDescription::TYPES listSizeType = listSizeTypes[propertyIdx];
+		if (ElementsDescription::TYPE_INVALID == listSizeType)
+		{
+			readBinaryFaceValue(reader, types[propertyIdx], swap);
+			continue;
+		}
+
+		// read & check list size
+		const uint32 listSize = readBinaryFaceValue(reader, listSizeType, swap);
+		if (listSize > 4 || listSize < 3)
+			throw FileCorruptionException("Unsupported index list size for a face.", mName);
+
+		uint32 corners[4];
+		for (uint32 cornerIdx = 0; cornerIdx < listSize; ++cornerIdx)
+			corners[cornerIdx] = readBinaryFaceValue(reader, types[propertyIdx], swap);
+
+		// convert quad to two triangles, keep winding order
+		indices.insert(indices.end(), corners, corners + 3);
+		if (4 == listSize)
+		{
+			indices.push_back(corners[0]);
+			indices.push_back(corners[2]);
+			indices.push_back(corners[3]);
+		}
+	}
+}
+
+uint32 PlyFile::readBinaryFaceValue(AsyncFileReader &reader, const ElementsDescription::TYPES type, const bool swap)
+{
+	const uint32 size = PlyVertexDecoder::getTypeSize(type);
+	if (0 == size)
+		throw FileCorruptionException("Unsupported ElementsDescription type.", mName);
+
+	// copy the value & convert it to host order
+	uint8 bytes[sizeof(double)];
+	if (size != reader.read(bytes, size))
+		throw FileCorruptionException("The ply file ends within its faces.", mName);
+	if (swap)
+		swapBytes(bytes, bytes, size, 1);
+
+	switch (type)
+	{
+		case ElementsDescription::TYPE_DOUBLE:
+		case ElementsDescription::TYPE_FLOAT64:
+			return (uint32) loadHostValue<double>(bytes);
+
+		case ElementsDescription::TYPE_FLOAT:
+		case ElementsDescription::TYPE_FLOAT32:
+			return (uint32) loadHostValue<float>(bytes);
+
+		case ElementsDescription::TYPE_UCHAR:
+		case ElementsDescription::TYPE_UINT8:
+			return bytes[0];
+
+		case ElementsDescription::TYPE_INT16:
+			return (uint32) loadHostValue<int16>(bytes);
+		case ElementsDescription::TYPE_UINT16:
+			return loadHostValue<uint16>(bytes);
+
+		case ElementsDescription::TYPE_INT:
+		case ElementsDescription::TYPE_INT32:
+			return (uint32) loadHostValue<int32>(bytes);
+
+		case ElementsDescription::TYPE_UINT:
+		case ElementsDescription::TYPE_UINT32:
+			return loadHostValue<uint32>(bytes);
+
+		default:
+			assert(false);
+			return 0;
+	}
+}
+
 void PlyFile::readFaceListProperty(vector<uint32> &indices,
 	const ElementsDescription::TYPES listSizeType, const ElementsDescription::TYPES type, const uint32 semantic)
 {
@@ -557,136 +822,259 @@ void PlyFile::saveVertices(const Encoding encoding, const ElementsDescription::T
 {
 	const bool singlePrecision = ((ElementsDescription::TYPE_FLOAT ==  outputPrecision) || (ElementsDescription::TYPE_FLOAT32 == outputPrecision));
 
-	// get pointers to go through all vertices
-	const Vector3 *position = positions;
-	const Vector3 *color = colors;
-	const Vector3 *normal = normals;
-	const Real *confidence = confidences;
-	const Real *value = values;
-	const uint32 *viewID = viewIDs;
-	const char space = ' ';
+	// chunks of vertices are encoded in parallel into large blocks
+	BufferedFileWriter writer(*this);
+	PlyMeshEncoder encoder(encoding, singlePrecision);
+	encoder.writeVertices(writer, vertexCount, colors, normals, positions, confidences, values, viewIDs, viewsPerVertex);
+}
+
+void PlyFile::saveTriangles(const Encoding encoding, const uint32 indexCount, const uint32 *indices)
+{
+	// write for each triangle: 3, index0, index1, index2 in chunks which are encoded in parallel
+	BufferedFileWriter writer(*this);
+	PlyMeshEncoder encoder(encoding, true);
+	encoder.writeTriangles(writer, indexCount, indices);
+}
 
-	// output all vertices
-	for (uint32 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx)
+void PlyFile::streamTextLines(const uint64 lineCount, const function<bool (const uint64 lineIdx, const char *start, const char *end)> &lineParser,
+	const char *elementName)
+{
+	const uint64 position = getPosition();
+	if (0 == lineCount)
+		return;
+
+	// mapped text is processed in place, other files are read ahead asynchronously while the buffered lines are processed
+	vector<char> buffer;
+	unique_ptr<AsyncFileReader> reader;
+	const char *bufferStart = NULL;
+	const char *bufferEnd = NULL;
+	bool fileEnd = (NULL != getData());
+
+	if (fileEnd)
 	{
-		// write vertex position, color & normal
-		for (Axis axis = AXIS_X; axis <= AXIS_Z; axis = (Axis) (axis + 1))
+		bufferStart = (const char *) getData() + position;
+		bufferEnd = (const char *) getData() + getSize();
+	}
+	else
+	{
+		buffer.resize(STREAM_TEXT_BUFFER_SIZE);
+		bufferStart = buffer.data();
+		bufferEnd = bufferStart;
+		reader.reset(new AsyncFileReader(mName, AsyncFileReader::DEFAULT_CHUNK_SIZE, AsyncFileReader::DEFAULT_BUFFER_COUNT,
+			AsyncFileReader::BACKEND_IO_URING, position));
+	}
+
+	uint64 consumedBytes = 0;
+	bool atLineStart = false;
+	uint64 lineIdx = 0;
+
+	while (true)
+	{
+		// append the next part of the file behind the incomplete last line
+		if (!fileEnd)
 		{
-			const Real temp = (*position)[axis];
-			if (singlePrecision)
-				writeFloat((float) temp, encoding);
-			else
-				writeDouble(temp, encoding);
+			size_t filledBytes = bufferEnd - bufferStart;
+			if (filledBytes == buffer.size())
+				buffer.resize(2 * buffer.size());
+
+			const uint64 freeBytes = buffer.size() - filledBytes;
+			const uint64 readBytes = reader->read(buffer.data() + filledBytes, freeBytes);
 
-			if (ENCODING_ASCII == encoding)
-				write(&space, 1, 1);
+			filledBytes += (size_t) readBytes;
+			fileEnd = (readBytes < freeBytes);
+			bufferStart = buffer.data();
+			bufferEnd = bufferStart + filledBytes;
 		}
-		++position;
-		
-		if (color)
+
+		// skip the rest of a line which was read value by value
+		const char *lineStart = bufferStart;
+		if (!atLineStart)
 		{
-			for (Axis axis = AXIS_X; axis <= AXIS_Z; axis = (Axis) (axis + 1))
-			{
-				const uint8 temp = (uint8) roundr((*color)[axis] * 255);
-				writeUInt8(temp, encoding);
+			const char *textStart = lineStart;
+			while (textStart < bufferEnd && '\n' != *textStart && isWhiteSpace(*textStart))
+				++textStart;
 
-				if (ENCODING_ASCII == encoding)
-					write(&space, 1, 1);
+			if (textStart < bufferEnd || fileEnd)
+			{
+				lineStart = (textStart < bufferEnd && '\n' == *textStart ? textStart + 1 : lineStart);
+				atLineStart = true;
 			}
-			++color;
 		}
-		
-		if (normal)
+
+		// process complete lines, the last line of the file might not end with a line break
+		while (atLineStart && lineIdx < lineCount && lineStart < bufferEnd)
 		{
-			for (Axis axis = AXIS_X; axis <= AXIS_Z; axis = (Axis) (axis + 1))
-			{
-				const Real temp = (*normal)[axis];
-				if (singlePrecision)
-					writeFloat((float) temp, encoding);
-				else
-					writeDouble(temp, encoding);
+			const char *lineEnd = (const char *) memchr(lineStart, '\n', bufferEnd - lineStart);
+			if (!lineEnd && !fileEnd)
+				break;
+			if (!lineEnd)
+				lineEnd = bufferEnd;
 
-				if (ENCODING_ASCII == encoding)
-					write(&space, 1, 1);
+			if (!lineParser(lineIdx, lineStart, lineEnd))
+			{
+				ostringstream error;
+				error << "Could not parse the ASCII ply " << elementName << " line " << lineIdx << " after the element start.";
+				throw FileCorruptionException(error.str(), mName);
 			}
-			++normal;
+
+			++lineIdx;
+			lineStart = (lineEnd < bufferEnd ? lineEnd + 1 : lineEnd);
 		}
 
-		if (confidence)
-		{
-			const Real temp = *confidence;
-			if (singlePrecision)
-				writeFloat((float) temp, encoding);
-			else
-				writeDouble(temp, encoding);
+		consumedBytes += lineStart - bufferStart;
+		if (lineIdx == lineCount)
+			break;
 
-			if (ENCODING_ASCII == encoding)
-				write(&space, 1, 1);
-			++confidence;
+		if (fileEnd)
+		{
+			ostringstream error;
+			error << "The ply file ends within its " << elementName << ".";
+			throw FileCorruptionException(error.str(), mName);
 		}
 
-		if (value)
+		// keep the incomplete last line for the next part
+		const size_t leftBytes = bufferEnd - lineStart;
+		memmove(buffer.data(), lineStart, leftBytes);
+		bufferEnd = buffer.data() + leftBytes;
+	}
+
+	setPosition(position + consumedBytes);
+}
+
+void PlyFile::streamTriangles(const TriangleBatchCallback &callback, const FacesDescription &facesFormat, const uint64 batchSize)
+{
+	const uint64 faceCount = facesFormat.getElementCount();
+	const uint64 batchFaceCount = (batchSize > 0 ? batchSize : 1);
+	uint64 batchStart = 0;
+
+	vector<uint32> indices;
+	indices.reserve((size_t) (faceCount < batchFaceCount ? faceCount : batchFaceCount) * 3 * 2);
+
+	// text faces are parsed line by line
+	if (ENCODING_ASCII == mEncoding)
+	{
+		streamTextLines(faceCount, [&] (const uint64 faceIdx, const char *start, const char *end) -> bool
 		{
-			const Real temp = *value;
-			if (singlePrecision)
-				writeFloat((float) temp, encoding);
-			else
-				writeDouble(temp, encoding);
+			if (!PlyTextParser::parseFace(indices, facesFormat, start, end))
+				return false;
 
-			if (ENCODING_ASCII == encoding)
-				write(&space, 1, 1);
-			++value;
-		}
+			if (faceIdx + 1 - batchStart == batchFaceCount || faceIdx + 1 == faceCount)
+			{
+				callback(indices.data(), indices.size() / 3, batchStart);
+				indices.clear();
+				batchStart = faceIdx + 1;
+			}
+			return true;
+		}, "faces");
+		return;
+	}
+
+	// binary faces are read property by property like by loadTriangles(), files which are not mapped are read ahead asynchronously
+	const ElementsSyntax &listSizeTypes = facesFormat.getListSizeTypes();
+	const ElementsSyntax &types = facesFormat.getTypeStructure();
+	const ElementsSemantics &semantics = facesFormat.getSemantics();
+	const uint32 propertyCount = facesFormat.getPropertyCount();
+	const bool swap = (isHostBigEndian() != (ENCODING_BINARY_BIG_ENDIAN == mEncoding));
+	unique_ptr<AsyncFileReader> reader(getData() ? NULL : new AsyncFileReader(mName, AsyncFileReader::DEFAULT_CHUNK_SIZE,
+		AsyncFileReader::DEFAULT_BUFFER_COUNT, AsyncFileReader::BACKEND_IO_URING, getPosition()));
 
-		if (viewID)
+	for (uint64 faceIdx = 0; faceIdx < faceCount; ++faceIdx)
+	{
+		if (reader)
 		{
-			for (uint32 viewIdx = 0; viewIdx < viewsPerVertex; ++viewIdx)
+			readBinaryFace(indices, *reader, facesFormat, swap);
+		}
+		else
+		{
+			for (uint32 propertyIdx = 0; propertyIdx < propertyCount; ++propertyIdx)
 			{
-				writeInt32(*viewID, encoding);
-				if (ENCODING_ASCII == encoding)
-					write(&space, 1, 1);
-				++viewID;
+				const ElementsDescription::TYPES listSizeType = listSizeTypes[propertyIdx];
+				if (ElementsDescription::TYPE_INVALID == listSizeType)
+					readFaceSingleProperty(types[propertyIdx], semantics[propertyIdx]);
+				else
+					readFaceListProperty(indices, listSizeType, types[propertyIdx], semantics[propertyIdx]);
 			}
+
+			if (endOfFileReached())
+				throw FileCorruptionException("The ply file ends within its faces.", mName);
+		}
+
+		if (faceIdx + 1 - batchStart == batchFaceCount || faceIdx + 1 == faceCount)
+		{
+			callback(indices.data(), indices.size() / 3, batchStart);
+			indices.clear();
+			batchStart = faceIdx + 1;
 		}
-		
-		if (ENCODING_ASCII == encoding)
-			write("\r\n", 1, 2);
 	}
-	
-	position = NULL;
-	color = NULL;
-	normal = NULL;
-	confidence = NULL;
-	value = NULL;
-	viewID = NULL;
+
+	if (reader)
+		setPosition(reader->getPosition());
 }
 
-void PlyFile::saveTriangles(const Encoding encoding, const uint32 indexCount, const uint32 *indices)
+void PlyFile::streamVertices(const VertexBatchCallback &callback, const VerticesDescription &format,
+	const uint64 batchSize, const uint32 attributeMask)
 {
-	const uint8 verticesPerTriangle = 3;
-	const uint32 triangleCount = indexCount / verticesPerTriangle;
-	const uint32 *triangle = indices;
-	const char space = ' ';
+	const PlyVertexDecoder decoder(format, attributeMask);
+	if (!decoder.isValid())
+		throw FileCorruptionException("Unsupported vertex property type or semantic.", mName);
+
+	// attribute arrays which are reused for all batches
+	const uint64 vertexCount = format.getElementCount();
+	const uint64 batchVertexCount = (vertexCount < batchSize ? vertexCount : (batchSize > 0 ? batchSize : 1));
+
+	PlyVertices batch;
+	decoder.prepare(batch, batchVertexCount);
+
+	// text vertices are decoded line by line
+	if (ENCODING_ASCII == mEncoding)
+	{
+		uint64 batchStart = 0;
+		streamTextLines(vertexCount, [&] (const uint64 vertexIdx, const char *start, const char *end) -> bool
+		{
+			if (!decoder.decodeText(batch, vertexIdx - batchStart, start, end))
+				return false;
+
+			if (vertexIdx + 1 - batchStart == batchVertexCount || vertexIdx + 1 == vertexCount)
+			{
+				callback(batch, batchStart, vertexIdx + 1 - batchStart);
+				batchStart = vertexIdx + 1;
+			}
+			return true;
+		}, "vertices");
+		return;
+	}
+
+	const uint64 vertexSize = decoder.getVertexSize();
+	if (0 == vertexSize || 0 == vertexCount)
+		return;
 
-	// write for each triangle: 3, index0, index1, index2
-	for (uint32 triangleIdx = 0; triangleIdx < triangleCount; ++triangleIdx)
+	// mapped files are decoded in place, other files are read ahead asynchronously while the batches are processed
+	const uint64 start = getPosition();
+	if (getData() && (getSize() - start) / vertexSize < vertexCount)
+		throw FileCorruptionException("The ply file ends within its vertices.", mName);
+
+	vector<uint8> buffer(getData() ? 0 : (size_t) (batchVertexCount * vertexSize));
+	unique_ptr<AsyncFileReader> reader(getData() ? NULL : new AsyncFileReader(mName, AsyncFileReader::DEFAULT_CHUNK_SIZE,
+		AsyncFileReader::DEFAULT_BUFFER_COUNT, AsyncFileReader::BACKEND_IO_URING, start, vertexCount * vertexSize));
+	for (uint64 batchStart = 0; batchStart < vertexCount; batchStart += batchVertexCount)
 	{
-		writeUInt8(verticesPerTriangle, encoding);
-		if (ENCODING_ASCII == encoding)
-			write(&space, 1, 1);
+		const uint64 count = (vertexCount - batchStart < batchVertexCount ? vertexCount - batchStart : batchVertexCount);
+		const uint8 *source = NULL;
 
-		for (uint32 cornerIdx = 0; cornerIdx < verticesPerTriangle; ++cornerIdx)
+		if (getData())
+		{
+			source = getData() + start + batchStart * vertexSize;
+		}
+		else
 		{
-			writeInt32(triangle[cornerIdx], encoding);
-			if (ENCODING_ASCII == encoding)
-				if (cornerIdx < verticesPerTriangle - 1)
-					write(&space, 1, 1);
+			if (count * vertexSize != reader->read(buffer.data(), count * vertexSize))
+				throw FileCorruptionException("The ply file ends within its vertices.", mName);
+			source = buffer.data();
 		}
-		if (ENCODING_ASCII == encoding)
-			write("\r\n", 1, 2);
 
-		triangle += 3;
+		decoder.decode(batch, 0, source, count);
+		callback(batch, batchStart, count);
 	}
-	
-	triangle = NULL;
+
+	setPosition(start + vertexCount * vertexSize);
 }
@@ -8,11 +8,15 @@
 #ifndef _PLY_FILE_H_
 #define _PLY_FILE_H_
 
+#include <functional>
 #include "Graphics/FacesDescription.h"
 #include "Graphics/VerticesDescription.h"
 #include "Math/Vector3.h"
 #include "Platform/FailureHandling/FileCorruptionException.h"
+#include "Platform/Storage/AsyncFileReader.h"
 #include "Platform/Storage/File.h"
+#include "Platform/Utilities/MeshCache.h"
+#include "Platform/Utilities/PlyVertexDecoder.h"
 
 namespace Utilities
 {
@@ -20,10 +24,40 @@ namespace Utilities
 	/** The class is used to process ply file data. */
 	class PlyFile : public Storage::File
 	{
+	public:
+		/** Receives a batch of consecutive vertices, see streamVertices().
+			vertices: Attribute arrays of the batch which are reused for the next batch. Only the first vertexCount elements of each array are valid.
+			firstVertexIdx: Index of the first vertex of the batch within the file.
+			vertexCount: Number of vertices in the batch. */
+		typedef std::function<void (const PlyVertices &vertices, const uint64 firstVertexIdx, const uint64 vertexCount)> VertexBatchCallback;
+
+		/** Receives the triangles of a batch of consecutive faces, see streamTriangles().
+			indices: Three vertex indices per triangle. The array is reused for the next batch.
+			triangleCount: Number of triangles in the batch, more than the number of faces if there are quads.
+			firstFaceIdx: Index of the first face of the batch within the file. */
+		typedef std::function<void (const uint32 *indices, const uint64 triangleCount, const uint64 firstFaceIdx)> TriangleBatchCallback;
+
+	public:
+		/** Returns the name of the cache file which is used by loadCached() for a ply file.
+		@param fileName Identifies the ply file.
+		@return Returns fileName extended by CACHE_FILE_EXTENSION, i.e., the cache is stored next to the ply file. */
+		static Storage::Path getCachePath(const Storage::Path &fileName);
+
+		/** Automatic cache mode: Provides the triangle mesh of a ply file via its native cache file without parsing the ply file again.
+			If the cache file next to the ply file does not exist, is invalid or outdated since the size or modification time of the ply file changed,
+			then the ply file is loaded completely and converted to a new cache file. Otherwise the cache file is only mapped into memory.
+		@param cache Is set to the open cache file with all loaded vertex attributes and the triangles of the ply file, see MeshCache.
+		@param fileName Identifies the ply file. It is only opened if the cache file must be created.
+		@param verifyChecksum Set this to true to read the complete cache file once to detect corrupted files which are then replaced.
+		@throws FileAccessException Is thrown if the ply file does not exist or if the cache file cannot be written.
+		@throws FileCorruptionException Is thrown if the ply file must be converted but cannot be loaded. */
+		static void loadCached(MeshCache &cache, const Storage::Path &fileName, const bool verifyChecksum = false);
+
 	public:
 		/** Opens or creates a specific ply file.
 		@param fileName The name and path of the file the access of which is requested.
 		@param mode Defines the way the file is used, corresponds to the file mode options of fopen. See FileMode.
+			Use OPEN_READING_MAPPED to parse large files directly from memory.
 		@param binaryFile If binaryFile is true than the file is opened as binary file
 						  otherwise it is opened as text file (some characters are treated in a special way.) */
 		PlyFile(const Storage::Path &fileName, FileMode mode, bool binaryFile);
@@ -34,9 +68,55 @@ namespace Utilities
 		/** todo */
 		void loadHeader(Graphics::VerticesDescription &verticesFormat, Graphics::FacesDescription *facesFormat = NULL);
 
-		/** todo */
+		/** Loads all vertices of the file into one array per attribute. Must be called directly after loadHeader().
+			Binary vertices are decoded by a PlyVertexDecoder directly from memory for OPEN_READING_MAPPED.
+			Otherwise they are decoded chunk by chunk while an AsyncFileReader reads the following chunks.
+			ASCII vertices are parsed in parallel chunks by a PlyTextParser.
+		@param vertices Is filled with the vertices. Arrays of attributes which are not stored in the file are cleared.
+		@param format Set this to the vertex format which was loaded by loadHeader().
+		@throws FileCorruptionException Is thrown if the file ends within its vertices or if a property type is not supported. */
+		void loadVertices(PlyVertices &vertices, const Graphics::VerticesDescription &format);
+
+		/** Loads all vertices of the file directly into a caller-described interleaved vertex buffer, e.g., an upload-ready GPU vertex buffer.
+			Must be called directly after loadHeader(). Each property is converted once from the file bytes or text to its component type in buffer,
+			e.g., to half floats or normalized bytes, without intermediate attribute arrays. Vertices are read like by loadVertices().
+		@param buffer Set this to a buffer for format.getElementCount() vertices with layout.mStride bytes each.
+			Only the components of attributes which are stored in the file and written according to layout are changed.
+		@param layout Set this to the offset and component type of each written attribute and the vertex stride of buffer.
+		@param format Set this to the vertex format which was loaded by loadHeader().
+		@throws FileCorruptionException Is thrown if the file ends within its vertices or if a property type is not supported. */
+		void loadInterleavedVertices(uint8 *buffer, const PlyVertexDecoder::InterleavedLayout &layout, const Graphics::VerticesDescription &format);
+
+		/** Loads all faces of the file as triangles. Must be called directly after loadVertices() or after loading the vertices property by property.
+			Quads are split into two triangles. ASCII faces are parsed in parallel chunks by a PlyTextParser.
+			Binary faces of files which are not mapped are read ahead by an AsyncFileReader while they are decoded.
+		@param indices Three vertex indices per triangle are appended to indices.
+		@param facesFormat Set this to the face format which was loaded by loadHeader().
+		@throws FileCorruptionException Is thrown if the file ends within its faces or if a face is neither a triangle nor a quad. */
 		void loadTriangles(std::vector<uint32> &indices, const Graphics::FacesDescription &facesFormat);
 
+		/** Streams all vertices of the file in batches of bounded size instead of loading them at once. Must be called directly after loadHeader().
+			Memory does not depend on the vertex count: a batch of attribute arrays, and for binary files which are not mapped a buffer of batchSize vertices,
+			and for ASCII files which are not mapped a text buffer of about STREAM_TEXT_BUFFER_SIZE bytes are reused for all batches.
+			Files which are not mapped are additionally read ahead by an AsyncFileReader with its chunk buffers while the batches are processed.
+		@param callback Set this to the function which processes each batch in file order on the calling thread.
+		@param format Set this to the vertex format which was loaded by loadHeader().
+		@param batchSize Set this to the maximum number of vertices per batch.
+		@param attributeMask Set bit (1 << PlyVertexDecoder::ATTRIBUTE) for each wanted attribute. Properties of other attributes are skipped without being decoded.
+		@throws FileCorruptionException Is thrown if the file ends within its vertices or if a vertex cannot be decoded. */
+		void streamVertices(const VertexBatchCallback &callback, const Graphics::VerticesDescription &format,
+			const uint64 batchSize = STREAM_BATCH_SIZE, const uint32 attributeMask = PlyVertexDecoder::ALL_ATTRIBUTES);
+
+		/** Streams all faces of the file as triangles in batches of bounded size instead of loading them at once.
+			Must be called directly after the vertices were loaded or streamed. Quads are split like by loadTriangles().
+			Files which are not mapped are read ahead by an AsyncFileReader while the batches are processed.
+		@param callback Set this to the function which processes each batch in file order on the calling thread.
+		@param facesFormat Set this to the face format which was loaded by loadHeader().
+		@param batchSize Set this to the maximum number of faces per batch.
+		@throws FileCorruptionException Is thrown if the file ends within its faces or if a face is neither a triangle nor a quad. */
+		void streamTriangles(const TriangleBatchCallback &callback, const Graphics::FacesDescription &facesFormat,
+			const uint64 batchSize = STREAM_BATCH_SIZE);
+
 		/** todo */
 		template <class T>
 		T read(const Graphics::ElementsDescription::TYPES type);
@@ -64,6 +144,29 @@ namespace Utilities
 		/** todo */
 		void loadFaceStructureSingleProperty(Graphics::FacesDescription &structure);
 
+		/** Loads all vertices of the file into attribute arrays or an interleaved buffer, see loadVertices() and loadInterleavedVertices().
+		@param vertices Set this to the prepared attribute arrays or NULL to fill buffer.
+		@param buffer Set this to the interleaved buffer or NULL to fill vertices.
+		@param decoder Set this to the decoder for the vertex format of the file and the destination.
+		@param vertexCount Set this to the number of vertices in the file. */
+		void loadVertices(PlyVertices *vertices, uint8 *buffer, const PlyVertexDecoder &decoder, const uint64 vertexCount);
+
+		/** Provides the remaining file content from the reading position on for parsing ASCII elements in memory.
+			Mapped files are used directly. Other files are read to their end once and the text is reused for the following elements.
+		@param end Is set behind the last character of the file.
+		@return Returns the character at the current reading position. */
+		const char *getRemainingText(const char *&end);
+
+		/** Processes the following lines of an ASCII file with a text buffer of bounded size.
+			Mapped files are processed directly in memory. Other files are read ahead by an AsyncFileReader while the buffered lines are processed.
+			The reading position is set behind the last processed line.
+		@param lineCount Set this to the number of processed lines.
+		@param lineParser Is called for each line with its index, its first character and its end. It returns false if the line cannot be parsed.
+		@param elementName Set this to the name of the elements in the lines, e.g., "vertices", for exceptions.
+		@throws FileCorruptionException Is thrown if the file has fewer than lineCount lines or if lineParser fails. */
+		void streamTextLines(const uint64 lineCount, const std::function<bool (const uint64 lineIdx, const char *start, const char *end)> &lineParser,
+			const char *elementName);
+
 		/** todo */
 		void loadVertexStructure(Graphics::VerticesDescription &structure);
 
@@ -74,6 +177,22 @@ namespace Utilities
 		/** todo */
 		void readFaceSingleProperty(const Graphics::ElementsDescription::TYPES type, const uint32 semantic);
 
+		/** Reads all properties of the next binary face from an asynchronously read file like readFaceListProperty() and readFaceSingleProperty().
+		@param indices The vertex indices of the face are appended to indices. Quads are split into two triangles.
+		@param reader Set this to the reader of the file which continues at the face.
+		@param facesFormat Set this to the face format which was loaded by loadHeader().
+		@param swap Set this to true if the byte order of the file differs from the one of this machine.
+		@throws FileCorruptionException Is thrown if the file ends within the face or if the face is neither a triangle nor a quad. */
+		void readBinaryFace(std::vector<uint32> &indices, Storage::AsyncFileReader &reader, const Graphics::FacesDescription &facesFormat, const bool swap);
+
+		/** Reads the next binary value of a face from an asynchronously read file, e.g., a list size or a vertex index.
+		@param reader Set this to the reader of the file which continues at the value.
+		@param type Set this to the file type of the value.
+		@param swap Set this to true if the byte order of the file differs from the one of this machine.
+		@return Returns the value converted to uint32.
+		@throws FileCorruptionException Is thrown if the file ends within the value or if the type is not supported. */
+		uint32 readBinaryFaceValue(Storage::AsyncFileReader &reader, const Graphics::ElementsDescription::TYPES type, const bool swap);
+
 		/** todo */
 		void saveTriangleMeshHeader(const Encoding encoding, const Graphics::ElementsDescription::TYPES outputPrecision,
 			const uint32 vertexCount, const uint32 indexCount,
@@ -87,6 +206,12 @@ namespace Utilities
 			const Real *confidences, const Real *values, const uint32 *viewIDs, const uint32 viewsPerVertex);
 		void saveTriangles(const Encoding encoding, const uint32 indexCount, const uint32 *indices);
 		
+	public:
+		static const char *CACHE_FILE_EXTENSION;				/// Appended to ply file names to get the names of their cache files, see loadCached().
+		static const uint32 STREAM_BATCH_SIZE = 1u << 16;		/// Default number of elements per batch of streamVertices() and streamTriangles().
+		static const uint32 STREAM_TEXT_BUFFER_SIZE = 1u << 20;	/// Initial size of the text buffer for streaming ASCII files, doubled for longer lines.
+		static const uint32 VERTEX_CHUNK_SIZE = 1u << 20;		/// Number of binary vertex bytes which are decoded at once by loadVertices() while the next ones are read.
+
 	private:
 		static const char *DELIMETERS;				/// Define where to split ply file lines into parts. E.g. "property float x"\n -> {property,float,x}
 		static const char *HEADER_COMMENT_START;	/// Each comment in the header begins like this.
@@ -103,6 +228,8 @@ namespace Utilities
 	private:
 		std::vector<std::string> mLineParts;	/// Used to split a ply file line into subparts. Subparts can be processed more easily.
 		std::string mLine;						/// Used to store a single ply file line.
+		std::vector<uint8> mText;				/// Remaining content of a file which is not mapped for parsing ASCII elements, see getRemainingText().
+		uint64 mTextOffset;						/// File offset of the first byte of mText.
 		Storage::Path mName;					/// Contains the ply file name for possible exceptions.
 		Encoding mEncoding;						/// Defines how data is encoded in the disk file, see DataTypes.h::enum Encoding.
 	};
@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+
+#include <cstring>
+#include <memory>
+#include "Math/MathCore.h"
+#include "Platform/Multithreading/Manager.h"
+#include "Platform/Utilities/ByteSwapping.h"
+#include "Platform/Utilities/NumberFormatting.h"
+#include "Platform/Utilities/PlyMeshEncoder.h"
+
+using namespace Math;
+using namespace Platform::Multithreading;
+using namespace std;
+using namespace Storage;
+using namespace Utilities;
+
+namespace
+{
+	/// Number of characters which are always enough for an ASCII encoded value including its separator.
+	const uint32 MAX_ASCII_VALUE_LENGTH = MAX_FIXED_NUMBER_LENGTH + 1;
+
+	/** Stores a binary value in the requested byte order.
+	@param target Set this to the first byte of the value.
+	@param value Set this to the stored value in host byte order.
+	@param swap Set this to true to reverse the byte order of value.
+	@return Returns a pointer behind the stored value. */
+	template <class T>
+	inline uint8 *storeValue(uint8 *target, const T value, const bool swap)
+	{
+		memcpy(target, &value, sizeof(T));
+		if (swap)
+			for (uint32 byteIdx = 0; byteIdx < sizeof(T) / 2; ++byteIdx)
+				std::swap(target[byteIdx], target[sizeof(T) - 1 - byteIdx]);
+		return target + sizeof(T);
+	}
+
+	/** Stores a real vertex attribute value as binary float or double.
+	@param target Set this to the first byte of the value.
+	@param value Set this to the stored value.
+	@param singlePrecision Set this to true to store a float instead of a double.
+	@param swap Set this to true to reverse the byte order of the value.
+	@return Returns a pointer behind the stored value. */
+	inline uint8 *storeReal(uint8 *target, const Real value, const bool singlePrecision, const bool swap)
+	{
+		if (singlePrecision)
+			return storeValue<float>(target, (float) value, swap);
+		return storeValue<double>(target, (double) value, swap);
+	}
+
+	/** Formats a real vertex attribute value like BufferedFileWriter::writeFloat() or writeDouble() followed by a space.
+	@param target Set this to at least MAX_ASCII_VALUE_LENGTH writable characters.
+	@param value Set this to the formatted value.
+	@param singlePrecision Set this to true to format the value as float.
+	@return Returns a pointer behind the separator. */
+	inline char *formatValue(char *target, const Real value, const bool singlePrecision)
+	{
+		if (singlePrecision)
+			target = formatFixed(target, (float) value, 6);
+		else
+			target = formatFixed(target, (double) value, 6);
+
+		*target = ' ';
+		return target + 1;
+	}
+}
+
+void PlyMeshEncoder::ChunkTask::function()
+{
+	mEncoder->encode(*this);
+}
+
+PlyMeshEncoder::PlyMeshEncoder(const Encoding encoding, const bool singlePrecision) :
+	mColors(NULL), mNormals(NULL), mPositions(NULL), mConfidences(NULL), mValues(NULL), mViewIDs(NULL), mIndices(NULL),
+	mViewsPerVertex(0), mEncoding(encoding), mSinglePrecision(singlePrecision),
+	mSwapBytes((ENCODING_BINARY_BIG_ENDIAN == encoding) != isHostBigEndian())
+{
+
+}
+
+void PlyMeshEncoder::encode(ChunkTask &task) const
+{
+	task.mFill = 0;
+	if (mIndices)
+		encodeTriangles(task);
+	else
+		encodeVertices(task);
+}
+
+void PlyMeshEncoder::encodeTriangles(ChunkTask &task) const
+{
+	const uint32 verticesPerTriangle = 3;
+	const uint32 *triangle = mIndices + task.mFirstElement * verticesPerTriangle;
+
+	// binary: list size and three indices
+	if (ENCODING_ASCII != mEncoding)
+	{
+		const uint64 triangleSize = sizeof(uint8) + verticesPerTriangle * sizeof(int32);
+		if (task.mBuffer.size() < task.mElementCount * triangleSize)
+			task.mBuffer.resize((size_t) (task.mElementCount * triangleSize));
+
+		uint8 *target = task.mBuffer.data();
+		for (uint64 triangleIdx = 0; triangleIdx < task.mElementCount; ++triangleIdx, triangle += verticesPerTriangle)
+		{
+			*target = (uint8) verticesPerTriangle;
+			++target;
+
+			for (uint32 cornerIdx = 0; cornerIdx < verticesPerTriangle; ++cornerIdx)
+				target = storeValue<int32>(target, (int32) triangle[cornerIdx], mSwapBytes);
+		}
+
+		task.mFill = target - task.mBuffer.data();
+		return;
+	}
+
+	// ASCII: "3 index0 index1 index2\r\n"
+	const uint64 maxLineLength = (verticesPerTriangle + 1) * MAX_NUMBER_LENGTH + 2;
+	if (task.mBuffer.size() < task.mElementCount * maxLineLength)
+		task.mBuffer.resize((size_t) (task.mElementCount * maxLineLength));
+
+	char *start = reinterpret_cast<char *>(task.mBuffer.data());
+	char *target = start;
+	for (uint64 triangleIdx = 0; triangleIdx < task.mElementCount; ++triangleIdx, triangle += verticesPerTriangle)
+	{
+		target = formatUnsigned(target, verticesPerTriangle);
+		for (uint32 cornerIdx = 0; cornerIdx < verticesPerTriangle; ++cornerIdx)
+		{
+			*target = ' ';
+			target = formatSigned(target + 1, (int32) triangle[cornerIdx]);
+		}
+
+		target[0] = '\r';
+		target[1] = '\n';
+		target += 2;
+	}
+
+	task.mFill = target - start;
+}
+
+void PlyMeshEncoder::encodeVertices(ChunkTask &task) const
+{
+	const uint64 firstVertex = task.mFirstElement;
+	const uint64 vertexCount = task.mElementCount;
+	const uint32 realSize = (mSinglePrecision ? sizeof(float) : sizeof(double));
+
+	// binary: fixed size records
+	if (ENCODING_ASCII != mEncoding)
+	{
+		const uint64 vertexSize = 3 * realSize + (mColors ? 3 : 0) + (mNormals ? 3 * realSize : 0) +
+			(mConfidences ? realSize : 0) + (mValues ? realSize : 0) + (mViewIDs ? mViewsPerVertex * sizeof(int32) : 0);
+		if (task.mBuffer.size() < vertexCount * vertexSize)
+			task.mBuffer.resize((size_t) (vertexCount * vertexSize));
+
+		uint8 *target = task.mBuffer.data();
+		for (uint64 vertexIdx = firstVertex; vertexIdx < firstVertex + vertexCount; ++vertexIdx)
+		{
+			for (Axis axis = AXIS_X; axis <= AXIS_Z; axis = (Axis) (axis + 1))
+				target = storeReal(target, mPositions[vertexIdx][axis], mSinglePrecision, mSwapBytes);
+
+			if (mColors)
+				for (Axis axis = AXIS_X; axis <= AXIS_Z; axis = (Axis) (axis + 1), ++target)
+					*target = (uint8) roundr(mColors[vertexIdx][axis] * 255);
+
+			if (mNormals)
+				for (Axis axis = AXIS_X; axis <= AXIS_Z; axis = (Axis) (axis + 1))
+					target = storeReal(target, mNormals[vertexIdx][axis], mSinglePrecision, mSwapBytes);
+
+			if (mConfidences)
+				target = storeReal(target, mConfidences[vertexIdx], mSinglePrecision, mSwapBytes);
+
+			if (mValues)
+				target = storeReal(target, mValues[vertexIdx], mSinglePrecision, mSwapBytes);
+
+			if (mViewIDs)
+				for (uint32 viewIdx = 0; viewIdx < mViewsPerVertex; ++viewIdx)
+					target = storeValue<int32>(target, (int32) mViewIDs[vertexIdx * mViewsPerVertex + viewIdx], mSwapBytes);
+		}
+
+		task.mFill = target - task.mBuffer.data();
+		return;
+	}
+
+	// ASCII: each value is followed by a space and each vertex by "\r\n"
+	const uint64 valueCount = 3 + (mColors ? 3 : 0) + (mNormals ? 3 : 0) + (mConfidences ? 1 : 0) + (mValues ? 1 : 0) + (mViewIDs ? mViewsPerVertex : 0);
+	const uint64 maxLineLength = valueCount * MAX_ASCII_VALUE_LENGTH + 2;
+	uint64 fill = 0;
+
+	for (uint64 vertexIdx = firstVertex; vertexIdx < firstVertex + vertexCount; ++vertexIdx)
+	{
+		// lines are usually much shorter than their maximum length
+		if (task.mBuffer.size() - fill < maxLineLength)
+			task.mBuffer.resize((size_t) (2 * task.mBuffer.size() > fill + maxLineLength ? 2 * task.mBuffer.size() : fill + maxLineLength));
+
+		char *start = reinterpret_cast<char *>(task.mBuffer.data() + fill);
+		char *target = start;
+
+		for (Axis axis = AXIS_X; axis <= AXIS_Z; axis = (Axis) (axis + 1))
+			target = formatValue(target, mPositions[vertexIdx][axis], mSinglePrecision);
+
+		if (mColors)
+		{
+			for (Axis axis = AXIS_X; axis <= AXIS_Z; axis = (Axis) (axis + 1))
+			{
+				target = formatUnsigned(target, (uint8) roundr(mColors[vertexIdx][axis] * 255));
+				*target = ' ';
+				++target;
+			}
+		}
+
+		if (mNormals)
+			for (Axis axis = AXIS_X; axis <= AXIS_Z; axis = (Axis) (axis + 1))
+				target = formatValue(target, mNormals[vertexIdx][axis], mSinglePrecision);
+
+		if (mConfidences)
+			target = formatValue(target, mConfidences[vertexIdx], mSinglePrecision);
+
+		if (mValues)
+			target = formatValue(target, mValues[vertexIdx], mSinglePrecision);
+
+		if (mViewIDs)
+		{
+			for (uint32 viewIdx = 0; viewIdx < mViewsPerVertex; ++viewIdx)
+			{
+				target = formatSigned(target, (int32) mViewIDs[vertexIdx * mViewsPerVertex + viewIdx]);
+				*target = ' ';
+				++target;
+			}
+		}
+
+		target[0] = '\r';
+		target[1] = '\n';
+		fill += (target + 2) - start;
+	}
+
+	task.mFill = fill;
+}
+
+void PlyMeshEncoder::write(BufferedFileWriter &writer, const uint64 elementCount)
+{
+	const uint64 chunkCount = (elementCount + CHUNK_ELEMENT_COUNT - 1) / CHUNK_ELEMENT_COUNT;
+	if (0 == chunkCount)
+		return;
+
+	// several chunks are encoded at once by the workers, but not if this thread is a worker which must not wait for other tasks
+	uint32 taskCount = 1;
+	bool useTasks = false;
+	if (Manager::exists() && Manager::getSingleton().isRunning() && !Manager::isWorkerThread())
+	{
+		const uint32 threadCount = Manager::getSingleton().getThreadCount();
+		taskCount = (2 * threadCount < MAX_TASK_COUNT ? 2 * threadCount : MAX_TASK_COUNT) + 1;
+		useTasks = (threadCount > 0 && chunkCount > 1);
+	}
+
+	unique_ptr<ChunkTask[]> tasks(new ChunkTask[taskCount]);
+	uint64 submittedCount = 0;
+
+	for (uint64 chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx)
+	{
+		// keep all tasks busy with the following chunks
+		for (; submittedCount < chunkCount && submittedCount < chunkIdx + taskCount; ++submittedCount)
+		{
+			ChunkTask &task = tasks[submittedCount % taskCount];
+			task.mEncoder = this;
+			task.mFirstElement = submittedCount * CHUNK_ELEMENT_COUNT;
+			task.mElementCount = (elementCount - task.mFirstElement < CHUNK_ELEMENT_COUNT ? elementCount - task.mFirstElement : CHUNK_ELEMENT_COUNT);
+
+			if (!useTasks)
+				continue;
+
+			task.redo();
+			Manager::getSingleton().enqueue(&task);
+		}
+
+		// write the oldest chunk to free its task
+		ChunkTask &task = tasks[chunkIdx % taskCount];
+		if (useTasks)
+			task.waitUntilFinished();
+		else
+			encode(task);
+
+		writer.write(task.mBuffer.data(), sizeof(uint8), task.mFill);
+	}
+}
+
+void PlyMeshEncoder::writeTriangles(BufferedFileWriter &writer, const uint32 indexCount, const uint32 *indices)
+{
+	mIndices = indices;
+	write(writer, indexCount / 3);
+	mIndices = NULL;
+}
+
+void PlyMeshEncoder::writeVertices(BufferedFileWriter &writer, const uint32 vertexCount,
+	const Vector3 *colors, const Vector3 *normals, const Vector3 *positions,
+	const Real *confidences, const Real *values, const uint32 *viewIDs, const uint32 viewsPerVertex)
+{
+	mColors = colors;
+	mNormals = normals;
+	mPositions = positions;
+	mConfidences = confidences;
+	mValues = values;
+	mViewIDs = viewIDs;
+	mViewsPerVertex = viewsPerVertex;
+
+	write(writer, vertexCount);
+
+	mColors = NULL;
+	mNormals = NULL;
+	mPositions = NULL;
+	mConfidences = NULL;
+	mValues = NULL;
+	mViewIDs = NULL;
+	mViewsPerVertex = 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _UTILITIES_PLY_MESH_ENCODER_H_
+#define _UTILITIES_PLY_MESH_ENCODER_H_
+
+#include <cassert>
+#include <vector>
+#include "Math/Vector3.h"
+#include "Platform/DataTypes.h"
+#include "Platform/Multithreading/Task.h"
+#include "Platform/Storage/BufferedFileWriter.h"
+
+namespace Utilities
+{
+	/// Encodes the vertices and triangles of ply files in parallel chunks which are written in file order, see PlyFile::saveTriangleMesh().
+	/** Each chunk of CHUNK_ELEMENT_COUNT vertices or triangles is encoded into its own large buffer by a task
+		of the Platform::Multithreading::Manager, binary values by plain copies and ASCII numbers by the printf-free formatting of NumberFormatting.h.
+		The calling thread writes the buffers in file order while the workers encode the following chunks.
+		Only a few chunks are in flight at once, so memory does not depend on the mesh size.
+		Without a running Manager or on one of its workers, all chunks are encoded and written by the calling thread.
+		The output is exactly the same as that of the BufferedFileWriter functions writeFloat(), writeDouble(), writeUInt8() and writeInt32(). */
+	class PlyMeshEncoder
+	{
+	public:
+		/** Prepares encoding of vertices and triangles.
+		@param encoding Set this to the encoding of the written ply file.
+		@param singlePrecision Set this to true to write floats instead of doubles for real vertex attributes. */
+		PlyMeshEncoder(const Encoding encoding, const bool singlePrecision);
+
+		/** Encodes and writes all triangles with three vertex indices each.
+		@param writer Set this to the writer of the ply file behind its vertices.
+		@param indexCount Set this to the number of indices, i.e., three times the number of triangles.
+		@param indices Set this to three vertex indices per triangle. */
+		void writeTriangles(Storage::BufferedFileWriter &writer, const uint32 indexCount, const uint32 *indices);
+
+		/** Encodes and writes all vertices with the same attribute order as in the header by PlyFile::saveTriangleMesh().
+		@param writer Set this to the writer of the ply file behind its header.
+		@param vertexCount Set this to the number of vertices.
+		@param colors Set this to vertexCount colors with components in [0, 1] or NULL.
+		@param normals Set this to vertexCount normals or NULL.
+		@param positions Set this to vertexCount positions.
+		@param confidences Set this to vertexCount confidences or NULL.
+		@param values Set this to vertexCount scalars or NULL.
+		@param viewIDs Set this to viewsPerVertex view IDs per vertex or NULL.
+		@param viewsPerVertex Set this to the number of view IDs per vertex. */
+		void writeVertices(Storage::BufferedFileWriter &writer, const uint32 vertexCount,
+			const Math::Vector3 *colors, const Math::Vector3 *normals, const Math::Vector3 *positions,
+			const Real *confidences, const Real *values, const uint32 *viewIDs, const uint32 viewsPerVertex);
+
+	public:
+		static const uint32 CHUNK_ELEMENT_COUNT = 1u << 12;	/// Number of vertices or triangles which are encoded by a single task.
+		static const uint32 MAX_TASK_COUNT = 32;			/// Maximum number of chunks which are encoded or buffered at once.
+
+	private:
+		/// Encodes a single chunk into its own buffer.
+		class ChunkTask : public Platform::Multithreading::Task
+		{
+		public:
+			ChunkTask() : Task(), mEncoder(NULL), mFirstElement(0), mElementCount(0), mFill(0) { }
+			virtual void function();
+
+		public:
+			std::vector<uint8>		mBuffer;		/// Encoded bytes of the chunk.
+			const PlyMeshEncoder	*mEncoder;		/// Encoder which defines the encoded arrays.
+			uint64					mFirstElement;	/// Index of the first vertex or triangle of the chunk.
+			uint64					mElementCount;	/// Number of vertices or triangles of the chunk.
+			uint64					mFill;			/// Number of encoded bytes at the start of mBuffer.
+		};
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		PlyMeshEncoder(const PlyMeshEncoder &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		PlyMeshEncoder &operator =(const PlyMeshEncoder &rhs) { assert(false); return *this; }
+
+		/** Encodes the elements of a chunk into its buffer.
+		@param task Set this to the chunk with its element range. Its buffer is enlarged if necessary. */
+		void encode(ChunkTask &task) const;
+
+		/** Encodes triangles as ASCII or binary faces with three vertex indices.
+		@param task Set this to the chunk with its triangle range. */
+		void encodeTriangles(ChunkTask &task) const;
+
+		/** Encodes vertices as ASCII lines or binary records.
+		@param task Set this to the chunk with its vertex range. */
+		void encodeVertices(ChunkTask &task) const;
+
+		/** Encodes all chunks of the current arrays and writes them in file order.
+		@param writer Set this to the writer of the ply file.
+		@param elementCount Set this to the number of vertices or triangles. */
+		void write(Storage::BufferedFileWriter &writer, const uint64 elementCount);
+
+	private:
+		const Math::Vector3	*mColors;			/// Colors of the written vertices or NULL.
+		const Math::Vector3	*mNormals;			/// Normals of the written vertices or NULL.
+		const Math::Vector3	*mPositions;		/// Positions of the written vertices or NULL while triangles are written.
+		const Real			*mConfidences;		/// Confidences of the written vertices or NULL.
+		const Real			*mValues;			/// Scalars of the written vertices or NULL.
+		const uint32		*mViewIDs;			/// View IDs of the written vertices or NULL.
+		const uint32		*mIndices;			/// Vertex indices of the written triangles or NULL while vertices are written.
+		uint32				mViewsPerVertex;	/// Number of view IDs per vertex.
+		Encoding			mEncoding;			/// Encoding of the ply file.
+		bool				mSinglePrecision;	/// Is true if real attributes are written as floats.
+		bool				mSwapBytes;			/// Is true if the binary byte order differs from the host byte order.
+	};
+}
+
+#endif // _UTILITIES_PLY_MESH_ENCODER_H_
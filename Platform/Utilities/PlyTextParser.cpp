@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include "Platform/FailureHandling/FileCorruptionException.h"
+#include "Platform/Multithreading/Manager.h"
+#include "Platform/Utilities/NumberParsing.h"
+#include "Platform/Utilities/PlyTextParser.h"
+
+using namespace FailureHandling;
+using namespace Graphics;
+using namespace Platform::Multithreading;
+using namespace std;
+using namespace Storage;
+using namespace Utilities;
+
+namespace
+{
+	/** Returns the end of the line which starts at start.
+	@param start Set this to the first character of a line.
+	@param end Set this to the end of the text.
+	@return Returns the position of the line break or end if the line is not terminated. */
+	inline const char *findLineEnd(const char *start, const char *end)
+	{
+		const char *lineEnd = (const char *) memchr(start, '\n', end - start);
+		return (lineEnd ? lineEnd : end);
+	}
+}
+
+void PlyTextParser::ChunkTask::function()
+{
+	mParser->processChunk(*mChunk);
+}
+
+const char *PlyTextParser::parseFace(vector<uint32> &indices, const FacesDescription &format, const char *start, const char *end)
+{
+	const ElementsSyntax &listSizeTypes = format.getListSizeTypes();
+	const ElementsSemantics &semantics = format.getSemantics();
+	const uint32 propertyCount = format.getPropertyCount();
+	const char *position = start;
+
+	for (uint32 propertyIdx = 0; propertyIdx < propertyCount; ++propertyIdx)
+	{
+		while (position < end && isWhiteSpace(*position))
+			++position;
+
+		// single properties of faces are ignored
+		if (ElementsDescription::TYPE_INVALID == listSizeTypes[propertyIdx])
+		{
+			double trash;
+			const char *next = parseReal(trash, position, end);
+			if (next == position)
+				return NULL;
+
+			position = next;
+			continue;
+		}
+
+		// list size
+		int64 listSize;
+		const char *next = parseInteger(listSize, position, end);
+		if (next == position || listSize < 0)
+			return NULL;
+		position = next;
+
+		const bool vertexIndices = (FacesDescription::SEMANTIC_VERTEX_INDICES == semantics[propertyIdx]);
+		if (vertexIndices && (listSize > 4 || listSize < 3))
+			return NULL;
+
+		// list elements
+		for (int64 listElementIdx = 0; listElementIdx < listSize; ++listElementIdx)
+		{
+			while (position < end && isWhiteSpace(*position))
+				++position;
+
+			int64 element;
+			next = parseInteger(element, position, end);
+			if (next == position)
+				return NULL;
+			position = next;
+
+			if (!vertexIndices)
+				continue;
+
+			// simple triangle or second triangle of a quad with the same winding order
+			if (listElementIdx < 3)
+			{
+				indices.push_back((uint32) element);
+				continue;
+			}
+
+			const size_t indexCount = indices.size();
+			const uint32 index0 = indices[indexCount - 3];
+			const uint32 index2 = indices[indexCount - 1];
+
+			indices.push_back(index0);
+			indices.push_back(index2);
+			indices.push_back((uint32) element);
+		}
+	}
+
+	return position;
+}
+
+PlyTextParser::PlyTextParser(const Path &fileName) :
+	mName(fileName), mDecoder(NULL), mFacesFormat(NULL), mVertices(NULL), mBuffer(NULL), mPass(PASS_COUNT)
+{
+
+}
+
+const char *PlyTextParser::parseFaces(vector<uint32> &indices, const FacesDescription &format, const char *start, const char *end)
+{
+	const char *sectionEnd = findLines(start, end, format.getElementCount(), "faces");
+
+	mFacesFormat = &format;
+	run(PASS_FACES);
+
+	// concatenate the indices of all chunks in file order
+	size_t indexCount = indices.size();
+	for (size_t chunkIdx = 0; chunkIdx < mChunks.size(); ++chunkIdx)
+		indexCount += mChunks[chunkIdx].mIndices.size();
+	indices.reserve(indexCount);
+
+	for (size_t chunkIdx = 0; chunkIdx < mChunks.size(); ++chunkIdx)
+	{
+		const Chunk &chunk = mChunks[chunkIdx];
+		if (chunk.mFailed)
+		{
+			ostringstream error;
+			error << "Could not parse a face of an ASCII ply file within lines " << chunk.mFirstLine << " to " <<
+				chunk.mFirstLine + chunk.mLineCount << " after the face element start.";
+			throw FileCorruptionException(error.str(), mName);
+		}
+
+		indices.insert(indices.end(), chunk.mIndices.begin(), chunk.mIndices.end());
+	}
+
+	mFacesFormat = NULL;
+	mChunks.clear();
+	return sectionEnd;
+}
+
+const char *PlyTextParser::parseVertices(PlyVertices &vertices, const PlyVertexDecoder &decoder, const uint64 vertexCount,
+	const char *start, const char *end)
+{
+	mVertices = &vertices;
+	return parseVertexLines(decoder, vertexCount, start, end);
+}
+
+const char *PlyTextParser::parseVertices(uint8 *buffer, const PlyVertexDecoder &decoder, const uint64 vertexCount,
+	const char *start, const char *end)
+{
+	mBuffer = buffer;
+	return parseVertexLines(decoder, vertexCount, start, end);
+}
+
+const char *PlyTextParser::parseVertexLines(const PlyVertexDecoder &decoder, const uint64 vertexCount, const char *start, const char *end)
+{
+	const char *sectionEnd = findLines(start, end, vertexCount, "vertices");
+
+	mDecoder = &decoder;
+	run(PASS_VERTICES);
+
+	for (size_t chunkIdx = 0; chunkIdx < mChunks.size(); ++chunkIdx)
+	{
+		const Chunk &chunk = mChunks[chunkIdx];
+		if (!chunk.mFailed)
+			continue;
+
+		ostringstream error;
+		error << "Could not parse a vertex of an ASCII ply file within lines " << chunk.mFirstLine << " to " <<
+			chunk.mFirstLine + chunk.mLineCount << " after the vertex element start.";
+		throw FileCorruptionException(error.str(), mName);
+	}
+
+	mDecoder = NULL;
+	mVertices = NULL;
+	mBuffer = NULL;
+	mChunks.clear();
+	return sectionEnd;
+}
+
+const char *PlyTextParser::findLines(const char *start, const char *end, const uint64 lineCount, const char *elementName)
+{
+	// split the text into chunks which end after line breaks
+	mChunks.clear();
+	if (0 == lineCount)
+		return start;
+
+	// skip the rest of a line which was read value by value
+	const char *textStart = start;
+	while (textStart < end && '\n' != *textStart && isWhiteSpace(*textStart))
+		++textStart;
+	textStart = (textStart < end && '\n' == *textStart ? textStart + 1 : start);
+
+	for (const char *chunkStart = textStart; chunkStart < end; )
+	{
+		const char *chunkEnd = (end - chunkStart > CHUNK_SIZE ? chunkStart + CHUNK_SIZE : end);
+		if (chunkEnd < end)
+		{
+			chunkEnd = findLineEnd(chunkEnd, end);
+			if (chunkEnd < end)
+				++chunkEnd;
+		}
+
+		mChunks.resize(mChunks.size() + 1);
+		Chunk &chunk = mChunks.back();
+		chunk.mStart = chunkStart;
+		chunk.mEnd = chunkEnd;
+		chunk.mFirstLine = 0;
+		chunk.mLineCount = 0;
+		chunk.mFailed = false;
+
+		chunkStart = chunkEnd;
+	}
+
+	// get the first line index of each chunk
+	run(PASS_COUNT_LINES);
+
+	uint64 firstLine = 0;
+	size_t chunkCount = 0;
+	for (; chunkCount < mChunks.size() && firstLine < lineCount; ++chunkCount)
+	{
+		mChunks[chunkCount].mFirstLine = firstLine;
+		firstLine += mChunks[chunkCount].mLineCount;
+	}
+
+	if (firstLine < lineCount)
+	{
+		ostringstream error;
+		error << "The ply file ends within its " << elementName << ".";
+		throw FileCorruptionException(error.str(), mName);
+	}
+
+	// remove the lines behind the last requested one
+	mChunks.resize(chunkCount);
+	Chunk &last = mChunks.back();
+
+	const char *lineStart = last.mStart;
+	for (uint64 lineIdx = last.mFirstLine; lineIdx < lineCount; ++lineIdx)
+	{
+		lineStart = findLineEnd(lineStart, last.mEnd);
+		if (lineStart < last.mEnd)
+			++lineStart;
+	}
+
+	last.mEnd = lineStart;
+	last.mLineCount = lineCount - last.mFirstLine;
+	return lineStart;
+}
+
+void PlyTextParser::processChunk(Chunk &chunk)
+{
+	if (PASS_COUNT_LINES == mPass)
+	{
+		// lines of the last chunk might not end with a line break
+		uint64 lineCount = 0;
+		for (const char *lineStart = chunk.mStart; lineStart < chunk.mEnd; ++lineCount)
+		{
+			lineStart = findLineEnd(lineStart, chunk.mEnd);
+			if (lineStart < chunk.mEnd)
+				++lineStart;
+		}
+
+		chunk.mLineCount = lineCount;
+		return;
+	}
+
+	// parse each line of the chunk
+	const char *lineStart = chunk.mStart;
+	for (uint64 lineIdx = 0; lineIdx < chunk.mLineCount; ++lineIdx)
+	{
+		const char *lineEnd = findLineEnd(lineStart, chunk.mEnd);
+		const char *parsedEnd = NULL;
+
+		if (PASS_VERTICES == mPass && mVertices)
+			parsedEnd = mDecoder->decodeText(*mVertices, chunk.mFirstLine + lineIdx, lineStart, lineEnd);
+		else if (PASS_VERTICES == mPass)
+			parsedEnd = mDecoder->decodeText(mBuffer, chunk.mFirstLine + lineIdx, lineStart, lineEnd);
+		else
+			parsedEnd = parseFace(chunk.mIndices, *mFacesFormat, lineStart, lineEnd);
+
+		if (!parsedEnd)
+		{
+			chunk.mFailed = true;
+			return;
+		}
+
+		lineStart = (lineEnd < chunk.mEnd ? lineEnd + 1 : lineEnd);
+	}
+}
+
+void PlyTextParser::run(const PASS pass)
+{
+	mPass = pass;
+
+	const size_t chunkCount = mChunks.size();
+	if (chunkCount < 2 || !Manager::exists() || !Manager::getSingleton().isRunning() || Manager::isWorkerThread())
+	{
+		for (size_t chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx)
+			processChunk(mChunks[chunkIdx]);
+		return;
+	}
+
+	// one task per chunk
+	unique_ptr<ChunkTask[]> tasks(new ChunkTask[chunkCount]);
+	Manager &manager = Manager::getSingleton();
+
+	for (size_t chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx)
+	{
+		ChunkTask &task = tasks[chunkIdx];
+		task.mChunk = &mChunks[chunkIdx];
+		task.mParser = this;
+		manager.enqueue(&task);
+	}
+
+	for (size_t chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx)
+		tasks[chunkIdx].waitUntilFinished();
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _UTILITIES_PLY_TEXT_PARSER_H_
+#define _UTILITIES_PLY_TEXT_PARSER_H_
+
+#include <cassert>
+#include <vector>
+#include "Graphics/FacesDescription.h"
+#include "Platform/DataTypes.h"
+#include "Platform/Multithreading/Task.h"
+#include "Platform/Storage/Path.h"
+#include "Platform/Utilities/PlyVertexDecoder.h"
+
+namespace Utilities
+{
+	/// Parses the elements of ASCII ply files in memory with several threads.
+	/** The text is split into chunks of about CHUNK_SIZE bytes at line boundaries and the lines of all chunks are counted concurrently
+		to get the index of the first element in each chunk. Then all chunks with lines of the requested elements are parsed concurrently
+		directly into the output arrays. Chunks are processed by tasks of the Platform::Multithreading::Manager if it is running and
+		if the caller is not one of its workers, otherwise by the calling thread.
+		Each element must be stored in a single line as required by the ply format. */
+	class PlyTextParser
+	{
+	public:
+		/** Parses a single ASCII encoded face, i.e., a line of the face element of an ASCII ply file.
+			Vertex index lists of quads are converted to two triangles like by PlyFile::loadTriangles().
+		@param indices The vertex indices of the face are appended to indices. Lists of other properties are skipped.
+		@param format Set this to the face format of the file.
+		@param start Set this to the first character of the face. Leading white space is skipped.
+		@param end Set this to the end of the readable characters, e.g., the end of the line.
+		@return Returns a pointer behind the last parsed number or NULL if numbers are missing or if a face is neither a triangle nor a quad. */
+		static const char *parseFace(std::vector<uint32> &indices, const Graphics::FacesDescription &format, const char *start, const char *end);
+
+	public:
+		/** Prepares parsing text of a ply file.
+		@param fileName Set this to the name of the parsed file which is used for exceptions. */
+		PlyTextParser(const Storage::Path &fileName);
+
+		/** Parses the face lines at the beginning of some text.
+		@param indices The vertex indices of all faces are appended to indices in file order.
+		@param format Set this to the face format of the file, see PlyFile::loadHeader(). It defines the number of parsed lines.
+		@param start Set this to the first character of the first face line.
+		@param end Set this to the end of the text, e.g., the end of the file.
+		@return Returns a pointer behind the line break of the last face line.
+		@throws FileCorruptionException Is thrown if there are fewer lines than faces or if a face cannot be parsed. */
+		const char *parseFaces(std::vector<uint32> &indices, const Graphics::FacesDescription &format, const char *start, const char *end);
+
+		/** Parses the vertex lines at the beginning of some text.
+		@param vertices Is filled with the vertices, see PlyVertexDecoder::prepare().
+		@param decoder Set this to the decoder for the vertex format of the file.
+		@param vertexCount Set this to the number of parsed vertex lines.
+		@param start Set this to the first character of the first vertex line.
+		@param end Set this to the end of the text, e.g., the end of the file.
+		@return Returns a pointer behind the line break of the last vertex line.
+		@throws FileCorruptionException Is thrown if there are fewer lines than vertices or if a vertex cannot be parsed. */
+		const char *parseVertices(PlyVertices &vertices, const PlyVertexDecoder &decoder, const uint64 vertexCount, const char *start, const char *end);
+
+		/** Parses the vertex lines at the beginning of some text into an interleaved vertex buffer.
+		@param buffer Is filled with vertexCount vertices, see PlyVertexDecoder::InterleavedLayout.
+		@param decoder Set this to the decoder for the vertex format of the file and the layout of buffer.
+		@param vertexCount Set this to the number of parsed vertex lines.
+		@param start Set this to the first character of the first vertex line.
+		@param end Set this to the end of the text, e.g., the end of the file.
+		@return Returns a pointer behind the line break of the last vertex line.
+		@throws FileCorruptionException Is thrown if there are fewer lines than vertices or if a vertex cannot be parsed. */
+		const char *parseVertices(uint8 *buffer, const PlyVertexDecoder &decoder, const uint64 vertexCount, const char *start, const char *end);
+
+	public:
+		static const uint32 CHUNK_SIZE = 1u << 22;	/// Approximate number of characters per chunk which is processed by a single task.
+
+	private:
+		/// Work of each pass over the chunks.
+		enum PASS
+		{
+			PASS_COUNT_LINES,	/// Counting of the lines in each chunk.
+			PASS_VERTICES,		/// Parsing of vertex lines.
+			PASS_FACES,			/// Parsing of face lines.
+			PASS_COUNT			/// Number of passes.
+		};
+
+		/// Consecutive lines which are processed by a single task.
+		struct Chunk
+		{
+			std::vector<uint32>	mIndices;		/// Parsed vertex indices of the faces in the chunk.
+			const char			*mStart;		/// First character of the first line.
+			const char			*mEnd;			/// Position behind the line break of the last line.
+			uint64				mFirstLine;		/// Index of the first line of the chunk in the complete text.
+			uint64				mLineCount;		/// Number of lines in the chunk.
+			bool				mFailed;		/// Is set to true if a line could not be parsed.
+		};
+
+		/// Processes a single chunk on a worker thread.
+		class ChunkTask : public Platform::Multithreading::Task
+		{
+		public:
+			ChunkTask() : Task(), mChunk(NULL), mParser(NULL) { }
+			virtual void function();
+
+		public:
+			Chunk			*mChunk;	/// Processed chunk.
+			PlyTextParser	*mParser;	/// Parser which defines the work for the chunk.
+		};
+
+	private:
+		/** Copy constructor is forbidden.
+		@param copy Copy constructor is forbidden. */
+		PlyTextParser(const PlyTextParser &copy) { assert(false); }
+
+		/** Assignment operator is forbidden.
+		@param rhs Operator is forbidden.*/
+		PlyTextParser &operator =(const PlyTextParser &rhs) { assert(false); return *this; }
+
+		/** Splits text into chunks, counts their lines and removes the chunk parts behind a number of lines.
+		@param start Set this to the first character of the text. If the text starts with the white space and the line break which remain after
+			reading the values of the previous line one by one, then the text is considered to start behind this line break.
+		@param end Set this to the end of the text.
+		@param lineCount Set this to the number of lines which are required.
+		@param elementName Set this to the name of the elements in the lines, e.g., "vertices", for exceptions.
+		@return Returns a pointer behind the line break of line lineCount - 1 or start if lineCount is 0.
+		@throws FileCorruptionException Is thrown if the text has fewer than lineCount lines. */
+		const char *findLines(const char *start, const char *end, const uint64 lineCount, const char *elementName);
+
+		/** Parses the vertex lines at the beginning of some text into mVertices or mBuffer, see parseVertices().
+		@param decoder Set this to the decoder for the vertex format of the file.
+		@param vertexCount Set this to the number of parsed vertex lines.
+		@param start Set this to the first character of the first vertex line.
+		@param end Set this to the end of the text.
+		@return Returns a pointer behind the line break of the last vertex line. */
+		const char *parseVertexLines(const PlyVertexDecoder &decoder, const uint64 vertexCount, const char *start, const char *end);
+
+		/** Executes the current pass for a chunk. */
+		void processChunk(Chunk &chunk);
+
+		/** Executes the current pass for all chunks, concurrently if possible.
+		@param pass Set this to the work which is done for each chunk. */
+		void run(const PASS pass);
+
+	private:
+		std::vector<Chunk>					mChunks;		/// Chunks of the currently parsed text.
+		const Storage::Path					mName;			/// Name of the parsed file for exceptions.
+		const PlyVertexDecoder				*mDecoder;		/// Decoder of parsed vertices.
+		const Graphics::FacesDescription	*mFacesFormat;	/// Format of parsed faces.
+		PlyVertices							*mVertices;		/// Receives the parsed vertices or NULL if they are parsed into mBuffer.
+		uint8								*mBuffer;		/// Interleaved buffer which receives the parsed vertices or NULL.
+		PASS								mPass;			/// Work which is currently done for each chunk.
+	};
+}
+
+#endif // _UTILITIES_PLY_TEXT_PARSER_H_
@@ -0,0 +1,676 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+
+#include <cassert>
+#include <cstring>
+#include "Platform/Utilities/ByteSwapping.h"
+#include "Platform/Utilities/NumberParsing.h"
+#include "Platform/Utilities/PlyVertexDecoder.h"
+
+using namespace Graphics;
+using namespace Math;
+using namespace std;
+using namespace Utilities;
+
+namespace
+{
+	/** Loads an unaligned binary value and converts it to host byte order.
+	@param source Set this to the first byte of the value.
+	@return Returns the value in host byte order. */
+	template <class T, bool SWAP>
+	inline T loadValue(const uint8 *source)
+	{
+		T value;
+		if (!SWAP)
+		{
+			memcpy(&value, source, sizeof(T));
+			return value;
+		}
+
+		uint8 bytes[sizeof(T)];
+		for (uint32 byteIdx = 0; byteIdx < sizeof(T); ++byteIdx)
+			bytes[byteIdx] = source[sizeof(T) - 1 - byteIdx];
+		memcpy(&value, bytes, sizeof(T));
+		return value;
+	}
+
+	/** Stores a value at a possibly unaligned position of an interleaved buffer.
+	@param target Set this to the first byte of the stored value.
+	@param value Set this to the stored value. */
+	template <class T>
+	inline void storeValue(uint8 *target, const T value)
+	{
+		memcpy(target, &value, sizeof(T));
+	}
+
+	/** Converts a float to an IEEE 754 half float with rounding to the nearest even value.
+	@param value Set this to the converted value. Values beyond the half float range become infinity.
+	@return Returns the bits of the half float. */
+	inline uint16 toHalf(const float value)
+	{
+		uint32 bits;
+		memcpy(&bits, &value, sizeof(float));
+
+		const uint32 sign = (bits >> 16) & 0x8000u;
+		const uint32 absolute = bits & 0x7FFFFFFFu;
+
+		// infinity, NaN and values which round to infinity
+		if (absolute >= 0x7F800000u)
+			return (uint16) (sign | 0x7C00u | (absolute > 0x7F800000u ? 0x200u : 0u));
+		if (absolute >= 0x477FF000u)
+			return (uint16) (sign | 0x7C00u);
+
+		// normalized half floats: rebias the exponent and round the mantissa at bit 13
+		if (absolute >= 0x38800000u)
+			return (uint16) (sign | ((absolute + 0xFFFu + ((absolute >> 13) & 1u) - 0x38000000u) >> 13));
+
+		// subnormal half floats or zero
+		if (absolute < 0x33000000u)
+			return (uint16) sign;
+
+		const uint32 mantissa = (absolute & 0x7FFFFFu) | 0x800000u;
+		const uint32 shift = 126u - (absolute >> 23);
+		const uint32 halfway = 1u << (shift - 1);
+		const uint32 remainder = mantissa & ((1u << shift) - 1);
+
+		uint32 result = mantissa >> shift;
+		if (remainder > halfway || (remainder == halfway && 0 != (result & 1u)))
+			++result;
+		return (uint16) (sign | result);
+	}
+
+	/** Converts an integer, e.g., a color component, to an unsigned byte.
+	@param value Set this to the converted value.
+	@return Returns value clamped to [0, 255]. */
+	inline uint8 toUInt8(const int64 value)
+	{
+		return (uint8) (value < 0 ? 0 : (value > 255 ? 255 : value));
+	}
+
+	/** Converts a real value in [0, 1] to a normalized unsigned byte.
+	@param value Set this to the converted value. It is clamped to [0, 1].
+	@return Returns the nearest byte of value * 255. */
+	inline uint8 toUnorm8(const double value)
+	{
+		if (!(value > 0.0))
+			return 0;
+		if (value >= 1.0)
+			return 255;
+		return (uint8) (value * 255.0 + 0.5);
+	}
+
+	/** Converts a parsed ASCII integer to the integer type of its property like File::readUInt8() etc.
+	@param value Set this to the parsed integer.
+	@param type Set this to the integer type of the property.
+	@return Returns value after conversion to type. */
+	inline int64 toPropertyType(const int64 value, const ElementsDescription::TYPES type)
+	{
+		switch (type)
+		{
+			case ElementsDescription::TYPE_UCHAR: case ElementsDescription::TYPE_UINT8:
+				return (uint8) value;
+
+			case ElementsDescription::TYPE_INT16:
+				return (int16) value;
+
+			case ElementsDescription::TYPE_UINT16:
+				return (uint16) value;
+
+			case ElementsDescription::TYPE_INT: case ElementsDescription::TYPE_INT32:
+				return (int32) value;
+
+			default:
+				return (uint32) value;
+		}
+	}
+}
+
+uint32 PlyVertexDecoder::getTypeSize(const ElementsDescription::TYPES type)
+{
+	switch (type)
+	{
+		case ElementsDescription::TYPE_DOUBLE: case ElementsDescription::TYPE_FLOAT64:
+			return 8;
+
+		case ElementsDescription::TYPE_FLOAT: case ElementsDescription::TYPE_FLOAT32:
+		case ElementsDescription::TYPE_INT: case ElementsDescription::TYPE_INT32:
+		case ElementsDescription::TYPE_UINT: case ElementsDescription::TYPE_UINT32:
+			return 4;
+
+		case ElementsDescription::TYPE_INT16: case ElementsDescription::TYPE_UINT16:
+			return 2;
+
+		case ElementsDescription::TYPE_UCHAR: case ElementsDescription::TYPE_UINT8:
+			return 1;
+
+		case ElementsDescription::TYPE_INVALID: case ElementsDescription::TYPE_COUNT: default:
+			return 0;
+	}
+}
+
+uint32 PlyVertexDecoder::getComponentSize(const COMPONENT_TYPE type)
+{
+	switch (type)
+	{
+		case COMPONENT_FLOAT32: case COMPONENT_UINT32:
+			return 4;
+
+		case COMPONENT_FLOAT16:
+			return 2;
+
+		case COMPONENT_UNORM8:
+			return 1;
+
+		case COMPONENT_NONE: case COMPONENT_COUNT: default:
+			return 0;
+	}
+}
+
+PlyVertexDecoder::PlyVertexDecoder(const VerticesDescription &format, const uint32 attributeMask) :
+	mLayoutStride(0), mVertexSize(0), mViewsPerVertex(0), mValid(true)
+{
+	compile(format, attributeMask, NULL);
+}
+
+PlyVertexDecoder::PlyVertexDecoder(const VerticesDescription &format, const InterleavedLayout &layout) :
+	mLayoutStride(layout.mStride), mVertexSize(0), mViewsPerVertex(0), mValid(true)
+{
+	assert(0 != layout.mStride);
+
+	// attributes which are not written are skipped
+	uint32 attributeMask = 0;
+	for (uint32 attributeIdx = 0; attributeIdx < ATTRIBUTE_COUNT; ++attributeIdx)
+		if (COMPONENT_NONE != layout.mTypes[attributeIdx])
+			attributeMask |= (1u << attributeIdx);
+
+	compile(format, attributeMask, &layout);
+}
+
+void PlyVertexDecoder::compile(const VerticesDescription &format, const uint32 attributeMask, const InterleavedLayout *layout)
+{
+	const vector<ElementsDescription::TYPES> &types = format.getTypeStructure();
+	const vector<uint32> &semantics = format.getSemantics();
+	const uint32 propertyCount = format.getPropertyCount();
+
+	for (uint32 attributeIdx = 0; attributeIdx < ATTRIBUTE_COUNT; ++attributeIdx)
+		mAttributes[attributeIdx] = false;
+	mOperations.reserve(propertyCount);
+	mSwapBytes = (ENCODING_BINARY_BIG_ENDIAN == format.getEncoding()) != isHostBigEndian();
+
+	// an operation per property at its fixed offset
+	for (uint32 propertyIdx = 0; propertyIdx < propertyCount; ++propertyIdx)
+	{
+		const ElementsDescription::TYPES type = types[propertyIdx];
+		const uint32 semantic = semantics[propertyIdx];
+		const uint32 size = getTypeSize(type);
+		const uint32 offset = mVertexSize;
+
+		mVertexSize += size;
+		if (0 == size || semantic >= VerticesDescription::SEMANTIC_INVALID)
+		{
+			mValid = false;
+			continue;
+		}
+
+		Operation operation;
+		operation.mSourceOffset = offset;
+		operation.mComponent = 0;
+		operation.mTargetOffset = 0;
+		operation.mSourceType = type;
+		operation.mTarget = TARGET_REAL;
+
+		if (VerticesDescription::SEMANTIC_UNKNOWN == semantic)
+		{
+			// only skipped
+			operation.mAttribute = ATTRIBUTE_COUNT;
+			mOperations.push_back(operation);
+			continue;
+		}
+
+		if (semantic <= VerticesDescription::SEMANTIC_Z)
+		{
+			operation.mAttribute = ATTRIBUTE_POSITION;
+			operation.mComponent = semantic - VerticesDescription::SEMANTIC_X;
+		}
+		else if (semantic <= VerticesDescription::SEMANTIC_NZ)
+		{
+			operation.mAttribute = ATTRIBUTE_NORMAL;
+			operation.mComponent = semantic - VerticesDescription::SEMANTIC_NX;
+		}
+		else if (semantic <= VerticesDescription::SEMANTIC_DIFFUSE_BLUE)
+		{
+			// integer colors are scaled to [0, 1]
+			operation.mAttribute = ATTRIBUTE_COLOR;
+			operation.mComponent = (semantic - VerticesDescription::SEMANTIC_R) / 3;
+			if (type >= ElementsDescription::TYPE_UCHAR)
+				operation.mTarget = TARGET_UNIT_REAL;
+		}
+		else if (semantic <= VerticesDescription::SEMANTIC_V)
+		{
+			operation.mAttribute = ATTRIBUTE_UV_COORDS;
+			operation.mComponent = semantic - VerticesDescription::SEMANTIC_U;
+		}
+		else if (VerticesDescription::SEMANTIC_CONFIDENCE == semantic)
+		{
+			operation.mAttribute = ATTRIBUTE_CONFIDENCE;
+		}
+		else if (VerticesDescription::SEMANTIC_VALUE == semantic)
+		{
+			operation.mAttribute = ATTRIBUTE_VALUE;
+		}
+		else
+		{
+			operation.mAttribute = ATTRIBUTE_VIEW_IDS;
+			operation.mComponent = semantic - VerticesDescription::SEMANTIC_VIEWID0;
+			operation.mTarget = TARGET_UINT32;
+		}
+
+		// unwanted attributes are only skipped
+		if (0 == (attributeMask & (1u << operation.mAttribute)))
+		{
+			operation.mAttribute = ATTRIBUTE_COUNT;
+			mOperations.push_back(operation);
+			continue;
+		}
+
+		// conversion to the component type of interleaved buffers
+		if (layout)
+		{
+			const COMPONENT_TYPE componentType = layout->mTypes[operation.mAttribute];
+			const bool unit = (TARGET_UNIT_REAL == operation.mTarget);
+			operation.mTargetOffset = layout->mOffsets[operation.mAttribute] + operation.mComponent * getComponentSize(componentType);
+
+			switch (componentType)
+			{
+				case COMPONENT_FLOAT32:
+					operation.mTarget = (unit ? TARGET_UNIT_FLOAT32 : TARGET_FLOAT32);
+					break;
+
+				case COMPONENT_FLOAT16:
+					operation.mTarget = (unit ? TARGET_UNIT_FLOAT16 : TARGET_FLOAT16);
+					break;
+
+				case COMPONENT_UNORM8:
+					operation.mTarget = (unit ? TARGET_UINT8 : TARGET_UNORM8);
+					break;
+
+				case COMPONENT_UINT32:
+					operation.mTarget = TARGET_UINT32;
+					break;
+
+				default:
+					assert(false);
+			}
+		}
+
+		if (ATTRIBUTE_VIEW_IDS == operation.mAttribute && operation.mComponent >= mViewsPerVertex)
+			mViewsPerVertex = operation.mComponent + 1;
+		mAttributes[operation.mAttribute] = true;
+		mOperations.push_back(operation);
+	}
+}
+
+void PlyVertexDecoder::decode(PlyVertices &vertices, const uint64 firstVertexIdx, const uint8 *source, const uint64 vertexCount) const
+{
+	assert(!isInterleaved());
+	assert(vertices.mViewsPerVertex == mViewsPerVertex);
+
+	Destination destination;
+	destination.mVertices = &vertices;
+	destination.mBuffer = NULL;
+	decodeBlocks(destination, firstVertexIdx, source, vertexCount);
+}
+
+void PlyVertexDecoder::decode(uint8 *buffer, const uint64 firstVertexIdx, const uint8 *source, const uint64 vertexCount) const
+{
+	assert(isInterleaved());
+
+	Destination destination;
+	destination.mVertices = NULL;
+	destination.mBuffer = buffer;
+	decodeBlocks(destination, firstVertexIdx, source, vertexCount);
+}
+
+void PlyVertexDecoder::decodeBlocks(const Destination &destination, const uint64 firstVertexIdx, const uint8 *source, const uint64 vertexCount) const
+{
+	assert(mValid);
+	if (0 == mVertexSize)
+		return;
+
+	// blocks which stay in the cache while each property is decoded separately
+	const uint64 blockVertexCount = (mVertexSize < BLOCK_SIZE ? BLOCK_SIZE / mVertexSize : 1);
+
+	for (uint64 blockStart = 0; blockStart < vertexCount; blockStart += blockVertexCount)
+	{
+		const uint64 blockCount = (vertexCount - blockStart < blockVertexCount ? vertexCount - blockStart : blockVertexCount);
+		const uint64 vertexIdx = firstVertexIdx + blockStart;
+		const uint8 *block = source + blockStart * mVertexSize;
+
+		for (size_t operationIdx = 0; operationIdx < mOperations.size(); ++operationIdx)
+		{
+			const Operation &operation = mOperations[operationIdx];
+			if (ATTRIBUTE_COUNT == operation.mAttribute)
+				continue;
+
+			uint32 targetStride = 0;
+			uint8 *target = getTarget(targetStride, destination, operation, vertexIdx);
+			decodeProperty(operation, target, targetStride, block, blockCount);
+		}
+	}
+}
+
+template <class Source, bool SWAP>
+void PlyVertexDecoder::decodeColumn(uint8 *target, const uint32 targetStride, const TARGET conversion,
+	const uint8 *source, const uint32 sourceStride, const uint64 vertexCount)
+{
+	// a loop per conversion without any branches per value
+	switch (conversion)
+	{
+		case TARGET_REAL:
+		{
+			for (uint64 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx, source += sourceStride, target += targetStride)
+				*reinterpret_cast<Real *>(target) = (Real) loadValue<Source, SWAP>(source);
+			return;
+		}
+
+		case TARGET_UNIT_REAL:
+		{
+			for (uint64 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx, source += sourceStride, target += targetStride)
+				*reinterpret_cast<Real *>(target) = (Real) ((uint32) loadValue<Source, SWAP>(source) / 255.0f);
+			return;
+		}
+
+		case TARGET_UINT32:
+		{
+			for (uint64 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx, source += sourceStride, target += targetStride)
+				storeValue<uint32>(target, (uint32) loadValue<Source, SWAP>(source));
+			return;
+		}
+
+		case TARGET_FLOAT32:
+		{
+			for (uint64 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx, source += sourceStride, target += targetStride)
+				storeValue<float>(target, (float) loadValue<Source, SWAP>(source));
+			return;
+		}
+
+		case TARGET_UNIT_FLOAT32:
+		{
+			for (uint64 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx, source += sourceStride, target += targetStride)
+				storeValue<float>(target, (uint32) loadValue<Source, SWAP>(source) / 255.0f);
+			return;
+		}
+
+		case TARGET_FLOAT16:
+		{
+			for (uint64 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx, source += sourceStride, target += targetStride)
+				storeValue<uint16>(target, toHalf((float) loadValue<Source, SWAP>(source)));
+			return;
+		}
+
+		case TARGET_UNIT_FLOAT16:
+		{
+			for (uint64 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx, source += sourceStride, target += targetStride)
+				storeValue<uint16>(target, toHalf((uint32) loadValue<Source, SWAP>(source) / 255.0f));
+			return;
+		}
+
+		case TARGET_UNORM8:
+		{
+			for (uint64 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx, source += sourceStride, target += targetStride)
+				*target = toUnorm8((double) loadValue<Source, SWAP>(source));
+			return;
+		}
+
+		case TARGET_UINT8:
+		{
+			for (uint64 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx, source += sourceStride, target += targetStride)
+				*target = toUInt8((int64) loadValue<Source, SWAP>(source));
+			return;
+		}
+
+		default:
+			assert(false);
+	}
+}
+
+void PlyVertexDecoder::decodeProperty(const Operation &operation, uint8 *target, const uint32 targetStride,
+	const uint8 *source, const uint64 vertexCount) const
+{
+	const TARGET conversion = operation.mTarget;
+	source += operation.mSourceOffset;
+
+	switch (operation.mSourceType)
+	{
+		case ElementsDescription::TYPE_DOUBLE: case ElementsDescription::TYPE_FLOAT64:
+			if (mSwapBytes)
+				decodeColumn<double, true>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			else
+				decodeColumn<double, false>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			return;
+
+		case ElementsDescription::TYPE_FLOAT: case ElementsDescription::TYPE_FLOAT32:
+			if (mSwapBytes)
+				decodeColumn<float, true>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			else
+				decodeColumn<float, false>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			return;
+
+		case ElementsDescription::TYPE_UCHAR: case ElementsDescription::TYPE_UINT8:
+			decodeColumn<uint8, false>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			return;
+
+		case ElementsDescription::TYPE_INT16:
+			if (mSwapBytes)
+				decodeColumn<int16, true>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			else
+				decodeColumn<int16, false>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			return;
+
+		case ElementsDescription::TYPE_UINT16:
+			if (mSwapBytes)
+				decodeColumn<uint16, true>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			else
+				decodeColumn<uint16, false>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			return;
+
+		case ElementsDescription::TYPE_INT: case ElementsDescription::TYPE_INT32:
+			if (mSwapBytes)
+				decodeColumn<int32, true>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			else
+				decodeColumn<int32, false>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			return;
+
+		case ElementsDescription::TYPE_UINT: case ElementsDescription::TYPE_UINT32:
+			if (mSwapBytes)
+				decodeColumn<uint32, true>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			else
+				decodeColumn<uint32, false>(target, targetStride, conversion, source, mVertexSize, vertexCount);
+			return;
+
+		default:
+			assert(false);
+	}
+}
+
+const char *PlyVertexDecoder::decodeText(PlyVertices &vertices, const uint64 vertexIdx, const char *start, const char *end) const
+{
+	assert(!isInterleaved());
+
+	Destination destination;
+	destination.mVertices = &vertices;
+	destination.mBuffer = NULL;
+	return decodeTextLine(destination, vertexIdx, start, end);
+}
+
+const char *PlyVertexDecoder::decodeText(uint8 *buffer, const uint64 vertexIdx, const char *start, const char *end) const
+{
+	assert(isInterleaved());
+
+	Destination destination;
+	destination.mVertices = NULL;
+	destination.mBuffer = buffer;
+	return decodeTextLine(destination, vertexIdx, start, end);
+}
+
+const char *PlyVertexDecoder::decodeTextLine(const Destination &destination, const uint64 vertexIdx, const char *start, const char *end) const
+{
+	const char *position = start;
+
+	for (size_t operationIdx = 0; operationIdx < mOperations.size(); ++operationIdx)
+	{
+		const Operation &operation = mOperations[operationIdx];
+		while (position < end && isWhiteSpace(*position))
+			++position;
+
+		// skipped values are not converted
+		if (ATTRIBUTE_COUNT == operation.mAttribute)
+		{
+			const char *valueStart = position;
+			while (position < end && !isWhiteSpace(*position))
+				++position;
+
+			if (valueStart == position)
+				return NULL;
+			continue;
+		}
+
+		// numbers are converted like by File::readFloat(), File::readInt32() etc.
+		const ElementsDescription::TYPES type = operation.mSourceType;
+		const bool isInteger = (type >= ElementsDescription::TYPE_UCHAR);
+		const char *numberEnd = NULL;
+		double real = 0.0;
+		int64 integer = 0;
+
+		if (ElementsDescription::TYPE_FLOAT == type || ElementsDescription::TYPE_FLOAT32 == type)
+		{
+			float singleReal = 0.0f;
+			numberEnd = parseReal(singleReal, position, end);
+			real = singleReal;
+		}
+		else if (!isInteger)
+		{
+			numberEnd = parseReal(real, position, end);
+		}
+		else
+		{
+			numberEnd = parseInteger(integer, position, end);
+			integer = toPropertyType(integer, type);
+		}
+
+		if (numberEnd == position)
+			return NULL;
+		position = numberEnd;
+
+		uint32 targetStride = 0;
+		uint8 *target = getTarget(targetStride, destination, operation, vertexIdx);
+
+		switch (operation.mTarget)
+		{
+			case TARGET_REAL:
+				*reinterpret_cast<Real *>(target) = (isInteger ? (Real) integer : (Real) real);
+				break;
+
+			case TARGET_UNIT_REAL:
+				*reinterpret_cast<Real *>(target) = (Real) ((uint32) integer / 255.0f);
+				break;
+
+			case TARGET_UINT32:
+				storeValue<uint32>(target, (isInteger ? (uint32) integer : (uint32) real));
+				break;
+
+			case TARGET_FLOAT32:
+				storeValue<float>(target, (isInteger ? (float) integer : (float) real));
+				break;
+
+			case TARGET_UNIT_FLOAT32:
+				storeValue<float>(target, (uint32) integer / 255.0f);
+				break;
+
+			case TARGET_FLOAT16:
+				storeValue<uint16>(target, toHalf(isInteger ? (float) integer : (float) real));
+				break;
+
+			case TARGET_UNIT_FLOAT16:
+				storeValue<uint16>(target, toHalf((uint32) integer / 255.0f));
+				break;
+
+			case TARGET_UNORM8:
+				*target = toUnorm8(isInteger ? (double) integer : real);
+				break;
+
+			case TARGET_UINT8:
+				*target = toUInt8(integer);
+				break;
+
+			default:
+				assert(false);
+		}
+	}
+
+	return position;
+}
+
+uint8 *PlyVertexDecoder::getTarget(uint32 &targetStride, const Destination &destination, const Operation &operation, const uint64 vertexIdx) const
+{
+	// interleaved buffers have fixed component offsets
+	if (destination.mBuffer)
+	{
+		targetStride = mLayoutStride;
+		return destination.mBuffer + vertexIdx * mLayoutStride + operation.mTargetOffset;
+	}
+
+	PlyVertices &vertices = *destination.mVertices;
+	switch (operation.mAttribute)
+	{
+		case ATTRIBUTE_POSITION:
+			targetStride = sizeof(Vector3);
+			return reinterpret_cast<uint8 *>(vertices.mPositions[vertexIdx].getData() + operation.mComponent);
+
+		case ATTRIBUTE_NORMAL:
+			targetStride = sizeof(Vector3);
+			return reinterpret_cast<uint8 *>(vertices.mNormals[vertexIdx].getData() + operation.mComponent);
+
+		case ATTRIBUTE_COLOR:
+			targetStride = sizeof(Vector3);
+			return reinterpret_cast<uint8 *>(vertices.mColors[vertexIdx].getData() + operation.mComponent);
+
+		case ATTRIBUTE_UV_COORDS:
+			targetStride = sizeof(Vector2);
+			return reinterpret_cast<uint8 *>(&vertices.mUVCoords[vertexIdx].x + operation.mComponent);
+
+		case ATTRIBUTE_CONFIDENCE:
+			targetStride = sizeof(Real);
+			return reinterpret_cast<uint8 *>(&vertices.mConfidences[vertexIdx]);
+
+		case ATTRIBUTE_VALUE:
+			targetStride = sizeof(Real);
+			return reinterpret_cast<uint8 *>(&vertices.mValues[vertexIdx]);
+
+		case ATTRIBUTE_VIEW_IDS:
+			targetStride = sizeof(uint32) * mViewsPerVertex;
+			return reinterpret_cast<uint8 *>(&vertices.mViewIDs[vertexIdx * mViewsPerVertex + operation.mComponent]);
+
+		default:
+			assert(false);
+			targetStride = 0;
+			return NULL;
+	}
+}
+
+void PlyVertexDecoder::prepare(PlyVertices &vertices, const uint64 vertexCount) const
+{
+	vertices.mPositions.resize(mAttributes[ATTRIBUTE_POSITION] ? vertexCount : 0);
+	vertices.mNormals.resize(mAttributes[ATTRIBUTE_NORMAL] ? vertexCount : 0);
+	vertices.mColors.resize(mAttributes[ATTRIBUTE_COLOR] ? vertexCount : 0);
+	vertices.mUVCoords.resize(mAttributes[ATTRIBUTE_UV_COORDS] ? vertexCount : 0);
+	vertices.mConfidences.resize(mAttributes[ATTRIBUTE_CONFIDENCE] ? vertexCount : 0);
+	vertices.mValues.resize(mAttributes[ATTRIBUTE_VALUE] ? vertexCount : 0);
+	vertices.mViewIDs.resize(vertexCount * mViewsPerVertex);
+	vertices.mViewsPerVertex = mViewsPerVertex;
+}
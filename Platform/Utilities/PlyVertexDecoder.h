@@ -0,0 +1,316 @@
+/*
+ * Copyright (C) 2017 by Author: Aroudj, Samir, born in Suhl, Thueringen, Germany
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD 3-Clause license. See the License.txt file for details.
+ */
+#ifndef _UTILITIES_PLY_VERTEX_DECODER_H_
+#define _UTILITIES_PLY_VERTEX_DECODER_H_
+
+#include <cassert>
+#include <vector>
+#include "Graphics/VerticesDescription.h"
+#include "Math/Vector2.h"
+#include "Math/Vector3.h"
+#include "Platform/DataTypes.h"
+
+namespace Utilities
+{
+	/// Vertex attributes of a ply file with one array per attribute, see PlyFile::loadVertices().
+	/** Arrays of attributes which are not stored in the file are empty. */
+	struct PlyVertices
+	{
+		std::vector<Math::Vector3>	mPositions;		/// Position of each vertex.
+		std::vector<Math::Vector3>	mNormals;		/// Normal of each vertex.
+		std::vector<Math::Vector3>	mColors;		/// RGB color of each vertex with components in [0, 1] for integer file colors.
+		std::vector<Math::Vector2>	mUVCoords;		/// Texture coordinates of each vertex.
+		std::vector<Real>			mConfidences;	/// Confidence of each vertex.
+		std::vector<Real>			mValues;		/// Arbitrary scalar of each vertex.
+		std::vector<uint32>			mViewIDs;		/// mViewsPerVertex view IDs of each vertex.
+		uint32						mViewsPerVertex;/// Number of view IDs per vertex.
+	};
+
+	/// Decodes ply vertices with a plan which is compiled once from the vertex format.
+	/** Binary ply vertices have a fixed size, so each property is at a fixed offset within each vertex.
+		The plan stores a decoding operation per property and decodes a block of vertices property by property:
+		each operation runs a tight loop over all vertices of the block which is specialized for the file type and byte order of the property.
+		ASCII vertices are decoded line by line with the same operations and conversions, see decodeText().
+		Vertices are decoded either into PlyVertices with an array per attribute or directly into a caller-described interleaved buffer, see InterleavedLayout.
+		Properties with unknown semantics or of unwanted attributes are skipped without being decoded. */
+	class PlyVertexDecoder
+	{
+	public:
+		/// Vertex attributes which are filled by the decoder.
+		enum ATTRIBUTE
+		{
+			ATTRIBUTE_POSITION,		/// Vector3 with SEMANTIC_X, SEMANTIC_Y and SEMANTIC_Z.
+			ATTRIBUTE_NORMAL,		/// Vector3 with SEMANTIC_NX, SEMANTIC_NY and SEMANTIC_NZ.
+			ATTRIBUTE_COLOR,		/// Vector3 with red, green and blue.
+			ATTRIBUTE_UV_COORDS,	/// Vector2 with SEMANTIC_U and SEMANTIC_V.
+			ATTRIBUTE_CONFIDENCE,	/// Real with SEMANTIC_CONFIDENCE.
+			ATTRIBUTE_VALUE,		/// Real with SEMANTIC_VALUE.
+			ATTRIBUTE_VIEW_IDS,		/// uint32 array with SEMANTIC_VIEWID0 to SEMANTIC_VIEWID10.
+			ATTRIBUTE_COUNT			/// Number of attributes.
+		};
+
+		/// Storage type of the components of an attribute in an interleaved vertex buffer, see InterleavedLayout.
+		enum COMPONENT_TYPE
+		{
+			COMPONENT_NONE,		/// The attribute is not written.
+			COMPONENT_FLOAT32,	/// 32 bit floats, integer colors are scaled from [0, 255] to [0, 1].
+			COMPONENT_FLOAT16,	/// IEEE 754 half floats, integer colors are scaled from [0, 255] to [0, 1].
+			COMPONENT_UNORM8,	/// Normalized unsigned bytes, i.e., real values in [0, 1] are scaled to [0, 255] and integer colors are copied.
+			COMPONENT_UINT32,	/// 32 bit unsigned integers, e.g., for view IDs.
+			COMPONENT_COUNT		/// Number of component types.
+		};
+
+		/// Caller-described interleaved vertex buffer, e.g., an upload-ready GPU vertex buffer, which is filled by decode() and decodeText() directly.
+		/** Each vertex occupies mStride bytes. Each written attribute starts at its offset within the vertex and stores its components consecutively
+			with its component type, e.g., three half floats for a normal. Bytes of the buffer which do not belong to a written attribute are not changed. */
+		struct InterleavedLayout
+		{
+		public:
+			/** Creates a layout without attributes. */
+			inline InterleavedLayout();
+
+			/** Writes an attribute into each vertex.
+			@param attribute Set this to the written attribute.
+			@param type Set this to the storage type of each component of the attribute or COMPONENT_NONE to not write it.
+			@param offset Set this to the offset of the first component of the attribute within each vertex in bytes. */
+			inline void setAttribute(const ATTRIBUTE attribute, const COMPONENT_TYPE type, const uint32 offset);
+
+		public:
+			uint32			mOffsets[ATTRIBUTE_COUNT];	/// Offset in bytes of the first component of each attribute within a vertex.
+			COMPONENT_TYPE	mTypes[ATTRIBUTE_COUNT];	/// Storage type of the components of each attribute or COMPONENT_NONE if it is not written.
+			uint32			mStride;					/// Number of bytes between the starts of two consecutive vertices.
+		};
+
+	public:
+		static const uint32 ALL_ATTRIBUTES = (1u << ATTRIBUTE_COUNT) - 1;	/// Attribute mask for decoding all attributes which are stored in a file.
+		static const uint32 BLOCK_SIZE = 1u << 15;	/// Vertices are decoded in blocks of about this many bytes which stay in the cache while all properties are decoded.
+
+	public:
+		/** Returns the size of a single ply value in a binary file.
+		@param type Set this to the file type of the value.
+		@return Returns the number of bytes of the value or 0 for TYPE_INVALID and TYPE_COUNT. */
+		static uint32 getTypeSize(const Graphics::ElementsDescription::TYPES type);
+
+		/** Returns the size of a single component in an interleaved vertex buffer.
+		@param type Set this to the storage type of the component.
+		@return Returns the number of bytes of the component or 0 for COMPONENT_NONE and COMPONENT_COUNT. */
+		static uint32 getComponentSize(const COMPONENT_TYPE type);
+
+	public:
+		/** Compiles the decoding plan for vertices of a particular format.
+		@param format Set this to the vertex format of a binary ply file, see PlyFile::loadHeader(). Invalid property types result in a plan which is not valid, see isValid().
+		@param attributeMask Set bit (1 << attribute) for each ATTRIBUTE which is decoded. Properties of other attributes are skipped without being decoded
+			and the decoder behaves as if the file did not store them, see hasAttribute() and prepare(). */
+		PlyVertexDecoder(const Graphics::VerticesDescription &format, const uint32 attributeMask = ALL_ATTRIBUTES);
+
+		/** Compiles the decoding plan for vertices of a particular format which are decoded into an interleaved vertex buffer.
+			The conversion to the component type of each property is chosen once, so vertices are converted in a single pass from the file bytes.
+		@param format Set this to the vertex format of a binary or ASCII ply file, see PlyFile::loadHeader().
+		@param layout Set this to the layout of the filled buffers. Attributes with COMPONENT_NONE are skipped without being decoded,
+			attributes of the layout which are not stored in the file are not written. */
+		PlyVertexDecoder(const Graphics::VerticesDescription &format, const InterleavedLayout &layout);
+
+		/** Decodes consecutive binary vertices into the attribute arrays of vertices.
+		@param vertices The arrays of all attributes which are stored in the file must contain at least firstVertexIdx + vertexCount elements.
+			mViewIDs must contain mViewsPerVertex elements per vertex.
+		@param firstVertexIdx Set this to the index of the first decoded vertex within the arrays of vertices.
+		@param source Set this to the file bytes of vertexCount vertices, i.e., vertexCount * getVertexSize() bytes.
+		@param vertexCount Set this to the number of decoded vertices. */
+		void decode(PlyVertices &vertices, const uint64 firstVertexIdx, const uint8 *source, const uint64 vertexCount) const;
+
+		/** Decodes consecutive binary vertices into an interleaved vertex buffer. The decoder must have been created for a layout.
+		@param buffer Set this to the start of a buffer with the layout of the decoder and with space for at least firstVertexIdx + vertexCount vertices.
+		@param firstVertexIdx Set this to the index of the first decoded vertex within buffer.
+		@param source Set this to the file bytes of vertexCount vertices, i.e., vertexCount * getVertexSize() bytes.
+		@param vertexCount Set this to the number of decoded vertices. */
+		void decode(uint8 *buffer, const uint64 firstVertexIdx, const uint8 *source, const uint64 vertexCount) const;
+
+		/** Decodes a single ASCII encoded vertex, i.e., a line of the vertex element of an ASCII ply file.
+		@param vertices The arrays of all attributes which are stored in the file must contain more than vertexIdx elements, see decode().
+		@param vertexIdx Set this to the index of the decoded vertex within the arrays of vertices.
+		@param start Set this to the first character of the vertex. Leading white space is skipped.
+		@param end Set this to the end of the readable characters, e.g., the end of the line.
+		@return Returns a pointer behind the last decoded number or NULL if there are not enough numbers for all properties. */
+		const char *decodeText(PlyVertices &vertices, const uint64 vertexIdx, const char *start, const char *end) const;
+
+		/** Decodes a single ASCII encoded vertex into an interleaved vertex buffer. The decoder must have been created for a layout.
+		@param buffer Set this to the start of a buffer with the layout of the decoder and with space for more than vertexIdx vertices.
+		@param vertexIdx Set this to the index of the decoded vertex within buffer.
+		@param start Set this to the first character of the vertex. Leading white space is skipped.
+		@param end Set this to the end of the readable characters, e.g., the end of the line.
+		@return Returns a pointer behind the last decoded number or NULL if there are not enough numbers for all properties. */
+		const char *decodeText(uint8 *buffer, const uint64 vertexIdx, const char *start, const char *end) const;
+
+		/** Returns the number of view IDs which are stored per vertex.
+		@return Returns one more than the largest SEMANTIC_VIEWIDx - SEMANTIC_VIEWID0 of the format or 0 if there are no view IDs. */
+		inline uint32 getViewsPerVertex() const;
+
+		/** Returns the size of a single binary vertex.
+		@return Returns the number of bytes between the starts of two consecutive vertices. */
+		inline uint32 getVertexSize() const;
+
+		/** Checks whether the file stores an attribute.
+		@param attribute Set this to the attribute of interest.
+		@return Returns true if the format contains at least one component of the attribute. */
+		inline bool hasAttribute(const ATTRIBUTE attribute) const;
+
+		/** Checks whether all property types of the format are valid.
+		@return Returns false if a property has the type TYPE_INVALID or TYPE_COUNT. Such formats cannot be decoded. */
+		inline bool isValid() const;
+
+		/** Checks whether the decoder fills interleaved vertex buffers.
+		@return Returns true if the decoder was created for an InterleavedLayout. */
+		inline bool isInterleaved() const;
+
+		/** Resizes the arrays of vertices to the attributes of the format and clears the arrays of the other attributes.
+		@param vertices The arrays are resized to vertexCount elements if the format stores their attributes or cleared otherwise.
+		@param vertexCount Set this to the number of vertices. */
+		void prepare(PlyVertices &vertices, const uint64 vertexCount) const;
+
+	private:
+		/// Conversion of decoded file values to the attribute type.
+		enum TARGET
+		{
+			TARGET_REAL,		/// Real components of positions, normals etc.
+			TARGET_UNIT_REAL,	/// Real color components which are scaled from [0, 255] to [0, 1].
+			TARGET_UINT32,		/// uint32 view IDs.
+			TARGET_FLOAT32,		/// float components of interleaved buffers.
+			TARGET_UNIT_FLOAT32,	/// float color components which are scaled from [0, 255] to [0, 1].
+			TARGET_FLOAT16,		/// Half float components of interleaved buffers.
+			TARGET_UNIT_FLOAT16,	/// Half float color components which are scaled from [0, 255] to [0, 1].
+			TARGET_UNORM8,		/// Unsigned byte components with real values in [0, 1] which are scaled to [0, 255].
+			TARGET_UINT8,		/// Unsigned byte components with integer values in [0, 255], e.g., colors.
+			TARGET_COUNT		/// Number of conversions.
+		};
+
+		/// Receiver of decoded vertices.
+		struct Destination
+		{
+			PlyVertices	*mVertices;	/// Attribute arrays or NULL for an interleaved buffer.
+			uint8		*mBuffer;	/// Interleaved buffer with mLayoutStride bytes per vertex or NULL for attribute arrays.
+		};
+
+		/// Decodes a single property of all vertices of a block.
+		struct Operation
+		{
+			uint32								mSourceOffset;	/// Offset of the property within each binary vertex.
+			uint32								mComponent;		/// Component of the attribute, e.g., 1 for the y-coordinate of a position.
+			uint32								mTargetOffset;	/// Offset of the component within each vertex of an interleaved buffer.
+			ATTRIBUTE							mAttribute;		/// Attribute which receives the decoded values or ATTRIBUTE_COUNT for unknown semantics.
+			Graphics::ElementsDescription::TYPES mSourceType;	/// Type of the property in the file.
+			TARGET								mTarget;		/// Conversion of the decoded values.
+		};
+
+	private:
+		/** Decodes a single property of consecutive vertices with a loop for a particular file type and byte order.
+		@param target Set this to the first decoded component within the attribute array.
+		@param targetStride Set this to the number of bytes between the components of two consecutive vertices in the attribute array.
+		@param conversion Set this to the conversion of the decoded values to the attribute type.
+		@param source Set this to the property of the first file vertex.
+		@param sourceStride Set this to the number of bytes per file vertex.
+		@param vertexCount Set this to the number of decoded vertices. */
+		template <class Source, bool SWAP>
+		static void decodeColumn(uint8 *target, const uint32 targetStride, const TARGET conversion,
+			const uint8 *source, const uint32 sourceStride, const uint64 vertexCount);
+
+		/** Compiles the operation of each property.
+		@param format Set this to the vertex format of the file.
+		@param attributeMask Set bit (1 << attribute) for each ATTRIBUTE which is decoded.
+		@param layout Set this to the layout of interleaved buffers or NULL to decode into attribute arrays. */
+		void compile(const Graphics::VerticesDescription &format, const uint32 attributeMask, const InterleavedLayout *layout);
+
+		/** Decodes consecutive binary vertices block by block and property by property, see decode().
+		@param destination Set this to the receiver of the vertices.
+		@param firstVertexIdx Set this to the index of the first decoded vertex within destination.
+		@param source Set this to the file bytes of vertexCount vertices.
+		@param vertexCount Set this to the number of decoded vertices. */
+		void decodeBlocks(const Destination &destination, const uint64 firstVertexIdx, const uint8 *source, const uint64 vertexCount) const;
+
+		/** Decodes a single property of consecutive vertices.
+		@param operation Set this to the operation of the property.
+		@param target Set this to the first decoded component within the attribute array.
+		@param targetStride Set this to the number of bytes between the components of two consecutive vertices in the attribute array.
+		@param source Set this to the first file vertex.
+		@param vertexCount Set this to the number of decoded vertices. */
+		void decodeProperty(const Operation &operation, uint8 *target, const uint32 targetStride,
+			const uint8 *source, const uint64 vertexCount) const;
+
+		/** Decodes a single ASCII encoded vertex, see decodeText().
+		@param destination Set this to the receiver of the vertex.
+		@param vertexIdx Set this to the index of the decoded vertex within destination.
+		@param start Set this to the first character of the vertex.
+		@param end Set this to the end of the readable characters.
+		@return Returns a pointer behind the last decoded number or NULL if there are not enough numbers for all properties. */
+		const char *decodeTextLine(const Destination &destination, const uint64 vertexIdx, const char *start, const char *end) const;
+
+		/** Returns where an operation stores its decoded values.
+		@param targetStride Is set to the number of bytes between the components of two consecutive vertices in the destination.
+		@param destination Set this to the attribute arrays or the interleaved buffer which receive the decoded values.
+		@param operation Set this to the operation of a property with a known semantic.
+		@param vertexIdx Set this to the index of the vertex within the destination.
+		@return Returns the component of vertex vertexIdx which is written by the operation. */
+		uint8 *getTarget(uint32 &targetStride, const Destination &destination, const Operation &operation, const uint64 vertexIdx) const;
+
+	private:
+		std::vector<Operation>	mOperations;					/// Decoding operation of each property in file order.
+		bool					mAttributes[ATTRIBUTE_COUNT];	/// Is true for each attribute which is stored in the file.
+		uint32					mLayoutStride;					/// Number of bytes per vertex of interleaved buffers or 0 for attribute arrays.
+		uint32					mVertexSize;					/// Number of bytes per binary vertex.
+		uint32					mViewsPerVertex;				/// Number of view IDs per vertex.
+		bool					mSwapBytes;						/// Is true if the file byte order differs from the host byte order.
+		bool					mValid;							/// Is false if a property type is invalid.
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	///   inline function definitions   ////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	inline PlyVertexDecoder::InterleavedLayout::InterleavedLayout() :
+		mStride(0)
+	{
+		for (uint32 attributeIdx = 0; attributeIdx < ATTRIBUTE_COUNT; ++attributeIdx)
+		{
+			mOffsets[attributeIdx] = 0;
+			mTypes[attributeIdx] = COMPONENT_NONE;
+		}
+	}
+
+	inline void PlyVertexDecoder::InterleavedLayout::setAttribute(const ATTRIBUTE attribute, const COMPONENT_TYPE type, const uint32 offset)
+	{
+		assert(attribute < ATTRIBUTE_COUNT && type < COMPONENT_COUNT);
+		mOffsets[attribute] = offset;
+		mTypes[attribute] = type;
+	}
+
+	inline uint32 PlyVertexDecoder::getViewsPerVertex() const
+	{
+		return mViewsPerVertex;
+	}
+
+	inline uint32 PlyVertexDecoder::getVertexSize() const
+	{
+		return mVertexSize;
+	}
+
+	inline bool PlyVertexDecoder::hasAttribute(const ATTRIBUTE attribute) const
+	{
+		return mAttributes[attribute];
+	}
+
+	inline bool PlyVertexDecoder::isInterleaved() const
+	{
+		return (0 != mLayoutStride);
+	}
+
+	inline bool PlyVertexDecoder::isValid() const
+	{
+		return mValid;
+	}
+}
+
+#endif // _UTILITIES_PLY_VERTEX_DECODER_H_
@@ -11,17 +11,38 @@
 #include <cstdio>
 #endif // _WINDOWS
 
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 #include <sstream>
+#include <string>
+#include <vector>
+#include "Graphics/FacesDescription.h"
+#include "Graphics/VerticesDescription.h"
+#include "Math/Matrix4x4.h"
+#include "Math/Quaternion.h"
+#include "Math/Vector3.h"
+#include "Math/Vector4.h"
 #include "Platform/Application.h"
 #include "Platform/Input/InputManager.h"
 #include "Platform/Multithreading/Manager.h"
 #include "Platform/ResourceManagement/MemoryManager.h"
+#include "Platform/Storage/Path.h"
 #include "Platform/Timing/TimePeriod.h"
+#include "Platform/Utilities/BatchTransforms.h"
+#include "Platform/Utilities/MeshCache.h"
+#include "Platform/Utilities/NumberParsing.h"
+#include "Platform/Utilities/PlyFile.h"
 
+using namespace Graphics;
 using namespace Input;
+using namespace Math;
 using namespace Platform;
 using namespace std;
+using namespace Storage;
 using namespace Timing;
+using namespace Utilities;
 
 #ifdef MEMORY_MANAGEMENT
 	const uint32 ResourceManagement::DEFAULT_POOL_BUCKET_NUMBER = 5;
@@ -31,6 +52,647 @@ using namespace Timing;
 
 std::mutex osMutex;
 
+void test(const string &name, bool value)
+{
+	cout << name << ((value) ? ": V":": X") << endl;
+}
+
+Real realRandom()
+{
+	return ((Real) rand() / RAND_MAX) * 2.0f - 1.0f;
+}
+
+/** Checks that parseReal() consumes the same characters as strtod / strtof and returns exactly the same bits.
+@param text Set this to the zero terminated number which is parsed.
+@return Returns true if the double and the float conversions match the library ones. */
+bool matchesLibrary(const char *text)
+{
+	const char *end = text + strlen(text);
+	char *libraryEnd = NULL;
+
+	double parsedDouble;
+	const double libraryDouble = strtod(text, &libraryEnd);
+	const char *doubleEnd = parseReal(parsedDouble, text, end);
+	const bool sameDouble = (std::isnan(libraryDouble) ?
+		std::isnan(parsedDouble) && std::signbit(parsedDouble) == std::signbit(libraryDouble) :
+		0 == memcmp(&parsedDouble, &libraryDouble, sizeof(double)));
+	if (!sameDouble || doubleEnd != libraryEnd)
+	{
+		cout << "parseReal(double) differs from strtod for \"" << text << "\"" << endl;
+		return false;
+	}
+
+	float parsedFloat;
+	const float libraryFloat = strtof(text, &libraryEnd);
+	const char *floatEnd = parseReal(parsedFloat, text, end);
+	const bool sameFloat = (std::isnan(libraryFloat) ?
+		std::isnan(parsedFloat) && std::signbit(parsedFloat) == std::signbit(libraryFloat) :
+		0 == memcmp(&parsedFloat, &libraryFloat, sizeof(float)));
+	if (!sameFloat || floatEnd != libraryEnd)
+	{
+		cout << "parseReal(float) differs from strtof for \"" << text << "\"" << endl;
+		return false;
+	}
+
+	return true;
+}
+
+/** Checks that all numbers of a zero terminated list are parsed like by the library.
+@param numbers Set this to the numbers followed by NULL.
+@return Returns true if all numbers match, see matchesLibrary(). */
+bool matchLibrary(const char **numbers)
+{
+	bool matches = true;
+	for (uint32 numberIdx = 0; numbers[numberIdx]; ++numberIdx)
+		matches &= matchesLibrary(numbers[numberIdx]);
+	return matches;
+}
+
+/** Checks that the first count vectors equal the reference ones and that the vectors behind them are still untouched.
+@param vectors Set this to count transformed vectors followed by untouched guard vectors.
+@param references Set this to count expected vectors followed by the expected guard vectors.
+@param count Set this to the number of transformed vectors.
+@param tolerance Set this to the maximum absolute difference of each component, 0 for exactly equal results.
+@return Returns true if all vectors match. */
+bool equalVectors(const vector<Vector3> &vectors, const vector<Vector3> &references, const uint64 count, const Real tolerance)
+{
+	for (uint64 vectorIdx = 0; vectorIdx < vectors.size(); ++vectorIdx)
+	{
+		const Vector3 &v = vectors[vectorIdx];
+		const Vector3 &reference = references[vectorIdx];
+		const Real componentTolerance = (vectorIdx < count ? tolerance : 0.0f);
+		if (!(fabsr(v.x - reference.x) <= componentTolerance && fabsr(v.y - reference.y) <= componentTolerance && fabsr(v.z - reference.z) <= componentTolerance))
+			return false;
+	}
+	return true;
+}
+
+/** Copies separate component arrays into a vector array, e.g., to compare them with equalVectors().
+@param vectors Is filled with the vectors of the components.
+@param x Set this to the x-components.
+@param y Set this to the y-components.
+@param z Set this to the z-components. */
+void gatherVectors(vector<Vector3> &vectors, const vector<Real> &x, const vector<Real> &y, const vector<Real> &z)
+{
+	vectors.resize(x.size());
+	for (size_t vectorIdx = 0; vectorIdx < x.size(); ++vectorIdx)
+		vectors[vectorIdx].set(x[vectorIdx], y[vectorIdx], z[vectorIdx]);
+}
+
+/** Compares all batch transformations of some vectors with per element Math operators.
+	Structures of arrays must equal arrays of structures exactly and transformations into the source arrays must equal the ones into separate targets.
+@param count Set this to the number of transformed vectors.
+@param parallel Set this to true to split large arrays across the worker threads.
+@return Returns false if any result differs. */
+bool testBatchTransforms(const uint64 count, const bool parallel)
+{
+	// guard vectors behind the transformed ones detect writes of zero padded tails
+	const uint64 GUARD_COUNT = 4;
+	const uint64 size = count + GUARD_COUNT;
+	const Real GUARD = 12345.0f;
+
+	vector<Vector3> sources(size, Vector3(GUARD, GUARD, GUARD));
+	vector<Real> x(size, GUARD);
+	vector<Real> y(size, GUARD);
+	vector<Real> z(size, GUARD);
+	for (uint64 vectorIdx = 0; vectorIdx < count; ++vectorIdx)
+	{
+		sources[vectorIdx].set(realRandom(), realRandom(), realRandom() + 3.0f);
+		x[vectorIdx] = sources[vectorIdx].x;
+		y[vectorIdx] = sources[vectorIdx].y;
+		z[vectorIdx] = sources[vectorIdx].z;
+	}
+
+	// transformations: scaled & translated rotation, projection, rotation quaternion
+	Matrix4x4 transformation = Matrix4x4::createRotationX(0.3f) * Matrix4x4::createRotationY(1.1f);
+	transformation.values[0][0] *= 2.0f;
+	transformation.addTranslation(1.0f, -2.0f, 0.5f);
+
+	Matrix4x4 normalMatrix = Matrix4x4::createInverse(transformation);
+	normalMatrix.transpose();
+
+	const Matrix4x4 projection = Matrix4x4::createProjectionFovLHDirectX(1.0f, 1.3f, 0.1f, 100.0f);
+
+	Vector3 axis(1.0f, 2.0f, 3.0f);
+	axis.normalize();
+	Quaternion rotation(axis, 0.7f);
+	rotation.normalize();
+
+	// operations: affine points, normals, normalized normals, rotation, projection
+	const uint32 OPERATION_COUNT = 5;
+	const Real tolerances[OPERATION_COUNT] = { 0.0f, 1e-4f, 1e-4f, 1e-4f, 0.0f };
+	bool correct = true;
+
+	for (uint32 operation = 0; operation < OPERATION_COUNT; ++operation)
+	{
+		// per element reference
+		vector<Vector3> references(sources);
+		for (uint64 vectorIdx = 0; vectorIdx < count; ++vectorIdx)
+		{
+			const Vector3 &s = sources[vectorIdx];
+			Vector4 result;
+			switch (operation)
+			{
+				case 0: result = Vector4(s.x, s.y, s.z, 1.0f) * transformation; break;
+				case 1: case 2: result = Vector4(s.x, s.y, s.z, 0.0f) * normalMatrix; break;
+				case 3: rotation.rotateVector(result, Vector4(s.x, s.y, s.z, 0.0f)); break;
+				default: result = Vector4(s.x, s.y, s.z, 1.0f) * projection; result = result / result.w; break;
+			}
+
+			references[vectorIdx].set(result.x, result.y, result.z);
+			if (2 == operation)
+				references[vectorIdx].normalize();
+		}
+
+		// batches into separate targets & in place, arrays of structures & structures of arrays
+		vector<Vector3> targets(size, Vector3(GUARD, GUARD, GUARD));
+		vector<Vector3> inPlace(sources);
+		vector<Real> targetsX(size, GUARD), targetsY(size, GUARD), targetsZ(size, GUARD);
+		vector<Real> inPlaceX(x), inPlaceY(y), inPlaceZ(z);
+
+		for (uint32 variant = 0; variant < 2; ++variant)
+		{
+			Vector3 *t = (0 == variant ? targets.data() : inPlace.data());
+			const Vector3 *s = (0 == variant ? sources.data() : inPlace.data());
+			Real *tX = (0 == variant ? targetsX.data() : inPlaceX.data());
+			Real *tY = (0 == variant ? targetsY.data() : inPlaceY.data());
+			Real *tZ = (0 == variant ? targetsZ.data() : inPlaceZ.data());
+			const Real *sX = (0 == variant ? x.data() : inPlaceX.data());
+			const Real *sY = (0 == variant ? y.data() : inPlaceY.data());
+			const Real *sZ = (0 == variant ? z.data() : inPlaceZ.data());
+
+			switch (operation)
+			{
+				case 0:
+					BatchTransforms::transformPoints(t, s, count, transformation, parallel);
+					BatchTransforms::transformPoints(tX, tY, tZ, sX, sY, sZ, count, transformation, parallel);
+					break;
+				case 1: case 2:
+					BatchTransforms::transformNormals(t, s, count, transformation, 2 == operation, parallel);
+					BatchTransforms::transformNormals(tX, tY, tZ, sX, sY, sZ, count, transformation, 2 == operation, parallel);
+					break;
+				case 3:
+					BatchTransforms::rotate(t, s, count, rotation, parallel);
+					BatchTransforms::rotate(tX, tY, tZ, sX, sY, sZ, count, rotation, parallel);
+					break;
+				default:
+					BatchTransforms::projectPoints(t, s, count, projection, parallel);
+					BatchTransforms::projectPoints(tX, tY, tZ, sX, sY, sZ, count, projection, parallel);
+					break;
+			}
+		}
+
+		vector<Vector3> gathered;
+		correct &= equalVectors(targets, references, count, tolerances[operation]);
+		correct &= equalVectors(inPlace, targets, count, 0.0f);
+		gatherVectors(gathered, targetsX, targetsY, targetsZ);
+		correct &= equalVectors(gathered, targets, count, 0.0f);
+		gatherVectors(gathered, inPlaceX, inPlaceY, inPlaceZ);
+		correct &= equalVectors(gathered, targets, count, 0.0f);
+	}
+
+	return correct;
+}
+
+void testBatchTransforms()
+{
+	cout << "Batch transforms tests:\n";
+
+	// empty, single vector, partial & complete blocks of 4 vectors, a block and a zero padded vector
+	const uint64 counts[] = { 0, 1, 3, 4, 5 };
+	bool correct = true;
+	for (uint32 countIdx = 0; countIdx < sizeof(counts) / sizeof(counts[0]); ++countIdx)
+		correct &= testBatchTransforms(counts[countIdx], false);
+	test("batch transforms of single blocks", correct);
+	test("batch transforms of many blocks", testBatchTransforms(1001, false));
+
+	// ranges of the calling thread & RangeTasks, the last count splits blocks and pads the tails of the ranges
+	Platform::Multithreading::Manager *manager = new Platform::Multithreading::Manager();
+	manager->runWork(3);
+	const uint64 threshold = 2 * Utilities::BatchTransforms::PARALLEL_ELEMENT_COUNT;
+	test("parallel batch transforms below the threshold", testBatchTransforms(threshold - 1, true));
+	test("parallel batch transforms at the threshold", testBatchTransforms(threshold, true));
+	test("parallel batch transforms of unaligned ranges", testBatchTransforms(3 * threshold + 3, true));
+	delete manager;
+
+	cout << endl;
+}
+
+void testNumberParsing()
+{
+	cout << "Number parsing tests:\n";
+
+	// exactly between two representable numbers -> round half to even, also just below and above
+	const char *halfwayNumbers[] =
+	{
+		"9007199254740993", "9007199254740995", "9007199254740993.0000000000000001",
+		"1.00000000000000011102230246251565404236316680908203125",
+		"1.00000000000000011102230246251565404236316680908203124",
+		"1.00000000000000011102230246251565404236316680908203126",
+		"16777217", "16777219", "1.000000059604644775390625", "1.000000059604644775390626",
+		"0.1", "0.2", "0.3", "2.5", "0.5e1", "4.35", NULL
+	};
+	test("parseReal halfway cases", matchLibrary(halfwayNumbers));
+
+	// gradual underflow
+	const char *subnormalNumbers[] =
+	{
+		"2.2250738585072011e-308", "2.2250738585072014e-308", "4.9406564584124654e-324",
+		"2.4703282292062327e-324", "2.4703282292062328e-324", "1e-310", "123456e-315",
+		"1.17549435e-38", "1.401298464e-45", "7.006492321624085e-46", "7.006492321624086e-46", "1e-40", NULL
+	};
+	test("parseReal subnormals", matchLibrary(subnormalNumbers));
+
+	// more digits than the fast path handles
+	const char *longNumbers[] =
+	{
+		"1234567890123456789", "9999999999999999999", "12345678901234567890", "18446744073709551615",
+		"18446744073709551616", "123456789012345678901234567890", "0.12345678901234567890123",
+		"00000000000000000000001.5", "0.000000000000000000000000000001", "1.0000000000000000000000000000001",
+		"3.14159265358979323846264338327950288419716939937510582097494459230781640628620899862803482534211706798214808651328230664709384460955058223172535940812848111745028410270193852110555964462294895493038196",
+		NULL
+	};
+	test("parseReal long mantissas", matchLibrary(longNumbers));
+
+	// overflow to infinity & underflow to zero
+	const char *exponentNumbers[] =
+	{
+		"1e22", "1e23", "1e-22", "1e-23", "1e308", "1.7976931348623157e308", "1.7976931348623158e308",
+		"1.7976931348623159e308", "1e309", "1e400", "-1e400", "1e-324", "1e-400", "-1e-400",
+		"3.4028234e38", "3.4028236e38", "1e39", "1e-46", "0e999999", "1e99999999999999999999",
+		"1e-99999999999999999999", "0.0000001e99999999999999999999", "10000000000e-99999999999999999999", NULL
+	};
+	test("parseReal exponent overflow & underflow", matchLibrary(exponentNumbers));
+
+	// special values, signs & incomplete numbers
+	const char *specialNumbers[] =
+	{
+		"inf", "-inf", "+inf", "INF", "infinity", "-Infinity", "infinit", "nan", "-nan", "+NaN", "nan(123)",
+		"0", "-0", "+0", "-0.0e10", "+1.5", "-1.5e-3", ".5", "5.", "-.5e1", "1e", "1e+", "1e-x", "1.5E+3",
+		"12abc", "1,5", "-", "+", ".", "", "abc", "0x1p3", "-0x1.8p1", "0x", NULL
+	};
+	test("parseReal inf, nan & signs", matchLibrary(specialNumbers));
+
+	// random numbers of various lengths & exponents
+	bool randomMatches = true;
+	char text[64];
+	srand(42);
+	for (uint32 iteration = 0; iteration < 100000 && randomMatches; ++iteration)
+	{
+		const uint32 digitCount = 1 + rand() % 24;
+		const uint32 pointPosition = rand() % (digitCount + 1);
+		uint32 length = 0;
+
+		if (0 == rand() % 2)
+			text[length++] = '-';
+		for (uint32 digitIdx = 0; digitIdx < digitCount; ++digitIdx)
+		{
+			if (digitIdx == pointPosition)
+				text[length++] = '.';
+			text[length++] = (char) ('0' + rand() % 10);
+		}
+		sprintf(text + length, "e%d", rand() % 700 - 350);
+
+		randomMatches = matchesLibrary(text);
+	}
+	test("parseReal random numbers", randomMatches);
+
+	cout << endl;
+}
+
+/** Saves a grid mesh with random positions, normals and colors.
+@param vertices Is filled with the saved positions, normals and colors.
+@param indices Is filled with the saved triangles.
+@param fileName Set this to the path of the created ply file.
+@param encoding Defines how the mesh is saved.
+@param gridSize Set this to the number of vertices per side of the grid. */
+void savePlyMesh(PlyVertices &vertices, vector<uint32> &indices, const Path &fileName, const Encoding encoding, const uint32 gridSize)
+{
+	const uint32 vertexCount = gridSize * gridSize;
+	vertices.mPositions.resize(vertexCount);
+	vertices.mNormals.resize(vertexCount);
+	vertices.mColors.resize(vertexCount);
+	for (uint32 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx)
+	{
+		vertices.mPositions[vertexIdx].set(realRandom(), realRandom(), realRandom());
+		vertices.mNormals[vertexIdx].set(realRandom(), realRandom(), realRandom());
+		vertices.mColors[vertexIdx].set((Real) (rand() % 256) / 255, (Real) (rand() % 256) / 255, (Real) (rand() % 256) / 255);
+	}
+
+	indices.clear();
+	for (uint32 y = 0; y + 1 < gridSize; ++y)
+	{
+		for (uint32 x = 0; x + 1 < gridSize; ++x)
+		{
+			const uint32 corner = y * gridSize + x;
+			const uint32 triangles[6] = { corner, corner + 1, corner + gridSize, corner + 1, corner + gridSize + 1, corner + gridSize };
+			indices.insert(indices.end(), triangles, triangles + 6);
+		}
+	}
+
+	PlyFile file(fileName, File::CREATE_WRITING, true);
+	file.saveTriangleMesh(encoding, true, vertexCount, (uint32) indices.size(),
+		vertices.mColors.data(), vertices.mNormals.data(), vertices.mPositions.data(), NULL, NULL, NULL, 0, indices.data());
+}
+
+/** Loads the vertices of a ply file property by property with PlyFile::readVertexProperty() as reference for all faster loading paths.
+@param vertices Is filled with the positions, normals and colors of the file.
+@param fileName Set this to the path of the ply file.
+@param encoding Set this to the encoding of the file. */
+void loadReferenceVertices(PlyVertices &vertices, const Path &fileName, const Encoding encoding)
+{
+	PlyFile file(fileName, File::OPEN_READING, ENCODING_ASCII != encoding);
+
+	VerticesDescription verticesFormat;
+	FacesDescription facesFormat;
+	file.loadHeader(verticesFormat, &facesFormat);
+
+	const vector<ElementsDescription::TYPES> &types = verticesFormat.getTypeStructure();
+	const vector<uint32> &semantics = verticesFormat.getSemantics();
+	const uint32 vertexCount = verticesFormat.getElementCount();
+	const uint32 propertyCount = verticesFormat.getPropertyCount();
+
+	vertices.mPositions.resize(vertexCount);
+	vertices.mNormals.resize(vertexCount);
+	vertices.mColors.resize(vertexCount);
+	for (uint32 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx)
+		for (uint32 propertyIdx = 0; propertyIdx < propertyCount; ++propertyIdx)
+			file.readVertexProperty(&vertices.mColors[vertexIdx], &vertices.mNormals[vertexIdx], vertices.mPositions[vertexIdx], NULL, NULL, NULL, NULL,
+				types[propertyIdx], (VerticesDescription::SEMANTICS) semantics[propertyIdx]);
+}
+
+/** Checks that the positions, normals and colors of some vertices equal the ones of reference vertices.
+@param vertices Set this to the tested vertices.
+@param references Set this to the expected vertices.
+@param tolerance Set this to the maximum absolute difference of each component, 0 for exactly equal vertices.
+@return Returns true if all attribute arrays have the same sizes and all vertices match. */
+bool equalVertices(const PlyVertices &vertices, const PlyVertices &references, const Real tolerance)
+{
+	if (vertices.mPositions.size() != references.mPositions.size() ||
+		vertices.mNormals.size() != references.mNormals.size() ||
+		vertices.mColors.size() != references.mColors.size())
+		return false;
+
+	return equalVectors(vertices.mPositions, references.mPositions, references.mPositions.size(), tolerance) &&
+		equalVectors(vertices.mNormals, references.mNormals, references.mNormals.size(), tolerance) &&
+		equalVectors(vertices.mColors, references.mColors, references.mColors.size(), tolerance);
+}
+
+/** Loads a ply file with PlyFile::loadVertices() and PlyFile::loadTriangles() and compares the mesh with the reference mesh.
+@param fileName Set this to the path of the ply file.
+@param encoding Set this to the encoding of the file.
+@param mode Set this to OPEN_READING or OPEN_READING_MAPPED.
+@param references Set this to the vertices which were loaded property by property, see loadReferenceVertices().
+@param referenceIndices Set this to the saved triangles.
+@return Returns true if the vertices equal the reference ones exactly and the triangles equal the saved ones. */
+bool testPlyLoading(const Path &fileName, const Encoding encoding, const File::FileMode mode,
+	const PlyVertices &references, const vector<uint32> &referenceIndices)
+{
+	PlyFile file(fileName, mode, ENCODING_ASCII != encoding);
+
+	VerticesDescription verticesFormat;
+	FacesDescription facesFormat;
+	file.loadHeader(verticesFormat, &facesFormat);
+
+	PlyVertices vertices;
+	file.loadVertices(vertices, verticesFormat);
+
+	vector<uint32> indices;
+	file.loadTriangles(indices, facesFormat);
+
+	return equalVertices(vertices, references, 0.0f) && indices == referenceIndices;
+}
+
+/** Appends the first elements of a streamed attribute array or checks that an attribute which was not requested is not delivered.
+@param target The first count elements of source are appended to target if the attribute is requested.
+@param source Set this to the attribute array of a batch.
+@param count Set this to the number of vertices of the batch.
+@param requested Set this to true if the attribute is set in the attribute mask of the stream.
+@return Returns false if source is too short for a requested attribute or if it is not empty for an attribute which was not requested. */
+bool appendStreamed(vector<Vector3> &target, const vector<Vector3> &source, const uint64 count, const bool requested)
+{
+	if (!requested)
+		return source.empty();
+	if (source.size() < count)
+		return false;
+
+	target.insert(target.end(), source.begin(), source.begin() + count);
+	return true;
+}
+
+/** Streams a ply file with PlyFile::streamVertices() and PlyFile::streamTriangles() and compares the batches with the reference mesh.
+@param fileName Set this to the path of the ply file.
+@param encoding Set this to the encoding of the file.
+@param mode Set this to OPEN_READING or OPEN_READING_MAPPED.
+@param batchSize Set this to the maximum number of vertices and faces per batch.
+@param attributeMask Set this to the streamed vertex attributes, see PlyVertexDecoder::ATTRIBUTE.
+@param references Set this to the vertices which were loaded property by property, see loadReferenceVertices().
+@param referenceIndices Set this to the saved triangles.
+@return Returns true if the batches are consecutive and not larger than batchSize, contain only the requested attributes and equal the reference mesh. */
+bool testPlyStreaming(const Path &fileName, const Encoding encoding, const File::FileMode mode, const uint64 batchSize, const uint32 attributeMask,
+	const PlyVertices &references, const vector<uint32> &referenceIndices)
+{
+	PlyFile file(fileName, mode, ENCODING_ASCII != encoding);
+
+	VerticesDescription verticesFormat;
+	FacesDescription facesFormat;
+	file.loadHeader(verticesFormat, &facesFormat);
+
+	// gather the vertex batches
+	PlyVertices vertices;
+	uint64 nextVertexIdx = 0;
+	bool validBatches = true;
+	file.streamVertices([&] (const PlyVertices &batch, const uint64 firstVertexIdx, const uint64 vertexCount)
+	{
+		validBatches &= (firstVertexIdx == nextVertexIdx && vertexCount > 0 && vertexCount <= batchSize);
+		validBatches &= appendStreamed(vertices.mPositions, batch.mPositions, vertexCount, 0 != (attributeMask & (1u << PlyVertexDecoder::ATTRIBUTE_POSITION)));
+		validBatches &= appendStreamed(vertices.mNormals, batch.mNormals, vertexCount, 0 != (attributeMask & (1u << PlyVertexDecoder::ATTRIBUTE_NORMAL)));
+		validBatches &= appendStreamed(vertices.mColors, batch.mColors, vertexCount, 0 != (attributeMask & (1u << PlyVertexDecoder::ATTRIBUTE_COLOR)));
+		nextVertexIdx += vertexCount;
+	}, verticesFormat, batchSize, attributeMask);
+
+	// gather the face batches, the mesh has only triangles
+	vector<uint32> indices;
+	uint64 nextFaceIdx = 0;
+	file.streamTriangles([&] (const uint32 *batch, const uint64 triangleCount, const uint64 firstFaceIdx)
+	{
+		validBatches &= (firstFaceIdx == nextFaceIdx && triangleCount > 0 && triangleCount <= batchSize);
+		indices.insert(indices.end(), batch, batch + 3 * triangleCount);
+		nextFaceIdx += triangleCount;
+	}, facesFormat, batchSize);
+
+	// unwanted attributes are not delivered
+	PlyVertices expected = references;
+	if (0 == (attributeMask & (1u << PlyVertexDecoder::ATTRIBUTE_POSITION)))
+		expected.mPositions.clear();
+	if (0 == (attributeMask & (1u << PlyVertexDecoder::ATTRIBUTE_NORMAL)))
+		expected.mNormals.clear();
+	if (0 == (attributeMask & (1u << PlyVertexDecoder::ATTRIBUTE_COLOR)))
+		expected.mColors.clear();
+
+	return validBatches && equalVertices(vertices, expected, 0.0f) && indices == referenceIndices;
+}
+
+/** Loads a ply file twice with PlyFile::loadCached(), i.e., converts it to a new cache file and then uses the mapped cache file,
+	and compares both cached meshes with the reference mesh. The cache file is removed afterwards.
+@param fileName Set this to the path of the ply file which must not have a cache file yet.
+@param references Set this to the vertices which were loaded property by property, see loadReferenceVertices().
+@param referenceIndices Set this to the saved triangles.
+@return Returns true if the converted and the mapped cached mesh equal the reference mesh exactly. */
+bool testPlyCache(const Path &fileName, const PlyVertices &references, const vector<uint32> &referenceIndices)
+{
+	bool equal = true;
+	for (uint32 loadIdx = 0; loadIdx < 2; ++loadIdx)
+	{
+		// the second load maps the cache file of the first one and verifies its checksum
+		MeshCache cache;
+		PlyFile::loadCached(cache, fileName, 1 == loadIdx);
+
+		PlyVertices vertices;
+		vector<uint32> indices;
+		cache.copyVertices(vertices);
+		cache.copyIndices(indices);
+		equal &= (equalVertices(vertices, references, 0.0f) && indices == referenceIndices);
+	}
+
+	remove(PlyFile::getCachePath(fileName).getCString());
+	return equal;
+}
+
+/** Converts a finite IEEE 754 half float to a float.
+@param half Set this to the bits of the half float.
+@return Returns the value of half. */
+float halfToFloat(const uint16 half)
+{
+	const float sign = (0 != (half & 0x8000) ? -1.0f : 1.0f);
+	const int32 exponent = (half >> 10) & 0x1f;
+	const int32 mantissa = half & 0x3ff;
+
+	// subnormal or normalized with implicit leading one
+	if (0 == exponent)
+		return sign * ldexpf((float) mantissa, -24);
+	return sign * ldexpf((float) (mantissa | 0x400), exponent - 25);
+}
+
+/** Loads the vertices of a ply file with PlyFile::loadInterleavedVertices() into float positions, half float normals and normalized byte colors
+	and compares them with the reference vertices.
+@param fileName Set this to the path of the ply file.
+@param encoding Set this to the encoding of the file.
+@param mode Set this to OPEN_READING or OPEN_READING_MAPPED.
+@param references Set this to the vertices which were loaded property by property, see loadReferenceVertices().
+@return Returns true if all components equal the converted reference components up to the precision of their types
+	and if the bytes behind the colors of each vertex are not changed. */
+bool testPlyInterleaving(const Path &fileName, const Encoding encoding, const File::FileMode mode, const PlyVertices &references)
+{
+	PlyFile file(fileName, mode, ENCODING_ASCII != encoding);
+
+	VerticesDescription verticesFormat;
+	FacesDescription facesFormat;
+	file.loadHeader(verticesFormat, &facesFormat);
+
+	// 12 bytes of positions, 6 bytes of normals, 3 bytes of colors & 3 unused bytes per vertex
+	PlyVertexDecoder::InterleavedLayout layout;
+	layout.setAttribute(PlyVertexDecoder::ATTRIBUTE_POSITION, PlyVertexDecoder::COMPONENT_FLOAT32, 0);
+	layout.setAttribute(PlyVertexDecoder::ATTRIBUTE_NORMAL, PlyVertexDecoder::COMPONENT_FLOAT16, 12);
+	layout.setAttribute(PlyVertexDecoder::ATTRIBUTE_COLOR, PlyVertexDecoder::COMPONENT_UNORM8, 18);
+	layout.mStride = 24;
+
+	const uint8 GUARD = 0xcd;
+	const uint64 vertexCount = verticesFormat.getElementCount();
+	vector<uint8> buffer(vertexCount * layout.mStride, GUARD);
+	file.loadInterleavedVertices(buffer.data(), layout, verticesFormat);
+
+	if (vertexCount != references.mPositions.size())
+		return false;
+
+	// ASCII values might be rounded differently when parsed directly as float, half floats have 11 significant bits
+	for (uint64 vertexIdx = 0; vertexIdx < vertexCount; ++vertexIdx)
+	{
+		const uint8 *vertex = buffer.data() + vertexIdx * layout.mStride;
+		float position[3];
+		uint16 normal[3];
+		memcpy(position, vertex, sizeof(position));
+		memcpy(normal, vertex + 12, sizeof(normal));
+
+		for (uint32 componentIdx = 0; componentIdx < 3; ++componentIdx)
+		{
+			if (fabsf(position[componentIdx] - (float) references.mPositions[vertexIdx].getData()[componentIdx]) > 1e-6f ||
+				fabsf(halfToFloat(normal[componentIdx]) - (float) references.mNormals[vertexIdx].getData()[componentIdx]) > 1e-3f ||
+				vertex[18 + componentIdx] != (uint8) roundr(references.mColors[vertexIdx].getData()[componentIdx] * 255) ||
+				vertex[21 + componentIdx] != GUARD)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/** Saves a random grid mesh and compares the ply loading paths with loading it property by property.
+@param encoding Defines how the mesh is saved.
+@param encodingName Set this to the name of the encoding which prefixes the test names.
+@param gridSize Set this to the number of vertices per side of the grid. */
+void testPlyFile(const Encoding encoding, const string &encodingName, const uint32 gridSize)
+{
+	const Path fileName("PlatformTest.ply");
+
+	PlyVertices savedVertices;
+	vector<uint32> savedIndices;
+	savePlyMesh(savedVertices, savedIndices, fileName, encoding, gridSize);
+
+	// ASCII files store 6 decimals
+	PlyVertices references;
+	loadReferenceVertices(references, fileName, encoding);
+	test(encodingName + " ply per property loading", equalVertices(references, savedVertices, 1e-5f));
+
+	test(encodingName + " ply loading", testPlyLoading(fileName, encoding, File::OPEN_READING, references, savedIndices));
+	test(encodingName + " mapped ply loading", testPlyLoading(fileName, encoding, File::OPEN_READING_MAPPED, references, savedIndices));
+
+	// single elements, partial last batches and a single batch
+	const uint64 batchSizes[] = { 1, 999, 1u << 20 };
+	bool streamed = true;
+	bool mappedStreamed = true;
+	for (uint32 batchSizeIdx = 0; batchSizeIdx < sizeof(batchSizes) / sizeof(batchSizes[0]); ++batchSizeIdx)
+	{
+		streamed &= testPlyStreaming(fileName, encoding, File::OPEN_READING, batchSizes[batchSizeIdx],
+			PlyVertexDecoder::ALL_ATTRIBUTES, references, savedIndices);
+		mappedStreamed &= testPlyStreaming(fileName, encoding, File::OPEN_READING_MAPPED, batchSizes[batchSizeIdx],
+			PlyVertexDecoder::ALL_ATTRIBUTES, references, savedIndices);
+	}
+	test(encodingName + " ply streaming", streamed);
+	test(encodingName + " mapped ply streaming", mappedStreamed);
+
+	// normals are skipped
+	const uint32 attributeMask = (1u << PlyVertexDecoder::ATTRIBUTE_POSITION) | (1u << PlyVertexDecoder::ATTRIBUTE_COLOR);
+	test(encodingName + " ply streaming of positions & colors",
+		testPlyStreaming(fileName, encoding, File::OPEN_READING, 999, attributeMask, references, savedIndices) &&
+		testPlyStreaming(fileName, encoding, File::OPEN_READING_MAPPED, 999, attributeMask, references, savedIndices));
+
+	test(encodingName + " ply mesh cache", testPlyCache(fileName, references, savedIndices));
+
+	test(encodingName + " interleaved ply loading", testPlyInterleaving(fileName, encoding, File::OPEN_READING, references));
+	test(encodingName + " mapped interleaved ply loading", testPlyInterleaving(fileName, encoding, File::OPEN_READING_MAPPED, references));
+
+	remove(fileName.getCString());
+}
+
+void testPlyFile()
+{
+	cout << "Ply file tests:\n";
+
+	// binary vertices span several chunks of PlyFile::VERTEX_CHUNK_SIZE bytes and a partial last one
+	testPlyFile(ENCODING_ASCII, "ASCII", 200);
+	testPlyFile(ENCODING_BINARY_LITTLE_ENDIAN, "binary little endian", 200);
+	testPlyFile(ENCODING_BINARY_BIG_ENDIAN, "binary big endian", 200);
+
+	// vertices & faces span several chunks of PlyTextParser::CHUNK_SIZE characters which are parsed by the worker threads
+	Platform::Multithreading::Manager *manager = new Platform::Multithreading::Manager();
+	manager->runWork(3);
+	testPlyFile(ENCODING_ASCII, "parallel ASCII", 320);
+	delete manager;
+
+	cout << endl;
+}
+
 class OutputTask : public Multithreading::Task
 {
 public:
@@ -218,6 +880,10 @@ protected:
 	{
 #endif // _WINDOWS
 
+	testNumberParsing();
+	testBatchTransforms();
+	testPlyFile();
+
 	{
 		#ifdef _WINDOWS
 			MyApp application(applicationHandle);